@@ -12,6 +12,8 @@ constexpr int BufferLength = 256;
 
 constexpr int TimeoutSeconds = 15;
 
+constexpr int ListenBacklog = 20;
+
 }
 
 }
@@ -14,7 +14,9 @@ class Network : public detail::NetworkInterface {
   virtual ~Network();
 
   static NetworkPtr Create();
+  static NetworkPtr Create(int listen_backlog);
   static NetworkPtr Create(detail::SystemInterfacePtr system);
+  static NetworkPtr Create(detail::SystemInterfacePtr system, int listen_backlog);
 
   int Socket(int domain = PF_INET) override;
 
@@ -34,7 +36,7 @@ class Network : public detail::NetworkInterface {
   ConnectionData Accept(int socket) override;
 
  private:
-  Network(detail::SystemInterfacePtr system);
+  Network(detail::SystemInterfacePtr system, int listen_backlog);
 
   int OpenSocket(int domain, struct sockaddr *saddr, int saddr_size);
 
@@ -42,8 +44,7 @@ class Network : public detail::NetworkInterface {
   size_t Send(int socket, const void *buffer, size_t length);
 
   detail::SystemInterfacePtr system_;
-  char buffer[detail::BufferLength];
-  std::vector<char> receive_text_buffer;
+  const int listen_backlog_;
 };
 
 }
@@ -36,14 +36,22 @@ Network::~Network() {
 }
 
 NetworkPtr Network::Create() {
+  return Create(detail::ListenBacklog);
+}
+
+NetworkPtr Network::Create(int listen_backlog) {
   BOOST_LOG_TRIVIAL(debug) << "libpatlms::network::Network::Create: Function call";
   detail::SystemInterfacePtr system(new detail::System());
-  return Create(system);
+  return Create(system, listen_backlog);
 }
 
 NetworkPtr Network::Create(detail::SystemInterfacePtr system) {
+  return Create(system, detail::ListenBacklog);
+}
+
+NetworkPtr Network::Create(detail::SystemInterfacePtr system, int listen_backlog) {
   BOOST_LOG_TRIVIAL(debug) << "libpatlms::network::Network::Create(system): Function call";
-  NetworkPtr network_ptr(new Network(system));
+  NetworkPtr network_ptr(new Network(system, listen_backlog));
   return network_ptr;
 }
 
@@ -154,8 +162,7 @@ void Network::SendText(int socket, const string &text) {
 const string Network::ReceiveText(int socket) {
   BOOST_LOG_TRIVIAL(debug) << "libpatlms::network::Network::ReceiveText: Function call with (socket=" << socket << ")";
   NetworkMessage message;
-
-  receive_text_buffer.clear();
+  vector<char> receive_text_buffer;
 
   do {
     message = RecvMessage(socket);
@@ -179,6 +186,7 @@ NetworkMessage Network::RecvMessage(int socket) {
   unsigned message_length = 0, total = 0, left_to_receive = 0;
   int received = 0;
   NetworkMessage message;
+  char buffer[detail::BufferLength];
 
   wait_status = WaitForData(socket, detail::TimeoutSeconds);
   if (wait_status != WaitStatus::NEW_DATA) {
@@ -273,8 +281,9 @@ ConnectionData Network::Accept(int socket) {
   return data;
 }
 
-Network::Network(detail::SystemInterfacePtr system)
-: system_(system) {
+Network::Network(detail::SystemInterfacePtr system, int listen_backlog)
+: system_(system),
+listen_backlog_(listen_backlog) {
 }
 
 int Network::OpenSocket(int domain, struct sockaddr *saddr, int saddr_size) {
@@ -296,7 +305,7 @@ int Network::OpenSocket(int domain, struct sockaddr *saddr, int saddr_size) {
     throw exception::detail::CantOpenSocketException();
   }
 
-  ret = system_->Listen(socket_fd, 20);
+  ret = system_->Listen(socket_fd, listen_backlog_);
   if (ret < 0) {
     BOOST_LOG_TRIVIAL(error) << "libpatlms::network::Network::OpenSocket: Listen error: " << strerror(errno);
     throw exception::detail::CantOpenSocketException();
@@ -162,6 +162,15 @@ TEST_F(NetworkTest, OpenIpv4SocketWhenListenFailed) {
   EXPECT_THROW(network->OpenIpv4Socket("127.1.0.1", 90), exception::detail::CantOpenSocketException);
 }
 
+TEST_F(NetworkTest, OpenIpv4SocketWithListenBacklog) {
+  EXPECT_CALL(*system, Socket(PF_INET, SOCK_STREAM, 0)).WillOnce(Return(13));
+  EXPECT_CALL(*system, Bind(_, _, sizeof (struct sockaddr_in))).WillOnce(Return(0));
+  EXPECT_CALL(*system, Listen(_, 128)).WillOnce(Return(0));
+  NetworkPtr network = Network::Create(system, 128);
+
+  EXPECT_EQ(13, network->OpenIpv4Socket("127.0.0.1", 90));
+}
+
 TEST_F(NetworkTest, ConnectUnix) {
   EXPECT_CALL(*system, Connect(13, _, _)).WillOnce(Return(0));
   NetworkPtr network = Network::Create(system);
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "src/apache/analyzer/detail/prepare_statistics/distance_kernel.h"
+#include "src/apache/analyzer/detail/prepare_statistics/knn_classifier.h"
+
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+using ::database::type::Classification;
+
+namespace
+{
+
+constexpr int SESSIONS_TO_CLASSIFY = 64;
+
+ApacheSessions RandomSessions(std::mt19937 &generator, long long count) {
+  std::uniform_real_distribution<double> distribution(0, 1000);
+
+  ApacheSessions sessions;
+  sessions.reserve(count);
+  for (long long i = 0; i < count; ++i) {
+    ApacheSessionEntry s;
+    s.id = i + 1;
+    s.session_length = distribution(generator);
+    s.bandwidth_usage = distribution(generator);
+    s.requests_count = distribution(generator);
+    s.error_percentage = distribution(generator) / 10;
+    s.classification = (i % 10 == 0) ? Classification::ANOMALY : Classification::NORMAL;
+
+    sessions.push_back(s);
+  }
+
+  return sessions;
+}
+
+// learning set is added in chunks, so 10M rows don't need a copy as ApacheSessions
+void FillLearningSet(KnnClassifierPtr classifier, long long rows) {
+  std::mt19937 generator(rows);
+  const long long CHUNK = 100000;
+
+  for (long long added = 0; added < rows; added += CHUNK)
+    classifier->AddToLearningSet(RandomSessions(generator, std::min(CHUNK, rows - added)));
+}
+
+void BM_KnnClassify(benchmark::State &state) {
+  auto classifier = KnnClassifier::Create(::analyzer::WorkerPool::Create());
+  FillLearningSet(classifier, state.range(0));
+
+  std::mt19937 generator(0);
+  const auto sessions = RandomSessions(generator, SESSIONS_TO_CLASSIFY);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(classifier->Classify(sessions));
+
+  state.SetItemsProcessed(state.iterations() * sessions.size());
+  state.counters["sessions/s"] = benchmark::Counter(state.iterations() * sessions.size(),
+                                                    benchmark::Counter::kIsRate);
+}
+
+void BM_KnnClassifyWithIndex(benchmark::State &state) {
+  auto classifier = KnnClassifier::Create(::analyzer::WorkerPool::Create());
+  FillLearningSet(classifier, state.range(0));
+  classifier->BuildIndex();
+
+  std::mt19937 generator(0);
+  const auto sessions = RandomSessions(generator, SESSIONS_TO_CLASSIFY);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(classifier->Classify(sessions));
+
+  state.SetItemsProcessed(state.iterations() * sessions.size());
+  state.counters["sessions/s"] = benchmark::Counter(state.iterations() * sessions.size(),
+                                                    benchmark::Counter::kIsRate);
+}
+
+void BM_KnnClassifyApproximate(benchmark::State &state) {
+  auto classifier = KnnClassifier::Create(::analyzer::WorkerPool::Create());
+  classifier->EnableApproximateSearch(16, 64);
+  FillLearningSet(classifier, state.range(0));
+
+  std::mt19937 generator(0);
+  const auto sessions = RandomSessions(generator, SESSIONS_TO_CLASSIFY);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(classifier->Classify(sessions));
+
+  state.SetItemsProcessed(state.iterations() * sessions.size());
+  state.counters["sessions/s"] = benchmark::Counter(state.iterations() * sessions.size(),
+                                                    benchmark::Counter::kIsRate);
+}
+
+template <void (*Kernel)(const LearningSet&, const SessionFeatures&, double*)>
+void BM_SquaredDistances(benchmark::State &state) {
+  std::mt19937 generator(state.range(0));
+  LearningSet learning_set;
+  for (const auto &s : RandomSessions(generator, state.range(0)))
+    learning_set.Add(s);
+
+  const auto session = SessionFeatures::Create(RandomSessions(generator, 1).at(0));
+  std::vector<double> distances(learning_set.Size());
+
+  for (auto _ : state) {
+    Kernel(learning_set, session, distances.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * learning_set.Size());
+}
+
+}
+
+BENCHMARK(BM_KnnClassify)->RangeMultiplier(10)->Range(1000, 10000000)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KnnClassifyWithIndex)->RangeMultiplier(10)->Range(1000, 10000000)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KnnClassifyApproximate)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SquaredDistances, SquaredDistancesScalar)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_SquaredDistances, SquaredDistancesAvx2)->RangeMultiplier(10)->Range(1000, 1000000);
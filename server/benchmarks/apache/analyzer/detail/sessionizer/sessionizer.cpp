@@ -0,0 +1,86 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/apache/analyzer/detail/sessionizer/sessionizer.h"
+
+using namespace ::apache::analyzer::detail::sessionizer;
+
+namespace
+{
+
+constexpr int CLIENTS = 200000;
+constexpr int USER_AGENTS = 500;
+constexpr int VIRTUALHOSTS = 20;
+constexpr int LOGS_PER_SECOND = 1000;
+
+// Logs are generated from a pool of distinct entries and only their time
+// is changed, so 10M lines don't have to be kept in memory.
+std::vector< ::type::ApacheLogEntry> CreateLogsPool(std::mt19937 &generator) {
+  std::uniform_int_distribution<int> user_agent(0, USER_AGENTS - 1);
+  std::uniform_int_distribution<int> virtualhost(0, VIRTUALHOSTS - 1);
+  std::uniform_int_distribution<int> status_code(0, 19);
+
+  std::vector< ::type::ApacheLogEntry> logs(CLIENTS);
+  for (int i = 0; i < CLIENTS; ++i) {
+    auto &log = logs[i];
+
+    log.id = i;
+    log.agent_name = "agent";
+    log.virtualhost = "virtualhost-" + std::to_string(virtualhost(generator)) + ".example.com";
+    log.client_ip = (i % 4 == 0) ?
+        "2001:db8::" + std::to_string(i) :
+        "10." + std::to_string(i >> 16) + "." + std::to_string((i >> 8) & 0xff) + "." + std::to_string(i & 0xff);
+    log.request = "GET /index.html HTTP/1.1";
+    log.status_code = (status_code(generator) == 0) ? 404 : 200;
+    log.bytes = 1024;
+    log.user_agent = "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/"
+        + std::to_string(user_agent(generator)) + ".0 Safari/537.36";
+  }
+
+  return logs;
+}
+
+void BM_SessionizerReplay(benchmark::State &state) {
+  std::mt19937 generator(0);
+  auto logs = CreateLogsPool(generator);
+  std::uniform_int_distribution<int> client(0, CLIENTS - 1);
+
+  for (auto _ : state) {
+    auto sessionizer = Sessionizer::Create();
+    long long seconds = 0;
+
+    for (long long line = 0; line < state.range(0); ++line) {
+      auto &log = logs[client(generator)];
+
+      if (line % LOGS_PER_SECOND == 0) {
+        ++seconds;
+
+        // once per simulated minute, like the analyzer loop
+        if (seconds % 60 == 0) {
+          sessionizer->CloseExpiredSessions(sessionizer->GetLatestLogTime());
+          sessionizer->ClearClosedSessions();
+        }
+      }
+
+      log.time.Set(seconds / 3600 % 24, seconds / 60 % 60, seconds % 60, 1 + seconds / 86400, 1, 2017);
+      sessionizer->Add(log);
+    }
+
+    benchmark::DoNotOptimize(sessionizer->GetOpenSessionsCount());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["lines/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                 benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK(BM_SessionizerReplay)->Arg(1000000)->Arg(10000000)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/library/fann/dense_network.h"
+#include "src/library/fann/fann_wrapper.h"
+#include "src/library/fann/matrix_kernel.h"
+
+using namespace ::library::fann;
+
+namespace
+{
+
+// the same shape as networks trained for bash daily user statistics
+constexpr unsigned NUMBER_OF_INPUTS = 100;
+constexpr unsigned NUMBER_OF_HIDDEN_NEURONS = 30;
+constexpr unsigned NUMBER_OF_OUTPUTS = 10;
+
+std::shared_ptr<struct fann> CreateNetwork(detail::FannWrapperInterfacePtr fann_wrapper) {
+  struct fann *ann = fann_wrapper->CreateStandard(3, NUMBER_OF_INPUTS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUTS);
+  fann_wrapper->SetActivationFunctionHidden(ann, FANN_SIGMOID);
+  fann_wrapper->SetActivationFunctionOutput(ann, FANN_SIGMOID);
+
+  return std::shared_ptr<struct fann>(ann, [fann_wrapper](struct fann *a) { fann_wrapper->Destroy(a); });
+}
+
+// the file is read again without libfann
+std::string SaveNetwork(detail::FannWrapperInterfacePtr fann_wrapper, struct fann *ann) {
+  const std::string file_path = "/tmp/slas-benchmark-network.net";
+  fann_wrapper->Save(ann, file_path);
+
+  return file_path;
+}
+
+// users run a small part of the selected commands every day
+std::vector<fann_type> RandomInputs(long long rows) {
+  std::mt19937 generator(rows);
+  std::uniform_real_distribution<fann_type> distribution(0, 1);
+
+  std::vector<fann_type> inputs(rows * NUMBER_OF_INPUTS);
+  for (auto &i : inputs)
+    i = (distribution(generator) < 0.2) ? distribution(generator) : 0;
+
+  return inputs;
+}
+
+// the loop used before rows were classified at once
+void BM_FannRunPerRow(benchmark::State &state) {
+  auto fann_wrapper = FannWrapper::Create();
+  auto ann = CreateNetwork(fann_wrapper);
+  auto inputs = RandomInputs(state.range(0));
+  std::vector<fann_type> outputs(state.range(0) * NUMBER_OF_OUTPUTS);
+
+  for (auto _ : state) {
+    for (long long row = 0; row < state.range(0); ++row) {
+      const fann_type *output = fann_wrapper->Run(ann.get(), inputs.data() + row * NUMBER_OF_INPUTS);
+      std::copy_n(output, NUMBER_OF_OUTPUTS, outputs.begin() + row * NUMBER_OF_OUTPUTS);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["rows/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                benchmark::Counter::kIsRate);
+}
+
+template <DenseNetwork::Precision precision>
+void BM_DenseNetworkRun(benchmark::State &state) {
+  auto fann_wrapper = FannWrapper::Create();
+  auto ann = CreateNetwork(fann_wrapper);
+  auto network = DenseNetwork::Create(ann.get(), fann_wrapper);
+  if (precision != DenseNetwork::Precision::FLOAT32)
+    network = DenseNetwork::CreateFromFile(SaveNetwork(fann_wrapper, ann.get()), precision);
+  const auto inputs = RandomInputs(state.range(0));
+  std::vector<fann_type> outputs(state.range(0) * NUMBER_OF_OUTPUTS);
+
+  for (auto _ : state) {
+    network->Run(inputs.data(), state.range(0), outputs.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["rows/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                benchmark::Counter::kIsRate);
+}
+
+template <void (*Kernel)(const float*, std::size_t, const float*, float*, std::size_t, unsigned, unsigned)>
+void BM_MultiplyAdd(benchmark::State &state) {
+  const auto a = RandomInputs(state.range(0));
+  const auto b = RandomInputs(NUMBER_OF_HIDDEN_NEURONS);
+  std::vector<float> c(state.range(0) * NUMBER_OF_HIDDEN_NEURONS);
+
+  for (auto _ : state) {
+    Kernel(a.data(), NUMBER_OF_INPUTS, b.data(), c.data(), state.range(0), NUMBER_OF_INPUTS, NUMBER_OF_HIDDEN_NEURONS);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_FannRunPerRow)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_DenseNetworkRun, DenseNetwork::Precision::FLOAT32)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_DenseNetworkRun, DenseNetwork::Precision::INT8)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_MultiplyAdd, MultiplyAddScalar)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_MultiplyAdd, MultiplyAddAvx2)->RangeMultiplier(10)->Range(100, 100000);
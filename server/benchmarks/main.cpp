@@ -0,0 +1,26 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "../config.h"
+
+#if defined(HAVE_GBENCHMARK)
+
+#include <boost/log/common.hpp>
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv) {
+  boost::log::core::get()->set_logging_enabled(false);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  return 0;
+}
+
+#else
+
+#error Cannot make benchmarks. Google Benchmark library not found.
+
+#endif // HAVE_GBENCHMARK
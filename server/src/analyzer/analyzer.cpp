@@ -1,13 +1,16 @@
 #include "analyzer.h"
 
+#include <algorithm>
 #include <boost/log/trivial.hpp>
-#include <unistd.h>
+#include <exception>
 
 using namespace std;
 
 namespace analyzer
 {
 
+constexpr std::chrono::milliseconds Analyzer::FLAGS_CHECK_INTERVAL;
+
 AnalyzerPtr Analyzer::Create() {
   BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::Create: Function call";
   auto ptr = AnalyzerPtr(new Analyzer());
@@ -16,14 +19,36 @@ AnalyzerPtr Analyzer::Create() {
 
 void Analyzer::StartLoop() {
   BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartLoop: Function call";
+  unique_lock<mutex> lock(mutex_);
 
   is_loop_running_ = true;
   while (is_loop_running_) {
-    BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartLoop: Loop is running";
-    ExecuteAll();
-    sleep(1);
+    const auto now = Clock::now();
+
+    if (is_analyzing_requested_.exchange(false)) {
+      BOOST_LOG_TRIVIAL(info) << "analyzer::Analyzer::StartLoop: Analyzing of all objects requested";
+      for (auto &entry : entries_)
+        entry.is_due = true;
+    }
+
+    JoinFinished();
+    StartDueObjects(now);
+
+    auto wake_time = now + FLAGS_CHECK_INTERVAL;
+    for (const auto &entry : entries_) {
+      if (entry.schedule.cadence.count() > 0 && !entry.is_running && !entry.is_due)
+        wake_time = min(wake_time, entry.next_run);
+    }
+
+    condition_.wait_until(lock, wake_time);
   }
 
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartLoop: Waiting for running objects";
+  condition_.wait(lock, [this]() {
+    return !IsAnyRunning();
+  });
+  JoinFinished();
+
   BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartLoop: Done";
 }
 
@@ -37,35 +62,170 @@ bool Analyzer::IsLoopRunning() const {
 }
 
 void Analyzer::StartAnalyzing() {
+  is_analyzing_requested_ = true;
+}
+
+bool Analyzer::StartAnalyzing(const std::string &name) {
   BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartAnalyzing: Function call";
-  is_analyzing_ = true;
+  lock_guard<mutex> lock(mutex_);
+
+  auto entry = FindEntry(name);
+  if (entry == nullptr) {
+    BOOST_LOG_TRIVIAL(warning) << "analyzer::Analyzer::StartAnalyzing: Unknown object: " << name;
+    return false;
+  }
+
+  entry->is_due = true;
+  condition_.notify_all();
+
+  return true;
 }
 
 bool Analyzer::IsAnalyzing() const {
-  return is_analyzing_;
+  if (is_analyzing_requested_)
+    return true;
+
+  lock_guard<mutex> lock(mutex_);
+  return any_of(entries_.begin(), entries_.end(), [](const Entry &entry) {
+    return entry.is_due || entry.is_running;
+  });
+}
+
+void Analyzer::AddData(const std::string &name, unsigned long long count) {
+  lock_guard<mutex> lock(mutex_);
+
+  auto entry = FindEntry(name);
+  if (entry == nullptr)
+    return;
+
+  entry->pending_data += count;
+  if (entry->schedule.data_threshold > 0 && entry->pending_data >= entry->schedule.data_threshold && !entry->is_due) {
+    BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::AddData: Data threshold reached by " << name;
+    entry->is_due = true;
+    condition_.notify_all();
+  }
 }
 
 void Analyzer::AddObject(AnalyzerObjectInterfacePtr object) {
-  BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::StartAnalyzing: Function call";
-  objects_.insert(object);
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::AddObject: Function call";
+  lock_guard<mutex> lock(mutex_);
+
+  entries_.emplace_back();
+  auto &entry = entries_.back();
+  entry.object = object;
+  entry.schedule = object->GetSchedule();
+  entry.next_run = Clock::now() + entry.schedule.cadence;
+  entry.is_due = false;
+  entry.is_running = false;
+  entry.pending_data = 0;
+  entry.runs_count = 0;
+
+  condition_.notify_all();
+}
+
+type::ObjectStatuses Analyzer::GetStatuses() const {
+  lock_guard<mutex> lock(mutex_);
+  const auto now = Clock::now();
+  const auto system_now = chrono::system_clock::now();
+
+  type::ObjectStatuses statuses;
+  for (const auto &entry : entries_) {
+    type::ObjectStatus status;
+    status.name = entry.schedule.name;
+    status.last_run = entry.last_run;
+    status.is_due = entry.is_due;
+    status.is_running = entry.is_running;
+    status.pending_data = entry.pending_data;
+    status.runs_count = entry.runs_count;
+
+    if (entry.is_due)
+      status.next_run = system_now;
+    else if (entry.schedule.cadence.count() > 0)
+      status.next_run = system_now + chrono::duration_cast<chrono::system_clock::duration>(max(entry.next_run - now, Clock::duration::zero()));
+
+    statuses.push_back(status);
+  }
+
+  return statuses;
 }
 
 Analyzer::Analyzer() :
 is_loop_running_(false),
-is_analyzing_(false) {
+is_analyzing_requested_(false) {
 }
 
-void Analyzer::ExecuteAll() {
-  BOOST_LOG_TRIVIAL(debug) << "analyzer::Analyzer::ExecuteAll: Function call";
-  if (is_analyzing_) {
-    BOOST_LOG_TRIVIAL(info) << "analyzer::Analyzer::ExecuteAll: Analyzing started";
-    for (auto obj : objects_) {
-      obj->Analyze();
+void Analyzer::StartDueObjects(Clock::time_point now) {
+  for (auto &entry : entries_) {
+    if (entry.schedule.cadence.count() > 0 && entry.next_run <= now)
+      entry.is_due = true;
+  }
+
+  for (auto &entry : entries_) {
+    if (!CanStart(entry))
+      continue;
+
+    BOOST_LOG_TRIVIAL(info) << "analyzer::Analyzer::StartDueObjects: Starting " << entry.schedule.name;
+    entry.is_due = false;
+    entry.is_running = true;
+    entry.pending_data = 0;
+    entry.last_run = chrono::system_clock::now();
+    entry.next_run = now + entry.schedule.cadence;
+    entry.thread = thread(&Analyzer::Run, this, &entry);
+  }
+}
+
+// dependencies must not form a cycle, objects in a cycle never start
+bool Analyzer::CanStart(const Entry &entry) const {
+  if (!entry.is_due || entry.is_running || entry.thread.joinable())
+    return false;
+
+  for (const auto &dependency : entry.schedule.dependencies) {
+    for (const auto &other : entries_) {
+      if (other.schedule.name == dependency && (other.is_due || other.is_running))
+        return false;
     }
-    BOOST_LOG_TRIVIAL(info) << "analyzer::Analyzer::ExecuteAll: Analyzing finished";
+  }
+
+  return true;
+}
 
-    is_analyzing_ = false;
+void Analyzer::Run(Entry *entry) {
+  try {
+    entry->object->Analyze();
   }
+  catch (std::exception &ex) {
+    BOOST_LOG_TRIVIAL(error) << "analyzer::Analyzer::Run: " << entry->schedule.name << " failed: " << ex.what();
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  BOOST_LOG_TRIVIAL(info) << "analyzer::Analyzer::Run: Finished " << entry->schedule.name;
+  entry->is_running = false;
+  ++entry->runs_count;
+  condition_.notify_all();
+}
+
+// a finished thread only has to return from Run, so joining it with the
+// mutex locked doesn't block for long
+void Analyzer::JoinFinished() {
+  for (auto &entry : entries_) {
+    if (!entry.is_running && entry.thread.joinable())
+      entry.thread.join();
+  }
+}
+
+bool Analyzer::IsAnyRunning() const {
+  return any_of(entries_.begin(), entries_.end(), [](const Entry &entry) {
+    return entry.is_running;
+  });
+}
+
+Analyzer::Entry* Analyzer::FindEntry(const std::string &name) {
+  for (auto &entry : entries_) {
+    if (entry.schedule.name == name)
+      return &entry;
+  }
+
+  return nullptr;
 }
 
 }
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
 #include <memory>
-#include <set>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include "analyzer_object_interface.h"
 #include "detail/analyzer_interface.h"
@@ -12,29 +18,66 @@ namespace analyzer
 class Analyzer;
 typedef std::shared_ptr<Analyzer> AnalyzerPtr;
 
+// Objects become due when their cadence passes, when data_threshold items
+// arrived or when they are triggered. Every due object with no due or
+// running dependencies is started on its own thread, so independent objects
+// run concurrently. Object names have to be unique.
 class Analyzer : public detail::AnalyzerInterface {
  public:
   virtual ~Analyzer() = default;
 
   static AnalyzerPtr Create();
 
+  // returns after all started objects finished
   void StartLoop() override;
   void StopLoop() override;
   bool IsLoopRunning() const override;
 
+  // triggers all objects, may be called from a signal handler
   void StartAnalyzing() override;
+  bool StartAnalyzing(const std::string &name) override;
   bool IsAnalyzing() const override;
 
+  void AddData(const std::string &name, unsigned long long count) override;
+
   void AddObject(AnalyzerObjectInterfacePtr object) override;
 
+  type::ObjectStatuses GetStatuses() const override;
+
+  // StopLoop and StartAnalyzing() can't notify the condition variable from
+  // a signal handler, the loop checks them at least this often
+  static constexpr std::chrono::milliseconds FLAGS_CHECK_INTERVAL{1000};
+
  private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry {
+    AnalyzerObjectInterfacePtr object;
+    type::Schedule schedule;
+    Clock::time_point next_run;
+    std::chrono::system_clock::time_point last_run;
+    bool is_due;
+    bool is_running;
+    unsigned long long pending_data;
+    unsigned long long runs_count;
+    std::thread thread;
+  };
+
   Analyzer();
 
-  void ExecuteAll();
+  void StartDueObjects(Clock::time_point now);
+  bool CanStart(const Entry &entry) const;
+  void Run(Entry *entry);
+  void JoinFinished();
+  bool IsAnyRunning() const;
+
+  Entry* FindEntry(const std::string &name);
 
-  std::set<AnalyzerObjectInterfacePtr> objects_;
-  bool is_loop_running_;
-  bool is_analyzing_;
+  std::list<Entry> entries_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::atomic<bool> is_loop_running_;
+  std::atomic<bool> is_analyzing_requested_;
 };
 
 }
@@ -2,6 +2,8 @@
 
 #include <memory>
 
+#include "type/schedule.h"
+
 namespace analyzer
 {
 
@@ -10,6 +12,8 @@ class AnalyzerObjectInterface {
   virtual ~AnalyzerObjectInterface() = default;
 
   virtual void Analyze() = 0;
+
+  virtual type::Schedule GetSchedule() const = 0;
 };
 
 typedef std::shared_ptr<AnalyzerObjectInterface> AnalyzerObjectInterfacePtr;
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
+
+#include "src/analyzer/analyzer_object_interface.h"
+#include "src/analyzer/type/object_status.h"
 
 namespace analyzer
 {
@@ -17,9 +21,14 @@ class AnalyzerInterface {
   virtual bool IsLoopRunning() const = 0;
 
   virtual void StartAnalyzing() = 0;
+  virtual bool StartAnalyzing(const std::string &name) = 0;
   virtual bool IsAnalyzing() const = 0;
 
+  virtual void AddData(const std::string &name, unsigned long long count) = 0;
+
   virtual void AddObject(AnalyzerObjectInterfacePtr object) = 0;
+
+  virtual type::ObjectStatuses GetStatuses() const = 0;
 };
 
 typedef std::shared_ptr<AnalyzerInterface> AnalyzerInterfacePtr;
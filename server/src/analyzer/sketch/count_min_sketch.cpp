@@ -0,0 +1,140 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "count_min_sketch.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "serialization.h"
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+namespace
+{
+
+using detail::Read;
+using detail::ReadVarint;
+using detail::Write;
+using detail::WriteVarint;
+
+constexpr std::uint8_t FORMAT_VERSION = 1;
+constexpr unsigned MAX_WIDTH = 1 << 20;
+constexpr unsigned MAX_DEPTH = 16;
+
+}
+
+constexpr unsigned CountMinSketch::DEFAULT_WIDTH;
+constexpr unsigned CountMinSketch::DEFAULT_DEPTH;
+
+CountMinSketch::CountMinSketch(unsigned width, unsigned depth) :
+width_(std::min(std::max(width, 1u), MAX_WIDTH)),
+depth_(std::min(std::max(depth, 1u), MAX_DEPTH)),
+total_(0),
+counters_(static_cast<std::size_t> (width_) * depth_, 0) {
+}
+
+std::uint64_t CountMinSketch::Add(std::uint64_t hash, std::uint64_t count) {
+  std::uint64_t estimate = std::numeric_limits<std::uint64_t>::max();
+
+  for (unsigned row = 0; row < depth_; ++row) {
+    auto &counter = counters_[GetColumn(hash, row)];
+    counter += count;
+    estimate = std::min(estimate, counter);
+  }
+
+  total_ += count;
+  return estimate;
+}
+
+std::uint64_t CountMinSketch::GetEstimate(std::uint64_t hash) const {
+  std::uint64_t estimate = std::numeric_limits<std::uint64_t>::max();
+
+  for (unsigned row = 0; row < depth_; ++row)
+    estimate = std::min(estimate, counters_[GetColumn(hash, row)]);
+
+  return estimate;
+}
+
+bool CountMinSketch::Merge(const CountMinSketch &other) {
+  if (width_ != other.width_ || depth_ != other.depth_)
+    return false;
+
+  for (std::size_t i = 0; i < counters_.size(); ++i)
+    counters_[i] += other.counters_[i];
+
+  total_ += other.total_;
+  return true;
+}
+
+void CountMinSketch::Halve() {
+  for (auto &c : counters_)
+    c >>= 1;
+
+  total_ >>= 1;
+}
+
+std::uint64_t CountMinSketch::GetTotal() const {
+  return total_;
+}
+
+std::string CountMinSketch::Serialize() const {
+  std::string data;
+  data.reserve(16 + counters_.size());
+
+  Write(data, FORMAT_VERSION);
+  WriteVarint(data, width_);
+  WriteVarint(data, depth_);
+  WriteVarint(data, total_);
+
+  for (auto c : counters_)
+    WriteVarint(data, c);
+
+  return data;
+}
+
+bool CountMinSketch::Deserialize(const std::string &data) {
+  std::size_t offset = 0;
+  std::uint8_t version;
+  std::uint64_t width, depth, total;
+
+  if (!Read(data, offset, version) || version != FORMAT_VERSION
+      || !ReadVarint(data, offset, width) || width == 0 || width > MAX_WIDTH
+      || !ReadVarint(data, offset, depth) || depth == 0 || depth > MAX_DEPTH
+      || !ReadVarint(data, offset, total))
+    return false;
+
+  std::vector<std::uint64_t> counters(width * depth);
+  for (auto &c : counters) {
+    if (!ReadVarint(data, offset, c))
+      return false;
+  }
+
+  if (offset != data.size())
+    return false;
+
+  width_ = width;
+  depth_ = depth;
+  total_ = total;
+  counters_.swap(counters);
+
+  return true;
+}
+
+std::size_t CountMinSketch::GetColumn(std::uint64_t hash, unsigned row) const {
+  // rows use h1 + row * h2 (Kirsch, Mitzenmacher) instead of separate hashes
+  const std::uint32_t h1 = static_cast<std::uint32_t> (hash);
+  const std::uint32_t h2 = static_cast<std::uint32_t> (hash >> 32) | 1;
+
+  return static_cast<std::size_t> (row) * width_ + (h1 + row * h2) % width_;
+}
+
+}
+
+}
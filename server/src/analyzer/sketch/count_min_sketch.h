@@ -0,0 +1,58 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+// Count-min sketch (Cormode, Muthukrishnan): depth rows of width counters,
+// every row adds a value to one counter, the estimate is the smallest of
+// them. Estimates are never too small and are too large by at most
+// e / width of the total count with probability 1 - exp(-depth).
+class CountMinSketch {
+ public:
+  static constexpr unsigned DEFAULT_WIDTH = 256;
+  static constexpr unsigned DEFAULT_DEPTH = 4;
+
+  explicit CountMinSketch(unsigned width = DEFAULT_WIDTH, unsigned depth = DEFAULT_DEPTH);
+
+  // hash should be a well mixed 64-bit hash, see Hash in hash.h; returns
+  // the estimate after adding.
+  std::uint64_t Add(std::uint64_t hash, std::uint64_t count = 1);
+  std::uint64_t GetEstimate(std::uint64_t hash) const;
+
+  // Returns false when dimensions differ.
+  bool Merge(const CountMinSketch &other);
+
+  // Divides all counters and the total by two, rounding down, so old
+  // counts weigh less than new ones and the error stops growing.
+  void Halve();
+
+  std::uint64_t GetTotal() const;
+
+  std::string Serialize() const;
+  // Returns false and leaves the sketch unchanged when data is invalid.
+  bool Deserialize(const std::string &data);
+
+ private:
+  std::size_t GetColumn(std::uint64_t hash, unsigned row) const;
+
+  unsigned width_;
+  unsigned depth_;
+  std::uint64_t total_;
+  std::vector<std::uint64_t> counters_;
+};
+
+}
+
+}
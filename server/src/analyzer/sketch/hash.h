@@ -0,0 +1,39 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+// 64-bit FNV-1a with the MurmurHash3 finalizer, so all bits of the result
+// depend on every byte; sketches take register and column numbers straight
+// from the hash bits. Values don't change between runs, saved sketches stay
+// valid.
+inline std::uint64_t Hash(const std::string &value) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : value) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "hyper_log_log.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "serialization.h"
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+namespace
+{
+
+using detail::Read;
+using detail::Write;
+
+constexpr std::uint8_t FORMAT_DENSE = 1;
+constexpr std::uint8_t FORMAT_SPARSE = 2;
+constexpr unsigned MIN_PRECISION = 4;
+constexpr unsigned MAX_PRECISION = 16;
+
+}
+
+constexpr unsigned HyperLogLog::DEFAULT_PRECISION;
+
+HyperLogLog::HyperLogLog(unsigned precision) :
+precision_(std::min(std::max(precision, MIN_PRECISION), MAX_PRECISION)),
+registers_(std::size_t(1) << precision_, 0) {
+}
+
+void HyperLogLog::Add(std::uint64_t hash) {
+  const std::size_t index = hash >> (64 - precision_);
+  const std::uint64_t rest = hash << precision_;
+
+  // position of the first set bit, values with no set bit get the maximum
+  const std::uint8_t rank = (rest == 0)
+      ? static_cast<std::uint8_t> (64 - precision_ + 1)
+      : static_cast<std::uint8_t> (__builtin_clzll(rest) + 1);
+
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+bool HyperLogLog::Merge(const HyperLogLog &other) {
+  if (precision_ != other.precision_)
+    return false;
+
+  for (std::size_t i = 0; i < registers_.size(); ++i)
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+
+  return true;
+}
+
+double HyperLogLog::GetEstimate() const {
+  const double m = registers_.size();
+  const double alpha = 0.7213 / (1. + 1.079 / m);
+
+  double sum = 0.;
+  std::size_t zeros = 0;
+  for (auto r : registers_) {
+    sum += std::ldexp(1., -static_cast<int> (r));
+    zeros += (r == 0) ? 1 : 0;
+  }
+
+  const double estimate = alpha * m * m / sum;
+
+  // linear counting is more accurate for small sets
+  if (estimate <= 2.5 * m && zeros > 0)
+    return m * std::log(m / zeros);
+
+  return estimate;
+}
+
+std::string HyperLogLog::Serialize() const {
+  std::string data;
+
+  const std::size_t used = registers_.size() - std::count(registers_.begin(), registers_.end(), 0);
+
+  // sparse entry takes three bytes
+  if (used * 3 < registers_.size()) {
+    Write(data, FORMAT_SPARSE);
+    Write(data, static_cast<std::uint8_t> (precision_));
+
+    for (std::size_t i = 0; i < registers_.size(); ++i) {
+      if (registers_[i] != 0) {
+        Write(data, static_cast<std::uint16_t> (i));
+        Write(data, registers_[i]);
+      }
+    }
+  }
+  else {
+    Write(data, FORMAT_DENSE);
+    Write(data, static_cast<std::uint8_t> (precision_));
+    data.append(registers_.begin(), registers_.end());
+  }
+
+  return data;
+}
+
+bool HyperLogLog::Deserialize(const std::string &data) {
+  std::size_t offset = 0;
+  std::uint8_t format, precision;
+
+  if (!Read(data, offset, format) || !Read(data, offset, precision)
+      || precision < MIN_PRECISION || precision > MAX_PRECISION)
+    return false;
+
+  std::vector<std::uint8_t> registers(std::size_t(1) << precision, 0);
+
+  if (format == FORMAT_DENSE) {
+    if (data.size() - offset != registers.size())
+      return false;
+
+    std::copy(data.begin() + offset, data.end(), registers.begin());
+  }
+  else if (format == FORMAT_SPARSE) {
+    std::uint16_t index;
+    std::uint8_t value;
+
+    while (offset < data.size()) {
+      if (!Read(data, offset, index) || !Read(data, offset, value) || index >= registers.size())
+        return false;
+
+      registers[index] = value;
+    }
+  }
+  else {
+    return false;
+  }
+
+  precision_ = precision;
+  registers_.swap(registers);
+
+  return true;
+}
+
+}
+
+}
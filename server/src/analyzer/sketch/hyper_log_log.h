@@ -0,0 +1,48 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+// Distinct values counter (Flajolet et al.) with 2^precision one byte
+// registers. The first precision bits of a value hash select a register,
+// the register keeps the longest run of leading zeros seen in the rest.
+// Standard error is 1.04 / sqrt(2^precision), 1.6% for the default.
+class HyperLogLog {
+ public:
+  static constexpr unsigned DEFAULT_PRECISION = 12;
+
+  explicit HyperLogLog(unsigned precision = DEFAULT_PRECISION);
+
+  // hash should be a well mixed 64-bit hash, see Hash in hash.h
+  void Add(std::uint64_t hash);
+
+  // Returns false when precisions differ.
+  bool Merge(const HyperLogLog &other);
+
+  double GetEstimate() const;
+
+  // Mostly empty sketches are saved as a list of used registers.
+  std::string Serialize() const;
+  // Returns false and leaves the sketch unchanged when data is invalid.
+  bool Deserialize(const std::string &data);
+
+ private:
+  unsigned precision_;
+  std::vector<std::uint8_t> registers_;
+};
+
+}
+
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "serialization.h"
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+namespace
+{
+
+using detail::Read;
+using detail::Write;
+
+constexpr std::uint8_t FORMAT_VERSION = 1;
+constexpr unsigned MIN_K = 8;
+constexpr double CAPACITY_RATIO = 2. / 3.;
+
+}
+
+constexpr unsigned QuantileSketch::DEFAULT_K;
+
+QuantileSketch::QuantileSketch(unsigned k) :
+k_(std::max(k, MIN_K)),
+count_(0),
+min_(0.),
+max_(0.),
+levels_(1),
+size_(0),
+capacity_(0),
+generator_(k_) {
+  UpdateCapacity();
+}
+
+void QuantileSketch::Add(double value) {
+  if (count_ == 0) {
+    min_ = max_ = value;
+  }
+  else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  ++count_;
+  ++size_;
+  levels_[0].push_back(value);
+
+  if (size_ > capacity_)
+    Compress();
+}
+
+void QuantileSketch::Merge(const QuantileSketch &other) {
+  if (other.count_ == 0)
+    return;
+
+  if (count_ == 0) {
+    min_ = other.min_;
+    max_ = other.max_;
+  }
+  else {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  if (levels_.size() < other.levels_.size()) {
+    levels_.resize(other.levels_.size());
+    UpdateCapacity();
+  }
+
+  for (std::size_t h = 0; h < other.levels_.size(); ++h)
+    levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+
+  count_ += other.count_;
+  size_ += other.size_;
+
+  Compress();
+}
+
+double QuantileSketch::GetQuantile(double q) const {
+  if (count_ == 0)
+    return 0.;
+  if (q <= 0.)
+    return min_;
+  if (q >= 1.)
+    return max_;
+
+  std::vector<std::pair<double, std::uint64_t>> values;
+  values.reserve(size_);
+  for (std::size_t h = 0; h < levels_.size(); ++h) {
+    for (auto v : levels_[h])
+      values.push_back(std::make_pair(v, std::uint64_t(1) << h));
+  }
+
+  std::sort(values.begin(), values.end());
+
+  const double rank = q * count_;
+  std::uint64_t weight = 0;
+  for (const auto &v : values) {
+    weight += v.second;
+    if (weight >= rank)
+      return v.first;
+  }
+
+  return max_;
+}
+
+std::uint64_t QuantileSketch::GetCount() const {
+  return count_;
+}
+
+bool QuantileSketch::IsEmpty() const {
+  return count_ == 0;
+}
+
+std::string QuantileSketch::Serialize() const {
+  std::string data;
+  data.reserve(64 + size_ * sizeof (double));
+
+  Write(data, FORMAT_VERSION);
+  Write(data, static_cast<std::uint32_t> (k_));
+  Write(data, count_);
+  Write(data, min_);
+  Write(data, max_);
+  Write(data, static_cast<std::uint32_t> (levels_.size()));
+
+  for (const auto &level : levels_) {
+    Write(data, static_cast<std::uint32_t> (level.size()));
+    data.append(reinterpret_cast<const char*> (level.data()), level.size() * sizeof (double));
+  }
+
+  return data;
+}
+
+bool QuantileSketch::Deserialize(const std::string &data) {
+  std::size_t offset = 0;
+  std::uint8_t version;
+  std::uint32_t k, levels_count;
+  std::uint64_t count;
+  double min, max;
+
+  if (!Read(data, offset, version) || version != FORMAT_VERSION
+      || !Read(data, offset, k) || k < MIN_K
+      || !Read(data, offset, count)
+      || !Read(data, offset, min)
+      || !Read(data, offset, max)
+      || !Read(data, offset, levels_count) || levels_count == 0 || levels_count > 64)
+    return false;
+
+  std::vector<Level> levels(levels_count);
+  std::size_t size = 0;
+  std::uint64_t weight = 0;
+
+  for (std::uint32_t h = 0; h < levels_count; ++h) {
+    std::uint32_t level_size;
+    if (!Read(data, offset, level_size) || (data.size() - offset) / sizeof (double) < level_size)
+      return false;
+
+    levels[h].resize(level_size);
+    std::memcpy(levels[h].data(), data.data() + offset, level_size * sizeof (double));
+    offset += level_size * sizeof (double);
+
+    size += level_size;
+    weight += static_cast<std::uint64_t> (level_size) << h;
+  }
+
+  if (offset != data.size() || weight != count)
+    return false;
+
+  k_ = k;
+  count_ = count;
+  min_ = min;
+  max_ = max;
+  levels_ = std::move(levels);
+  size_ = size;
+  UpdateCapacity();
+
+  return true;
+}
+
+unsigned QuantileSketch::GetCapacity(std::size_t level) const {
+  const double depth = static_cast<double> (levels_.size() - 1 - level);
+
+  return std::max(2u, static_cast<unsigned> (std::ceil(k_ * std::pow(CAPACITY_RATIO, depth))));
+}
+
+void QuantileSketch::UpdateCapacity() {
+  capacity_ = 0;
+  for (std::size_t h = 0; h < levels_.size(); ++h)
+    capacity_ += GetCapacity(h);
+}
+
+void QuantileSketch::Compress() {
+  // some level is over its capacity as long as the sketch is
+  while (size_ > capacity_) {
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+      if (levels_[h].size() >= GetCapacity(h)) {
+        CompactLevel(h);
+        break;
+      }
+    }
+  }
+}
+
+void QuantileSketch::CompactLevel(std::size_t level) {
+  if (level + 1 == levels_.size()) {
+    levels_.emplace_back();
+    UpdateCapacity();
+  }
+
+  Level &current = levels_[level];
+  Level &next = levels_[level + 1];
+
+  std::sort(current.begin(), current.end());
+
+  // with an odd count the smallest value stays on the level
+  const std::size_t first = current.size() % 2;
+  const std::size_t offset = generator_() % 2;
+
+  for (std::size_t i = first + offset; i < current.size(); i += 2)
+    next.push_back(current[i]);
+
+  size_ -= (current.size() - first) / 2;
+  current.resize(first);
+}
+
+}
+
+}
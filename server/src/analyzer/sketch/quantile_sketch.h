@@ -0,0 +1,69 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+// KLL quantile sketch (Karnin, Lang, Liberty). Values are kept in levels,
+// a value on level h stands for 2^h added values. When the sketch is full
+// the lowest full level is sorted and every other value is moved one level
+// up. Memory is O(k) and a quantile rank is off by about 1.7 / k of the
+// values count; while nothing was compacted quantiles are exact.
+//
+// Sketches with the same k may be merged, e.g. sketches of parts of a set.
+class QuantileSketch {
+ public:
+  static constexpr unsigned DEFAULT_K = 200;
+
+  explicit QuantileSketch(unsigned k = DEFAULT_K);
+
+  void Add(double value);
+  void Merge(const QuantileSketch &other);
+
+  // Smallest value v for which at least q * GetCount() values are <= v,
+  // 0 when the sketch is empty.
+  double GetQuantile(double q) const;
+
+  std::uint64_t GetCount() const;
+  bool IsEmpty() const;
+
+  std::string Serialize() const;
+  // Returns false and leaves the sketch unchanged when data is invalid.
+  bool Deserialize(const std::string &data);
+
+ private:
+  typedef std::vector<double> Level;
+
+  unsigned GetCapacity(std::size_t level) const;
+  void UpdateCapacity();
+
+  void Compress();
+  void CompactLevel(std::size_t level);
+
+  unsigned k_;
+  std::uint64_t count_;
+  double min_;
+  double max_;
+
+  std::vector<Level> levels_;
+  std::size_t size_;
+  std::size_t capacity_;
+
+  std::minstd_rand generator_;
+};
+
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+namespace detail
+{
+
+// Sketches are saved in the host byte order, they aren't moved between
+// machines.
+template<typename T>
+void Write(std::string &data, const T &value) {
+  data.append(reinterpret_cast<const char*> (&value), sizeof (value));
+}
+
+template<typename T>
+bool Read(const std::string &data, std::size_t &offset, T &value) {
+  if (data.size() - offset < sizeof (value))
+    return false;
+
+  std::memcpy(&value, data.data() + offset, sizeof (value));
+  offset += sizeof (value);
+  return true;
+}
+
+// Small values take one byte, used for counters which are mostly zeros.
+inline void WriteVarint(std::string &data, std::uint64_t value) {
+  while (value >= 0x80) {
+    data.push_back(static_cast<char> ((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data.push_back(static_cast<char> (value));
+}
+
+inline bool ReadVarint(const std::string &data, std::size_t &offset, std::uint64_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64 && offset < data.size(); shift += 7) {
+    const auto byte = static_cast<std::uint8_t> (data[offset++]);
+    value |= static_cast<std::uint64_t> (byte & 0x7f) << shift;
+
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+inline void WriteString(std::string &data, const std::string &value) {
+  WriteVarint(data, value.size());
+  data.append(value);
+}
+
+inline bool ReadString(const std::string &data, std::size_t &offset, std::string &value) {
+  std::uint64_t size;
+  if (!ReadVarint(data, offset, size) || data.size() - offset < size)
+    return false;
+
+  value.assign(data, offset, size);
+  offset += size;
+  return true;
+}
+
+}
+
+}
+
+}
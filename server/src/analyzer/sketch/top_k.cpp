@@ -0,0 +1,143 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "top_k.h"
+
+#include <algorithm>
+
+#include "hash.h"
+#include "serialization.h"
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+namespace
+{
+
+using detail::Read;
+using detail::ReadString;
+using detail::ReadVarint;
+using detail::Write;
+using detail::WriteString;
+using detail::WriteVarint;
+
+constexpr std::uint8_t FORMAT_VERSION = 1;
+constexpr unsigned MAX_K = 1000;
+
+}
+
+constexpr unsigned TopK::DEFAULT_K;
+
+TopK::TopK(unsigned k, unsigned width, unsigned depth) :
+k_(std::min(std::max(k, 1u), MAX_K)),
+counts_(width, depth) {
+}
+
+void TopK::Add(const std::string &value) {
+  Offer(value, counts_.Add(Hash(value)));
+}
+
+bool TopK::Merge(const TopK &other) {
+  if (!counts_.Merge(other.counts_))
+    return false;
+
+  Items candidates;
+  candidates.swap(items_);
+  candidates.insert(candidates.end(), other.items_.begin(), other.items_.end());
+
+  for (const auto &c : candidates)
+    Offer(c.value, counts_.GetEstimate(Hash(c.value)));
+
+  return true;
+}
+
+TopK::Items TopK::GetItems() const {
+  Items items = items_;
+  std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+    return a.count > b.count || (a.count == b.count && a.value < b.value);
+  });
+
+  return items;
+}
+
+std::uint64_t TopK::GetTotal() const {
+  return counts_.GetTotal();
+}
+
+std::string TopK::Serialize() const {
+  std::string data;
+
+  Write(data, FORMAT_VERSION);
+  WriteVarint(data, k_);
+  WriteString(data, counts_.Serialize());
+  WriteVarint(data, items_.size());
+
+  for (const auto &i : items_) {
+    WriteString(data, i.value);
+    WriteVarint(data, i.count);
+  }
+
+  return data;
+}
+
+bool TopK::Deserialize(const std::string &data) {
+  std::size_t offset = 0;
+  std::uint8_t version;
+  std::uint64_t k, items_count;
+  std::string counts_data;
+  CountMinSketch counts;
+
+  if (!Read(data, offset, version) || version != FORMAT_VERSION
+      || !ReadVarint(data, offset, k) || k == 0 || k > MAX_K
+      || !ReadString(data, offset, counts_data) || !counts.Deserialize(counts_data)
+      || !ReadVarint(data, offset, items_count) || items_count > k)
+    return false;
+
+  Items items(items_count);
+  for (auto &i : items) {
+    if (!ReadString(data, offset, i.value) || !ReadVarint(data, offset, i.count))
+      return false;
+  }
+
+  if (offset != data.size())
+    return false;
+
+  k_ = k;
+  counts_ = counts;
+  items_.swap(items);
+
+  return true;
+}
+
+void TopK::Offer(const std::string &value, std::uint64_t count) {
+  // k is small, a linear scan is cheaper than keeping an index
+  auto it = std::find_if(items_.begin(), items_.end(), [&value](const Item &i) {
+    return i.value == value;
+  });
+
+  if (it != items_.end()) {
+    it->count = std::max(it->count, count);
+    return;
+  }
+
+  if (items_.size() < k_) {
+    items_.push_back(Item{value, count});
+    return;
+  }
+
+  auto smallest = std::min_element(items_.begin(), items_.end(), [](const Item &a, const Item &b) {
+    return a.count < b.count;
+  });
+
+  if (count > smallest->count)
+    *smallest = Item{value, count};
+}
+
+}
+
+}
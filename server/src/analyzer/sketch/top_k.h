@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "count_min_sketch.h"
+
+namespace analyzer
+{
+
+namespace sketch
+{
+
+// Most frequent values. All values are counted in a count-min sketch, only
+// k values with the largest estimates are kept, so counts are estimates too
+// and a value is listed only if it was frequent after it was seen for the
+// last time.
+class TopK {
+ public:
+  struct Item {
+    std::string value;
+    std::uint64_t count;
+  };
+
+  typedef std::vector<Item> Items;
+
+  static constexpr unsigned DEFAULT_K = 10;
+
+  explicit TopK(unsigned k = DEFAULT_K,
+                unsigned width = CountMinSketch::DEFAULT_WIDTH,
+                unsigned depth = CountMinSketch::DEFAULT_DEPTH);
+
+  void Add(const std::string &value);
+
+  // Items of both sketches are estimated again with merged counters.
+  // Returns false when sketches dimensions differ.
+  bool Merge(const TopK &other);
+
+  // Sorted by count, the largest first.
+  Items GetItems() const;
+  std::uint64_t GetTotal() const;
+
+  std::string Serialize() const;
+  // Returns false and leaves the sketch unchanged when data is invalid.
+  bool Deserialize(const std::string &data);
+
+ private:
+  void Offer(const std::string &value, std::uint64_t count);
+
+  unsigned k_;
+  CountMinSketch counts_;
+  Items items_;
+};
+
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "stage_metrics.h"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <boost/log/trivial.hpp>
+
+namespace analyzer
+{
+
+namespace
+{
+
+std::mutex active_stages_mutex;
+unsigned active_stages_count = 0;
+
+// peak is reset only when no other stage is measured, so the peak of
+// overlapping stages is shared
+void StartMemoryMeasurement() {
+  std::lock_guard<std::mutex> lock(active_stages_mutex);
+
+  if (active_stages_count++ == 0) {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+  }
+}
+
+void StopMemoryMeasurement() {
+  std::lock_guard<std::mutex> lock(active_stages_mutex);
+  --active_stages_count;
+}
+
+long long GetPeakMemoryKb() {
+  std::ifstream status("/proc/self/status");
+  std::string name;
+
+  while (status >> name) {
+    if (name == "VmHWM:") {
+      long long value = 0;
+      status >> value;
+      return value;
+    }
+
+    status.ignore(256, '\n');
+  }
+
+  return 0;
+}
+
+}
+
+constexpr std::size_t StageMetrics::RUNS_COUNT;
+
+StageMetricsPtr StageMetrics::Create() {
+  return Create(RUNS_COUNT);
+}
+
+StageMetricsPtr StageMetrics::Create(std::size_t runs_count) {
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::StageMetrics::Create: Function call";
+
+  return StageMetricsPtr(new StageMetrics(std::max<std::size_t>(runs_count, 1)));
+}
+
+void StageMetrics::Add(const type::StageRun &run) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (runs_.size() < runs_count_)
+    runs_.push_back(run);
+  else
+    runs_[next_index_] = run;
+
+  next_index_ = (next_index_ + 1) % runs_count_;
+}
+
+type::StageRuns StageMetrics::GetRuns() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (runs_.size() < runs_count_)
+    return runs_;
+
+  type::StageRuns runs(runs_.begin() + next_index_, runs_.end());
+  runs.insert(runs.end(), runs_.begin(), runs_.begin() + next_index_);
+  return runs;
+}
+
+StageMetrics::StageMetrics(std::size_t runs_count) :
+runs_count_(runs_count),
+next_index_(0) {
+}
+
+StageRecorder::StageRecorder(StageMetricsPtr metrics, const std::string &stage) :
+metrics_(metrics),
+stage_(stage),
+start_(std::chrono::system_clock::now()),
+steady_start_(std::chrono::steady_clock::now()) {
+  if (metrics_) {
+    counters_scope_.reset(new ::database::StatementCountersScope(&counters_));
+    StartMemoryMeasurement();
+  }
+}
+
+StageRecorder::~StageRecorder() {
+  if (!metrics_)
+    return;
+
+  type::StageRun run;
+  run.stage = stage_;
+  run.start = start_;
+  run.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - steady_start_).count();
+  run.statements = counters_.statements;
+  run.rows_read = counters_.rows_read;
+  run.rows_written = counters_.rows_written;
+  run.peak_memory_kb = GetPeakMemoryKb();
+  run.failed = std::uncaught_exception();
+
+  StopMemoryMeasurement();
+  counters_scope_.reset();
+
+  try {
+    metrics_->Add(run);
+  }
+  catch (const std::exception &ex) {
+    BOOST_LOG_TRIVIAL(error) << "analyzer::StageRecorder::~StageRecorder: Can't add run: " << ex.what();
+  }
+}
+
+}
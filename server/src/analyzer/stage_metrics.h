@@ -0,0 +1,69 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/analyzer/type/stage_run.h"
+#include "src/database/statement_counters.h"
+
+namespace analyzer
+{
+
+class StageMetrics;
+typedef std::shared_ptr<StageMetrics> StageMetricsPtr;
+
+// Keeps the last runs_count stage runs.
+class StageMetrics {
+ public:
+  virtual ~StageMetrics() = default;
+
+  static StageMetricsPtr Create();
+  static StageMetricsPtr Create(std::size_t runs_count);
+
+  void Add(const type::StageRun &run);
+
+  // oldest run first
+  type::StageRuns GetRuns() const;
+
+  static constexpr std::size_t RUNS_COUNT = 100;
+
+ private:
+  explicit StageMetrics(std::size_t runs_count);
+
+  const std::size_t runs_count_;
+  std::vector<type::StageRun> runs_;
+  std::size_t next_index_;
+  mutable std::mutex mutex_;
+};
+
+// Measures a stage from construction to destruction and adds the run to
+// the metrics. SQL statements executed by the thread (and by WorkerPool
+// tasks started from it) are counted. Does nothing when metrics is null.
+class StageRecorder {
+ public:
+  StageRecorder(StageMetricsPtr metrics, const std::string &stage);
+  ~StageRecorder();
+
+  StageRecorder(const StageRecorder&) = delete;
+  StageRecorder& operator=(const StageRecorder&) = delete;
+
+ private:
+  StageMetricsPtr metrics_;
+  const std::string stage_;
+  const std::chrono::system_clock::time_point start_;
+  const std::chrono::steady_clock::time_point steady_start_;
+
+  ::database::StatementCounters counters_;
+  std::unique_ptr<::database::StatementCountersScope> counters_scope_;
+};
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace type
+{
+
+// last_run is the start of the last run, both times are zero when not set
+struct ObjectStatus {
+  std::string name;
+  std::chrono::system_clock::time_point last_run;
+  std::chrono::system_clock::time_point next_run;
+  bool is_due;
+  bool is_running;
+  unsigned long long pending_data;
+  unsigned long long runs_count;
+};
+
+typedef std::vector<ObjectStatus> ObjectStatuses;
+
+}
+
+}
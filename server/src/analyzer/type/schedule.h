@@ -0,0 +1,30 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace type
+{
+
+// An object with zero cadence runs only when triggered, zero data_threshold
+// means that arriving data doesn't trigger it. The object is not started
+// while any of its dependencies is due or running.
+struct Schedule {
+  std::string name;
+  std::chrono::seconds cadence;
+  unsigned long long data_threshold;
+  std::vector<std::string> dependencies;
+};
+
+}
+
+}
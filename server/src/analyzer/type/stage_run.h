@@ -0,0 +1,35 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace analyzer
+{
+
+namespace type
+{
+
+// peak_memory_kb is the peak resident set size of the process during the
+// stage, it includes memory used by stages running at the same time
+struct StageRun {
+  std::string stage;
+  std::chrono::system_clock::time_point start;
+  double wall_seconds;
+  long long statements;
+  long long rows_read;
+  long long rows_written;
+  long long peak_memory_kb;
+  bool failed;
+};
+
+typedef std::vector<StageRun> StageRuns;
+
+}
+
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "command_executor_object.h"
+
+#include <boost/log/trivial.hpp>
+#include <chrono>
+#include <json/json.hpp>
+
+using namespace std;
+using namespace nlohmann;
+
+namespace analyzer
+{
+
+namespace web
+{
+
+namespace
+{
+
+long long GetSeconds(const chrono::system_clock::time_point &time) {
+  return chrono::duration_cast<chrono::seconds>(time.time_since_epoch()).count();
+}
+
+}
+
+CommandExecutorObjectPtr CommandExecutorObject::Create(::analyzer::detail::AnalyzerInterfacePtr analyzer,
+                                                       ::analyzer::StageMetricsPtr stage_metrics) {
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::web::CommandExecutorObject::Create: Function call";
+  auto p = CommandExecutorObjectPtr(new CommandExecutorObject(analyzer, stage_metrics));
+  return p;
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::Execute(const ::web::type::JsonMessage &message) {
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::web::CommandExecutorObject::Execute: Function call";
+  auto json_object = json::parse(message);
+  auto command = json_object["command"];
+  auto result = GetUnknownCommandErrorJson();
+
+  if (command == "start_analyzing") {
+    BOOST_LOG_TRIVIAL(info) << "analyzer::web::CommandExecutorObject::Execute: Found 'start_analyzing' command";
+
+    auto args = json_object["args"];
+    if (args.size() > 1) {
+      BOOST_LOG_TRIVIAL(warning) << "analyzer::web::CommandExecutorObject::Execute: start_analyzing require zero or one argument";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = args.empty() ? StartAnalyzing() : StartAnalyzing(args.at(0));
+  }
+  else if (command == "get_analyzer_schedule") {
+    BOOST_LOG_TRIVIAL(info) << "analyzer::web::CommandExecutorObject::Execute: Found 'get_analyzer_schedule' command";
+    result = GetAnalyzerSchedule();
+  }
+  else if (command == "get_analyzer_metrics") {
+    BOOST_LOG_TRIVIAL(info) << "analyzer::web::CommandExecutorObject::Execute: Found 'get_analyzer_metrics' command";
+    result = GetAnalyzerMetrics();
+  }
+
+  return result;
+}
+
+bool CommandExecutorObject::IsCommandSupported(const ::web::type::Command &command) {
+  return (command == "start_analyzing")
+      || (command == "get_analyzer_schedule")
+      || (command == "get_analyzer_metrics")
+      ;
+}
+
+CommandExecutorObject::CommandExecutorObject(::analyzer::detail::AnalyzerInterfacePtr analyzer,
+                                             ::analyzer::StageMetricsPtr stage_metrics) :
+analyzer_(analyzer),
+stage_metrics_(stage_metrics) {
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::StartAnalyzing() {
+  for (const auto &status : analyzer_->GetStatuses())
+    analyzer_->StartAnalyzing(status.name);
+
+  json j;
+  j["status"] = "ok";
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::StartAnalyzing(const std::string &name) {
+  if (!analyzer_->StartAnalyzing(name))
+    return GetInvalidArgumentErrorJson();
+
+  json j;
+  j["status"] = "ok";
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::GetAnalyzerSchedule() const {
+  json r = json::array();
+
+  for (const auto &status : analyzer_->GetStatuses()) {
+    json s;
+    s["name"] = status.name;
+    s["last_run"] = GetSeconds(status.last_run);
+    s["next_run"] = GetSeconds(status.next_run);
+    s["is_due"] = status.is_due;
+    s["is_running"] = status.is_running;
+    s["pending_data"] = status.pending_data;
+    s["runs_count"] = status.runs_count;
+    r.push_back(s);
+  }
+
+  json j;
+  j["status"] = "ok";
+  j["result"] = r;
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::GetAnalyzerMetrics() const {
+  json r = json::array();
+
+  for (const auto &run : stage_metrics_->GetRuns()) {
+    json s;
+    s["stage"] = run.stage;
+    s["start"] = GetSeconds(run.start);
+    s["wall_seconds"] = run.wall_seconds;
+    s["statements"] = run.statements;
+    s["rows_read"] = run.rows_read;
+    s["rows_written"] = run.rows_written;
+    s["peak_memory_kb"] = run.peak_memory_kb;
+    s["failed"] = run.failed;
+    r.push_back(s);
+  }
+
+  json j;
+  j["status"] = "ok";
+  j["result"] = r;
+  return j.dump();
+}
+
+}
+
+}
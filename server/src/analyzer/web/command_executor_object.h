@@ -0,0 +1,50 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "src/analyzer/detail/analyzer_interface.h"
+#include "src/analyzer/stage_metrics.h"
+#include "src/web/type/command_executor_object_interface.h"
+
+namespace analyzer
+{
+
+namespace web
+{
+
+class CommandExecutorObject;
+typedef std::shared_ptr<CommandExecutorObject> CommandExecutorObjectPtr;
+
+class CommandExecutorObject : public ::web::type::CommandExecutorObjectInterface {
+ public:
+  virtual ~CommandExecutorObject() = default;
+
+  static CommandExecutorObjectPtr Create(::analyzer::detail::AnalyzerInterfacePtr analyzer,
+                                         ::analyzer::StageMetricsPtr stage_metrics);
+
+  const ::web::type::JsonMessage Execute(const ::web::type::JsonMessage &message);
+
+  bool IsCommandSupported(const ::web::type::Command &command);
+
+ private:
+  CommandExecutorObject(::analyzer::detail::AnalyzerInterfacePtr analyzer,
+                        ::analyzer::StageMetricsPtr stage_metrics);
+
+  const ::web::type::JsonMessage StartAnalyzing();
+  const ::web::type::JsonMessage StartAnalyzing(const std::string &name);
+  const ::web::type::JsonMessage GetAnalyzerSchedule() const;
+  const ::web::type::JsonMessage GetAnalyzerMetrics() const;
+
+  ::analyzer::detail::AnalyzerInterfacePtr analyzer_;
+  ::analyzer::StageMetricsPtr stage_metrics_;
+};
+
+}
+
+}
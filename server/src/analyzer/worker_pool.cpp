@@ -0,0 +1,218 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <boost/log/trivial.hpp>
+
+namespace analyzer
+{
+
+namespace
+{
+
+// queue owned by the current thread, set only on pool threads
+thread_local const void *current_pool = nullptr;
+thread_local unsigned current_queue_index = 0;
+
+}
+
+struct WorkerPool::Batch {
+  Batch() :
+  remaining(0) {
+  }
+
+  std::atomic<std::size_t> remaining;
+  std::exception_ptr exception;
+};
+
+WorkerPool::~WorkerPool() {
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::WorkerPool::~WorkerPool: Function call";
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  queue_condition_.notify_all();
+
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+WorkerPoolPtr WorkerPool::Create() {
+  unsigned threads_count = std::thread::hardware_concurrency();
+  if (threads_count == 0)
+    threads_count = 1;
+
+  return Create(threads_count);
+}
+
+WorkerPoolPtr WorkerPool::Create(unsigned threads_count) {
+  BOOST_LOG_TRIVIAL(debug) << "analyzer::WorkerPool::Create: Function call";
+
+  return WorkerPoolPtr(new WorkerPool(std::max(threads_count, 1u)));
+}
+
+unsigned WorkerPool::GetThreadsCount() const {
+  return threads_.size();
+}
+
+void WorkerPool::Run(Tasks tasks) {
+  if (tasks.empty())
+    return;
+
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = tasks.size();
+
+  // tasks started from a pool thread stay in its queue, others are spread
+  // over all queues
+  const unsigned own_queue_index = GetQueueIndex();
+  const auto counters = ::database::StatementCountersScope::GetCurrent();
+
+  // counted before they are visible, so a thread which takes a task
+  // never decrements the counter below zero
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_tasks_count_ += tasks.size();
+  }
+
+  for (auto &task : tasks) {
+    const unsigned queue_index = (own_queue_index < queues_.size()) ? own_queue_index : next_queue_index_++ % queues_.size();
+    Queue &queue = *queues_[queue_index];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(QueuedTask{std::move(task), batch, counters});
+  }
+
+  queue_condition_.notify_all();
+  done_condition_.notify_all();
+
+  while (batch->remaining > 0) {
+    if (!RunOneQueuedTask()) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_condition_.wait(lock, [this, &batch]() {
+        return batch->remaining == 0 || queued_tasks_count_ > 0;
+      });
+    }
+  }
+
+  if (batch->exception)
+    std::rethrow_exception(batch->exception);
+}
+
+void WorkerPool::RunPartially(long long count,
+                              std::function<void(long long, long long)> f) {
+  if (count <= 0)
+    return;
+
+  const long long parts_count = std::min<long long>(count, GetThreadsCount() * 4);
+  const long long part_size = (count + parts_count - 1) / parts_count;
+
+  Tasks tasks;
+  for (long long begin = 0; begin < count; begin += part_size) {
+    const long long end = std::min(count, begin + part_size);
+    tasks.push_back([&f, begin, end]() {
+      f(begin, end);
+    });
+  }
+
+  Run(std::move(tasks));
+}
+
+WorkerPool::WorkerPool(unsigned threads_count) :
+queued_tasks_count_(0),
+next_queue_index_(0),
+is_stopping_(false) {
+  for (unsigned i = 0; i < threads_count; ++i)
+    queues_.push_back(std::unique_ptr<Queue>(new Queue()));
+
+  for (unsigned i = 0; i < threads_count; ++i)
+    threads_.push_back(std::thread(&WorkerPool::WorkerLoop, this, i));
+}
+
+void WorkerPool::WorkerLoop(unsigned queue_index) {
+  current_pool = this;
+  current_queue_index = queue_index;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_condition_.wait(lock, [this]() {
+        return is_stopping_ || queued_tasks_count_ > 0;
+      });
+
+      if (is_stopping_ && queued_tasks_count_ <= 0)
+        return;
+    }
+
+    RunOneQueuedTask();
+  }
+}
+
+bool WorkerPool::RunOneQueuedTask() {
+  const unsigned queue_index = GetQueueIndex();
+
+  QueuedTask queued_task;
+  if (!PopTask(queue_index, queued_task) && !StealTask(queue_index, queued_task))
+    return false;
+
+  --queued_tasks_count_;
+
+  try {
+    ::database::StatementCountersScope scope(queued_task.counters);
+    queued_task.task();
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!queued_task.batch->exception)
+      queued_task.batch->exception = std::current_exception();
+  }
+
+  if (--queued_task.batch->remaining == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_condition_.notify_all();
+  }
+
+  return true;
+}
+
+bool WorkerPool::PopTask(unsigned queue_index, QueuedTask &queued_task) {
+  if (queue_index >= queues_.size())
+    return false;
+
+  Queue &queue = *queues_[queue_index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+
+  if (queue.tasks.empty())
+    return false;
+
+  queued_task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool WorkerPool::StealTask(unsigned queue_index, QueuedTask &queued_task) {
+  for (std::size_t i = 1; i <= queues_.size(); ++i) {
+    Queue &queue = *queues_[(queue_index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+      continue;
+
+    queued_task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+
+  return false;
+}
+
+unsigned WorkerPool::GetQueueIndex() const {
+  return (current_pool == this) ? current_queue_index : queues_.size();
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/database/statement_counters.h"
+
+namespace analyzer
+{
+
+class WorkerPool;
+typedef std::shared_ptr<WorkerPool> WorkerPoolPtr;
+
+// Every thread owns a queue of tasks. Threads take their own tasks from
+// the back and, when the queue is empty, steal the oldest tasks of other
+// threads, so long tasks don't hold short ones queued behind them.
+class WorkerPool {
+ public:
+  typedef std::function<void()> Task;
+  typedef std::vector<Task> Tasks;
+
+  ~WorkerPool();
+
+  static WorkerPoolPtr Create();
+  static WorkerPoolPtr Create(unsigned threads_count);
+
+  unsigned GetThreadsCount() const;
+
+  // Runs all tasks and blocks until they are finished. The calling thread
+  // executes queued tasks too, so Run may be called from inside a task.
+  // First exception thrown by a task is rethrown here. SQL statements of
+  // the tasks are counted in the statement counters of the caller.
+  void Run(Tasks tasks);
+
+  // Splits [0, count) into parts (one or more per thread) and runs f on them.
+  void RunPartially(long long count,
+                    std::function<void(long long /* begin */, long long /* end */)> f);
+
+ private:
+  struct Batch;
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  struct QueuedTask {
+    Task task;
+    BatchPtr batch;
+    ::database::StatementCounters *counters;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<QueuedTask> tasks;
+  };
+
+  explicit WorkerPool(unsigned threads_count);
+
+  void WorkerLoop(unsigned queue_index);
+  bool RunOneQueuedTask();
+
+  bool PopTask(unsigned queue_index, QueuedTask &queued_task);
+  bool StealTask(unsigned queue_index, QueuedTask &queued_task);
+  unsigned GetQueueIndex() const;
+
+  // one queue for every pool thread, tasks from outside of the pool
+  // are spread over all queues
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<long long> queued_tasks_count_;
+  std::atomic<unsigned> next_queue_index_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_condition_;
+  std::condition_variable done_condition_;
+  bool is_stopping_;
+};
+
+}
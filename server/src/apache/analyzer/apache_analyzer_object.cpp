@@ -9,7 +9,6 @@
 
 #include <slas/util/distance.h>
 #include "detail/session_length.h"
-#include "detail/prepare_statistics_analyzer_object.h"
 #include "detail/knn_analyzer_object.h"
 #include "src/apache/notifier/type/apache_notifier_message.h"
 
@@ -19,37 +18,60 @@ namespace apache
 namespace analyzer
 {
 
+const std::string ApacheAnalyzerObject::NAME = "apache";
+constexpr unsigned long long ApacheAnalyzerObject::DATA_THRESHOLD;
+
 ApacheAnalyzerObjectPtr ApacheAnalyzerObject::Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                                      ::apache::database::DatabaseFunctionsPtr database_functions,
-                                                     ::notifier::detail::NotifierInterfacePtr notifier) {
+                                                     ::notifier::detail::NotifierInterfacePtr notifier,
+                                                     ::apache::database::ReadConnectionPoolPtr read_connections,
+                                                     ::analyzer::WorkerPoolPtr worker_pool,
+                                                     StreamingSessionizerPtr sessionizer,
+                                                     const std::string &knn_index_file_prefix,
+                                                     ::analyzer::StageMetricsPtr stage_metrics) {
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::ApacheAnalyzerObject::Create: Function call";
   auto system_interface = detail::System::Create();
 
-  return Create(general_database_functions, database_functions, notifier, system_interface);
+  return Create(general_database_functions, database_functions, notifier, read_connections, worker_pool, sessionizer, knn_index_file_prefix, stage_metrics, system_interface);
 }
 
 ApacheAnalyzerObjectPtr ApacheAnalyzerObject::Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                                      ::apache::database::DatabaseFunctionsPtr database_functions,
                                                      ::notifier::detail::NotifierInterfacePtr notifier,
+                                                     ::apache::database::ReadConnectionPoolPtr read_connections,
+                                                     ::analyzer::WorkerPoolPtr worker_pool,
+                                                     StreamingSessionizerPtr sessionizer,
+                                                     const std::string &knn_index_file_prefix,
+                                                     ::analyzer::StageMetricsPtr stage_metrics,
                                                      detail::SystemInterfacePtr system_interface) {
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::ApacheAnalyzerObject::Create: Function call";
 
-  return ApacheAnalyzerObjectPtr(new ApacheAnalyzerObject(general_database_functions, database_functions, notifier, system_interface));
+  return ApacheAnalyzerObjectPtr(new ApacheAnalyzerObject(general_database_functions, database_functions, notifier, read_connections, worker_pool, sessionizer, knn_index_file_prefix, stage_metrics, system_interface));
 }
 
 void ApacheAnalyzerObject::Analyze() {
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::ApacheAnalyzerObject::Analyze: Function call";
 
-  auto statistics = detail::PrepareStatisticsAnalyzerObject::Create(database_functions_);
+  // sessions are closed and saved every minute by SessionizerAnalyzerObject,
+  // sessions closed since then are saved before KNN
+  sessionizer_->Flush();
+
   auto knn_analyzer = detail::KnnAnalyzerObject::Create(general_database_functions_,
-                                                        database_functions_);
+                                                        database_functions_,
+                                                        database_writer_,
+                                                        read_connections_,
+                                                        worker_pool_,
+                                                        knn_classifiers_,
+                                                        knn_index_file_prefix_);
 
   auto now = GetCurrentTimestamp();
 
   if (ShouldRun(now)) {
     BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::ApacheAnalyzerObject::Analyze: ShouldRun: true";
-    statistics->Prepare(now);
-    knn_analyzer->Analyze();
+    {
+      ::analyzer::StageRecorder recorder(stage_metrics_, "apache.knn");
+      knn_analyzer->Analyze();
+    }
 
     if (knn_analyzer->IsAnomalyDetected()) {
       auto summary = knn_analyzer->GetAnalyzeSummary();
@@ -67,13 +89,31 @@ void ApacheAnalyzerObject::Analyze() {
   }
 }
 
+// data arriving earlier only flushes sessions, ShouldRun still limits KNN
+// to one run per session length, also across restarts
+::analyzer::type::Schedule ApacheAnalyzerObject::GetSchedule() const {
+  return {NAME, std::chrono::seconds(detail::SESSION_LENGTH), DATA_THRESHOLD, {}};
+}
+
 ApacheAnalyzerObject::ApacheAnalyzerObject(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                            ::apache::database::DatabaseFunctionsPtr database_functions,
                                            ::notifier::detail::NotifierInterfacePtr notifier,
+                                           ::apache::database::ReadConnectionPoolPtr read_connections,
+                                           ::analyzer::WorkerPoolPtr worker_pool,
+                                           StreamingSessionizerPtr sessionizer,
+                                           const std::string &knn_index_file_prefix,
+                                           ::analyzer::StageMetricsPtr stage_metrics,
                                            detail::SystemInterfacePtr system_interface) :
 general_database_functions_(general_database_functions),
 database_functions_(database_functions),
 notifier_(notifier),
+read_connections_(read_connections),
+sessionizer_(sessionizer),
+knn_index_file_prefix_(knn_index_file_prefix),
+database_writer_(detail::DatabaseWriter::Create(database_functions)),
+worker_pool_(worker_pool),
+knn_classifiers_(detail::KnnClassifierCache::Create()),
+stage_metrics_(stage_metrics),
 system_interface_(system_interface) {
 }
 
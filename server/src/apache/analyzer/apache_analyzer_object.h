@@ -8,10 +8,17 @@
 #include "src/analyzer/analyzer_object_interface.h"
 
 #include <memory>
+#include <string>
 
 #include <slas/type/timestamp.h>
 #include "src/database/detail/general_database_functions_interface.h"
+#include "src/analyzer/stage_metrics.h"
+#include "src/analyzer/worker_pool.h"
 #include "src/apache/database/database_functions.h"
+#include "src/apache/database/read_connection_pool.h"
+#include "streaming_sessionizer.h"
+#include "detail/database_writer.h"
+#include "detail/knn_classifier_cache.h"
 #include "detail/system.h"
 #include "src/notifier/detail/notifier_interface.h"
 
@@ -30,24 +37,51 @@ class ApacheAnalyzerObject : public ::analyzer::AnalyzerObjectInterface {
 
   static ApacheAnalyzerObjectPtr Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                         ::apache::database::DatabaseFunctionsPtr database_functions,
-                                        ::notifier::detail::NotifierInterfacePtr notifier);
+                                        ::notifier::detail::NotifierInterfacePtr notifier,
+                                        ::apache::database::ReadConnectionPoolPtr read_connections,
+                                        ::analyzer::WorkerPoolPtr worker_pool,
+                                        StreamingSessionizerPtr sessionizer,
+                                        const std::string &knn_index_file_prefix,
+                                        ::analyzer::StageMetricsPtr stage_metrics);
 
   static ApacheAnalyzerObjectPtr Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                         ::apache::database::DatabaseFunctionsPtr database_functions,
                                         ::notifier::detail::NotifierInterfacePtr notifier,
+                                        ::apache::database::ReadConnectionPoolPtr read_connections,
+                                        ::analyzer::WorkerPoolPtr worker_pool,
+                                        StreamingSessionizerPtr sessionizer,
+                                        const std::string &knn_index_file_prefix,
+                                        ::analyzer::StageMetricsPtr stage_metrics,
                                         detail::SystemInterfacePtr system_interface);
 
   void Analyze() override;
 
+  ::analyzer::type::Schedule GetSchedule() const override;
+
+  static const std::string NAME;
+  static constexpr unsigned long long DATA_THRESHOLD = 100000;
+
  private:
   ApacheAnalyzerObject(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                        ::apache::database::DatabaseFunctionsPtr database_functions,
                        ::notifier::detail::NotifierInterfacePtr notifier,
+                       ::apache::database::ReadConnectionPoolPtr read_connections,
+                       ::analyzer::WorkerPoolPtr worker_pool,
+                       StreamingSessionizerPtr sessionizer,
+                       const std::string &knn_index_file_prefix,
+                       ::analyzer::StageMetricsPtr stage_metrics,
                        detail::SystemInterfacePtr system_interface);
 
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
   ::apache::database::DatabaseFunctionsPtr database_functions_;
   ::notifier::detail::NotifierInterfacePtr notifier_;
+  ::apache::database::ReadConnectionPoolPtr read_connections_;
+  StreamingSessionizerPtr sessionizer_;
+  const std::string knn_index_file_prefix_;
+  detail::DatabaseWriterPtr database_writer_;
+  ::analyzer::WorkerPoolPtr worker_pool_;
+  detail::KnnClassifierCachePtr knn_classifiers_;
+  ::analyzer::StageMetricsPtr stage_metrics_;
   detail::SystemInterfacePtr system_interface_;
 
   bool ShouldRun(const ::type::Timestamp &now);
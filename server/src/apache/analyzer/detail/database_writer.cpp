@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "database_writer.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+DatabaseWriterPtr DatabaseWriter::Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::DatabaseWriter::Create: Function call";
+
+  return DatabaseWriterPtr(new DatabaseWriter(database_functions));
+}
+
+void DatabaseWriter::UpdateSessionStatisticsClassification(const ::database::type::RowIds &ids,
+                                                           const ::database::type::Classification &classification) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  database_functions_->UpdateSessionStatisticsClassification(ids, classification);
+}
+
+void DatabaseWriter::SetFeatureNormalization(const ::database::type::RowId &agent_name_id,
+                                             const ::database::type::RowId &virtualhost_name_id,
+                                             const ::apache::type::FeatureNormalization &normalization) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  database_functions_->SetFeatureNormalization(agent_name_id, virtualhost_name_id, normalization);
+}
+
+DatabaseWriter::DatabaseWriter(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) :
+database_functions_(database_functions) {
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "src/apache/database/detail/database_functions_interface.h"
+#include "src/apache/type/feature_normalization.h"
+#include "src/database/type/classification.h"
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+class DatabaseWriter;
+typedef std::shared_ptr<DatabaseWriter> DatabaseWriterPtr;
+
+// Changes made by analyzer tasks running in parallel go through the main
+// connection one at a time, tasks read through their own connections.
+class DatabaseWriter {
+ public:
+  virtual ~DatabaseWriter() = default;
+
+  static DatabaseWriterPtr Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  void UpdateSessionStatisticsClassification(const ::database::type::RowIds &ids,
+                                             const ::database::type::Classification &classification);
+  void SetFeatureNormalization(const ::database::type::RowId &agent_name_id,
+                               const ::database::type::RowId &virtualhost_name_id,
+                               const ::apache::type::FeatureNormalization &normalization);
+
+ private:
+  explicit DatabaseWriter(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  ::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
+  std::mutex mutex_;
+};
+
+}
+
+}
+
+}
@@ -5,9 +5,8 @@
 
 #include "knn_analyzer_object.h"
 
+#include <map>
 #include <boost/log/trivial.hpp>
-#include <cmath>
-#include <limits>
 #include <slas/util/run_partially.h>
 
 #include "system.h"
@@ -27,11 +26,21 @@ namespace detail
 {
 
 KnnAnalyzerObjectPtr KnnAnalyzerObject::Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                               ::apache::database::DatabaseFunctionsPtr apache_database_functions) {
-  return KnnAnalyzerObjectPtr(new KnnAnalyzerObject(general_database_functions, apache_database_functions));
+                                               ::apache::database::DatabaseFunctionsPtr apache_database_functions,
+                                               DatabaseWriterPtr database_writer,
+                                               ::apache::database::ReadConnectionPoolPtr read_connections,
+                                               ::analyzer::WorkerPoolPtr worker_pool,
+                                               KnnClassifierCachePtr classifiers,
+                                               const std::string &index_file_prefix) {
+  return KnnAnalyzerObjectPtr(new KnnAnalyzerObject(general_database_functions, apache_database_functions,
+                                                    database_writer, read_connections, worker_pool,
+                                                    classifiers, index_file_prefix));
 }
 
 void KnnAnalyzerObject::Analyze() {
+  ::apache::analyzer::type::KnnAnalyzerSummary summary;
+  ::analyzer::WorkerPool::Tasks tasks;
+
   for (auto agent_name : general_database_functions_->GetAgentNames()) {
     BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::Analyze: Preparing agent: " << agent_name;
 
@@ -43,9 +52,27 @@ void KnnAnalyzerObject::Analyze() {
       BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::Analyze: Agent ID: " << agent_id;
       BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::Analyze: Virtualhost ID " << virtualhost_id;
 
-      AnalyzeVirtualhost(agent_id, virtualhost_id);
+      auto configuration = apache_database_functions_->GetKnnConfiguration(agent_name, virtualhost_name);
+
+      // every task writes only its own element, the summary isn't resized
+      // until all tasks are finished
+      const auto index = summary.size();
+      summary.push_back(type::KnnVirtualhostAnalyzeStatistics());
+
+      tasks.push_back([this, &summary, index, agent_id, virtualhost_id, configuration]() {
+        summary[index] = AnalyzeVirtualhost(agent_id, virtualhost_id, configuration);
+      });
     }
   }
+
+  worker_pool_->Run(tasks);
+
+  for (const auto &stats : summary) {
+    if (!stats.anomaly_sessions_ids.empty())
+      is_anomaly_detected_ = true;
+
+    analyze_summary_.push_back(stats);
+  }
 }
 
 bool KnnAnalyzerObject::IsAnomalyDetected() const {
@@ -56,108 +83,225 @@ bool KnnAnalyzerObject::IsAnomalyDetected() const {
   return analyze_summary_;
 }
 
-void KnnAnalyzerObject::AnalyzeVirtualhost(const ::database::type::RowId &agent_name_id,
-                                           const ::database::type::RowId &virtualhost_name_id) {
+type::KnnVirtualhostAnalyzeStatistics KnnAnalyzerObject::AnalyzeVirtualhost(const ::database::type::RowId &agent_name_id,
+                                                                             const ::database::type::RowId &virtualhost_name_id,
+                                                                             const ::apache::type::KnnConfiguration &configuration) {
+  auto database_functions = read_connections_->Acquire();
+  type::KnnVirtualhostAnalyzeStatistics stats;
+
+  try {
+    stats = AnalyzeVirtualhost(database_functions, agent_name_id, virtualhost_name_id, configuration);
+  }
+  catch (...) {
+    read_connections_->Release(database_functions);
+    throw;
+  }
+
+  read_connections_->Release(database_functions);
+  return stats;
+}
+
+type::KnnVirtualhostAnalyzeStatistics KnnAnalyzerObject::AnalyzeVirtualhost(DatabaseFunctionsInterfacePtr database_functions,
+                                                                             const ::database::type::RowId &agent_name_id,
+                                                                             const ::database::type::RowId &virtualhost_name_id,
+                                                                             const ::apache::type::KnnConfiguration &configuration) {
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeVirtualhost: Function call";
   constexpr RowsCount MAX_ROWS_IN_MEMORY = 100;
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Max rows in memory: " << MAX_ROWS_IN_MEMORY;
 
-  auto sessions_count = apache_database_functions_->GetNotClassifiedSessionsStatisticsCount(agent_name_id, virtualhost_name_id);
+  auto sessions_count = database_functions->GetNotClassifiedSessionsStatisticsCount(agent_name_id, virtualhost_name_id);
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeVirtualhost: Found " << sessions_count << " sessions to analyze";
 
-  analyze_summary_.push_back(type::KnnVirtualhostAnalyzeStatistics());
+  type::KnnVirtualhostAnalyzeStatistics stats;
+  stats.agent_id = agent_name_id;
+  stats.virtualhost_id = virtualhost_name_id;
+
+  prepare_statistics::KnnClassifierPtr classifier;
+  if (sessions_count > 0)
+    classifier = GetClassifier(database_functions, agent_name_id, virtualhost_name_id, configuration);
 
   util::RunPartially(MAX_ROWS_IN_MEMORY, sessions_count, [&](long long part_count, long long offset) {
-    AnalyzeSessions(agent_name_id, virtualhost_name_id, part_count, 0);
+    AnalyzeSessions(database_functions, classifier, agent_name_id, virtualhost_name_id, part_count, 0, stats);
   });
+
+  return stats;
 }
 
-void KnnAnalyzerObject::AnalyzeSessions(const ::database::type::RowId &agent_name_id,
-                                        const ::database::type::RowId &virtualhost_name_id,
-                                        unsigned limit,
-                                        ::database::type::RowsCount offset) {
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Function call";
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Analyzing sessions: agent_name_id=" << agent_name_id << "; virtualhost_name_id=" << virtualhost_name_id << " (limit=" << limit << "; offset=" << offset << ")";
-  constexpr RowsCount MAX_ROWS_IN_MEMORY = 100;
+prepare_statistics::KnnClassifierPtr KnnAnalyzerObject::GetClassifier(DatabaseFunctionsInterfacePtr database_functions,
+                                                                      const ::database::type::RowId &agent_name_id,
+                                                                      const ::database::type::RowId &virtualhost_name_id,
+                                                                      const ::apache::type::KnnConfiguration &configuration) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::GetClassifier: Function call";
 
-  auto sessions_part = apache_database_functions_->GetNotClassifiedSessionStatistics(agent_name_id, virtualhost_name_id, limit, 0);
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Received " << sessions_part.size() << " sessions statictics";
+  const auto version = database_functions->GetLearningSetVersion(agent_name_id, virtualhost_name_id);
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::GetClassifier: Learning set version: " << version;
 
-  type::KnnVirtualhostAnalyzeStatistics &stats = analyze_summary_.at(analyze_summary_.size() - 1);
-  stats.agent_id = agent_name_id;
-  stats.virtualhost_id = virtualhost_name_id;
+  auto classifier = classifiers_->Get(agent_name_id, virtualhost_name_id, version, configuration);
+  if (classifier) {
+    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::GetClassifier: Classifier reused from the previous run";
+  }
+  else {
+    classifier = prepare_statistics::KnnClassifier::Create(worker_pool_);
+    LoadLearningSet(database_functions, classifier, agent_name_id, virtualhost_name_id, version, configuration);
+    classifiers_->Put(agent_name_id, virtualhost_name_id, version, configuration, classifier);
+  }
 
-  auto learning_set_count = apache_database_functions_->GetLearningSessionsCount(agent_name_id, virtualhost_name_id);
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Found " << learning_set_count << " sessions in learning set";
+  classifier->SetNeighboursCount(configuration.neighbours_count);
+  classifier->SetVoting(configuration.voting);
 
-  for (auto session : sessions_part) {
-    neighbours_table_.SetSession(session);
+  return classifier;
+}
 
-    util::RunPartially(MAX_ROWS_IN_MEMORY, learning_set_count, [&](long long part_count, long long offset) {
-      AnalyzeSessionsWithLearningSet(agent_name_id, virtualhost_name_id, part_count, 0, session);
-    });
+void KnnAnalyzerObject::LoadLearningSet(DatabaseFunctionsInterfacePtr database_functions,
+                                        prepare_statistics::KnnClassifierPtr classifier,
+                                        const ::database::type::RowId &agent_name_id,
+                                        const ::database::type::RowId &virtualhost_name_id,
+                                        const ::database::type::RowId &learning_set_version,
+                                        const ::apache::type::KnnConfiguration &configuration) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSet: Function call";
 
-    auto classification = GetSessionClassification();
+  // normalization computed for an older learning set is replaced with
+  // statistics gathered while the learning set is loaded
+  const auto normalization = database_functions->GetFeatureNormalization(agent_name_id, virtualhost_name_id);
+  const bool is_normalization_current = normalization.learning_set_version == learning_set_version;
 
-    if (classification == ::database::type::Classification::ANOMALY) {
-      is_anomaly_detected_ = true;
-      stats.anomaly_sessions_ids.push_back(session.id);
+  classifier->SetLearningSet({});
+  classifier->SetNormalization(is_normalization_current ? normalization : prepare_statistics::GetIdentityNormalization());
+
+  if (configuration.mode == KnnMode::APPROXIMATE) {
+    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSet: Approximate mode: m=" << configuration.hnsw_m << "; ef=" << configuration.hnsw_ef;
+
+    // graph is extended with every part read from database, without a
+    // current normalization it's built once, after the normalization is known
+    if (is_normalization_current)
+      classifier->EnableApproximateSearch(configuration.hnsw_m, configuration.hnsw_ef);
+
+    auto statistics = LoadLearningSetFromDatabase(database_functions, classifier, agent_name_id, virtualhost_name_id);
+
+    if (!is_normalization_current) {
+      UpdateNormalization(classifier, agent_name_id, virtualhost_name_id, learning_set_version, statistics);
+      classifier->EnableApproximateSearch(configuration.hnsw_m, configuration.hnsw_ef);
     }
+    return;
+  }
 
-    session.classification = classification;
-    apache_database_functions_->UpdateSessionStatisticClassification(session.id, session.classification);
+  classifier->DisableApproximateSearch();
 
-    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Is session with id " << session.id << " anomaly? - " << (session.classification == ::database::type::Classification::ANOMALY);
+  const auto index_file_path = GetIndexFilePath(agent_name_id, virtualhost_name_id);
+
+  if (is_normalization_current && !index_file_path.empty() && classifier->LoadIndex(index_file_path, learning_set_version)) {
+    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSet: Learning set loaded from index file " << index_file_path;
+    return;
   }
+
+  auto statistics = LoadLearningSetFromDatabase(database_functions, classifier, agent_name_id, virtualhost_name_id);
+
+  if (!is_normalization_current)
+    UpdateNormalization(classifier, agent_name_id, virtualhost_name_id, learning_set_version, statistics);
+
+  classifier->BuildIndex();
+
+  if (!index_file_path.empty())
+    classifier->SaveIndex(index_file_path, learning_set_version);
 }
 
-void KnnAnalyzerObject::AnalyzeSessionsWithLearningSet(const ::database::type::RowId &agent_name_id,
-                                                       const ::database::type::RowId &virtualhost_name_id,
-                                                       unsigned limit,
-                                                       ::database::type::RowsCount offset,
-                                                       const ::apache::type::ApacheSessionEntry &session_to_analyze) {
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessionsWithLearningSet: Function call";
-  auto learning_set_ids = apache_database_functions_->GetLearningSessionsIds(agent_name_id, virtualhost_name_id, limit, offset);
+prepare_statistics::FeatureStatistics KnnAnalyzerObject::LoadLearningSetFromDatabase(DatabaseFunctionsInterfacePtr database_functions,
+                                                                                     prepare_statistics::KnnClassifierPtr classifier,
+                                                                                     const ::database::type::RowId &agent_name_id,
+                                                                                     const ::database::type::RowId &virtualhost_name_id) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSetFromDatabase: Function call";
+  constexpr RowsCount MAX_LEARNING_SET_ROWS_IN_PART = 10000;
 
-  for (const auto &session_id : learning_set_ids) {
-    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessionsWithLearningSet: Comparing session to analyze with id=" << session_to_analyze.id << " to session from learning set " << session_id;
+  auto learning_set_count = database_functions->GetLearningSessionsCount(agent_name_id, virtualhost_name_id);
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSetFromDatabase: Found " << learning_set_count << " sessions in learning set";
 
-    const auto &learning_set_session = apache_database_functions_->GetOneSessionStatistic(session_id);
+  prepare_statistics::FeatureStatistics statistics;
 
-    if (learning_set_session.classification != ::database::type::Classification::UNKNOWN)
-      neighbours_table_.Add(learning_set_session);
-    else
-      BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessionsWithLearningSet: Unknown session classification (id=" << learning_set_session.id << "(";
-  }
+  util::RunPartially(MAX_LEARNING_SET_ROWS_IN_PART, learning_set_count, [&](long long part_count, long long offset) {
+    auto sessions = database_functions->GetLearningSessions(agent_name_id, virtualhost_name_id, part_count, offset);
+    classifier->AddToLearningSet(sessions);
+
+    for (const auto &s : sessions) {
+      if (s.classification != ::database::type::Classification::UNKNOWN)
+        statistics.Add(s);
+    }
+  });
+
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::LoadLearningSetFromDatabase: Learning set size: " << classifier->GetLearningSet().Size();
+
+  return statistics;
 }
 
-::database::type::Classification KnnAnalyzerObject::GetSessionClassification() {
-  long long i = 0;
-  const auto &neighbours = neighbours_table_.Get();
+void KnnAnalyzerObject::UpdateNormalization(prepare_statistics::KnnClassifierPtr classifier,
+                                            const ::database::type::RowId &agent_name_id,
+                                            const ::database::type::RowId &virtualhost_name_id,
+                                            const ::database::type::RowId &learning_set_version,
+                                            const prepare_statistics::FeatureStatistics &statistics) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::UpdateNormalization: Function call";
+
+  auto normalization = statistics.GetNormalization();
+  normalization.learning_set_version = learning_set_version;
 
-  for (const auto &n : neighbours)
-    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::IsSessionAnomaly: Final nearest neighbour id=" << n.session_id;
+  classifier->SetNormalization(normalization);
+  database_writer_->SetFeatureNormalization(agent_name_id, virtualhost_name_id, normalization);
+}
 
-  for (const auto &n : neighbours)
-    i = i - 1 + 2 * static_cast<int> (n.classification == ::database::type::Classification::ANOMALY);
+std::string KnnAnalyzerObject::GetIndexFilePath(const ::database::type::RowId &agent_name_id,
+                                                const ::database::type::RowId &virtualhost_name_id) const {
+  if (index_file_prefix_.empty())
+    return "";
 
-  ::database::type::Classification c = ::database::type::Classification::UNKNOWN;
-  if (neighbours.size() > 0) {
-    if (i > 0)
-      c = ::database::type::Classification::ANOMALY;
-    else
-      c = ::database::type::Classification::NORMAL;
-  }
+  return index_file_prefix_ + "-knn-" + std::to_string(agent_name_id) + "-" + std::to_string(virtualhost_name_id) + ".index";
+}
+
+void KnnAnalyzerObject::AnalyzeSessions(DatabaseFunctionsInterfacePtr database_functions,
+                                        prepare_statistics::KnnClassifierPtr classifier,
+                                        const ::database::type::RowId &agent_name_id,
+                                        const ::database::type::RowId &virtualhost_name_id,
+                                        unsigned limit,
+                                        ::database::type::RowsCount offset,
+                                        type::KnnVirtualhostAnalyzeStatistics &stats) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Function call";
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Analyzing sessions: agent_name_id=" << agent_name_id << "; virtualhost_name_id=" << virtualhost_name_id << " (limit=" << limit << "; offset=" << offset << ")";
+
+  auto sessions_part = database_functions->GetNotClassifiedSessionStatistics(agent_name_id, virtualhost_name_id, limit, 0);
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Received " << sessions_part.size() << " sessions statictics";
+
+  auto classifications = classifier->Classify(sessions_part);
+  std::map< ::database::type::Classification, ::database::type::RowIds> classified_ids;
 
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::IsSessionAnomaly: Classification: " << static_cast<int> (c);
+  for (std::size_t i = 0; i < sessions_part.size(); ++i) {
+    auto &session = sessions_part[i];
+    auto classification = classifications[i];
+
+    if (classification == ::database::type::Classification::ANOMALY) {
+      stats.anomaly_sessions_ids.push_back(session.id);
+    }
+
+    session.classification = classification;
+    classified_ids[classification].push_back(session.id);
+
+    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnAnalyzerObject::AnalyzeSessions: Is session with id " << session.id << " anomaly? - " << (session.classification == ::database::type::Classification::ANOMALY);
+  }
 
-  return c;
+  for (const auto &ids : classified_ids)
+    database_writer_->UpdateSessionStatisticsClassification(ids.second, ids.first);
 }
 
 KnnAnalyzerObject::KnnAnalyzerObject(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                     ::apache::database::DatabaseFunctionsPtr apache_database_functions) :
+                                     ::apache::database::DatabaseFunctionsPtr apache_database_functions,
+                                     DatabaseWriterPtr database_writer,
+                                     ::apache::database::ReadConnectionPoolPtr read_connections,
+                                     ::analyzer::WorkerPoolPtr worker_pool,
+                                     KnnClassifierCachePtr classifiers,
+                                     const std::string &index_file_prefix) :
 general_database_functions_(general_database_functions),
 apache_database_functions_(apache_database_functions),
+database_writer_(database_writer),
+read_connections_(read_connections),
+worker_pool_(worker_pool),
+classifiers_(classifiers),
+index_file_prefix_(index_file_prefix),
 is_anomaly_detected_(false) {
 }
 
@@ -9,13 +9,19 @@
 
 #include <array>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include <slas/type/timestamp.h>
 
-#include "prepare_statistics/nearest_neighbours_table.h"
+#include "database_writer.h"
+#include "knn_classifier_cache.h"
+#include "prepare_statistics/feature_normalization.h"
+#include "prepare_statistics/knn_classifier.h"
+#include "src/analyzer/worker_pool.h"
 #include "src/database/detail/general_database_functions_interface.h"
 #include "src/apache/database/database_functions.h"
+#include "src/apache/database/read_connection_pool.h"
 #include "src/database/type/agent_name.h"
 #include "src/database/type/virtualhost_name.h"
 
@@ -35,43 +41,87 @@ class KnnAnalyzerObject : public KnnAnalyzerObjectInterface {
  public:
   virtual ~KnnAnalyzerObject() = default;
 
+  // Virtualhosts are analyzed in parallel, every task has its own classifier
+  // and reads sessions through a connection from read_connections.
+  // Classifiers are reused from classifiers while the learning set version
+  // doesn't change. Learning set index is kept in
+  // <index_file_prefix>-knn-<agent id>-<virtualhost id>.index for restarts,
+  // empty prefix disables the index files.
   static KnnAnalyzerObjectPtr Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                     ::apache::database::DatabaseFunctionsPtr apache_database_functions);
+                                     ::apache::database::DatabaseFunctionsPtr apache_database_functions,
+                                     DatabaseWriterPtr database_writer,
+                                     ::apache::database::ReadConnectionPoolPtr read_connections,
+                                     ::analyzer::WorkerPoolPtr worker_pool,
+                                     KnnClassifierCachePtr classifiers,
+                                     const std::string &index_file_prefix);
 
   void Analyze();
 
   bool IsAnomalyDetected() const override;
 
+  // Virtualhosts are in this same order as in a sequential analyze, no matter
+  // which task finished first.
   ::apache::analyzer::type::KnnAnalyzerSummary GetAnalyzeSummary() const override;
 
  private:
-  KnnAnalyzerObject(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                    ::apache::database::DatabaseFunctionsPtr apache_database_functions);
-
-  void AnalyzeVirtualhost(const ::database::type::RowId &agent_name_id,
-                          const ::database::type::RowId &virtualhost_name_id);
+  typedef ::apache::database::detail::DatabaseFunctionsInterfacePtr DatabaseFunctionsInterfacePtr;
 
-  void AnalyzeSessions(const ::database::type::RowId &agent_name_id,
+  KnnAnalyzerObject(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                    ::apache::database::DatabaseFunctionsPtr apache_database_functions,
+                    DatabaseWriterPtr database_writer,
+                    ::apache::database::ReadConnectionPoolPtr read_connections,
+                    ::analyzer::WorkerPoolPtr worker_pool,
+                    KnnClassifierCachePtr classifiers,
+                    const std::string &index_file_prefix);
+
+  type::KnnVirtualhostAnalyzeStatistics AnalyzeVirtualhost(const ::database::type::RowId &agent_name_id,
+                                                           const ::database::type::RowId &virtualhost_name_id,
+                                                           const ::apache::type::KnnConfiguration &configuration);
+  type::KnnVirtualhostAnalyzeStatistics AnalyzeVirtualhost(DatabaseFunctionsInterfacePtr database_functions,
+                                                           const ::database::type::RowId &agent_name_id,
+                                                           const ::database::type::RowId &virtualhost_name_id,
+                                                           const ::apache::type::KnnConfiguration &configuration);
+
+  void AnalyzeSessions(DatabaseFunctionsInterfacePtr database_functions,
+                       prepare_statistics::KnnClassifierPtr classifier,
+                       const ::database::type::RowId &agent_name_id,
                        const ::database::type::RowId &virtualhost_name_id,
                        unsigned limit,
-                       ::database::type::RowsCount offset);
-
-  void AnalyzeSessionsWithLearningSet(const ::database::type::RowId &agent_name_id,
-                                      const ::database::type::RowId &virtualhost_name_id,
-                                      unsigned limit,
-                                      ::database::type::RowsCount offset,
-                                      const ::apache::type::ApacheSessionEntry &session_to_analyze);
-
-  ::database::type::Classification GetSessionClassification();
-  double Distance(const ::apache::type::ApacheSessionEntry &a, const ::apache::type::ApacheSessionEntry &b) const;
+                       ::database::type::RowsCount offset,
+                       type::KnnVirtualhostAnalyzeStatistics &stats);
+
+  prepare_statistics::KnnClassifierPtr GetClassifier(DatabaseFunctionsInterfacePtr database_functions,
+                                                     const ::database::type::RowId &agent_name_id,
+                                                     const ::database::type::RowId &virtualhost_name_id,
+                                                     const ::apache::type::KnnConfiguration &configuration);
+  void LoadLearningSet(DatabaseFunctionsInterfacePtr database_functions,
+                       prepare_statistics::KnnClassifierPtr classifier,
+                       const ::database::type::RowId &agent_name_id,
+                       const ::database::type::RowId &virtualhost_name_id,
+                       const ::database::type::RowId &learning_set_version,
+                       const ::apache::type::KnnConfiguration &configuration);
+  prepare_statistics::FeatureStatistics LoadLearningSetFromDatabase(DatabaseFunctionsInterfacePtr database_functions,
+                                                                    prepare_statistics::KnnClassifierPtr classifier,
+                                                                    const ::database::type::RowId &agent_name_id,
+                                                                    const ::database::type::RowId &virtualhost_name_id);
+  void UpdateNormalization(prepare_statistics::KnnClassifierPtr classifier,
+                           const ::database::type::RowId &agent_name_id,
+                           const ::database::type::RowId &virtualhost_name_id,
+                           const ::database::type::RowId &learning_set_version,
+                           const prepare_statistics::FeatureStatistics &statistics);
+  std::string GetIndexFilePath(const ::database::type::RowId &agent_name_id,
+                               const ::database::type::RowId &virtualhost_name_id) const;
 
   ::type::Timestamp GetCurrentTimestamp() const;
   ::type::Timestamp GetLastAnalyzeTimestamp(const ::type::Timestamp &now) const;
 
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
   ::apache::database::DatabaseFunctionsPtr apache_database_functions_;
-
-  prepare_statistics::NearestNeighboursTable neighbours_table_;
+  DatabaseWriterPtr database_writer_;
+  ::apache::database::ReadConnectionPoolPtr read_connections_;
+  ::analyzer::WorkerPoolPtr worker_pool_;
+  KnnClassifierCachePtr classifiers_;
+  const std::string index_file_prefix_;
 
   bool is_anomaly_detected_;
   ::apache::analyzer::type::KnnAnalyzerSummary analyze_summary_;
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "knn_classifier_cache.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+KnnClassifierCachePtr KnnClassifierCache::Create() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnClassifierCache::Create: Function call";
+
+  return KnnClassifierCachePtr(new KnnClassifierCache());
+}
+
+prepare_statistics::KnnClassifierPtr KnnClassifierCache::Get(const ::database::type::RowId &agent_name_id,
+                                                             const ::database::type::RowId &virtualhost_name_id,
+                                                             const ::database::type::RowId &learning_set_version,
+                                                             const ::apache::type::KnnConfiguration &configuration) const {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnClassifierCache::Get: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = entries_.find(std::make_pair(agent_name_id, virtualhost_name_id));
+  if (it == entries_.end())
+    return nullptr;
+
+  const auto &entry = it->second;
+  if (entry.learning_set_version != learning_set_version || entry.configuration.mode != configuration.mode)
+    return nullptr;
+
+  if (configuration.mode == ::apache::type::KnnMode::APPROXIMATE
+      && (entry.configuration.hnsw_m != configuration.hnsw_m || entry.configuration.hnsw_ef != configuration.hnsw_ef))
+    return nullptr;
+
+  return entry.classifier;
+}
+
+void KnnClassifierCache::Put(const ::database::type::RowId &agent_name_id,
+                             const ::database::type::RowId &virtualhost_name_id,
+                             const ::database::type::RowId &learning_set_version,
+                             const ::apache::type::KnnConfiguration &configuration,
+                             prepare_statistics::KnnClassifierPtr classifier) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::KnnClassifierCache::Put: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  entries_[std::make_pair(agent_name_id, virtualhost_name_id)] = {learning_set_version, configuration, classifier};
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "prepare_statistics/knn_classifier.h"
+#include "src/apache/type/knn_configuration.h"
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+class KnnClassifierCache;
+typedef std::shared_ptr<KnnClassifierCache> KnnClassifierCachePtr;
+
+// Keeps classifiers with their indexes between analyzer runs, so the
+// approximate graph isn't rebuilt while the learning set doesn't change.
+// A new learning set version changes the feature normalization, so
+// distances between all rows change and the classifier is built again.
+class KnnClassifierCache {
+ public:
+  virtual ~KnnClassifierCache() = default;
+
+  static KnnClassifierCachePtr Create();
+
+  // nullptr when the classifier was built for another learning set version,
+  // mode or hnsw parameters
+  prepare_statistics::KnnClassifierPtr Get(const ::database::type::RowId &agent_name_id,
+                                           const ::database::type::RowId &virtualhost_name_id,
+                                           const ::database::type::RowId &learning_set_version,
+                                           const ::apache::type::KnnConfiguration &configuration) const;
+  void Put(const ::database::type::RowId &agent_name_id,
+           const ::database::type::RowId &virtualhost_name_id,
+           const ::database::type::RowId &learning_set_version,
+           const ::apache::type::KnnConfiguration &configuration,
+           prepare_statistics::KnnClassifierPtr classifier);
+
+ private:
+  struct Entry {
+    ::database::type::RowId learning_set_version;
+    ::apache::type::KnnConfiguration configuration;
+    prepare_statistics::KnnClassifierPtr classifier;
+  };
+
+  KnnClassifierCache() = default;
+
+  std::map<std::pair< ::database::type::RowId, ::database::type::RowId>, Entry> entries_;
+  mutable std::mutex mutex_;
+};
+
+}
+
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "distance_kernel.h"
+
+#include <boost/log/trivial.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SLAS_HAVE_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+namespace
+{
+
+typedef void (*SquaredDistancesFunction)(const LearningSet&, const SessionFeatures&, double*);
+
+inline void SquaredDistancesRange(const LearningSet &learning_set,
+                                  const SessionFeatures &session,
+                                  std::size_t begin, std::size_t end,
+                                  double *distances) {
+  const double session_length = session.session_length;
+  const double bandwidth_usage = session.bandwidth_usage;
+  const double requests_count = session.requests_count;
+  const double error_percentage = session.error_percentage;
+
+  for (std::size_t i = begin; i < end; ++i) {
+    const double a = learning_set.session_length[i] - session_length;
+    const double b = learning_set.bandwidth_usage[i] - bandwidth_usage;
+    const double c = learning_set.requests_count[i] - requests_count;
+    const double d = learning_set.error_percentage[i] - error_percentage;
+
+    distances[i] = a * a + b * b + c * c + d * d;
+  }
+}
+
+#ifdef SLAS_HAVE_AVX2_KERNEL
+
+__attribute__((target("avx2")))
+void SquaredDistancesAvx2Impl(const LearningSet &learning_set,
+                              const SessionFeatures &session,
+                              double *distances) {
+  const std::size_t size = learning_set.Size();
+  const std::size_t vectorized_size = size - size % 4;
+
+  const __m256d session_length = _mm256_set1_pd(session.session_length);
+  const __m256d bandwidth_usage = _mm256_set1_pd(session.bandwidth_usage);
+  const __m256d requests_count = _mm256_set1_pd(session.requests_count);
+  const __m256d error_percentage = _mm256_set1_pd(session.error_percentage);
+
+  const double *sl = learning_set.session_length.data();
+  const double *bu = learning_set.bandwidth_usage.data();
+  const double *rc = learning_set.requests_count.data();
+  const double *ep = learning_set.error_percentage.data();
+
+  for (std::size_t i = 0; i < vectorized_size; i += 4) {
+    const __m256d a = _mm256_sub_pd(_mm256_loadu_pd(sl + i), session_length);
+    const __m256d b = _mm256_sub_pd(_mm256_loadu_pd(bu + i), bandwidth_usage);
+    const __m256d c = _mm256_sub_pd(_mm256_loadu_pd(rc + i), requests_count);
+    const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(ep + i), error_percentage);
+
+    __m256d sum = _mm256_mul_pd(a, a);
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(b, b));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(c, c));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(d, d));
+
+    _mm256_storeu_pd(distances + i, sum);
+  }
+
+  SquaredDistancesRange(learning_set, session, vectorized_size, size, distances);
+}
+
+#endif
+
+SquaredDistancesFunction SelectSquaredDistancesFunction() {
+  if (IsAvx2Supported()) {
+    BOOST_LOG_TRIVIAL(info) << "apache::analyzer::detail::prepare_statistics::SelectSquaredDistancesFunction: Using AVX2 distance kernel";
+    return SquaredDistancesAvx2;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "apache::analyzer::detail::prepare_statistics::SelectSquaredDistancesFunction: Using scalar distance kernel";
+  return SquaredDistancesScalar;
+}
+
+}
+
+void SquaredDistances(const LearningSet &learning_set,
+                      const SessionFeatures &session,
+                      double *distances) {
+  static const SquaredDistancesFunction function = SelectSquaredDistancesFunction();
+
+  function(learning_set, session, distances);
+}
+
+void SquaredDistancesScalar(const LearningSet &learning_set,
+                            const SessionFeatures &session,
+                            double *distances) {
+  SquaredDistancesRange(learning_set, session, 0, learning_set.Size(), distances);
+}
+
+void SquaredDistancesAvx2(const LearningSet &learning_set,
+                          const SessionFeatures &session,
+                          double *distances) {
+#ifdef SLAS_HAVE_AVX2_KERNEL
+  SquaredDistancesAvx2Impl(learning_set, session, distances);
+#else
+  SquaredDistancesScalar(learning_set, session, distances);
+#endif
+}
+
+bool IsAvx2Supported() {
+#ifdef SLAS_HAVE_AVX2_KERNEL
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+}
+
+}
+
+}
+
+}
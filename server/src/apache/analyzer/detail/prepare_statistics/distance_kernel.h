@@ -0,0 +1,45 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "learning_set.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+// Computes squared euclidean distances between the session and every row
+// from the learning set, distances must point to learning_set.Size() elements.
+// The implementation (AVX2 or scalar) is selected once, at first call.
+void SquaredDistances(const LearningSet &learning_set,
+                      const SessionFeatures &session,
+                      double *distances);
+
+void SquaredDistancesScalar(const LearningSet &learning_set,
+                            const SessionFeatures &session,
+                            double *distances);
+
+void SquaredDistancesAvx2(const LearningSet &learning_set,
+                          const SessionFeatures &session,
+                          double *distances);
+
+bool IsAvx2Supported();
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "feature_normalization.h"
+
+#include <cmath>
+#include <vector>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+namespace
+{
+
+// x = x * multiplier + addend
+void Transform(std::vector<double> &values, std::size_t begin,
+               double multiplier, double addend) {
+  double *v = values.data();
+  const std::size_t size = values.size();
+
+  for (std::size_t i = begin; i < size; ++i)
+    v[i] = v[i] * multiplier + addend;
+}
+
+void Transform(std::vector<double> &values, std::size_t begin,
+               const ::apache::type::FeatureScale &from,
+               const ::apache::type::FeatureScale &to) {
+  // ((x * from.sd + from.mean) - to.mean) / to.sd
+  Transform(values, begin,
+            from.standard_deviation / to.standard_deviation,
+            (from.mean - to.mean) / to.standard_deviation);
+}
+
+inline double Normalize(double value, const ::apache::type::FeatureScale &scale) {
+  return (value - scale.mean) / scale.standard_deviation;
+}
+
+const ::apache::type::FeatureScale IDENTITY_SCALE = {0., 1.};
+
+}
+
+FeatureStatistics::FeatureStatistics() :
+count_(0),
+session_length_({0., 0.}),
+bandwidth_usage_({0., 0.}),
+requests_count_({0., 0.}),
+error_percentage_({0., 0.}) {
+}
+
+void FeatureStatistics::Add(const ::apache::type::ApacheSessionEntry &session) {
+  ++count_;
+
+  session_length_.Add(session.session_length, count_);
+  bandwidth_usage_.Add(session.bandwidth_usage, count_);
+  requests_count_.Add(session.requests_count, count_);
+  error_percentage_.Add(session.error_percentage, count_);
+}
+
+void FeatureStatistics::Add(const ::apache::type::ApacheSessions &sessions) {
+  for (const auto &s : sessions)
+    Add(s);
+}
+
+std::size_t FeatureStatistics::Count() const {
+  return count_;
+}
+
+::apache::type::FeatureNormalization FeatureStatistics::GetNormalization() const {
+  ::apache::type::FeatureNormalization n;
+  n.learning_set_version = -1;
+  n.session_length = session_length_.GetScale(count_);
+  n.bandwidth_usage = bandwidth_usage_.GetScale(count_);
+  n.requests_count = requests_count_.GetScale(count_);
+  n.error_percentage = error_percentage_.GetScale(count_);
+
+  return n;
+}
+
+void FeatureStatistics::Moments::Add(double value, std::size_t count) {
+  const double delta = value - mean;
+  mean += delta / count;
+  m2 += delta * (value - mean);
+}
+
+::apache::type::FeatureScale FeatureStatistics::Moments::GetScale(std::size_t count) const {
+  ::apache::type::FeatureScale scale;
+  scale.mean = mean;
+  scale.standard_deviation = (count > 0) ? std::sqrt(m2 / count) : 0.;
+
+  if (scale.standard_deviation == 0.)
+    scale.standard_deviation = 1.;
+
+  return scale;
+}
+
+::apache::type::FeatureNormalization GetIdentityNormalization() {
+  ::apache::type::FeatureNormalization n;
+  n.learning_set_version = -1;
+  n.session_length = IDENTITY_SCALE;
+  n.bandwidth_usage = IDENTITY_SCALE;
+  n.requests_count = IDENTITY_SCALE;
+  n.error_percentage = IDENTITY_SCALE;
+
+  return n;
+}
+
+SessionFeatures Normalize(const SessionFeatures &features,
+                          const ::apache::type::FeatureNormalization &normalization) {
+  SessionFeatures f;
+  f.session_length = Normalize(features.session_length, normalization.session_length);
+  f.bandwidth_usage = Normalize(features.bandwidth_usage, normalization.bandwidth_usage);
+  f.requests_count = Normalize(features.requests_count, normalization.requests_count);
+  f.error_percentage = Normalize(features.error_percentage, normalization.error_percentage);
+
+  return f;
+}
+
+void Normalize(LearningSet &learning_set, std::size_t begin,
+               const ::apache::type::FeatureNormalization &normalization) {
+  Transform(learning_set.session_length, begin, IDENTITY_SCALE, normalization.session_length);
+  Transform(learning_set.bandwidth_usage, begin, IDENTITY_SCALE, normalization.bandwidth_usage);
+  Transform(learning_set.requests_count, begin, IDENTITY_SCALE, normalization.requests_count);
+  Transform(learning_set.error_percentage, begin, IDENTITY_SCALE, normalization.error_percentage);
+}
+
+void Renormalize(LearningSet &learning_set,
+                 const ::apache::type::FeatureNormalization &from,
+                 const ::apache::type::FeatureNormalization &to) {
+  Transform(learning_set.session_length, 0, from.session_length, to.session_length);
+  Transform(learning_set.bandwidth_usage, 0, from.bandwidth_usage, to.bandwidth_usage);
+  Transform(learning_set.requests_count, 0, from.requests_count, to.requests_count);
+  Transform(learning_set.error_percentage, 0, from.error_percentage, to.error_percentage);
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "learning_set.h"
+#include "src/apache/type/apache_session_entry.h"
+#include "src/apache/type/feature_normalization.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+// Mean and standard deviation of the session features computed in a single
+// pass (Welford's algorithm), sessions can be added in parts.
+class FeatureStatistics {
+ public:
+  FeatureStatistics();
+
+  void Add(const ::apache::type::ApacheSessionEntry &session);
+  void Add(const ::apache::type::ApacheSessions &sessions);
+  std::size_t Count() const;
+
+  // Features with zero deviation are only centered.
+  ::apache::type::FeatureNormalization GetNormalization() const;
+
+ private:
+  struct Moments {
+    double mean;
+    double m2;
+
+    inline void Add(double value, std::size_t count);
+    inline ::apache::type::FeatureScale GetScale(std::size_t count) const;
+  };
+
+  std::size_t count_;
+  Moments session_length_;
+  Moments bandwidth_usage_;
+  Moments requests_count_;
+  Moments error_percentage_;
+};
+
+// Mean 0 and standard deviation 1 - features are left unchanged.
+::apache::type::FeatureNormalization GetIdentityNormalization();
+
+SessionFeatures Normalize(const SessionFeatures &features,
+                          const ::apache::type::FeatureNormalization &normalization);
+
+// Normalizes rows [begin, learning_set.Size()), every feature is a separate
+// loop over a contiguous vector, so the compiler can vectorize it.
+void Normalize(LearningSet &learning_set, std::size_t begin,
+               const ::apache::type::FeatureNormalization &normalization);
+
+// Rows normalized with `from` are converted to `to` without going back
+// to the original values.
+void Renormalize(LearningSet &learning_set,
+                 const ::apache::type::FeatureNormalization &from,
+                 const ::apache::type::FeatureNormalization &to);
+
+}
+
+}
+
+}
+
+}
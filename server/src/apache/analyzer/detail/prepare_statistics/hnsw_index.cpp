@@ -0,0 +1,248 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "hnsw_index.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+HnswIndexPtr HnswIndex::Create(unsigned m, unsigned ef) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::HnswIndex::Create: Function call";
+
+  return HnswIndexPtr(new HnswIndex(std::max(m, 2u), std::max(ef, 1u)));
+}
+
+void HnswIndex::Update(const LearningSet &learning_set) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::HnswIndex::Update: Inserting " << learning_set.Size() - Size() << " rows";
+
+  for (NodeId id = links_.size(); id < learning_set.Size(); ++id)
+    Insert(learning_set, id);
+}
+
+std::size_t HnswIndex::Size() const {
+  return links_.size();
+}
+
+void HnswIndex::Search(const LearningSet &learning_set,
+                       const SessionFeatures &session,
+                       NearestNeighboursTable &neighbours_table) const {
+  if (links_.empty())
+    return;
+
+  const Point point = {{
+      session.session_length,
+      session.bandwidth_usage,
+      session.requests_count,
+      session.error_percentage
+    }};
+
+  Candidates entry_points = {Candidate(Distance(learning_set, entry_point_, point), entry_point_)};
+  for (int level = max_level_; level > 0; --level)
+    entry_points = SearchLayer(learning_set, point, entry_points, 1, level);
+
+  Neighbour n;
+  const unsigned ef = std::max(ef_, neighbours_table.GetNeighboursCount());
+
+  for (const auto &c : SearchLayer(learning_set, point, entry_points, ef, 0)) {
+    n.distance = c.first;
+    n.classification = learning_set.classification[c.second];
+    n.session_id = learning_set.id[c.second];
+
+    neighbours_table.Add(n);
+  }
+}
+
+HnswIndex::HnswIndex(unsigned m, unsigned ef) :
+m_(m),
+ef_(ef),
+level_multiplier_(1. / std::log(static_cast<double> (m))),
+entry_point_(0),
+max_level_(-1) {
+}
+
+void HnswIndex::Insert(const LearningSet &learning_set, NodeId id) {
+  const int level = RandomLevel();
+  const Point point = GetPoint(learning_set, id);
+
+  links_.push_back(std::vector<Links>(level + 1));
+
+  if (max_level_ < 0) {
+    entry_point_ = id;
+    max_level_ = level;
+    return;
+  }
+
+  Candidates entry_points = {Candidate(Distance(learning_set, entry_point_, point), entry_point_)};
+  for (int l = max_level_; l > level; --l)
+    entry_points = SearchLayer(learning_set, point, entry_points, 1, l);
+
+  for (int l = std::min(level, max_level_); l >= 0; --l) {
+    entry_points = SearchLayer(learning_set, point, entry_points, ef_, l);
+
+    links_[id][l] = SelectNeighbours(learning_set, entry_points, m_);
+    for (auto neighbour : links_[id][l])
+      Connect(learning_set, neighbour, id, l);
+  }
+
+  if (level > max_level_) {
+    entry_point_ = id;
+    max_level_ = level;
+  }
+}
+
+HnswIndex::Candidates HnswIndex::SearchLayer(const LearningSet &learning_set, const Point &point,
+                                             const Candidates &entry_points, unsigned ef, int level) const {
+  std::priority_queue<Candidate, Candidates, std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate, Candidates> results;
+
+  // searches run concurrently on worker pool threads, every thread keeps
+  // its own marks; a new tag invalidates marks left by the previous search
+  thread_local std::vector<std::uint32_t> visited;
+  thread_local std::uint32_t tag = 0;
+
+  if (visited.size() < links_.size())
+    visited.resize(links_.size(), 0);
+  if (++tag == 0) {
+    std::fill(visited.begin(), visited.end(), 0);
+    tag = 1;
+  }
+
+  for (const auto &e : entry_points) {
+    visited[e.second] = tag;
+    candidates.push(e);
+    results.push(e);
+  }
+
+  while (results.size() > ef)
+    results.pop();
+
+  while (!candidates.empty()) {
+    const Candidate current = candidates.top();
+    candidates.pop();
+
+    if (current.first > results.top().first && results.size() >= ef)
+      break;
+
+    for (auto neighbour : links_[current.second][level]) {
+      if (visited[neighbour] == tag)
+        continue;
+      visited[neighbour] = tag;
+
+      const double distance = Distance(learning_set, neighbour, point);
+      if (results.size() < ef || distance < results.top().first) {
+        candidates.push(Candidate(distance, neighbour));
+        results.push(Candidate(distance, neighbour));
+
+        if (results.size() > ef)
+          results.pop();
+      }
+    }
+  }
+
+  Candidates sorted(results.size());
+  for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+    *it = results.top();
+    results.pop();
+  }
+
+  return sorted;
+}
+
+HnswIndex::Links HnswIndex::SelectNeighbours(const LearningSet &learning_set,
+                                             const Candidates &candidates, unsigned count) const {
+  // candidates are sorted by distance, a candidate is skipped when it is closer
+  // to an already selected neighbour than to the inserted point - this keeps
+  // links between clusters; skipped candidates fill the remaining places
+  Links selected, skipped;
+
+  for (const auto &c : candidates) {
+    if (selected.size() >= count)
+      break;
+
+    const Point point = GetPoint(learning_set, c.second);
+    const bool is_diverse = std::none_of(selected.begin(), selected.end(), [&](NodeId s) {
+      return Distance(learning_set, s, point) < c.first;
+    });
+
+    if (is_diverse)
+      selected.push_back(c.second);
+    else
+      skipped.push_back(c.second);
+  }
+
+  for (auto it = skipped.begin(); it != skipped.end() && selected.size() < count; ++it)
+    selected.push_back(*it);
+
+  return selected;
+}
+
+void HnswIndex::Connect(const LearningSet &learning_set, NodeId from, NodeId to, int level) {
+  auto &links = links_[from][level];
+  links.push_back(to);
+
+  if (links.size() <= MaxLinks(level))
+    return;
+
+  const Point point = GetPoint(learning_set, from);
+
+  Candidates candidates;
+  candidates.reserve(links.size());
+  for (auto l : links)
+    candidates.push_back(Candidate(Distance(learning_set, l, point), l));
+  std::sort(candidates.begin(), candidates.end());
+
+  links = SelectNeighbours(learning_set, candidates, MaxLinks(level));
+}
+
+int HnswIndex::RandomLevel() {
+  std::uniform_real_distribution<double> distribution(0., 1.);
+
+  return static_cast<int> (-std::log(1. - distribution(generator_)) * level_multiplier_);
+}
+
+unsigned HnswIndex::MaxLinks(int level) const {
+  return (level == 0) ? 2 * m_ : m_;
+}
+
+HnswIndex::Point HnswIndex::GetPoint(const LearningSet &learning_set, NodeId id) {
+  return Point{{
+      learning_set.session_length[id],
+      learning_set.bandwidth_usage[id],
+      learning_set.requests_count[id],
+      learning_set.error_percentage[id]
+    }};
+}
+
+double HnswIndex::Distance(const LearningSet &learning_set, NodeId id, const Point &point) {
+  const double a = learning_set.session_length[id] - point.features[0];
+  const double b = learning_set.bandwidth_usage[id] - point.features[1];
+  const double c = learning_set.requests_count[id] - point.features[2];
+  const double d = learning_set.error_percentage[id] - point.features[3];
+
+  return a * a + b * b + c * c + d * d;
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "learning_set.h"
+#include "nearest_neighbours_table.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+class HnswIndex;
+typedef std::shared_ptr<HnswIndex> HnswIndexPtr;
+
+// Hierarchical navigable small world graph (Malkov, Yashunin) - approximate
+// nearest neighbours search. m is the number of links created for every row
+// (2 * m on the bottom layer), ef is the size of the candidates list used
+// both while inserting and searching. Larger values give better recall
+// and slower queries.
+//
+// Nodes are learning set row numbers, so the learning set must be append-only
+// while the graph is used.
+class HnswIndex {
+ public:
+  virtual ~HnswIndex() = default;
+
+  static HnswIndexPtr Create(unsigned m, unsigned ef);
+
+  // Inserts rows which were added to the learning set after the last update.
+  void Update(const LearningSet &learning_set);
+  std::size_t Size() const;
+
+  void Search(const LearningSet &learning_set,
+              const SessionFeatures &session,
+              NearestNeighboursTable &neighbours_table) const;
+
+ private:
+  typedef std::uint32_t NodeId;
+  typedef std::vector<NodeId> Links;
+  typedef std::pair<double, NodeId> Candidate;
+  typedef std::vector<Candidate> Candidates;
+
+  struct Point {
+    double features[4];
+  };
+
+  HnswIndex(unsigned m, unsigned ef);
+
+  void Insert(const LearningSet &learning_set, NodeId id);
+
+  Candidates SearchLayer(const LearningSet &learning_set, const Point &point,
+                         const Candidates &entry_points, unsigned ef, int level) const;
+  Links SelectNeighbours(const LearningSet &learning_set,
+                         const Candidates &candidates, unsigned count) const;
+  void Connect(const LearningSet &learning_set, NodeId from, NodeId to, int level);
+
+  int RandomLevel();
+  unsigned MaxLinks(int level) const;
+
+  static Point GetPoint(const LearningSet &learning_set, NodeId id);
+  static double Distance(const LearningSet &learning_set, NodeId id, const Point &point);
+
+  const unsigned m_;
+  const unsigned ef_;
+  const double level_multiplier_;
+
+  std::vector<std::vector<Links>> links_;
+  NodeId entry_point_;
+  int max_level_;
+
+  std::mt19937 generator_;
+};
+
+}
+
+}
+
+}
+
+}
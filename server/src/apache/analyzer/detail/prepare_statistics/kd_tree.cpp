@@ -0,0 +1,341 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "kd_tree.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+namespace
+{
+
+constexpr std::size_t MAX_LEAF_SIZE = 16;
+
+const char FILE_MAGIC[8] = {'S', 'L', 'A', 'S', 'K', 'D', 'T', '1'};
+
+template <typename T>
+void WriteVector(std::ostream &stream, const std::vector<T> &v) {
+  stream.write(reinterpret_cast<const char*> (v.data()), v.size() * sizeof (T));
+}
+
+template <typename T>
+void ReadVector(std::istream &stream, std::vector<T> &v, std::size_t size) {
+  v.resize(size);
+  stream.read(reinterpret_cast<char*> (v.data()), size * sizeof (T));
+}
+
+template <typename T>
+void Permute(std::vector<T> &v, const std::vector<std::size_t> &order) {
+  std::vector<T> permuted;
+  permuted.reserve(v.size());
+
+  for (auto i : order)
+    permuted.push_back(v[i]);
+
+  v.swap(permuted);
+}
+
+}
+
+KdTreePtr KdTree::Create(LearningSet &learning_set) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Create: Function call";
+
+  std::vector<std::size_t> order(learning_set.Size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  SplitDimensions split_dimensions;
+  SplitValues split_values;
+  Build(learning_set, order, 0, 0, order.size(), split_dimensions, split_values);
+
+  Permute(learning_set.session_length, order);
+  Permute(learning_set.bandwidth_usage, order);
+  Permute(learning_set.requests_count, order);
+  Permute(learning_set.error_percentage, order);
+  Permute(learning_set.classification, order);
+  Permute(learning_set.id, order);
+
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Create: Built tree with " << split_dimensions.size() << " nodes for " << learning_set.Size() << " rows";
+
+  return KdTreePtr(new KdTree(std::move(split_dimensions), std::move(split_values)));
+}
+
+KdTreePtr KdTree::Load(const std::string &file_path, Version version,
+                       LearningSet &learning_set) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Function call";
+
+  std::ifstream file(file_path.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Index file not found: " << file_path;
+    return KdTreePtr();
+  }
+
+  char magic[sizeof (FILE_MAGIC)];
+  std::int64_t file_version;
+  std::uint64_t rows, nodes;
+
+  file.read(magic, sizeof (magic));
+  file.read(reinterpret_cast<char*> (&file_version), sizeof (file_version));
+  file.read(reinterpret_cast<char*> (&rows), sizeof (rows));
+  file.read(reinterpret_cast<char*> (&nodes), sizeof (nodes));
+
+  if (!file || !std::equal(magic, magic + sizeof (magic), FILE_MAGIC)) {
+    BOOST_LOG_TRIVIAL(warning) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Damaged index file: " << file_path;
+    return KdTreePtr();
+  }
+
+  const std::streamoff data_begin = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff data_size = file.tellg() - data_begin;
+  file.seekg(data_begin);
+
+  const std::streamoff ROW_SIZE = 4 * sizeof (double) + sizeof (std::int32_t) + sizeof (::database::type::RowId);
+  const std::streamoff NODE_SIZE = sizeof (unsigned char) + sizeof (double);
+  if (rows > static_cast<std::uint64_t> (data_size) / ROW_SIZE
+      || static_cast<std::streamoff> (rows) * ROW_SIZE + static_cast<std::streamoff> (nodes) * NODE_SIZE != data_size) {
+    BOOST_LOG_TRIVIAL(warning) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Damaged index file: " << file_path;
+    return KdTreePtr();
+  }
+
+  if (file_version != version) {
+    BOOST_LOG_TRIVIAL(info) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Index file " << file_path << " is outdated (version " << file_version << ", expected " << version << ")";
+    return KdTreePtr();
+  }
+
+  LearningSet loaded;
+  std::vector<std::int32_t> classification;
+  SplitDimensions split_dimensions;
+  SplitValues split_values;
+
+  ReadVector(file, loaded.session_length, rows);
+  ReadVector(file, loaded.bandwidth_usage, rows);
+  ReadVector(file, loaded.requests_count, rows);
+  ReadVector(file, loaded.error_percentage, rows);
+  ReadVector(file, classification, rows);
+  ReadVector(file, loaded.id, rows);
+  ReadVector(file, split_dimensions, nodes);
+  ReadVector(file, split_values, nodes);
+
+  const bool is_valid_tree = nodes == NodesCount(0, 0, rows)
+      && std::all_of(split_dimensions.begin(), split_dimensions.end(), [](unsigned char d) {
+           return d < DIMENSIONS;
+         });
+
+  if (!file || !is_valid_tree) {
+    BOOST_LOG_TRIVIAL(warning) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Damaged index file: " << file_path;
+    return KdTreePtr();
+  }
+
+  loaded.classification.reserve(rows);
+  for (auto c : classification)
+    loaded.classification.push_back(static_cast< ::database::type::Classification> (c));
+
+  learning_set = std::move(loaded);
+
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Load: Loaded " << rows << " rows from " << file_path;
+
+  return KdTreePtr(new KdTree(std::move(split_dimensions), std::move(split_values)));
+}
+
+bool KdTree::Save(const std::string &file_path, Version version,
+                  const LearningSet &learning_set) const {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KdTree::Save: Function call";
+
+  const std::string temporary_file_path = file_path + ".tmp";
+  const std::int64_t file_version = version;
+  const std::uint64_t rows = learning_set.Size();
+  const std::uint64_t nodes = split_dimensions_.size();
+
+  std::vector<std::int32_t> classification;
+  classification.reserve(rows);
+  for (auto c : learning_set.classification)
+    classification.push_back(static_cast<std::int32_t> (c));
+
+  {
+    std::ofstream file(temporary_file_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+
+    file.write(FILE_MAGIC, sizeof (FILE_MAGIC));
+    file.write(reinterpret_cast<const char*> (&file_version), sizeof (file_version));
+    file.write(reinterpret_cast<const char*> (&rows), sizeof (rows));
+    file.write(reinterpret_cast<const char*> (&nodes), sizeof (nodes));
+
+    WriteVector(file, learning_set.session_length);
+    WriteVector(file, learning_set.bandwidth_usage);
+    WriteVector(file, learning_set.requests_count);
+    WriteVector(file, learning_set.error_percentage);
+    WriteVector(file, classification);
+    WriteVector(file, learning_set.id);
+    WriteVector(file, split_dimensions_);
+    WriteVector(file, split_values_);
+
+    file.flush();
+    if (!file) {
+      BOOST_LOG_TRIVIAL(error) << "apache::analyzer::detail::prepare_statistics::KdTree::Save: Can't write index file: " << temporary_file_path;
+      std::remove(temporary_file_path.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(temporary_file_path.c_str(), file_path.c_str()) != 0) {
+    BOOST_LOG_TRIVIAL(error) << "apache::analyzer::detail::prepare_statistics::KdTree::Save: Can't rename " << temporary_file_path << " to " << file_path;
+    std::remove(temporary_file_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void KdTree::Search(const LearningSet &learning_set,
+                    const SessionFeatures &session,
+                    NearestNeighboursTable &neighbours_table) const {
+  const double point[DIMENSIONS] = {
+    session.session_length,
+    session.bandwidth_usage,
+    session.requests_count,
+    session.error_percentage
+  };
+
+  Search(learning_set, point, 0, 0, learning_set.Size(), neighbours_table);
+}
+
+KdTree::KdTree(SplitDimensions split_dimensions, SplitValues split_values) :
+split_dimensions_(std::move(split_dimensions)),
+split_values_(std::move(split_values)) {
+}
+
+void KdTree::Build(const LearningSet &learning_set,
+                   std::vector<std::size_t> &order,
+                   std::size_t node, std::size_t begin, std::size_t end,
+                   SplitDimensions &split_dimensions,
+                   SplitValues &split_values) {
+  if (IsLeaf(begin, end))
+    return;
+
+  // split along the dimension with the largest spread
+  unsigned split_dimension = 0;
+  double max_spread = -1;
+  for (unsigned d = 0; d < DIMENSIONS; ++d) {
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+
+    for (std::size_t i = begin; i < end; ++i) {
+      const double value = Feature(learning_set, order[i], d);
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+
+    if (max - min > max_spread) {
+      max_spread = max - min;
+      split_dimension = d;
+    }
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                   [&](std::size_t a, std::size_t b) {
+                     return Feature(learning_set, a, split_dimension) < Feature(learning_set, b, split_dimension);
+                   });
+
+  if (split_dimensions.size() <= node) {
+    split_dimensions.resize(node + 1);
+    split_values.resize(node + 1);
+  }
+  split_dimensions[node] = split_dimension;
+  split_values[node] = Feature(learning_set, order[middle], split_dimension);
+
+  Build(learning_set, order, 2 * node + 1, begin, middle, split_dimensions, split_values);
+  Build(learning_set, order, 2 * node + 2, middle, end, split_dimensions, split_values);
+}
+
+void KdTree::Search(const LearningSet &learning_set,
+                    const double point[DIMENSIONS],
+                    std::size_t node, std::size_t begin, std::size_t end,
+                    NearestNeighboursTable &neighbours_table) const {
+  if (IsLeaf(begin, end)) {
+    Neighbour n;
+
+    for (std::size_t i = begin; i < end; ++i) {
+      const double a = learning_set.session_length[i] - point[0];
+      const double b = learning_set.bandwidth_usage[i] - point[1];
+      const double c = learning_set.requests_count[i] - point[2];
+      const double d = learning_set.error_percentage[i] - point[3];
+
+      n.distance = a * a + b * b + c * c + d * d;
+      n.classification = learning_set.classification[i];
+      n.session_id = learning_set.id[i];
+
+      neighbours_table.Add(n);
+    }
+
+    return;
+  }
+
+  const unsigned split_dimension = split_dimensions_[node];
+  const std::size_t middle = begin + (end - begin) / 2;
+  const double difference = point[split_dimension] - split_values_[node];
+
+  if (difference < 0) {
+    Search(learning_set, point, 2 * node + 1, begin, middle, neighbours_table);
+    if (difference * difference < neighbours_table.GetWorstDistance())
+      Search(learning_set, point, 2 * node + 2, middle, end, neighbours_table);
+  }
+  else {
+    Search(learning_set, point, 2 * node + 2, middle, end, neighbours_table);
+    if (difference * difference < neighbours_table.GetWorstDistance())
+      Search(learning_set, point, 2 * node + 1, begin, middle, neighbours_table);
+  }
+}
+
+std::size_t KdTree::NodesCount(std::size_t node, std::size_t begin, std::size_t end) {
+  if (IsLeaf(begin, end))
+    return 0;
+
+  const std::size_t middle = begin + (end - begin) / 2;
+
+  return std::max({node + 1,
+                   NodesCount(2 * node + 1, begin, middle),
+                   NodesCount(2 * node + 2, middle, end)});
+}
+
+bool KdTree::IsLeaf(std::size_t begin, std::size_t end) {
+  return end - begin <= MAX_LEAF_SIZE;
+}
+
+double KdTree::Feature(const LearningSet &learning_set, std::size_t row, unsigned dimension) {
+  switch (dimension) {
+    case 0:
+      return learning_set.session_length[row];
+    case 1:
+      return learning_set.bandwidth_usage[row];
+    case 2:
+      return learning_set.requests_count[row];
+    default:
+      return learning_set.error_percentage[row];
+  }
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "learning_set.h"
+#include "nearest_neighbours_table.h"
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+class KdTree;
+typedef std::shared_ptr<KdTree> KdTreePtr;
+
+// Balanced k-d tree over the four session features. The tree doesn't copy
+// the learning set, rows are reordered in place so every node is a contiguous
+// range [begin, end) and only the split planes have to be stored.
+class KdTree {
+ public:
+  typedef ::database::type::RowId Version;
+
+  virtual ~KdTree() = default;
+
+  static KdTreePtr Create(LearningSet &learning_set);
+
+  // Returns nullptr when the file doesn't exist, is damaged or was saved
+  // for another learning set version.
+  static KdTreePtr Load(const std::string &file_path, Version version,
+                        LearningSet &learning_set);
+
+  // File is written to a temporary path and renamed, so readers never see
+  // a partially written index.
+  bool Save(const std::string &file_path, Version version,
+            const LearningSet &learning_set) const;
+
+  // Exact search - neighbours_table receives every row that could be
+  // closer than the current worst neighbour.
+  void Search(const LearningSet &learning_set,
+              const SessionFeatures &session,
+              NearestNeighboursTable &neighbours_table) const;
+
+ private:
+  static constexpr unsigned DIMENSIONS = 4;
+
+  typedef std::vector<unsigned char> SplitDimensions;
+  typedef std::vector<double> SplitValues;
+
+  KdTree(SplitDimensions split_dimensions, SplitValues split_values);
+
+  static void Build(const LearningSet &learning_set,
+                    std::vector<std::size_t> &order,
+                    std::size_t node, std::size_t begin, std::size_t end,
+                    SplitDimensions &split_dimensions,
+                    SplitValues &split_values);
+
+  void Search(const LearningSet &learning_set,
+              const double point[DIMENSIONS],
+              std::size_t node, std::size_t begin, std::size_t end,
+              NearestNeighboursTable &neighbours_table) const;
+
+  static std::size_t NodesCount(std::size_t node, std::size_t begin, std::size_t end);
+  static bool IsLeaf(std::size_t begin, std::size_t end);
+  static double Feature(const LearningSet &learning_set, std::size_t row, unsigned dimension);
+
+  SplitDimensions split_dimensions_;
+  SplitValues split_values_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "knn_classifier.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cmath>
+
+#include "distance_kernel.h"
+#include "feature_normalization.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+KnnClassifierPtr KnnClassifier::Create(::analyzer::WorkerPoolPtr worker_pool) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::Create: Function call";
+
+  return KnnClassifierPtr(new KnnClassifier(worker_pool));
+}
+
+void KnnClassifier::SetLearningSet(const ::apache::type::ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::SetLearningSet: Function call";
+
+  learning_set_.Clear();
+  learning_set_.Reserve(sessions.size());
+  index_.reset();
+
+  if (approximate_index_)
+    approximate_index_ = HnswIndex::Create(approximate_index_m_, approximate_index_ef_);
+
+  AddToLearningSet(sessions);
+}
+
+void KnnClassifier::AddToLearningSet(const ::apache::type::ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::AddToLearningSet: Function call";
+  index_.reset();
+
+  const auto begin = learning_set_.Size();
+  for (const auto &session : sessions) {
+    if (session.classification != ::database::type::Classification::UNKNOWN)
+      learning_set_.Add(session);
+    else
+      BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::AddToLearningSet: Unknown session classification (id=" << session.id << ")";
+  }
+
+  Normalize(learning_set_, begin, normalization_);
+
+  if (approximate_index_)
+    approximate_index_->Update(learning_set_);
+}
+
+const LearningSet& KnnClassifier::GetLearningSet() const {
+  return learning_set_;
+}
+
+void KnnClassifier::SetNormalization(const ::apache::type::FeatureNormalization &normalization) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::SetNormalization: Function call";
+
+  Renormalize(learning_set_, normalization_, normalization);
+  normalization_ = normalization;
+
+  if (learning_set_.Size() > 0) {
+    index_.reset();
+
+    if (approximate_index_)
+      EnableApproximateSearch(approximate_index_m_, approximate_index_ef_);
+  }
+}
+
+const ::apache::type::FeatureNormalization& KnnClassifier::GetNormalization() const {
+  return normalization_;
+}
+
+void KnnClassifier::BuildIndex() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::BuildIndex: Function call";
+
+  approximate_index_.reset();
+  index_ = KdTree::Create(learning_set_);
+}
+
+bool KnnClassifier::LoadIndex(const std::string &file_path, KdTree::Version version) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::LoadIndex: Function call";
+
+  approximate_index_.reset();
+  index_ = KdTree::Load(file_path, version, learning_set_);
+
+  return HasIndex();
+}
+
+bool KnnClassifier::SaveIndex(const std::string &file_path, KdTree::Version version) const {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::SaveIndex: Function call";
+
+  if (!HasIndex())
+    return false;
+
+  return index_->Save(file_path, version, learning_set_);
+}
+
+bool KnnClassifier::HasIndex() const {
+  return static_cast<bool> (index_);
+}
+
+void KnnClassifier::EnableApproximateSearch(unsigned m, unsigned ef) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::EnableApproximateSearch: m=" << m << "; ef=" << ef;
+
+  index_.reset();
+
+  approximate_index_m_ = m;
+  approximate_index_ef_ = ef;
+  approximate_index_ = HnswIndex::Create(m, ef);
+  approximate_index_->Update(learning_set_);
+}
+
+void KnnClassifier::DisableApproximateSearch() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::DisableApproximateSearch: Function call";
+
+  approximate_index_.reset();
+}
+
+bool KnnClassifier::IsApproximateSearchEnabled() const {
+  return static_cast<bool> (approximate_index_);
+}
+
+void KnnClassifier::SetNeighboursCount(unsigned neighbours_count) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::SetNeighboursCount: k=" << neighbours_count;
+
+  neighbours_count_ = std::max(neighbours_count, 1u);
+}
+
+unsigned KnnClassifier::GetNeighboursCount() const {
+  return neighbours_count_;
+}
+
+void KnnClassifier::SetVoting(::apache::type::KnnVoting voting) {
+  voting_ = voting;
+}
+
+KnnClassifier::Classifications KnnClassifier::Classify(const ::apache::type::ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::Classify: Classifying " << sessions.size() << " sessions with learning set size " << learning_set_.Size();
+
+  Classifications classifications(sessions.size(), ::database::type::Classification::UNKNOWN);
+
+  worker_pool_->RunPartially(sessions.size(), [&](long long begin, long long end) {
+    std::vector<double> distances((index_ || approximate_index_) ? 0 : learning_set_.Size());
+    NearestNeighboursTable neighbours_table(neighbours_count_);
+
+    for (long long i = begin; i < end; ++i) {
+      FindSessionNearestNeighbours(sessions[i], distances, neighbours_table);
+      classifications[i] = GetSessionClassification(neighbours_table.Get(), voting_);
+    }
+  });
+
+  return classifications;
+}
+
+KnnClassifier::NeighboursList KnnClassifier::FindNearestNeighbours(const ::apache::type::ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnClassifier::FindNearestNeighbours: Searching neighbours for " << sessions.size() << " sessions";
+
+  NeighboursList neighbours(sessions.size());
+
+  worker_pool_->RunPartially(sessions.size(), [&](long long begin, long long end) {
+    std::vector<double> distances((index_ || approximate_index_) ? 0 : learning_set_.Size());
+    NearestNeighboursTable neighbours_table(neighbours_count_);
+
+    for (long long i = begin; i < end; ++i) {
+      FindSessionNearestNeighbours(sessions[i], distances, neighbours_table);
+      neighbours[i] = neighbours_table.Get();
+    }
+  });
+
+  return neighbours;
+}
+
+::database::type::Classification KnnClassifier::GetSessionClassification(const Neighbours &neighbours,
+                                                                         ::apache::type::KnnVoting voting) {
+  if (voting == ::apache::type::KnnVoting::DISTANCE_WEIGHTED)
+    return GetSessionClassificationByWeightedVoting(neighbours);
+
+  long long i = 0;
+
+  for (const auto &n : neighbours)
+    i = i - 1 + 2 * static_cast<int> (n.classification == ::database::type::Classification::ANOMALY);
+
+  ::database::type::Classification c = ::database::type::Classification::UNKNOWN;
+  if (neighbours.size() > 0) {
+    if (i > 0)
+      c = ::database::type::Classification::ANOMALY;
+    else
+      c = ::database::type::Classification::NORMAL;
+  }
+
+  return c;
+}
+
+::database::type::Classification KnnClassifier::GetSessionClassificationByWeightedVoting(const Neighbours &neighbours) {
+  if (neighbours.empty())
+    return ::database::type::Classification::UNKNOWN;
+
+  // neighbours are sorted, exact matches are at the beginning
+  const bool has_exact_match = neighbours.front().distance == 0;
+
+  double anomaly = 0, normal = 0;
+  for (const auto &n : neighbours) {
+    if (has_exact_match && n.distance != 0)
+      break;
+
+    const double weight = has_exact_match ? 1. : 1. / std::sqrt(n.distance);
+    if (n.classification == ::database::type::Classification::ANOMALY)
+      anomaly += weight;
+    else
+      normal += weight;
+  }
+
+  return (anomaly > normal) ? ::database::type::Classification::ANOMALY : ::database::type::Classification::NORMAL;
+}
+
+KnnClassifier::KnnClassifier(::analyzer::WorkerPoolPtr worker_pool) :
+worker_pool_(worker_pool),
+approximate_index_m_(0),
+approximate_index_ef_(0),
+neighbours_count_(NearestNeighboursTable::DEFAULT_NEIGHBOURS_COUNT),
+voting_(::apache::type::KnnVoting::MAJORITY),
+normalization_(GetIdentityNormalization()) {
+}
+
+void KnnClassifier::FindSessionNearestNeighbours(const ::apache::type::ApacheSessionEntry &original_session,
+                                                 std::vector<double> &distances,
+                                                 NearestNeighboursTable &neighbours_table) const {
+  neighbours_table.Clear();
+
+  const auto session = Normalize(SessionFeatures::Create(original_session), normalization_);
+
+  if (approximate_index_) {
+    approximate_index_->Search(learning_set_, session, neighbours_table);
+    return;
+  }
+
+  if (index_) {
+    index_->Search(learning_set_, session, neighbours_table);
+    return;
+  }
+
+  SquaredDistances(learning_set_, session, distances.data());
+
+  Neighbour n;
+  for (std::size_t i = 0; i < learning_set_.Size(); ++i) {
+    n.distance = distances[i];
+    n.classification = learning_set_.classification[i];
+    n.session_id = learning_set_.id[i];
+
+    neighbours_table.Add(n);
+  }
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hnsw_index.h"
+#include "kd_tree.h"
+#include "learning_set.h"
+#include "neighbour.h"
+#include "nearest_neighbours_table.h"
+#include "src/analyzer/worker_pool.h"
+#include "src/apache/type/apache_session_entry.h"
+#include "src/apache/type/feature_normalization.h"
+#include "src/apache/type/knn_configuration.h"
+#include "src/database/type/classification.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+class KnnClassifier;
+typedef std::shared_ptr<KnnClassifier> KnnClassifierPtr;
+
+class KnnClassifier {
+ public:
+  typedef std::vector< ::database::type::Classification> Classifications;
+  typedef std::vector<Neighbours> NeighboursList;
+
+  virtual ~KnnClassifier() = default;
+
+  static KnnClassifierPtr Create(::analyzer::WorkerPoolPtr worker_pool);
+
+  // Rows with unknown classification are skipped, they can't vote.
+  // Changing the learning set drops the k-d tree, the approximate index is
+  // updated with new rows.
+  void SetLearningSet(const ::apache::type::ApacheSessions &sessions);
+  void AddToLearningSet(const ::apache::type::ApacheSessions &sessions);
+  const LearningSet& GetLearningSet() const;
+
+  // Rows already in the learning set are converted to the new normalization,
+  // new rows and classified sessions are normalized on the fly. K-d tree is
+  // dropped, the approximate index is rebuilt.
+  void SetNormalization(const ::apache::type::FeatureNormalization &normalization);
+  const ::apache::type::FeatureNormalization& GetNormalization() const;
+
+  // Without an index every session is compared with the whole learning set.
+  // K-d tree and approximate search exclude each other.
+  void BuildIndex();
+  bool LoadIndex(const std::string &file_path, KdTree::Version version);
+  bool SaveIndex(const std::string &file_path, KdTree::Version version) const;
+  bool HasIndex() const;
+
+  void EnableApproximateSearch(unsigned m, unsigned ef);
+  void DisableApproximateSearch();
+  bool IsApproximateSearchEnabled() const;
+
+  void SetNeighboursCount(unsigned neighbours_count);
+  unsigned GetNeighboursCount() const;
+  void SetVoting(::apache::type::KnnVoting voting);
+
+  // Sessions are split between worker pool threads.
+  Classifications Classify(const ::apache::type::ApacheSessions &sessions);
+  NeighboursList FindNearestNeighbours(const ::apache::type::ApacheSessions &sessions);
+
+  // Distance weighted voting counts every neighbour with weight 1 / distance,
+  // neighbours equal to the session outvote all others.
+  static ::database::type::Classification GetSessionClassification(const Neighbours &neighbours,
+                                                                   ::apache::type::KnnVoting voting = ::apache::type::KnnVoting::MAJORITY);
+
+ private:
+  explicit KnnClassifier(::analyzer::WorkerPoolPtr worker_pool);
+
+  static ::database::type::Classification GetSessionClassificationByWeightedVoting(const Neighbours &neighbours);
+
+  void FindSessionNearestNeighbours(const ::apache::type::ApacheSessionEntry &session,
+                                    std::vector<double> &distances,
+                                    NearestNeighboursTable &neighbours_table) const;
+
+  ::analyzer::WorkerPoolPtr worker_pool_;
+  LearningSet learning_set_;
+  KdTreePtr index_;
+  HnswIndexPtr approximate_index_;
+  unsigned approximate_index_m_;
+  unsigned approximate_index_ef_;
+  unsigned neighbours_count_;
+  ::apache::type::KnnVoting voting_;
+  ::apache::type::FeatureNormalization normalization_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "knn_recall_evaluator.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <chrono>
+
+#include "feature_normalization.h"
+#include "knn_classifier.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+constexpr std::size_t KnnRecallEvaluator::QUERY_STEP;
+
+KnnRecallEvaluatorPtr KnnRecallEvaluator::Create(::analyzer::WorkerPoolPtr worker_pool) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnRecallEvaluator::Create: Function call";
+
+  return KnnRecallEvaluatorPtr(new KnnRecallEvaluator(worker_pool));
+}
+
+KnnRecallEvaluation KnnRecallEvaluator::Evaluate(const ::apache::type::ApacheSessions &sessions,
+                                                 const ::apache::type::KnnConfiguration &configuration) const {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::KnnRecallEvaluator::Evaluate: Function call";
+  typedef std::chrono::steady_clock Clock;
+  typedef std::chrono::duration<double> Seconds;
+
+  ::apache::type::ApacheSessions learning_sessions, queries;
+  FeatureStatistics statistics;
+  for (std::size_t i = 0; i < sessions.size(); ++i) {
+    if (i % QUERY_STEP == QUERY_STEP - 1) {
+      queries.push_back(sessions[i]);
+    }
+    else {
+      learning_sessions.push_back(sessions[i]);
+
+      // like in the analyzer, unknown rows aren't in the learning set
+      if (sessions[i].classification != ::database::type::Classification::UNKNOWN)
+        statistics.Add(sessions[i]);
+    }
+  }
+
+  auto exact = KnnClassifier::Create(worker_pool_);
+  auto approximate = KnnClassifier::Create(worker_pool_);
+
+  for (const auto &classifier : {exact, approximate}) {
+    classifier->SetNormalization(statistics.GetNormalization());
+    classifier->SetNeighboursCount(configuration.neighbours_count);
+    classifier->SetVoting(configuration.voting);
+  }
+
+  auto start = Clock::now();
+  exact->SetLearningSet(learning_sessions);
+  exact->BuildIndex();
+  auto exact_neighbours = exact->FindNearestNeighbours(queries);
+  auto exact_time = Seconds(Clock::now() - start).count();
+
+  start = Clock::now();
+  approximate->EnableApproximateSearch(configuration.hnsw_m, configuration.hnsw_ef);
+  approximate->SetLearningSet(learning_sessions);
+  auto approximate_neighbours = approximate->FindNearestNeighbours(queries);
+  auto approximate_time = Seconds(Clock::now() - start).count();
+
+  // neighbours with equal distances are interchangeable, so an approximate
+  // neighbour is correct when it isn't farther than the worst exact one
+  std::size_t expected = 0, found = 0, agreements = 0;
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    const auto &e = exact_neighbours[i];
+    const auto &a = approximate_neighbours[i];
+
+    double worst_distance = 0;
+    for (const auto &n : e)
+      worst_distance = std::max(worst_distance, n.distance);
+
+    const std::size_t correct = std::count_if(a.begin(), a.end(), [worst_distance](const Neighbour &n) {
+      return n.distance <= worst_distance;
+    });
+
+    expected += e.size();
+    found += std::min(correct, e.size());
+    agreements += static_cast<std::size_t> (KnnClassifier::GetSessionClassification(e, configuration.voting) == KnnClassifier::GetSessionClassification(a, configuration.voting));
+  }
+
+  KnnRecallEvaluation evaluation;
+  evaluation.learning_set_size = exact->GetLearningSet().Size();
+  evaluation.queries_count = queries.size();
+  evaluation.recall = (expected > 0) ? static_cast<double> (found) / expected : 1.;
+  evaluation.classification_agreement = queries.empty() ? 1. : static_cast<double> (agreements) / queries.size();
+  evaluation.exact_time = exact_time;
+  evaluation.approximate_time = approximate_time;
+  evaluation.normalization = exact->GetNormalization();
+
+  BOOST_LOG_TRIVIAL(info) << "apache::analyzer::detail::prepare_statistics::KnnRecallEvaluator::Evaluate: Recall: " << evaluation.recall << "; agreement: " << evaluation.classification_agreement << "; exact time: " << exact_time << "s; approximate time: " << approximate_time << "s";
+
+  return evaluation;
+}
+
+KnnRecallEvaluator::KnnRecallEvaluator(::analyzer::WorkerPoolPtr worker_pool) :
+worker_pool_(worker_pool) {
+}
+
+}
+
+}
+
+}
+
+}
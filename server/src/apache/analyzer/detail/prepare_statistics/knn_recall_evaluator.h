@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "src/analyzer/worker_pool.h"
+#include "src/apache/type/apache_session_entry.h"
+#include "src/apache/type/feature_normalization.h"
+#include "src/apache/type/knn_configuration.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+struct KnnRecallEvaluation {
+  std::size_t learning_set_size;
+  std::size_t queries_count;
+  double recall; // part of exact neighbours found by the approximate search
+  double classification_agreement;
+  double exact_time; // seconds
+  double approximate_time; // seconds, graph construction included
+  ::apache::type::FeatureNormalization normalization; // used by both searches
+};
+
+class KnnRecallEvaluator;
+typedef std::shared_ptr<KnnRecallEvaluator> KnnRecallEvaluatorPtr;
+
+// Compares the approximate search with the exact one on the learning set.
+// Every QUERY_STEP-th session is held out of the learning set and used as a query.
+// Both searches use the neighbours count and voting from the configuration,
+// the mode is ignored.
+class KnnRecallEvaluator {
+ public:
+  static constexpr std::size_t QUERY_STEP = 10;
+
+  virtual ~KnnRecallEvaluator() = default;
+
+  static KnnRecallEvaluatorPtr Create(::analyzer::WorkerPoolPtr worker_pool);
+
+  KnnRecallEvaluation Evaluate(const ::apache::type::ApacheSessions &sessions,
+                               const ::apache::type::KnnConfiguration &configuration) const;
+
+ private:
+  explicit KnnRecallEvaluator(::analyzer::WorkerPoolPtr worker_pool);
+
+  ::analyzer::WorkerPoolPtr worker_pool_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "src/apache/type/apache_session_entry.h"
+#include "src/database/type/row_id.h"
+#include "src/database/type/classification.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace prepare_statistics
+{
+
+// Features of a single session in the learning set units - when the learning
+// set is normalized, the session has to be normalized too.
+struct SessionFeatures {
+  double session_length;
+  double bandwidth_usage;
+  double requests_count;
+  double error_percentage;
+
+  static inline SessionFeatures Create(const ::apache::type::ApacheSessionEntry &session);
+};
+
+// Structure of arrays - every feature is stored in a separate, contiguous
+// vector, so the distance kernel can process a few rows with one instruction.
+struct LearningSet {
+  std::vector<double> session_length;
+  std::vector<double> bandwidth_usage;
+  std::vector<double> requests_count;
+  std::vector<double> error_percentage;
+  std::vector< ::database::type::Classification> classification;
+  std::vector< ::database::type::RowId> id;
+
+  inline void Add(const ::apache::type::ApacheSessionEntry &session);
+  inline void Reserve(std::size_t count);
+  inline void Clear();
+  inline std::size_t Size() const;
+};
+
+SessionFeatures SessionFeatures::Create(const ::apache::type::ApacheSessionEntry &session) {
+  SessionFeatures f;
+  f.session_length = session.session_length;
+  f.bandwidth_usage = session.bandwidth_usage;
+  f.requests_count = session.requests_count;
+  f.error_percentage = session.error_percentage;
+
+  return f;
+}
+
+void LearningSet::Add(const ::apache::type::ApacheSessionEntry &session) {
+  session_length.push_back(session.session_length);
+  bandwidth_usage.push_back(session.bandwidth_usage);
+  requests_count.push_back(session.requests_count);
+  error_percentage.push_back(session.error_percentage);
+  classification.push_back(session.classification);
+  id.push_back(session.id);
+}
+
+void LearningSet::Reserve(std::size_t count) {
+  session_length.reserve(count);
+  bandwidth_usage.reserve(count);
+  requests_count.reserve(count);
+  error_percentage.reserve(count);
+  classification.reserve(count);
+  id.reserve(count);
+}
+
+void LearningSet::Clear() {
+  session_length.clear();
+  bandwidth_usage.clear();
+  requests_count.clear();
+  error_percentage.clear();
+  classification.clear();
+  id.clear();
+}
+
+std::size_t LearningSet::Size() const {
+  return id.size();
+}
+
+}
+
+}
+
+}
+
+}
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <boost/log/trivial.hpp>
+#include <limits>
 
 using namespace std;
 
@@ -22,9 +23,11 @@ namespace detail
 namespace prepare_statistics
 {
 
-NearestNeighboursTable::NearestNeighboursTable() :
-number_of_neighbours_(3) {
-  nearest_neighbours_.reserve(number_of_neighbours_ + 1);
+constexpr unsigned NearestNeighboursTable::DEFAULT_NEIGHBOURS_COUNT;
+
+NearestNeighboursTable::NearestNeighboursTable(unsigned neighbours_count) :
+number_of_neighbours_(std::max(neighbours_count, 1u)) {
+  nearest_neighbours_.reserve(number_of_neighbours_);
 }
 
 void NearestNeighboursTable::SetSession(const ::apache::type::ApacheSessionEntry &session) {
@@ -36,33 +39,33 @@ void NearestNeighboursTable::SetSession(const ::apache::type::ApacheSessionEntry
 void NearestNeighboursTable::Add(const ::apache::type::ApacheSessionEntry &session) {
   BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Add: Function call";
 
-  auto it = find_if(nearest_neighbours_.begin(), nearest_neighbours_.end(), [&session](const Neighbour & n) {
-    return n.session_id == session.id;
-  });
-  if (it != nearest_neighbours_.end())
-    return;
-
   Neighbour n;
-  n.distance = Distance(session, original_session_);
+  n.distance = SquaredDistance(session, original_session_);
   n.classification = session.classification;
   n.session_id = session.id;
 
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Add: Adding neighbour where distance=" << n.distance << "; classification=" << static_cast<int> (n.classification) << "; session_id=" << n.session_id;
+  Add(n);
+}
 
-  nearest_neighbours_.push_back(n);
+void NearestNeighboursTable::Add(const Neighbour &n) {
+  const bool is_full = nearest_neighbours_.size() == number_of_neighbours_;
+  if (is_full && n.distance >= nearest_neighbours_.back().distance)
+    return;
 
-  sort(nearest_neighbours_.begin(), nearest_neighbours_.end(),
-       [](const Neighbour &a, const Neighbour & b) {
-         return a.distance < b.distance;
-       });
+  auto position = nearest_neighbours_.size();
+  for (; position > 0 && nearest_neighbours_[position - 1].distance > n.distance; --position);
 
-  if (nearest_neighbours_.size() > static_cast<unsigned> (number_of_neighbours_)) {
-    auto position_to_erase = nearest_neighbours_.end() - 1;
-    BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Add: Removing item with id=" << position_to_erase->session_id;
-    nearest_neighbours_.erase(position_to_erase);
+  // the same session always has the same distance, so only the run
+  // of equal distances directly before the insert position is checked
+  for (auto i = position; i > 0 && nearest_neighbours_[i - 1].distance == n.distance; --i) {
+    if (nearest_neighbours_[i - 1].session_id == n.session_id)
+      return;
   }
 
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Add: New table size " << nearest_neighbours_.size();
+  if (is_full)
+    nearest_neighbours_.pop_back();
+
+  nearest_neighbours_.insert(nearest_neighbours_.begin() + position, n);
 }
 
 const Neighbours& NearestNeighboursTable::Get() {
@@ -71,25 +74,34 @@ const Neighbours& NearestNeighboursTable::Get() {
   return nearest_neighbours_;
 }
 
-void NearestNeighboursTable::Clear() {
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Clear: Function call";
+double NearestNeighboursTable::GetWorstDistance() const {
+  if (nearest_neighbours_.size() < number_of_neighbours_)
+    return std::numeric_limits<double>::infinity();
 
-  nearest_neighbours_.clear();
+  return nearest_neighbours_.back().distance;
 }
 
-double NearestNeighboursTable::Distance(const ::apache::type::ApacheSessionEntry &a,
-                                        const ::apache::type::ApacheSessionEntry &b) const {
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Distance: Function call";
+unsigned NearestNeighboursTable::GetNeighboursCount() const {
+  return number_of_neighbours_;
+}
 
-  double d = sqrt(pow(a.session_length - b.session_length, 2) +
-                  pow(a.bandwidth_usage - b.bandwidth_usage, 2) +
-                  pow(a.requests_count - b.requests_count, 2) +
-                  pow(a.error_percentage - b.error_percentage, 2)
-                  );
+void NearestNeighboursTable::Clear() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Clear: Function call";
 
-  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::prepare_statistics::NearestNeighboursTable::Distance: Distance between session id=" << a.id << "; id2=" << b.id << " is " << d;
+  nearest_neighbours_.clear();
+}
 
-  return d;
+double NearestNeighboursTable::SquaredDistance(const ::apache::type::ApacheSessionEntry &a,
+                                               const ::apache::type::ApacheSessionEntry &b) const {
+  const double session_length = a.session_length - b.session_length;
+  const double bandwidth_usage = a.bandwidth_usage - b.bandwidth_usage;
+  const double requests_count = a.requests_count - b.requests_count;
+  const double error_percentage = a.error_percentage - b.error_percentage;
+
+  return session_length * session_length +
+      bandwidth_usage * bandwidth_usage +
+      requests_count * requests_count +
+      error_percentage * error_percentage;
 }
 
 }
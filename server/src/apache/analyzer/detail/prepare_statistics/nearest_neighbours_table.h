@@ -21,26 +21,34 @@ namespace detail
 namespace prepare_statistics
 {
 
+// Keeps the k closest neighbours sorted by distance in a vector reserved
+// up front, so adding candidates never allocates.
 class NearestNeighboursTable : public NearestNeighboursTableInterface {
  public:
-  NearestNeighboursTable();
+  static constexpr unsigned DEFAULT_NEIGHBOURS_COUNT = 3;
+
+  explicit NearestNeighboursTable(unsigned neighbours_count = DEFAULT_NEIGHBOURS_COUNT);
   virtual ~NearestNeighboursTable() = default;
 
   void SetSession(const ::apache::type::ApacheSessionEntry &session) override;
 
   void Add(const ::apache::type::ApacheSessionEntry &session) override;
+  void Add(const Neighbour &neighbour) override;
   const Neighbours& Get() override;
 
+  double GetWorstDistance() const override;
+  unsigned GetNeighboursCount() const override;
+
   void Clear() override;
 
  private:
-  int number_of_neighbours_;
+  unsigned number_of_neighbours_;
 
   ::apache::type::ApacheSessionEntry original_session_;
   Neighbours nearest_neighbours_;
 
-  double Distance(const ::apache::type::ApacheSessionEntry &a,
-                  const ::apache::type::ApacheSessionEntry &b) const;
+  double SquaredDistance(const ::apache::type::ApacheSessionEntry &a,
+                         const ::apache::type::ApacheSessionEntry &b) const;
 };
 
 }
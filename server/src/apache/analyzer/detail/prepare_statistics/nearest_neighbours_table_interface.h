@@ -28,8 +28,13 @@ class NearestNeighboursTableInterface {
   virtual void SetSession(const ::apache::type::ApacheSessionEntry &session) = 0;
 
   virtual void Add(const ::apache::type::ApacheSessionEntry &session) = 0;
+  virtual void Add(const Neighbour &neighbour) = 0;
   virtual const Neighbours& Get() = 0;
 
+  // Distance of the farthest kept neighbour, infinity until the table is full.
+  virtual double GetWorstDistance() const = 0;
+  virtual unsigned GetNeighboursCount() const = 0;
+
   virtual void Clear() = 0;
 };
 
@@ -25,7 +25,7 @@ namespace prepare_statistics
 {
 
 struct Neighbour {
-  double distance;
+  double distance; // squared euclidean distance
   ::database::type::Classification classification;
   ::database::type::RowId session_id;
 
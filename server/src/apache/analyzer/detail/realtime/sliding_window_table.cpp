@@ -0,0 +1,162 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "sliding_window_table.h"
+
+#include <algorithm>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace realtime
+{
+
+namespace
+{
+
+constexpr std::uint32_t NONE = sessionizer::SessionTable::NOT_FOUND;
+
+}
+
+constexpr long long SlidingWindowTable::NEVER_REPORTED;
+
+SlidingWindowTable::SlidingWindowTable(std::uint32_t capacity, long long bucket_length, unsigned buckets_count) :
+capacity_(std::max(capacity, 1u)),
+bucket_length_(std::max(bucket_length, 1ll)),
+buckets_count_(std::max(buckets_count, 1u)),
+head_(NONE),
+tail_(NONE) {
+}
+
+SlidingWindowTable::Window& SlidingWindowTable::Add(Key key, long long time, bool is_error, long long bytes) {
+  const long long tick = time / bucket_length_;
+  const Index index = GetEntry(key, tick);
+  Entry &entry = entries_[index];
+
+  MoveToFront(index);
+
+  if (tick > entry.last_tick)
+    Slide(index, tick);
+  else if (tick <= entry.last_tick - buckets_count_)
+    return entry.window;
+
+  Bucket &bucket = GetBucket(index, tick);
+  bucket.requests_count += 1;
+  bucket.errors_count += is_error ? 1 : 0;
+  bucket.bandwidth_usage += bytes;
+
+  WindowFeatures &features = entry.window.features;
+  features.requests_count += 1;
+  features.errors_count += is_error ? 1 : 0;
+  features.bandwidth_usage += bytes;
+
+  return entry.window;
+}
+
+std::size_t SlidingWindowTable::Size() const {
+  return table_.Size();
+}
+
+long long SlidingWindowTable::GetWindowLength() const {
+  return bucket_length_ * buckets_count_;
+}
+
+SlidingWindowTable::Index SlidingWindowTable::GetEntry(Key key, long long tick) {
+  Index index = table_.Find(key);
+  if (index != NONE)
+    return index;
+
+  if (entries_.size() < capacity_) {
+    index = entries_.size();
+    entries_.push_back(Entry());
+    buckets_.resize(buckets_.size() + buckets_count_);
+  }
+  else {
+    index = tail_;
+    Unlink(index);
+    table_.Erase(entries_[index].key);
+  }
+
+  Entry &entry = entries_[index];
+  entry.key = key;
+  entry.last_tick = tick;
+  entry.window.features = WindowFeatures{0, 0, 0};
+  entry.window.last_report_time = NEVER_REPORTED;
+  entry.previous = NONE;
+  entry.next = NONE;
+  std::fill_n(buckets_.begin() + static_cast<std::size_t> (index) * buckets_count_, buckets_count_, Bucket{0, 0, 0});
+
+  table_.Insert(key, index);
+
+  return index;
+}
+
+void SlidingWindowTable::MoveToFront(Index index) {
+  if (head_ == index)
+    return;
+
+  if (entries_[index].previous != NONE || tail_ == index)
+    Unlink(index);
+
+  entries_[index].next = head_;
+  if (head_ != NONE)
+    entries_[head_].previous = index;
+  head_ = index;
+
+  if (tail_ == NONE)
+    tail_ = index;
+}
+
+void SlidingWindowTable::Unlink(Index index) {
+  Entry &entry = entries_[index];
+
+  if (entry.previous != NONE)
+    entries_[entry.previous].next = entry.next;
+  else
+    head_ = entry.next;
+
+  if (entry.next != NONE)
+    entries_[entry.next].previous = entry.previous;
+  else
+    tail_ = entry.previous;
+
+  entry.previous = NONE;
+  entry.next = NONE;
+}
+
+void SlidingWindowTable::Slide(Index index, long long tick) {
+  Entry &entry = entries_[index];
+  WindowFeatures &features = entry.window.features;
+
+  // buckets between the last and the new tick leave the window
+  const long long steps = std::min(tick - entry.last_tick, static_cast<long long> (buckets_count_));
+  for (long long t = tick - steps + 1; t <= tick; ++t) {
+    Bucket &bucket = GetBucket(index, t);
+    features.requests_count -= bucket.requests_count;
+    features.errors_count -= bucket.errors_count;
+    features.bandwidth_usage -= bucket.bandwidth_usage;
+    bucket = Bucket{0, 0, 0};
+  }
+
+  entry.last_tick = tick;
+}
+
+SlidingWindowTable::Bucket& SlidingWindowTable::GetBucket(Index index, long long tick) {
+  return buckets_[static_cast<std::size_t> (index) * buckets_count_ + tick % buckets_count_];
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "window_features.h"
+#include "src/apache/analyzer/detail/sessionizer/session_table.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace realtime
+{
+
+// Requests of every client are counted in a ring of buckets_count buckets,
+// bucket_length seconds each, the window ends with the bucket of the latest
+// request. At most capacity clients are tracked, the least recently seen
+// client is dropped to make place for a new one, so memory usage doesn't
+// depend on traffic.
+class SlidingWindowTable {
+ public:
+  typedef std::uint64_t Key;
+
+  static constexpr long long NEVER_REPORTED = -1;
+
+  struct Window {
+    WindowFeatures features;
+    long long last_report_time;
+  };
+
+  SlidingWindowTable(std::uint32_t capacity, long long bucket_length, unsigned buckets_count);
+
+  // Requests older than the window of the client are not counted.
+  Window& Add(Key key, long long time, bool is_error, long long bytes);
+
+  std::size_t Size() const;
+  long long GetWindowLength() const;
+
+ private:
+  typedef std::uint32_t Index;
+
+  struct Bucket {
+    std::uint32_t requests_count;
+    std::uint32_t errors_count;
+    long long bandwidth_usage;
+  };
+
+  struct Entry {
+    Key key;
+    long long last_tick;
+    Window window;
+    Index previous;
+    Index next;
+  };
+
+  Index GetEntry(Key key, long long tick);
+  void MoveToFront(Index index);
+  void Unlink(Index index);
+  void Slide(Index index, long long tick);
+
+  Bucket& GetBucket(Index index, long long tick);
+
+  const std::uint32_t capacity_;
+  const long long bucket_length_;
+  const unsigned buckets_count_;
+
+  sessionizer::SessionTable table_;
+  std::vector<Entry> entries_;
+  std::vector<Bucket> buckets_;
+  Index head_;
+  Index tail_;
+};
+
+}
+
+}
+
+}
+
+}
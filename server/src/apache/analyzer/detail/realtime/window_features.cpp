@@ -0,0 +1,54 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "window_features.h"
+
+#include <algorithm>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace realtime
+{
+
+namespace
+{
+
+double GetDeviation(double value, const ::apache::type::FeatureScale &scale) {
+  if (scale.standard_deviation <= 0.)
+    return 0.;
+
+  return std::max((value - scale.mean) / scale.standard_deviation, 0.);
+}
+
+}
+
+double GetAnomalyScore(const WindowFeatures &features,
+                       const ::apache::type::FeatureNormalization &normalization) {
+  if (features.requests_count == 0)
+    return 0.;
+
+  const double error_percentage = features.errors_count * 100. / features.requests_count;
+
+  return std::max({
+    GetDeviation(features.requests_count, normalization.requests_count),
+    GetDeviation(features.bandwidth_usage, normalization.bandwidth_usage),
+    GetDeviation(error_percentage, normalization.error_percentage)
+  });
+}
+
+}
+
+}
+
+}
+
+}
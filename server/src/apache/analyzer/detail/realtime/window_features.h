@@ -0,0 +1,41 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/apache/type/feature_normalization.h"
+#include "src/database/type/rows_count.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace realtime
+{
+
+struct WindowFeatures {
+  ::database::type::RowsCount requests_count;
+  ::database::type::RowsCount errors_count;
+  long long bandwidth_usage;
+};
+
+// Largest number of standard deviations by which the requests count,
+// bandwidth usage or error percentage is above the learning set mean.
+// Values below the mean aren't suspicious, they give 0.
+double GetAnomalyScore(const WindowFeatures &features,
+                       const ::apache::type::FeatureNormalization &normalization);
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "address.h"
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <functional>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+Address Address::Parse(const std::string &text) {
+  Address address;
+  address.bytes.fill(0);
+
+  if (inet_pton(AF_INET, text.c_str(), address.bytes.data()) == 1) {
+    address.family = Family::IPV4;
+  }
+  else if (inet_pton(AF_INET6, text.c_str(), address.bytes.data()) == 1) {
+    address.family = Family::IPV6;
+  }
+  else {
+    address.bytes.fill(0);
+    address.family = Family::TEXT;
+    address.text = text;
+  }
+
+  return address;
+}
+
+std::string Address::ToString() const {
+  char buffer[INET6_ADDRSTRLEN];
+
+  switch (family) {
+    case Family::IPV4:
+      return inet_ntop(AF_INET, bytes.data(), buffer, sizeof (buffer));
+    case Family::IPV6:
+      return inet_ntop(AF_INET6, bytes.data(), buffer, sizeof (buffer));
+    default:
+      return text;
+  }
+}
+
+bool Address::operator==(const Address &other) const {
+  return family == other.family && bytes == other.bytes && text == other.text;
+}
+
+std::size_t AddressHash::operator()(const Address &address) const {
+  if (address.family == Address::Family::TEXT)
+    return std::hash<std::string>()(address.text);
+
+  std::uint64_t high, low;
+  std::memcpy(&high, address.bytes.data(), sizeof (high));
+  std::memcpy(&low, address.bytes.data() + sizeof (high), sizeof (low));
+
+  std::uint64_t hash = high * 0x9e3779b97f4a7c15ULL ^ low ^ static_cast<std::uint64_t> (address.family);
+  hash ^= hash >> 29;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 32;
+
+  return static_cast<std::size_t> (hash);
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+// Client address in binary form. Text which isn't an IPv4 or IPv6 address
+// (e.g. a host name logged by Apache) is kept as it is.
+struct Address {
+  enum class Family : std::uint8_t {
+    TEXT,
+    IPV4,
+    IPV6
+  };
+
+  Family family;
+  std::array<std::uint8_t, 16> bytes;
+  std::string text;
+
+  static Address Parse(const std::string &text);
+  std::string ToString() const;
+
+  bool operator==(const Address &other) const;
+};
+
+struct AddressHash {
+  std::size_t operator()(const Address &address) const;
+};
+
+}
+
+}
+
+}
+
+}
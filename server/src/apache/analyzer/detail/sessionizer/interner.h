@@ -0,0 +1,98 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+// Maps values to small integer ids. Ids are reference counted, an id is
+// reused when its last reference is released.
+template <typename Key, typename Hash = std::hash<Key>>
+class Interner {
+ public:
+  typedef std::uint32_t Id;
+
+  static constexpr Id NOT_FOUND = 0xffffffff;
+
+  Id Find(const Key &key) const {
+    auto it = ids_.find(key);
+    return (it == ids_.end()) ? NOT_FOUND : it->second;
+  }
+
+  Id Acquire(const Key &key) {
+    auto it = ids_.find(key);
+    if (it != ids_.end()) {
+      ++references_[it->second];
+      return it->second;
+    }
+
+    Id id;
+    if (free_ids_.empty()) {
+      id = static_cast<Id> (keys_.size());
+      keys_.push_back(nullptr);
+      references_.push_back(0);
+    }
+    else {
+      id = free_ids_.back();
+      free_ids_.pop_back();
+    }
+
+    // keys of unordered_map nodes don't move, the map holds the only copy
+    it = ids_.emplace(key, id).first;
+    keys_[id] = &it->first;
+    references_[id] = 1;
+
+    return id;
+  }
+
+  void Release(Id id) {
+    if (--references_[id] > 0)
+      return;
+
+    ids_.erase(*keys_[id]);
+    keys_[id] = nullptr;
+    free_ids_.push_back(id);
+  }
+
+  const Key& Get(Id id) const {
+    return *keys_[id];
+  }
+
+  std::size_t Size() const {
+    return ids_.size();
+  }
+
+ private:
+  std::unordered_map<Key, Id, Hash> ids_;
+  std::vector<const Key*> keys_;
+  std::vector<std::uint32_t> references_;
+  std::vector<Id> free_ids_;
+};
+
+template <typename Key, typename Hash>
+constexpr typename Interner<Key, Hash>::Id Interner<Key, Hash>::NOT_FOUND;
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "session_pool.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+constexpr unsigned SessionPool::BLOCK_BITS;
+constexpr SessionPool::Index SessionPool::BLOCK_SIZE;
+
+SessionPool::SessionPool() :
+capacity_(0) {
+}
+
+SessionPool::Index SessionPool::Allocate() {
+  Index index;
+
+  if (free_indexes_.empty()) {
+    if (capacity_ % BLOCK_SIZE == 0)
+      blocks_.emplace_back(new OpenSession[BLOCK_SIZE]);
+
+    index = capacity_++;
+    is_used_.push_back(true);
+  }
+  else {
+    index = free_indexes_.back();
+    free_indexes_.pop_back();
+    is_used_[index] = true;
+  }
+
+  return index;
+}
+
+void SessionPool::Free(Index index) {
+  is_used_[index] = false;
+  free_indexes_.push_back(index);
+}
+
+OpenSession& SessionPool::operator[](Index index) {
+  return blocks_[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+}
+
+const OpenSession& SessionPool::operator[](Index index) const {
+  return blocks_[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+}
+
+bool SessionPool::IsUsed(Index index) const {
+  return is_used_[index];
+}
+
+SessionPool::Index SessionPool::Capacity() const {
+  return capacity_;
+}
+
+std::size_t SessionPool::Size() const {
+  return capacity_ - free_indexes_.size();
+}
+
+}
+
+}
+
+}
+
+}
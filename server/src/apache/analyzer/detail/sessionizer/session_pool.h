@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "src/database/type/rows_count.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+struct OpenSession {
+  std::uint32_t scope_id;
+  std::uint32_t client_ip_id;
+  std::uint32_t user_agent_id;
+  long long start;
+  long long expiry;
+  long long session_length;
+  long long bandwidth_usage;
+  ::database::type::RowsCount requests_count;
+  ::database::type::RowsCount errors_count;
+};
+
+// Open sessions are stored in fixed size blocks, blocks are never freed
+// and free entries are reused, so sessions don't move and memory isn't
+// reallocated when the number of open sessions changes.
+class SessionPool {
+ public:
+  typedef std::uint32_t Index;
+
+  SessionPool();
+
+  Index Allocate();
+  void Free(Index index);
+
+  OpenSession& operator[](Index index);
+  const OpenSession& operator[](Index index) const;
+
+  bool IsUsed(Index index) const;
+
+  // Number of entries ever allocated, used or not.
+  Index Capacity() const;
+  std::size_t Size() const;
+
+ private:
+  static constexpr unsigned BLOCK_BITS = 12;
+  static constexpr Index BLOCK_SIZE = 1u << BLOCK_BITS;
+
+  std::vector<std::unique_ptr<OpenSession[]>> blocks_;
+  std::vector<bool> is_used_;
+  std::vector<Index> free_indexes_;
+  Index capacity_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "session_table.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+namespace
+{
+
+constexpr std::size_t INITIAL_CAPACITY = 16;
+
+}
+
+constexpr SessionTable::Value SessionTable::NOT_FOUND;
+
+SessionTable::SessionTable() :
+slots_(INITIAL_CAPACITY, Slot{0, NOT_FOUND}),
+mask_(INITIAL_CAPACITY - 1),
+size_(0) {
+}
+
+SessionTable::Value SessionTable::Find(Key key) const {
+  for (std::size_t i = Hash(key) & mask_; slots_[i].value != NOT_FOUND; i = (i + 1) & mask_) {
+    if (slots_[i].key == key)
+      return slots_[i].value;
+  }
+
+  return NOT_FOUND;
+}
+
+void SessionTable::Insert(Key key, Value value) {
+  // load factor is kept below 0.7
+  if ((size_ + 1) * 10 > slots_.size() * 7)
+    Grow();
+
+  Place(key, value);
+  ++size_;
+}
+
+void SessionTable::Erase(Key key) {
+  std::size_t i = Hash(key) & mask_;
+  while (slots_[i].value != NOT_FOUND && slots_[i].key != key)
+    i = (i + 1) & mask_;
+
+  if (slots_[i].value == NOT_FOUND)
+    return;
+
+  // entries placed after the erased one are moved back, unless their home
+  // slot lies between the hole and their current position
+  for (std::size_t j = (i + 1) & mask_; slots_[j].value != NOT_FOUND; j = (j + 1) & mask_) {
+    const std::size_t home = Hash(slots_[j].key) & mask_;
+    const bool can_move = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+
+    if (can_move) {
+      slots_[i] = slots_[j];
+      i = j;
+    }
+  }
+
+  slots_[i].value = NOT_FOUND;
+  --size_;
+}
+
+std::size_t SessionTable::Size() const {
+  return size_;
+}
+
+std::size_t SessionTable::Hash(Key key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+
+  return static_cast<std::size_t> (key);
+}
+
+void SessionTable::Grow() {
+  std::vector<Slot> old_slots(slots_.size() * 2, Slot{0, NOT_FOUND});
+  old_slots.swap(slots_);
+  mask_ = slots_.size() - 1;
+
+  for (const auto &slot : old_slots) {
+    if (slot.value != NOT_FOUND)
+      Place(slot.key, slot.value);
+  }
+}
+
+void SessionTable::Place(Key key, Value value) {
+  std::size_t i = Hash(key) & mask_;
+  while (slots_[i].value != NOT_FOUND)
+    i = (i + 1) & mask_;
+
+  slots_[i] = Slot{key, value};
+}
+
+}
+
+}
+
+}
+
+}
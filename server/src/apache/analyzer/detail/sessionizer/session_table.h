@@ -0,0 +1,67 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+// Open addressing hash map from 64-bit session keys to session pool
+// indexes. Collisions are resolved with linear probing, erased slots are
+// filled by shifting the following entries back, so there are no
+// tombstones.
+class SessionTable {
+ public:
+  typedef std::uint64_t Key;
+  typedef std::uint32_t Value;
+
+  static constexpr Value NOT_FOUND = 0xffffffff;
+
+  SessionTable();
+
+  Value Find(Key key) const;
+
+  // The key must not be in the table.
+  void Insert(Key key, Value value);
+  void Erase(Key key);
+
+  std::size_t Size() const;
+
+ private:
+  // value NOT_FOUND marks an empty slot
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  static std::size_t Hash(Key key);
+
+  void Grow();
+  void Place(Key key, Value value);
+
+  std::vector<Slot> slots_;
+  std::size_t mask_;
+  std::size_t size_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "sessionizer.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+
+#include "src/apache/analyzer/detail/session_length.h"
+
+using namespace ::apache::type;
+using namespace ::type;
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+namespace
+{
+
+constexpr std::size_t TIMER_WHEEL_SLOTS = 64;
+constexpr Sessionizer::Seconds TIMER_WHEEL_SLOT_LENGTH = 60;
+constexpr Sessionizer::Seconds DAY_LENGTH = 24 * 3600;
+
+}
+
+SessionizerPtr Sessionizer::Create() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::sessionizer::Sessionizer::Create: Function call";
+
+  return SessionizerPtr(new Sessionizer());
+}
+
+void Sessionizer::Add(const ApacheLogEntry &log_entry) {
+  const Seconds log_time = ToSeconds(log_entry.time);
+  const Id scope_id = GetScopeId(log_entry.agent_name, log_entry.virtualhost);
+  const Address client_ip = Address::Parse(log_entry.client_ip);
+
+  latest_log_time_ = std::max(latest_log_time_, log_time);
+
+  const Id client_ip_id = client_ips_.Find(client_ip);
+  const Id user_agent_id = (client_ip_id == Interner<Address, AddressHash>::NOT_FOUND) ?
+      Interner<std::string>::NOT_FOUND : user_agents_.Find(log_entry.user_agent);
+
+  if (user_agent_id != Interner<std::string>::NOT_FOUND) {
+    const SessionPool::Index index = sessions_[scope_id].Find(GetKey(client_ip_id, user_agent_id));
+
+    if (index != SessionTable::NOT_FOUND) {
+      OpenSession &session = pool_[index];
+      const Seconds day_start = session.start - session.start % DAY_LENGTH;
+
+      if (log_time >= day_start && log_time < session.expiry && session.start - log_time < SESSION_LENGTH) {
+        session.bandwidth_usage += log_entry.bytes;
+        session.errors_count += static_cast<int> (IsErrorCode(log_entry.status_code));
+        session.requests_count += 1;
+        session.session_length = (log_time > session.start) ? log_time - session.start : session.start - log_time;
+        return;
+      }
+
+      BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::sessionizer::Sessionizer::Add: Log doesn't fit into the open session, closing it";
+      Close(index);
+    }
+  }
+
+  OpenSession session;
+  session.start = log_time;
+  session.session_length = 0;
+  session.bandwidth_usage = log_entry.bytes;
+  session.requests_count = 1;
+  session.errors_count = static_cast<int> (IsErrorCode(log_entry.status_code));
+
+  Open(scope_id, client_ip, log_entry.user_agent, session);
+}
+
+void Sessionizer::CloseExpiredSessions(Seconds now) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::sessionizer::Sessionizer::CloseExpiredSessions: Function call";
+
+  timers_.Advance(now, [this](SessionPool::Index index, Seconds expiry) {
+    // timer of a session which was already closed, the entry may be used
+    // by another session
+    if (!pool_.IsUsed(index) || pool_[index].expiry != expiry)
+      return;
+
+    Close(index);
+  });
+}
+
+const ApacheSessions& Sessionizer::GetClosedSessions() const {
+  return closed_sessions_;
+}
+
+void Sessionizer::ClearClosedSessions() {
+  closed_sessions_.clear();
+}
+
+ApacheSessions Sessionizer::GetOpenSessions() const {
+  ApacheSessions sessions;
+  sessions.reserve(pool_.Size());
+
+  for (SessionPool::Index index = 0; index < pool_.Capacity(); ++index) {
+    if (pool_.IsUsed(index))
+      sessions.push_back(ToSessionEntry(pool_[index]));
+  }
+
+  return sessions;
+}
+
+std::size_t Sessionizer::GetOpenSessionsCount() const {
+  return pool_.Size();
+}
+
+void Sessionizer::RestoreOpenSessions(const ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::detail::sessionizer::Sessionizer::RestoreOpenSessions: Restoring " << sessions.size() << " sessions";
+
+  for (const auto &entry : sessions) {
+    const Id scope_id = GetScopeId(entry.agent_name, entry.virtualhost);
+    const Address client_ip = Address::Parse(entry.client_ip);
+
+    const Id client_ip_id = client_ips_.Find(client_ip);
+    const Id user_agent_id = user_agents_.Find(entry.useragent);
+    if (client_ip_id != Interner<Address, AddressHash>::NOT_FOUND && user_agent_id != Interner<std::string>::NOT_FOUND &&
+        sessions_[scope_id].Find(GetKey(client_ip_id, user_agent_id)) != SessionTable::NOT_FOUND) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::analyzer::detail::sessionizer::Sessionizer::RestoreOpenSessions: Skipping duplicated session";
+      continue;
+    }
+
+    OpenSession session;
+    session.start = ToSeconds(entry.session_start);
+    session.session_length = entry.session_length;
+    session.bandwidth_usage = entry.bandwidth_usage;
+    session.requests_count = entry.requests_count;
+    session.errors_count = entry.errors_count;
+
+    Open(scope_id, client_ip, entry.useragent, session);
+
+    latest_log_time_ = std::max(latest_log_time_, session.start + session.session_length);
+  }
+}
+
+Sessionizer::Seconds Sessionizer::GetLatestLogTime() const {
+  return latest_log_time_;
+}
+
+Sessionizer::Seconds Sessionizer::ToSeconds(const Timestamp &timestamp) {
+  // days from 1970-01-01 in the proleptic gregorian calendar
+  const Date &date = timestamp.GetDate();
+  const Time &time = timestamp.GetTime();
+
+  const long long month = date.GetMonth();
+  const long long year = date.GetYear() - (month <= 2);
+  const long long era = (year >= 0 ? year : year - 399) / 400;
+  const long long year_of_era = year - era * 400;
+  const long long day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + date.GetDay() - 1;
+  const long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  const long long days = era * 146097 + day_of_era - 719468;
+
+  return days * DAY_LENGTH + time.GetHour() * 3600 + time.GetMinute() * 60 + time.GetSecond();
+}
+
+Sessionizer::Sessionizer() :
+timers_(TIMER_WHEEL_SLOTS, TIMER_WHEEL_SLOT_LENGTH),
+latest_log_time_(-1) {
+}
+
+Sessionizer::Id Sessionizer::GetScopeId(const std::string &agent_name, const std::string &virtualhost) {
+  Id agent_name_id = agent_names_.Find(agent_name);
+  Id virtualhost_id = virtualhosts_.Find(virtualhost);
+
+  // names of agents and virtualhosts are never released, there are few of them
+  if (agent_name_id == Interner<std::string>::NOT_FOUND)
+    agent_name_id = agent_names_.Acquire(agent_name);
+  if (virtualhost_id == Interner<std::string>::NOT_FOUND)
+    virtualhost_id = virtualhosts_.Acquire(virtualhost);
+
+  const std::uint64_t names = (static_cast<std::uint64_t> (agent_name_id) << 32) | virtualhost_id;
+  auto it = scope_ids_.find(names);
+  if (it != scope_ids_.end())
+    return it->second;
+
+  const Id scope_id = static_cast<Id> (scopes_.size());
+  scope_ids_.emplace(names, scope_id);
+  scopes_.push_back(std::make_pair(agent_name_id, virtualhost_id));
+  sessions_.emplace_back();
+
+  return scope_id;
+}
+
+SessionTable::Key Sessionizer::GetKey(Id client_ip_id, Id user_agent_id) {
+  return (static_cast<SessionTable::Key> (client_ip_id) << 32) | user_agent_id;
+}
+
+void Sessionizer::Open(Id scope_id, const Address &client_ip, const std::string &user_agent, const OpenSession &session) {
+  const SessionPool::Index index = pool_.Allocate();
+  OpenSession &open_session = pool_[index];
+
+  open_session = session;
+  open_session.scope_id = scope_id;
+  open_session.client_ip_id = client_ips_.Acquire(client_ip);
+  open_session.user_agent_id = user_agents_.Acquire(user_agent);
+
+  // the last second a log still fits into the session is expiry - 1
+  const Seconds next_day = session.start - session.start % DAY_LENGTH + DAY_LENGTH;
+  open_session.expiry = std::min(session.start + SESSION_LENGTH, next_day);
+
+  sessions_[scope_id].Insert(GetKey(open_session.client_ip_id, open_session.user_agent_id), index);
+  timers_.Add(index, open_session.expiry);
+}
+
+void Sessionizer::Close(SessionPool::Index index) {
+  const OpenSession &session = pool_[index];
+
+  closed_sessions_.push_back(ToSessionEntry(session));
+
+  sessions_[session.scope_id].Erase(GetKey(session.client_ip_id, session.user_agent_id));
+  client_ips_.Release(session.client_ip_id);
+  user_agents_.Release(session.user_agent_id);
+  pool_.Free(index);
+}
+
+ApacheSessionEntry Sessionizer::ToSessionEntry(const OpenSession &session) const {
+  ApacheSessionEntry entry;
+
+  entry.id = -1;
+  entry.agent_name = agent_names_.Get(scopes_[session.scope_id].first);
+  entry.virtualhost = virtualhosts_.Get(scopes_[session.scope_id].second);
+  entry.client_ip = client_ips_.Get(session.client_ip_id).ToString();
+  entry.session_start = FromSeconds(session.start);
+  entry.session_length = session.session_length;
+  entry.bandwidth_usage = session.bandwidth_usage;
+  entry.requests_count = session.requests_count;
+  entry.errors_count = session.errors_count;
+  entry.error_percentage = session.errors_count * 100. / session.requests_count;
+  entry.useragent = user_agents_.Get(session.user_agent_id);
+  entry.classification = ::database::type::Classification::UNKNOWN;
+
+  return entry;
+}
+
+Timestamp Sessionizer::FromSeconds(Seconds seconds) {
+  // inverse of ToSeconds
+  const long long days = seconds / DAY_LENGTH - (seconds % DAY_LENGTH < 0);
+  const long long time_of_day = seconds - days * DAY_LENGTH;
+
+  const long long shifted_days = days + 719468;
+  const long long era = (shifted_days >= 0 ? shifted_days : shifted_days - 146096) / 146097;
+  const long long day_of_era = shifted_days - era * 146097;
+  const long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  const long long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const long long mp = (5 * day_of_year + 2) / 153;
+  const long long day = day_of_year - (153 * mp + 2) / 5 + 1;
+  const long long month = mp < 10 ? mp + 3 : mp - 9;
+  const long long year = year_of_era + era * 400 + (month <= 2);
+
+  Timestamp timestamp;
+  timestamp.Set(time_of_day / 3600, time_of_day / 60 % 60, time_of_day % 60, day, month, year);
+
+  return timestamp;
+}
+
+bool Sessionizer::IsErrorCode(int status_code) {
+  return (status_code >= 400) && (status_code <= 511);
+}
+
+}
+
+}
+
+}
+
+}
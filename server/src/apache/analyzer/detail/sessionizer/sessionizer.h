@@ -0,0 +1,111 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <slas/type/apache_log_entry.h>
+#include <slas/type/timestamp.h>
+
+#include "address.h"
+#include "interner.h"
+#include "session_pool.h"
+#include "session_table.h"
+#include "timer_wheel.h"
+#include "src/apache/type/apache_session_entry.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+class Sessionizer;
+typedef std::shared_ptr<Sessionizer> SessionizerPtr;
+
+// Builds sessions from logs as they arrive. A session is identified by
+// agent, virtualhost, client ip and user agent, it lasts at most
+// SESSION_LENGTH seconds and doesn't cross midnight. Sessions are closed
+// when a log doesn't fit into them or when their timer expires.
+//
+// Names are interned, open sessions are found by a 64-bit key built from
+// client ip and user agent ids in the table of their agent and virtualhost.
+class Sessionizer {
+ public:
+  typedef long long Seconds;
+
+  virtual ~Sessionizer() = default;
+
+  static SessionizerPtr Create();
+
+  void Add(const ::type::ApacheLogEntry &log_entry);
+
+  // Closes sessions which can't get any new log at the time now.
+  void CloseExpiredSessions(Seconds now);
+
+  const ::apache::type::ApacheSessions& GetClosedSessions() const;
+  void ClearClosedSessions();
+
+  ::apache::type::ApacheSessions GetOpenSessions() const;
+  std::size_t GetOpenSessionsCount() const;
+  void RestoreOpenSessions(const ::apache::type::ApacheSessions &sessions);
+
+  // Time of the newest log seen (restored sessions included), -1 before
+  // the first one.
+  Seconds GetLatestLogTime() const;
+
+  static Seconds ToSeconds(const ::type::Timestamp &timestamp);
+  static bool IsErrorCode(int status_code);
+
+ private:
+  typedef std::uint32_t Id;
+
+  Sessionizer();
+
+  Id GetScopeId(const std::string &agent_name, const std::string &virtualhost);
+  static SessionTable::Key GetKey(Id client_ip_id, Id user_agent_id);
+
+  void Open(Id scope_id, const Address &client_ip, const std::string &user_agent, const OpenSession &session);
+  void Close(SessionPool::Index index);
+  ::apache::type::ApacheSessionEntry ToSessionEntry(const OpenSession &session) const;
+
+  static ::type::Timestamp FromSeconds(Seconds seconds);
+
+  Interner<std::string> agent_names_;
+  Interner<std::string> virtualhosts_;
+  Interner<std::string> user_agents_;
+  Interner<Address, AddressHash> client_ips_;
+
+  // agent name and virtualhost ids pair -> scope id, every scope has its
+  // own sessions table
+  std::unordered_map<std::uint64_t, Id> scope_ids_;
+  std::vector<std::pair<Id, Id>> scopes_;
+  std::vector<SessionTable> sessions_;
+
+  SessionPool pool_;
+  TimerWheel<SessionPool::Index> timers_;
+  ::apache::type::ApacheSessions closed_sessions_;
+  Seconds latest_log_time_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace sessionizer
+{
+
+// Hashed timer wheel - timers are kept in slots of slot_length seconds,
+// a timer expiring more than one turn of the wheel ahead waits in its slot
+// until its turn comes. Adding a timer and advancing by one slot don't
+// depend on the number of timers.
+template <typename Key>
+class TimerWheel {
+ public:
+  typedef long long Seconds;
+
+  TimerWheel(std::size_t slots_count, Seconds slot_length) :
+  slots_(slots_count),
+  slot_length_(slot_length),
+  current_tick_(NOT_STARTED),
+  timers_count_(0) {
+  }
+
+  // Timers which already expired fire on the next Advance call.
+  void Add(const Key &key, Seconds expiry) {
+    Seconds tick = expiry / slot_length_;
+    if (current_tick_ != NOT_STARTED && tick < current_tick_)
+      tick = current_tick_;
+
+    slots_[tick % slots_.size()].push_back(Timer{key, expiry});
+    ++timers_count_;
+  }
+
+  // Calls f(key, expiry) for every timer with expiry <= now.
+  template <typename Function>
+  void Advance(Seconds now, Function f) {
+    const Seconds now_tick = now / slot_length_;
+
+    if (current_tick_ == NOT_STARTED || now_tick - current_tick_ >= static_cast<Seconds> (slots_.size())) {
+      for (std::size_t i = 0; i < slots_.size(); ++i)
+        FireExpired(slots_[i], now, f);
+    }
+    else {
+      for (Seconds tick = current_tick_; tick <= now_tick; ++tick)
+        FireExpired(slots_[tick % slots_.size()], now, f);
+    }
+
+    current_tick_ = now_tick;
+  }
+
+  std::size_t Size() const {
+    return timers_count_;
+  }
+
+ private:
+  struct Timer {
+    Key key;
+    Seconds expiry;
+  };
+
+  static constexpr Seconds NOT_STARTED = -1;
+
+  template <typename Function>
+  void FireExpired(std::vector<Timer> &slot, Seconds now, Function &f) {
+    std::size_t kept = 0;
+
+    for (std::size_t i = 0; i < slot.size(); ++i) {
+      if (slot[i].expiry <= now) {
+        f(slot[i].key, slot[i].expiry);
+        --timers_count_;
+      }
+      else {
+        if (kept != i)
+          slot[kept] = std::move(slot[i]);
+        ++kept;
+      }
+    }
+
+    slot.resize(kept);
+  }
+
+  std::vector<std::vector<Timer>> slots_;
+  const Seconds slot_length_;
+  Seconds current_tick_;
+  std::size_t timers_count_;
+};
+
+template <typename Key>
+constexpr typename TimerWheel<Key>::Seconds TimerWheel<Key>::NOT_STARTED;
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "realtime_scorer.h"
+
+#include <boost/log/trivial.hpp>
+
+#include "detail/sessionizer/address.h"
+#include "detail/sessionizer/sessionizer.h"
+#include "src/apache/notifier/type/apache_realtime_notifier_message.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+constexpr std::uint32_t RealtimeScorer::CLIENTS_COUNT;
+constexpr long long RealtimeScorer::BUCKET_LENGTH;
+constexpr unsigned RealtimeScorer::BUCKETS_COUNT;
+constexpr std::chrono::seconds RealtimeScorer::REFRESH_INTERVAL;
+
+RealtimeScorerPtr RealtimeScorer::Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                                         ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                                         ::notifier::detail::NotifierInterfacePtr notifier) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::RealtimeScorer::Create: Function call";
+
+  return RealtimeScorerPtr(new RealtimeScorer(general_database_functions, apache_database_functions, notifier));
+}
+
+void RealtimeScorer::AddLogs(const ::type::ApacheLogs &log_entries) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::RealtimeScorer::AddLogs: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  type::RealtimeAlerts alerts;
+
+  for (const auto &log_entry : log_entries) {
+    const auto scope_id = GetScopeId(log_entry.agent_name, log_entry.virtualhost);
+    const Scope &scope = scopes_[scope_id];
+
+    if (!scope.configuration.enabled || scope.normalization.learning_set_version < 0)
+      continue;
+
+    const long long time = detail::sessionizer::Sessionizer::ToSeconds(log_entry.time);
+    auto &window = windows_.Add(GetKey(scope_id, log_entry.client_ip), time,
+                                detail::sessionizer::Sessionizer::IsErrorCode(log_entry.status_code),
+                                log_entry.bytes);
+    const auto &features = window.features;
+
+    if (features.requests_count < scope.configuration.min_requests)
+      continue;
+
+    if (window.last_report_time != detail::realtime::SlidingWindowTable::NEVER_REPORTED
+        && time - window.last_report_time < windows_.GetWindowLength())
+      continue;
+
+    const double score = detail::realtime::GetAnomalyScore(features, scope.normalization);
+    if (score < scope.configuration.threshold)
+      continue;
+
+    window.last_report_time = time;
+
+    type::RealtimeAlert alert;
+    alert.agent_name = log_entry.agent_name;
+    alert.virtualhost_name = log_entry.virtualhost;
+    alert.client_ip = log_entry.client_ip;
+    alert.time = log_entry.time;
+    alert.window_length = windows_.GetWindowLength();
+    alert.requests_count = features.requests_count;
+    alert.bandwidth_usage = features.bandwidth_usage;
+    alert.error_percentage = features.errors_count * 100. / features.requests_count;
+    alert.score = score;
+
+    alerts.push_back(alert);
+  }
+
+  if (!alerts.empty()) {
+    BOOST_LOG_TRIVIAL(info) << "apache::analyzer::RealtimeScorer::AddLogs: Reporting " << alerts.size() << " suspicious clients";
+    notifier_->AddMessages({::apache::notifier::type::ApacheRealtimeNotifierMessage::Create(alerts)});
+  }
+}
+
+RealtimeScorer::RealtimeScorer(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                               ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                               ::notifier::detail::NotifierInterfacePtr notifier) :
+general_database_functions_(general_database_functions),
+apache_database_functions_(apache_database_functions),
+notifier_(notifier),
+windows_(CLIENTS_COUNT, BUCKET_LENGTH, BUCKETS_COUNT) {
+}
+
+std::uint32_t RealtimeScorer::GetScopeId(const std::string &agent_name, const std::string &virtualhost_name) {
+  const auto key = std::make_pair(agent_name, virtualhost_name);
+  auto it = scope_ids_.find(key);
+
+  if (it == scope_ids_.end()) {
+    it = scope_ids_.insert(std::make_pair(key, static_cast<std::uint32_t> (scopes_.size()))).first;
+    scopes_.push_back(Scope());
+    Refresh(agent_name, virtualhost_name, scopes_.back());
+  }
+  else if (std::chrono::steady_clock::now() - scopes_[it->second].refresh_time >= REFRESH_INTERVAL) {
+    Refresh(agent_name, virtualhost_name, scopes_[it->second]);
+  }
+
+  return it->second;
+}
+
+void RealtimeScorer::Refresh(const std::string &agent_name, const std::string &virtualhost_name, Scope &scope) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::RealtimeScorer::Refresh: Function call";
+
+  scope.configuration = apache_database_functions_->GetRealtimeScoringConfiguration(agent_name, virtualhost_name);
+  scope.normalization.learning_set_version = -1;
+
+  if (scope.configuration.enabled) {
+    const auto agent_name_id = general_database_functions_->GetAgentNameId(agent_name);
+    const auto virtualhost_name_id = apache_database_functions_->GetVirtualhostNameId(virtualhost_name);
+    scope.normalization = apache_database_functions_->GetFeatureNormalization(agent_name_id, virtualhost_name_id);
+  }
+
+  scope.refresh_time = std::chrono::steady_clock::now();
+}
+
+detail::realtime::SlidingWindowTable::Key RealtimeScorer::GetKey(std::uint32_t scope_id, const std::string &client_ip) {
+  // different addresses may get the same key, with 64-bit keys it is too
+  // rare to matter for alerts
+  const std::uint64_t address_hash = detail::sessionizer::AddressHash()(detail::sessionizer::Address::Parse(client_ip));
+
+  return address_hash ^ (static_cast<std::uint64_t> (scope_id) * 0x9e3779b97f4a7c15ULL);
+}
+
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <slas/type/apache_log_entry.h>
+
+#include "detail/realtime/sliding_window_table.h"
+#include "type/realtime_alert.h"
+#include "src/apache/database/detail/database_functions_interface.h"
+#include "src/apache/type/feature_normalization.h"
+#include "src/apache/type/realtime_scoring_configuration.h"
+#include "src/database/detail/general_database_functions_interface.h"
+#include "src/notifier/detail/notifier_interface.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+class RealtimeScorer;
+typedef std::shared_ptr<RealtimeScorer> RealtimeScorerPtr;
+
+// Scores clients while logs are received, for virtualhosts with realtime
+// scoring enabled. Requests, errors and bytes sent by every client in the
+// last SESSION_LENGTH seconds are compared with the feature normalization
+// of the current learning set and suspicious clients are reported by the
+// notifier, at most once per window. Sessions are still classified by the
+// KNN analyzer, alerts aren't saved.
+class RealtimeScorer {
+ public:
+  virtual ~RealtimeScorer() = default;
+
+  static RealtimeScorerPtr Create(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                                  ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                                  ::notifier::detail::NotifierInterfacePtr notifier);
+
+  void AddLogs(const ::type::ApacheLogs &log_entries);
+
+  static constexpr std::uint32_t CLIENTS_COUNT = 65536;
+  static constexpr long long BUCKET_LENGTH = 300;
+  static constexpr unsigned BUCKETS_COUNT = 12;
+  static constexpr std::chrono::seconds REFRESH_INTERVAL{60};
+
+ private:
+  struct Scope {
+    ::apache::type::RealtimeScoringConfiguration configuration;
+    ::apache::type::FeatureNormalization normalization;
+    std::chrono::steady_clock::time_point refresh_time;
+  };
+
+  RealtimeScorer(::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                 ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                 ::notifier::detail::NotifierInterfacePtr notifier);
+
+  std::uint32_t GetScopeId(const std::string &agent_name, const std::string &virtualhost_name);
+  void Refresh(const std::string &agent_name, const std::string &virtualhost_name, Scope &scope);
+
+  static detail::realtime::SlidingWindowTable::Key GetKey(std::uint32_t scope_id, const std::string &client_ip);
+
+  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
+  ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions_;
+  ::notifier::detail::NotifierInterfacePtr notifier_;
+
+  // configuration and normalization are read again every REFRESH_INTERVAL
+  std::map<std::pair<std::string, std::string>, std::uint32_t> scope_ids_;
+  std::vector<Scope> scopes_;
+
+  detail::realtime::SlidingWindowTable windows_;
+  std::mutex mutex_;
+};
+
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "sessionizer_analyzer_object.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+const std::string SessionizerAnalyzerObject::NAME = "apache_sessionizer";
+
+SessionizerAnalyzerObjectPtr SessionizerAnalyzerObject::Create(StreamingSessionizerPtr sessionizer,
+                                                               ::analyzer::StageMetricsPtr stage_metrics) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::SessionizerAnalyzerObject::Create: Function call";
+
+  return SessionizerAnalyzerObjectPtr(new SessionizerAnalyzerObject(sessionizer, stage_metrics));
+}
+
+void SessionizerAnalyzerObject::Analyze() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::SessionizerAnalyzerObject::Analyze: Function call";
+
+  ::analyzer::StageRecorder recorder(stage_metrics_, "apache.sessionization");
+  sessionizer_->Flush();
+}
+
+::analyzer::type::Schedule SessionizerAnalyzerObject::GetSchedule() const {
+  return {NAME, StreamingSessionizer::CHECKPOINT_INTERVAL, 0, {}};
+}
+
+SessionizerAnalyzerObject::SessionizerAnalyzerObject(StreamingSessionizerPtr sessionizer,
+                                                     ::analyzer::StageMetricsPtr stage_metrics) :
+sessionizer_(sessionizer),
+stage_metrics_(stage_metrics) {
+}
+
+}
+
+}
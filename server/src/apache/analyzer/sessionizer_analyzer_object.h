@@ -0,0 +1,50 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/analyzer/analyzer_object_interface.h"
+
+#include <memory>
+#include <string>
+
+#include "src/analyzer/stage_metrics.h"
+#include "streaming_sessionizer.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+class SessionizerAnalyzerObject;
+typedef std::shared_ptr<SessionizerAnalyzerObject> SessionizerAnalyzerObjectPtr;
+
+// Closes expired sessions and saves the sessionizer checkpoint every
+// CHECKPOINT_INTERVAL, independently of the hourly KNN analysis.
+class SessionizerAnalyzerObject : public ::analyzer::AnalyzerObjectInterface {
+ public:
+  virtual ~SessionizerAnalyzerObject() = default;
+
+  static SessionizerAnalyzerObjectPtr Create(StreamingSessionizerPtr sessionizer,
+                                             ::analyzer::StageMetricsPtr stage_metrics);
+
+  void Analyze() override;
+
+  ::analyzer::type::Schedule GetSchedule() const override;
+
+  static const std::string NAME;
+
+ private:
+  SessionizerAnalyzerObject(StreamingSessionizerPtr sessionizer,
+                            ::analyzer::StageMetricsPtr stage_metrics);
+
+  StreamingSessionizerPtr sessionizer_;
+  ::analyzer::StageMetricsPtr stage_metrics_;
+};
+
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "streaming_sessionizer.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+constexpr std::chrono::seconds StreamingSessionizer::CHECKPOINT_INTERVAL;
+
+StreamingSessionizerPtr StreamingSessionizer::Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::StreamingSessionizer::Create: Function call";
+
+  return StreamingSessionizerPtr(new StreamingSessionizer(database_functions));
+}
+
+void StreamingSessionizer::AddLogs(const ::type::ApacheLogs &log_entries) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::StreamingSessionizer::AddLogs: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  database_functions_->AddLogs(log_entries);
+  last_log_id_ = database_functions_->GetLastLogId();
+
+  for (const auto &log_entry : log_entries)
+    sessionizer_->Add(log_entry);
+
+  last_log_arrival_ = std::chrono::steady_clock::now();
+  is_changed_ = true;
+}
+
+void StreamingSessionizer::Flush() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::StreamingSessionizer::Flush: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto now = std::chrono::steady_clock::now();
+  const auto latest_log_time = sessionizer_->GetLatestLogTime();
+  if (latest_log_time >= 0) {
+    const auto idle_time = std::chrono::duration_cast<std::chrono::seconds>(now - last_log_arrival_).count();
+    sessionizer_->CloseExpiredSessions(latest_log_time + idle_time);
+  }
+
+  if (is_changed_ || !sessionizer_->GetClosedSessions().empty()) {
+    ::apache::type::SessionizerCheckpoint checkpoint;
+    checkpoint.last_log_id = last_log_id_;
+    checkpoint.open_sessions = sessionizer_->GetOpenSessions();
+
+    const auto &closed_sessions = sessionizer_->GetClosedSessions();
+    BOOST_LOG_TRIVIAL(info) << "apache::analyzer::StreamingSessionizer::Flush: Saving " << closed_sessions.size()
+        << " closed sessions and " << checkpoint.open_sessions.size() << " open sessions";
+
+    database_functions_->SaveSessionizerCheckpoint(closed_sessions, checkpoint);
+    sessionizer_->ClearClosedSessions();
+    is_changed_ = false;
+  }
+}
+
+void StreamingSessionizer::Restore() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::StreamingSessionizer::Restore: Function call";
+  constexpr unsigned MAX_ROWS_IN_MEMORY = 10000;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto checkpoint = database_functions_->GetSessionizerCheckpoint();
+  sessionizer_->RestoreOpenSessions(checkpoint.open_sessions);
+  last_log_id_ = checkpoint.last_log_id;
+
+  ::type::ApacheLogs logs;
+  do {
+    logs = database_functions_->GetLogsAfter(last_log_id_, MAX_ROWS_IN_MEMORY);
+
+    for (const auto &log_entry : logs)
+      sessionizer_->Add(log_entry);
+
+    if (!logs.empty()) {
+      last_log_id_ = logs.back().id;
+      is_changed_ = true;
+    }
+
+    // sessions which ended before the newest replayed log are closed, so
+    // a long backlog doesn't stay in memory
+    if (sessionizer_->GetLatestLogTime() >= 0)
+      sessionizer_->CloseExpiredSessions(sessionizer_->GetLatestLogTime());
+  }
+  while (logs.size() == MAX_ROWS_IN_MEMORY);
+
+  BOOST_LOG_TRIVIAL(info) << "apache::analyzer::StreamingSessionizer::Restore: Restored " << sessionizer_->GetOpenSessionsCount()
+      << " open sessions, last log id: " << last_log_id_;
+
+  last_log_arrival_ = std::chrono::steady_clock::now();
+}
+
+StreamingSessionizer::StreamingSessionizer(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) :
+database_functions_(database_functions),
+sessionizer_(detail::sessionizer::Sessionizer::Create()),
+last_log_id_(0),
+last_log_arrival_(std::chrono::steady_clock::now()),
+is_changed_(false) {
+}
+
+}
+
+}
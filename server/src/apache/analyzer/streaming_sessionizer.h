@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include <slas/type/apache_log_entry.h>
+
+#include "detail/sessionizer/sessionizer.h"
+#include "src/apache/database/detail/database_functions_interface.h"
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+class StreamingSessionizer;
+typedef std::shared_ptr<StreamingSessionizer> StreamingSessionizerPtr;
+
+// Logs received from agents are saved and added to open sessions at once.
+// Closed sessions and open sessions state are saved together by Flush,
+// which SessionizerAnalyzerObject calls every CHECKPOINT_INTERVAL; logs
+// received after the last checkpoint are replayed by Restore.
+class StreamingSessionizer {
+ public:
+  virtual ~StreamingSessionizer() = default;
+
+  static StreamingSessionizerPtr Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  void AddLogs(const ::type::ApacheLogs &log_entries);
+
+  // Closes expired sessions and saves the checkpoint. Logs time is used as
+  // the clock, it is moved forward by the time elapsed since the last log,
+  // so sessions are closed also when agents stop sending logs.
+  void Flush();
+
+  void Restore();
+
+  static constexpr std::chrono::seconds CHECKPOINT_INTERVAL{60};
+
+ private:
+  explicit StreamingSessionizer(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  ::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
+  detail::sessionizer::SessionizerPtr sessionizer_;
+  ::database::type::RowId last_log_id_;
+  std::chrono::steady_clock::time_point last_log_arrival_;
+  bool is_changed_;
+  std::mutex mutex_;
+};
+
+}
+
+}
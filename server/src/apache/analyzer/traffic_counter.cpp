@@ -0,0 +1,126 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "traffic_counter.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+
+#include "detail/sessionizer/sessionizer.h"
+#include "src/analyzer/sketch/hash.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+constexpr std::chrono::seconds TrafficCounter::SAVE_INTERVAL;
+
+TrafficCounterPtr TrafficCounter::Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::TrafficCounter::Create: Function call";
+
+  return TrafficCounterPtr(new TrafficCounter(database_functions));
+}
+
+void TrafficCounter::AddLogs(const ::type::ApacheLogs &log_entries) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::TrafficCounter::AddLogs: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto &log_entry : log_entries) {
+    Hour &hour = GetHour(log_entry);
+    auto &sketches = hour.sketches;
+
+    sketches.requests_count++;
+    sketches.client_ips.Add(::analyzer::sketch::Hash(log_entry.client_ip));
+    sketches.user_agents.Add(::analyzer::sketch::Hash(log_entry.user_agent));
+    sketches.top_paths.Add(GetPath(log_entry.request));
+    sketches.top_client_ips.Add(log_entry.client_ip);
+    hour.is_changed = true;
+  }
+
+  if (std::chrono::steady_clock::now() - last_save_ >= SAVE_INTERVAL)
+    Save();
+}
+
+void TrafficCounter::Flush() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::analyzer::TrafficCounter::Flush: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  Save();
+}
+
+std::string TrafficCounter::GetPath(const std::string &request) {
+  auto begin = request.find(' ');
+  begin = (begin == std::string::npos) ? 0 : begin + 1;
+
+  auto end = request.find(' ', begin);
+  end = std::min(end, request.find('?', begin));
+  end = std::min(end, request.find('#', begin));
+
+  return request.substr(begin, (end == std::string::npos) ? std::string::npos : end - begin);
+}
+
+void TrafficCounter::Save() {
+  ::apache::type::TrafficSketchesList changed;
+  for (auto &h : hours_) {
+    if (h.second.is_changed) {
+      changed.push_back(h.second.sketches);
+      h.second.is_changed = false;
+    }
+  }
+
+  if (!changed.empty()) {
+    BOOST_LOG_TRIVIAL(info) << "apache::analyzer::TrafficCounter::Save: Saving " << changed.size() << " hours";
+    database_functions_->SaveTrafficSketches(changed);
+  }
+
+  // the previous hour stays in memory for logs delivered with a delay
+  for (auto it = hours_.begin(); it != hours_.end();) {
+    if (std::get<2>(it->first) < latest_hour_ - 1)
+      it = hours_.erase(it);
+    else
+      ++it;
+  }
+
+  last_save_ = std::chrono::steady_clock::now();
+}
+
+TrafficCounter::Hour& TrafficCounter::GetHour(const ::type::ApacheLogEntry &log_entry) {
+  const long long hour_number = detail::sessionizer::Sessionizer::ToSeconds(log_entry.time) / 3600;
+  latest_hour_ = std::max(latest_hour_, hour_number);
+
+  const HourKey key(log_entry.agent_name, log_entry.virtualhost, hour_number);
+  auto it = hours_.find(key);
+  if (it != hours_.end())
+    return it->second;
+
+  Hour hour;
+  hour.is_changed = false;
+  hour.sketches.agent_name = log_entry.agent_name;
+  hour.sketches.virtualhost_name = log_entry.virtualhost;
+  hour.sketches.hour = ::type::Timestamp::Create(log_entry.time.GetTime().GetHour(), 0, 0,
+                                                 log_entry.time.GetDate().GetDay(),
+                                                 log_entry.time.GetDate().GetMonth(),
+                                                 log_entry.time.GetDate().GetYear());
+  hour.sketches.requests_count = 0;
+
+  auto saved = database_functions_->GetTrafficSketches(log_entry.agent_name, log_entry.virtualhost,
+                                                       hour.sketches.hour, hour.sketches.hour);
+  if (!saved.empty())
+    hour.sketches = saved.front();
+
+  return hours_.insert(std::make_pair(key, hour)).first->second;
+}
+
+TrafficCounter::TrafficCounter(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions) :
+database_functions_(database_functions),
+latest_hour_(0),
+last_save_(std::chrono::steady_clock::now()) {
+}
+
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <slas/type/apache_log_entry.h>
+
+#include "src/apache/database/detail/database_functions_interface.h"
+#include "src/apache/type/traffic_sketches.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+class TrafficCounter;
+typedef std::shared_ptr<TrafficCounter> TrafficCounterPtr;
+
+// Counts distinct client IPs and user agents and the most frequent paths and
+// client IPs of every virtualhost in every hour, while logs are received.
+// Changed hours are saved by AddLogs when SAVE_INTERVAL has passed since the
+// previous save and by Flush, which is called at shutdown. An hour which
+// isn't in memory is read from the database before it is updated, so logs
+// delivered late are added to the saved sketches.
+class TrafficCounter {
+ public:
+  virtual ~TrafficCounter() = default;
+
+  static TrafficCounterPtr Create(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  void AddLogs(const ::type::ApacheLogs &log_entries);
+  void Flush();
+
+  // "GET /index.php?id=1 HTTP/1.1" -> "/index.php"
+  static std::string GetPath(const std::string &request);
+
+  static constexpr std::chrono::seconds SAVE_INTERVAL{60};
+
+ private:
+  // agent name, virtualhost name, hours since the epoch
+  typedef std::tuple<std::string, std::string, long long> HourKey;
+
+  struct Hour {
+    ::apache::type::TrafficSketches sketches;
+    bool is_changed;
+  };
+
+  explicit TrafficCounter(::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions);
+
+  void Save();
+  Hour& GetHour(const ::type::ApacheLogEntry &log_entry);
+
+  ::apache::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
+  std::map<HourKey, Hour> hours_;
+  long long latest_hour_;
+  std::chrono::steady_clock::time_point last_save_;
+  std::mutex mutex_;
+};
+
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <slas/type/timestamp.h>
+
+#include "src/database/type/rows_count.h"
+
+namespace apache
+{
+
+namespace analyzer
+{
+
+namespace type
+{
+
+// Features are counted in the window_length seconds ending at time.
+struct RealtimeAlert {
+  std::string agent_name;
+  std::string virtualhost_name;
+  std::string client_ip;
+  ::type::Timestamp time;
+  long long window_length;
+  ::database::type::RowsCount requests_count;
+  long long bandwidth_usage;
+  double error_percentage;
+  double score;
+};
+
+typedef std::vector<RealtimeAlert> RealtimeAlerts;
+
+}
+
+}
+
+}
@@ -9,6 +9,7 @@
 #include <cmath>
 #include <string>
 #include <utility>
+#include <vector>
 #include <boost/log/trivial.hpp>
 #include <slas/type/timestamp.h>
 
@@ -59,8 +60,9 @@ void DatabaseFunctions::CreateTables() {
                         "  USED_IN_STATISTICS integer default 0"
                         ");");
 
-  sqlite_wrapper_->Exec("create index if not exists APACHE_LOGS_TABLE_AGENT_NAME_VIRTUALHOST_USED_IN_STATISTICS "
-                        " on APACHE_LOGS_TABLE (AGENT_NAME, VIRTUALHOST, USED_IN_STATISTICS);");
+  // logs are sessionized at ingest, the index used by the hourly calculation
+  // only slowed down inserts
+  sqlite_wrapper_->Exec("drop index if exists APACHE_LOGS_TABLE_AGENT_NAME_VIRTUALHOST_USED_IN_STATISTICS;");
 
   sqlite_wrapper_->Exec("create table if not exists APACHE_LAST_RUN_TABLE ( "
                         "  ID integer primary key not null, "
@@ -90,6 +92,61 @@ void DatabaseFunctions::CreateTables() {
   sqlite_wrapper_->Exec("create index if not exists APACHE_LEARNING_SESSIONS_AGENT_NAME_ID_VIRTUALHOST_NAME_ID"
                         " on APACHE_LEARNING_SESSIONS (AGENT_NAME_ID, VIRTUALHOST_NAME_ID);");
 
+  sqlite_wrapper_->Exec("create table if not exists APACHE_TRAFFIC_SKETCH_TABLE ( "
+                        "  ID integer primary key not null, "
+                        "  AGENT_NAME text not null, "
+                        "  VIRTUALHOST text not null, "
+                        "  UTC_YEAR integer not null, "
+                        "  UTC_MONTH integer not null, "
+                        "  UTC_DAY integer not null, "
+                        "  UTC_HOUR integer not null, "
+                        "  REQUESTS_COUNT integer not null, "
+                        "  CLIENT_IPS blob not null, "
+                        "  USER_AGENTS blob not null, "
+                        "  TOP_PATHS blob not null, "
+                        "  TOP_CLIENT_IPS blob not null, "
+                        "  unique(AGENT_NAME, VIRTUALHOST, UTC_YEAR, UTC_MONTH, UTC_DAY, UTC_HOUR) "
+                        ");");
+
+  sqlite_wrapper_->Exec("create table if not exists APACHE_LEARNING_SET_SKETCHES ( "
+                        "  ID integer primary key not null, "
+                        "  AGENT_NAME_ID integer not null, "
+                        "  VIRTUALHOST_NAME_ID integer not null, "
+                        "  FEATURE integer not null, "
+                        "  SKETCH blob not null, "
+                        "  foreign key(AGENT_NAME_ID) references AGENT_NAMES(ID), "
+                        "  foreign key(VIRTUALHOST_NAME_ID) references APACHE_VIRTUALHOSTS_NAMES(ID), "
+                        "  unique(AGENT_NAME_ID, VIRTUALHOST_NAME_ID, FEATURE) "
+                        ");");
+
+  sqlite_wrapper_->Exec("create table if not exists APACHE_LEARNING_SET_VERSIONS ( "
+                        "  ID integer primary key not null, "
+                        "  AGENT_NAME_ID integer not null, "
+                        "  VIRTUALHOST_NAME_ID integer not null, "
+                        "  VERSION integer not null, "
+                        "  foreign key(AGENT_NAME_ID) references AGENT_NAMES(ID), "
+                        "  foreign key(VIRTUALHOST_NAME_ID) references APACHE_VIRTUALHOSTS_NAMES(ID), "
+                        "  unique(AGENT_NAME_ID, VIRTUALHOST_NAME_ID) "
+                        ");");
+
+  sqlite_wrapper_->Exec("create table if not exists APACHE_FEATURE_NORMALIZATION ( "
+                        "  ID integer primary key not null, "
+                        "  AGENT_NAME_ID integer not null, "
+                        "  VIRTUALHOST_NAME_ID integer not null, "
+                        "  LEARNING_SET_VERSION integer not null, "
+                        "  SESSION_LENGTH_MEAN real not null, "
+                        "  SESSION_LENGTH_STDDEV real not null, "
+                        "  BANDWIDTH_USAGE_MEAN real not null, "
+                        "  BANDWIDTH_USAGE_STDDEV real not null, "
+                        "  REQUESTS_COUNT_MEAN real not null, "
+                        "  REQUESTS_COUNT_STDDEV real not null, "
+                        "  ERROR_PERCENTAGE_MEAN real not null, "
+                        "  ERROR_PERCENTAGE_STDDEV real not null, "
+                        "  foreign key(AGENT_NAME_ID) references AGENT_NAMES(ID), "
+                        "  foreign key(VIRTUALHOST_NAME_ID) references APACHE_VIRTUALHOSTS_NAMES(ID), "
+                        "  unique(AGENT_NAME_ID, VIRTUALHOST_NAME_ID) "
+                        ");");
+
   sqlite_wrapper_->Exec("create table if not exists APACHE_SESSION_TABLE ("
                         "  ID integer primary key, "
                         "  AGENT_NAME text,"
@@ -113,16 +170,58 @@ void DatabaseFunctions::CreateTables() {
   sqlite_wrapper_->Exec("create index if not exists APACHE_SESSION_TABLE_AGENT_NAME_VIRTUALHOST_CLASSIFICATION"
                         " on APACHE_SESSION_TABLE (AGENT_NAME, VIRTUALHOST, CLASSIFICATION);");
 
+  sqlite_wrapper_->Exec("create table if not exists APACHE_OPEN_SESSION_TABLE ("
+                        "  ID integer primary key, "
+                        "  AGENT_NAME text,"
+                        "  VIRTUALHOST text, "
+                        "  CLIENT_IP text, "
+                        "  UTC_HOUR integer, "
+                        "  UTC_MINUTE integer, "
+                        "  UTC_SECOND integer, "
+                        "  UTC_DAY integer, "
+                        "  UTC_MONTH integer, "
+                        "  UTC_YEAR integer, "
+                        "  SESSION_LENGTH integer, "
+                        "  BANDWIDTH_USAGE integer, "
+                        "  REQUESTS_COUNT integer, "
+                        "  ERRORS_COUNT integer, "
+                        "  ERROR_PERCENTAGE real, "
+                        "  USER_AGENT text, "
+                        "  CLASSIFICATION integer default 0 "
+                        ");");
+
+  sqlite_wrapper_->Exec("create table if not exists APACHE_SESSIONIZER_TABLE ("
+                        "  ID integer primary key, "
+                        "  LAST_LOG_ID integer not null "
+                        ");");
+
   sqlite_wrapper_->Exec("create table if not exists APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE ("
                         "  ID integer primary key, "
                         "  AGENT_NAME text not null, "
                         "  VIRTUALHOST_NAME text not null, "
                         "  BEGIN_DATE_ID integer not null, "
                         "  END_DATE_ID integer not null, "
+                        "  KNN_MODE integer not null default 0, "
+                        "  HNSW_M integer not null default 16, "
+                        "  HNSW_EF integer not null default 64, "
+                        "  KNN_NEIGHBOURS integer not null default 3, "
+                        "  KNN_VOTING integer not null default 0, "
+                        "  REALTIME_SCORING integer not null default 0, "
+                        "  REALTIME_THRESHOLD real not null default 4, "
+                        "  REALTIME_MIN_REQUESTS integer not null default 20, "
                         "  foreign key(BEGIN_DATE_ID) references DATE_TABLE(ID), "
                         "  foreign key(BEGIN_DATE_ID) references DATE_TABLE(ID),"
                         "  unique (AGENT_NAME, VIRTUALHOST_NAME) "
                         ");");
+
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "KNN_MODE", "integer not null default 0");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "HNSW_M", "integer not null default 16");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "HNSW_EF", "integer not null default 64");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "KNN_NEIGHBOURS", "integer not null default 3");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "KNN_VOTING", "integer not null default 0");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "REALTIME_SCORING", "integer not null default 0");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "REALTIME_THRESHOLD", "real not null default 4");
+  AddColumnIfNotExists("APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE", "REALTIME_MIN_REQUESTS", "integer not null default 20");
 }
 
 void DatabaseFunctions::RemoveAnomalyDetectionConfiguration(const ::database::type::RowId &id) {
@@ -140,7 +239,7 @@ const ::apache::type::AnomalyDetectionConfiguration DatabaseFunctions::GetAnomal
 void DatabaseFunctions::AddLogs(const ::type::ApacheLogs &log_entries) {
   BOOST_LOG_TRIVIAL(debug) << "apache::DatabaseFunctions::AddLogs: Function call";
 
-  sqlite_wrapper_->Exec("begin transaction");
+  sqlite_wrapper_->BeginTransaction();
 
   try {
     for (const ::type::ApacheLogEntry &entry : log_entries) {
@@ -174,79 +273,44 @@ void DatabaseFunctions::AddLogs(const ::type::ApacheLogs &log_entries) {
 
       sqlite_wrapper_->Finalize(statement);
     }
-
-    sqlite_wrapper_->Exec("end transaction");
   }
   catch (exception::DatabaseException &ex) {
-    sqlite_wrapper_->Exec("rollback");
+    sqlite_wrapper_->RollbackTransaction();
     throw;
   }
-}
-
-::database::type::RowsCount DatabaseFunctions::GetUnusedLogsCount(std::string agent_name, std::string virtualhost_name) {
-  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetLogsCount: Function call";
 
-  string sql =
-      "select count(*) from APACHE_LOGS_TABLE "
-      " indexed by APACHE_LOGS_TABLE_AGENT_NAME_VIRTUALHOST_USED_IN_STATISTICS "
-      "  where "
-      "    ( "
-      "      AGENT_NAME=? "
-      "      and "
-      "      VIRTUALHOST=? "
-      "    )"
-      "  and "
-      "  USED_IN_STATISTICS=0 "
-      ";";
-
-  sqlite3_stmt *statement;
-  sqlite_wrapper_->Prepare(sql, &statement);
-
-  sqlite_wrapper_->BindText(statement, 1, agent_name);
-
-  sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
-
-  sqlite_wrapper_->Step(statement);
-
-  auto count = sqlite_wrapper_->ColumnInt64(statement, 0);
+  sqlite_wrapper_->CommitTransaction();
+}
 
-  sqlite_wrapper_->Finalize(statement);
+::database::type::RowId DatabaseFunctions::GetLastLogId() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetLastLogId: Function call";
 
-  return count;
+  return sqlite_wrapper_->GetFirstInt64Column("select coalesce(max(ID), 0) from APACHE_LOGS_TABLE;");
 }
 
-::type::ApacheLogs DatabaseFunctions::GetUnusedLogs(std::string agent_name, std::string virtualhost_name,
-                                                    unsigned limit, ::database::type::RowsCount offset) {
-  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetUnusedLogs: Function call";
+::type::ApacheLogs DatabaseFunctions::GetLogsAfter(const ::database::type::RowId &id, unsigned limit) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetLogsAfter: Function call";
 
+  // logs used by the old hourly sessions calculation have USED_IN_STATISTICS=1
   string sql =
       "select ID, AGENT_NAME, VIRTUALHOST, CLIENT_IP, UTC_HOUR, UTC_MINUTE, UTC_SECOND, UTC_DAY, UTC_MONTH, UTC_YEAR, REQUEST, STATUS_CODE, BYTES, USER_AGENT from APACHE_LOGS_TABLE"
-      " indexed by APACHE_LOGS_TABLE_AGENT_NAME_VIRTUALHOST_USED_IN_STATISTICS "
       "  where"
-      "    ("
-      "      AGENT_NAME=?"
-      "      and"
-      "      VIRTUALHOST=?"
-      "    )"
+      "    ID > ?"
       "  and "
-      "  USED_IN_STATISTICS=0 "
-      "  order by UTC_YEAR, UTC_MONTH, UTC_DAY, UTC_HOUR, UTC_MINUTE, UTC_SECOND "
-      "   limit " + to_string(limit) + " offset " + to_string(offset) +
+      "    USED_IN_STATISTICS=0 "
+      "  order by ID "
+      "   limit " + to_string(limit) +
       ";";
 
   sqlite3_stmt *statement;
   sqlite_wrapper_->Prepare(sql, &statement);
 
-  sqlite_wrapper_->BindText(statement, 1, agent_name);
-  sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
-
   ::type::ApacheLogs logs;
-  int ret;
-  do {
-    ret = sqlite_wrapper_->Step(statement);
 
-    if (ret == SQLITE_ROW) {
-      BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetUnusedLogs: Found new log entry in database";
+  try {
+    sqlite_wrapper_->BindInt64(statement, 1, id);
+
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
       ::type::ApacheLogEntry log_entry;
 
       log_entry.id = sqlite_wrapper_->ColumnInt64(statement, 0);
@@ -266,28 +330,205 @@ void DatabaseFunctions::AddLogs(const ::type::ApacheLogs &log_entries) {
       log_entry.bytes = sqlite_wrapper_->ColumnInt(statement, 12);
       log_entry.user_agent = sqlite_wrapper_->ColumnText(statement, 13);
 
-      logs.push_back(log_entry);
+      logs.push_back(std::move(log_entry));
     }
   }
-  while (ret != SQLITE_DONE);
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
 
   sqlite_wrapper_->Finalize(statement);
 
   return logs;
 }
 
-void DatabaseFunctions::MarkLogsAsUsed(const ::type::ApacheLogs &logs) {
-  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::MarkLogsAsUsed: Function call";
+::apache::type::SessionizerCheckpoint DatabaseFunctions::GetSessionizerCheckpoint() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetSessionizerCheckpoint: Function call";
 
-  string sql = "update APACHE_LOGS_TABLE set USED_IN_STATISTICS=1 where ID in ( ";
+  ::apache::type::SessionizerCheckpoint checkpoint;
+  checkpoint.last_log_id = sqlite_wrapper_->GetFirstInt64Column("select LAST_LOG_ID from APACHE_SESSIONIZER_TABLE where ID=1;", -1);
 
-  for (auto log : logs) {
-    sql += to_string(log.id) + ", ";
+  if (checkpoint.last_log_id < 0) {
+    // database created before the sessionizer, logs not used in statistics
+    // by the old hourly calculation are replayed
+    BOOST_LOG_TRIVIAL(info) << "apache::database::DatabaseFunctions::GetSessionizerCheckpoint: Checkpoint not found, starting from the first not used log";
+    checkpoint.last_log_id = sqlite_wrapper_->GetFirstInt64Column("select coalesce((select min(ID) - 1 from APACHE_LOGS_TABLE where USED_IN_STATISTICS=0), "
+                                                                  "                (select max(ID) from APACHE_LOGS_TABLE), "
+                                                                  "                0);");
+    return checkpoint;
   }
 
-  sql += "-1 );";
+  const string sql =
+      "select ID, AGENT_NAME, VIRTUALHOST, CLIENT_IP, UTC_HOUR, UTC_MINUTE, UTC_SECOND, UTC_DAY, UTC_MONTH, UTC_YEAR, SESSION_LENGTH, BANDWIDTH_USAGE, REQUESTS_COUNT, ERRORS_COUNT, ERROR_PERCENTAGE, USER_AGENT, CLASSIFICATION "
+      " from APACHE_OPEN_SESSION_TABLE;";
+
+  sqlite3_stmt *statement;
+  sqlite_wrapper_->Prepare(sql, &statement);
 
-  sqlite_wrapper_->Exec(sql);
+  try {
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      ::apache::type::ApacheSessionEntry session;
+
+      session.id = sqlite_wrapper_->ColumnInt64(statement, 0);
+      session.agent_name = sqlite_wrapper_->ColumnText(statement, 1);
+      session.virtualhost = sqlite_wrapper_->ColumnText(statement, 2);
+      session.client_ip = sqlite_wrapper_->ColumnText(statement, 3);
+      session.session_start.Set(sqlite_wrapper_->ColumnInt(statement, 4),
+                                sqlite_wrapper_->ColumnInt(statement, 5),
+                                sqlite_wrapper_->ColumnInt(statement, 6),
+                                sqlite_wrapper_->ColumnInt(statement, 7),
+                                sqlite_wrapper_->ColumnInt(statement, 8),
+                                sqlite_wrapper_->ColumnInt(statement, 9));
+      session.session_length = sqlite_wrapper_->ColumnInt64(statement, 10);
+      session.bandwidth_usage = sqlite_wrapper_->ColumnInt64(statement, 11);
+      session.requests_count = sqlite_wrapper_->ColumnInt64(statement, 12);
+      session.errors_count = sqlite_wrapper_->ColumnInt64(statement, 13);
+      session.error_percentage = sqlite_wrapper_->ColumnDouble(statement, 14);
+      session.useragent = sqlite_wrapper_->ColumnText(statement, 15);
+      session.classification = static_cast<Classification> (sqlite_wrapper_->ColumnInt(statement, 16));
+
+      checkpoint.open_sessions.push_back(session);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return checkpoint;
+}
+
+void DatabaseFunctions::SaveSessionizerCheckpoint(const ::apache::type::ApacheSessions &closed_sessions,
+                                                  const ::apache::type::SessionizerCheckpoint &checkpoint) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::SaveSessionizerCheckpoint: Function call";
+
+  // closed sessions and the checkpoint are saved together, after a restart
+  // logs aren't counted twice
+  sqlite_wrapper_->BeginTransaction();
+
+  try {
+    AddSessions("APACHE_SESSION_TABLE", closed_sessions);
+
+    sqlite_wrapper_->Exec("delete from APACHE_OPEN_SESSION_TABLE;");
+    AddSessions("APACHE_OPEN_SESSION_TABLE", checkpoint.open_sessions);
+
+    sqlite_wrapper_->Exec("insert or replace into APACHE_SESSIONIZER_TABLE (ID, LAST_LOG_ID) "
+                          " values (1, " + to_string(checkpoint.last_log_id) + ");");
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->RollbackTransaction();
+    throw;
+  }
+
+  sqlite_wrapper_->CommitTransaction();
+}
+
+::apache::type::TrafficSketchesList DatabaseFunctions::GetTrafficSketches(const std::string &agent_name,
+                                                                         const std::string &virtualhost_name,
+                                                                         const ::type::Timestamp &from,
+                                                                         const ::type::Timestamp &to) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetTrafficSketches: Function call";
+  ::apache::type::TrafficSketchesList list;
+
+  auto hour_number = [](const ::type::Timestamp &t) {
+    return t.GetDate().GetYear() * 1000000LL + t.GetDate().GetMonth() * 10000LL
+        + t.GetDate().GetDay() * 100LL + t.GetTime().GetHour();
+  };
+
+  const string sql =
+      "select UTC_YEAR, UTC_MONTH, UTC_DAY, UTC_HOUR, REQUESTS_COUNT, CLIENT_IPS, USER_AGENTS, TOP_PATHS, TOP_CLIENT_IPS "
+      " from APACHE_TRAFFIC_SKETCH_TABLE "
+      " where AGENT_NAME=? and VIRTUALHOST=? "
+      "   and (UTC_YEAR * 1000000 + UTC_MONTH * 10000 + UTC_DAY * 100 + UTC_HOUR) between " + to_string(hour_number(from)) + " and " + to_string(hour_number(to)) +
+      " order by UTC_YEAR, UTC_MONTH, UTC_DAY, UTC_HOUR;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindText(statement, 1, agent_name);
+    sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
+
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      ::apache::type::TrafficSketches s;
+      s.agent_name = agent_name;
+      s.virtualhost_name = virtualhost_name;
+      s.hour = ::type::Timestamp::Create(sqlite_wrapper_->ColumnInt(statement, 3), 0, 0,
+                                         sqlite_wrapper_->ColumnInt(statement, 2),
+                                         sqlite_wrapper_->ColumnInt(statement, 1),
+                                         sqlite_wrapper_->ColumnInt(statement, 0));
+      s.requests_count = sqlite_wrapper_->ColumnInt64(statement, 4);
+
+      const bool is_valid = s.client_ips.Deserialize(sqlite_wrapper_->ColumnBlob(statement, 5))
+          && s.user_agents.Deserialize(sqlite_wrapper_->ColumnBlob(statement, 6))
+          && s.top_paths.Deserialize(sqlite_wrapper_->ColumnBlob(statement, 7))
+          && s.top_client_ips.Deserialize(sqlite_wrapper_->ColumnBlob(statement, 8));
+
+      if (is_valid)
+        list.push_back(s);
+      else
+        BOOST_LOG_TRIVIAL(warning) << "apache::database::DatabaseFunctions::GetTrafficSketches: Skipping invalid sketches of " << s.hour.ToString();
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return list;
+}
+
+void DatabaseFunctions::SaveTrafficSketches(const ::apache::type::TrafficSketchesList &sketches) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::SaveTrafficSketches: Function call";
+
+  const string sql =
+      "insert or replace into APACHE_TRAFFIC_SKETCH_TABLE "
+      " (AGENT_NAME, VIRTUALHOST, UTC_YEAR, UTC_MONTH, UTC_DAY, UTC_HOUR, REQUESTS_COUNT, CLIENT_IPS, USER_AGENTS, TOP_PATHS, TOP_CLIENT_IPS) "
+      " values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+  sqlite_wrapper_->BeginTransaction();
+
+  sqlite3_stmt *statement = nullptr;
+  try {
+    sqlite_wrapper_->Prepare(sql, &statement);
+
+    for (const auto &s : sketches) {
+      // blobs are bound without copying, they must live until the step
+      const string client_ips = s.client_ips.Serialize();
+      const string user_agents = s.user_agents.Serialize();
+      const string top_paths = s.top_paths.Serialize();
+      const string top_client_ips = s.top_client_ips.Serialize();
+
+      sqlite_wrapper_->BindText(statement, 1, s.agent_name);
+      sqlite_wrapper_->BindText(statement, 2, s.virtualhost_name);
+      sqlite_wrapper_->BindInt(statement, 3, s.hour.GetDate().GetYear());
+      sqlite_wrapper_->BindInt(statement, 4, s.hour.GetDate().GetMonth());
+      sqlite_wrapper_->BindInt(statement, 5, s.hour.GetDate().GetDay());
+      sqlite_wrapper_->BindInt(statement, 6, s.hour.GetTime().GetHour());
+      sqlite_wrapper_->BindInt64(statement, 7, s.requests_count);
+      sqlite_wrapper_->BindBlob(statement, 8, client_ips);
+      sqlite_wrapper_->BindBlob(statement, 9, user_agents);
+      sqlite_wrapper_->BindBlob(statement, 10, top_paths);
+      sqlite_wrapper_->BindBlob(statement, 11, top_client_ips);
+      sqlite_wrapper_->Step(statement);
+      sqlite_wrapper_->Reset(statement);
+    }
+
+    sqlite_wrapper_->Finalize(statement);
+  }
+  catch (exception::DatabaseException &ex) {
+    if (statement != nullptr)
+      sqlite_wrapper_->Finalize(statement);
+    sqlite_wrapper_->RollbackTransaction();
+    throw;
+  }
+
+  sqlite_wrapper_->CommitTransaction();
 }
 
 bool DatabaseFunctions::AddSessionStatistics(const ::apache::type::ApacheSessions &sessions) {
@@ -573,6 +814,12 @@ void DatabaseFunctions::UpdateSessionStatisticClassification(const ::database::t
   sqlite_wrapper_->Exec(sql);
 }
 
+void DatabaseFunctions::UpdateSessionStatisticsClassification(const ::database::type::RowIds &ids, const ::database::type::Classification &classification) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::UpdateSessionStatisticsClassification: Function call";
+
+  session_classification_writer_->Write(ids, classification);
+}
+
 void DatabaseFunctions::ClearAnomalyMarksInLearningSet(const ::database::type::RowId &agent_name_id,
                                                        const ::database::type::RowId &virtualhost_name_id) {
   BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::ClearAnomalyMarksInLearningSet: Function call";
@@ -588,42 +835,219 @@ void DatabaseFunctions::ClearAnomalyMarksInLearningSet(const ::database::type::R
       "         );";
 
   sqlite_wrapper_->Exec(sql);
+  IncrementLearningSetVersion(agent_name_id, virtualhost_name_id);
 }
 
 void DatabaseFunctions::MarkLearningSetWithIqrMethod(const ::database::type::RowId &agent_name_id,
                                                      const ::database::type::RowId &virtualhost_name_id) {
   BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::MarkLearningSetWithIqrMethod: Function call";
 
-  typedef std::pair<::database::type::RowId, long long> IdQueriesPair;
-  std::vector<IdQueriesPair> id_queries;
+  auto sketches = GetLearningSetSketches(agent_name_id, virtualhost_name_id);
+  const auto count = GetLearningSessionsCount(agent_name_id, virtualhost_name_id);
+
+  // learning sets created before the sketches were kept are added at once
+  if (sketches[0].GetCount() != static_cast<std::uint64_t> (count)) {
+    BOOST_LOG_TRIVIAL(info) << "apache::database::DatabaseFunctions::MarkLearningSetWithIqrMethod: Rebuilding sketches of " << count << " sessions";
+    sketches = ::apache::type::LearningSetSketches();
+    AddLearningSessionsToSketches(agent_name_id, virtualhost_name_id, 0, sketches);
+    SaveLearningSetSketches(agent_name_id, virtualhost_name_id, sketches);
+  }
+
+  // session is an anomaly when any feature is above q3 + 1.5 * iqr; a feature
+  // with zero iqr is skipped, most sessions have e.g. no errors and the fence
+  // would mark every session with one error
+  std::vector<double> fences;
+  string conditions;
+  const char *columns[] = {"SESSION_LENGTH", "BANDWIDTH_USAGE", "REQUESTS_COUNT", "ERROR_PERCENTAGE"};
+  for (unsigned i = 0; count != 0 && i < ::apache::type::SESSION_FEATURES_COUNT; ++i) {
+    const double q1 = sketches[i].GetQuantile(0.25);
+    const double q3 = sketches[i].GetQuantile(0.75);
+    const double fence = q3 + 1.5 * (q3 - q1);
+
+    BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::MarkLearningSetWithIqrMethod: Info: feature=" << i << "; q1=" << q1 << "; q3=" << q3 << "; m=" << fence;
 
-  auto count = GetLearningSessionsCount(agent_name_id, virtualhost_name_id);
-  auto learning_set_ids = GetLearningSessionsIds(agent_name_id, virtualhost_name_id, count, 0);
+    if (q3 - q1 <= 0)
+      continue;
 
-  for (auto id : learning_set_ids) {
-    auto session = GetOneSessionStatistic(id);
-    id_queries.push_back(std::make_pair(session.id, session.requests_count));
+    conditions += (conditions.empty() ? "" : " or ") + string(columns[i]) + ">?";
+    fences.push_back(fence);
   }
 
-  sort(id_queries.begin(), id_queries.end(), [](const IdQueriesPair &a, const IdQueriesPair & b) {
-    return a.second < b.second;
-  });
+  sqlite_wrapper_->BeginTransaction();
+
+  try {
+    ClearAnomalyMarksInLearningSet(agent_name_id, virtualhost_name_id);
+
+    if (!conditions.empty()) {
+      const string sql =
+          "update APACHE_SESSION_TABLE set CLASSIFICATION=" + to_string(static_cast<int> (::database::type::Classification::ANOMALY)) +
+          " where "
+          "  ID in ( "
+          "         select SESSION_ID from APACHE_LEARNING_SESSIONS where "
+          "             AGENT_NAME_ID=" + to_string(agent_name_id) +
+          "           and "
+          "             VIRTUALHOST_NAME_ID=" + to_string(virtualhost_name_id) +
+          "         ) "
+          "  and (" + conditions + ");";
+
+      sqlite3_stmt *statement = nullptr;
+      sqlite_wrapper_->Prepare(sql, &statement);
+
+      try {
+        for (unsigned i = 0; i < fences.size(); ++i)
+          sqlite_wrapper_->BindDouble(statement, i + 1, fences[i]);
+
+        sqlite_wrapper_->Step(statement);
+      }
+      catch (exception::DatabaseException &ex) {
+        sqlite_wrapper_->Finalize(statement);
+        throw;
+      }
+
+      sqlite_wrapper_->Finalize(statement);
 
-  auto q1_element = ceil(id_queries.size() * 1. / 4.) - 1;
-  auto q3_element = ceil(id_queries.size() * 3. / 4.) - 1;
-  auto iqr = id_queries.at(q3_element).second - id_queries.at(q1_element).second;
+      IncrementLearningSetVersion(agent_name_id, virtualhost_name_id);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->RollbackTransaction();
+    throw;
+  }
 
-  auto m = id_queries.at(q3_element).second + 1.5 * iqr;
+  sqlite_wrapper_->CommitTransaction();
+}
 
-  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::MarkLearningSetWithIqrMethod: Info: q1_element=" << q1_element << "; q3_element=" << q3_element << "; iqr=" << iqr << "; m=" << m;
+::apache::type::KnnConfiguration DatabaseFunctions::GetKnnConfiguration(const std::string &agent_name,
+                                                                        const std::string &virtualhost_name) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetKnnConfiguration: Function call";
+  ::apache::type::KnnConfiguration configuration;
+  configuration.mode = ::apache::type::KnnMode::EXACT;
+  configuration.hnsw_m = 16;
+  configuration.hnsw_ef = 64;
+  configuration.neighbours_count = 3;
+  configuration.voting = ::apache::type::KnnVoting::MAJORITY;
 
-  ClearAnomalyMarksInLearningSet(agent_name_id, virtualhost_name_id);
-  for (auto element : id_queries) {
-    BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::MarkLearningSetWithIqrMethod: Loop: Comparing m to element.second=" << element.second;
+  const string sql =
+      "select KNN_MODE, HNSW_M, HNSW_EF, KNN_NEIGHBOURS, KNN_VOTING from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE "
+      " where AGENT_NAME=? and VIRTUALHOST_NAME=?;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
 
-    if (element.second > m)
-      UpdateSessionStatisticClassification(element.first, ::database::type::Classification::ANOMALY);
+  try {
+    sqlite_wrapper_->BindText(statement, 1, agent_name);
+    sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
+
+    if (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      configuration.mode = static_cast< ::apache::type::KnnMode> (sqlite_wrapper_->ColumnInt(statement, 0));
+      configuration.hnsw_m = sqlite_wrapper_->ColumnInt(statement, 1);
+      configuration.hnsw_ef = sqlite_wrapper_->ColumnInt(statement, 2);
+      configuration.neighbours_count = sqlite_wrapper_->ColumnInt(statement, 3);
+      configuration.voting = static_cast< ::apache::type::KnnVoting> (sqlite_wrapper_->ColumnInt(statement, 4));
+    }
   }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return configuration;
+}
+
+void DatabaseFunctions::SetKnnConfiguration(const std::string &agent_name,
+                                            const std::string &virtualhost_name,
+                                            const ::apache::type::KnnConfiguration &configuration) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::SetKnnConfiguration: Function call";
+
+  const string sql =
+      "update APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE "
+      " set KNN_MODE=" + to_string(static_cast<int> (configuration.mode)) +
+      "   , HNSW_M=" + to_string(configuration.hnsw_m) +
+      "   , HNSW_EF=" + to_string(configuration.hnsw_ef) +
+      "   , KNN_NEIGHBOURS=" + to_string(configuration.neighbours_count) +
+      "   , KNN_VOTING=" + to_string(static_cast<int> (configuration.voting)) +
+      " where AGENT_NAME=? and VIRTUALHOST_NAME=?;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindText(statement, 1, agent_name);
+    sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
+    sqlite_wrapper_->Step(statement);
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+}
+
+::apache::type::RealtimeScoringConfiguration DatabaseFunctions::GetRealtimeScoringConfiguration(const std::string &agent_name,
+                                                                                                const std::string &virtualhost_name) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::GetRealtimeScoringConfiguration: Function call";
+  ::apache::type::RealtimeScoringConfiguration configuration;
+  configuration.enabled = false;
+  configuration.threshold = 4.;
+  configuration.min_requests = 20;
+
+  const string sql =
+      "select REALTIME_SCORING, REALTIME_THRESHOLD, REALTIME_MIN_REQUESTS from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE "
+      " where AGENT_NAME=? and VIRTUALHOST_NAME=?;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindText(statement, 1, agent_name);
+    sqlite_wrapper_->BindText(statement, 2, virtualhost_name);
+
+    if (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      configuration.enabled = sqlite_wrapper_->ColumnInt(statement, 0) != 0;
+      configuration.threshold = sqlite_wrapper_->ColumnDouble(statement, 1);
+      configuration.min_requests = sqlite_wrapper_->ColumnInt(statement, 2);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return configuration;
+}
+
+void DatabaseFunctions::SetRealtimeScoringConfiguration(const std::string &agent_name,
+                                                        const std::string &virtualhost_name,
+                                                        const ::apache::type::RealtimeScoringConfiguration &configuration) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::SetRealtimeScoringConfiguration: Function call";
+
+  const string sql =
+      "update APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE "
+      " set REALTIME_SCORING=" + to_string(configuration.enabled ? 1 : 0) +
+      "   , REALTIME_THRESHOLD=?"
+      "   , REALTIME_MIN_REQUESTS=" + to_string(configuration.min_requests) +
+      " where AGENT_NAME=? and VIRTUALHOST_NAME=?;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindDouble(statement, 1, configuration.threshold);
+    sqlite_wrapper_->BindText(statement, 2, agent_name);
+    sqlite_wrapper_->BindText(statement, 3, virtualhost_name);
+    sqlite_wrapper_->Step(statement);
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
 }
 
 ::database::type::AgentNames DatabaseFunctions::GetAgentNames() {
@@ -901,6 +1325,9 @@ void DatabaseFunctions::SetLearningSessions(const RowId &agent_id,
                                             const RowIds &sessions_ids) {
   BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::SetLearningSessions: Function call";
 
+  auto sketches = GetLearningSetSketches(agent_id, virtualhost_id);
+  const RowId last_id = sqlite_wrapper_->GetFirstInt64Column("select ifnull(max(ID), 0) from APACHE_LEARNING_SESSIONS;");
+
   string sql;
   sql = "begin transaction; ";
 
@@ -917,6 +1344,12 @@ void DatabaseFunctions::SetLearningSessions(const RowId &agent_id,
   sql += "end transaction; ";
 
   sqlite_wrapper_->Exec(sql);
+
+  // sessions already in the learning set were ignored, they don't get new ids
+  AddLearningSessionsToSketches(agent_id, virtualhost_id, last_id, sketches);
+  SaveLearningSetSketches(agent_id, virtualhost_id, sketches);
+
+  IncrementLearningSetVersion(agent_id, virtualhost_id);
 }
 
 void DatabaseFunctions::RemoveAllLearningSessions(const RowId &agent_id,
@@ -928,9 +1361,114 @@ void DatabaseFunctions::RemoveAllLearningSessions(const RowId &agent_id,
       "    AGENT_NAME_ID=" + to_string(agent_id) +
       "  and " +
       "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      "; "
+      "delete from APACHE_LEARNING_SET_SKETCHES where "
+      "    AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
       ";";
 
   sqlite_wrapper_->Exec(sql);
+
+  // the persisted index and normalization were built from removed sessions
+  IncrementLearningSetVersion(agent_id, virtualhost_id);
+}
+
+::database::type::RowId DatabaseFunctions::GetLearningSetVersion(const RowId &agent_id,
+                                                                 const RowId &virtualhost_id) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::GetLearningSetVersion: Function call";
+
+  string sql =
+      "select ifnull(max(VERSION), 0) from APACHE_LEARNING_SET_VERSIONS "
+      " where "
+      "    AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      ";";
+
+  return sqlite_wrapper_->GetFirstInt64Column(sql);
+}
+
+::apache::type::FeatureNormalization DatabaseFunctions::GetFeatureNormalization(const RowId &agent_id,
+                                                                                const RowId &virtualhost_id) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::GetFeatureNormalization: Function call";
+  ::apache::type::FeatureNormalization n;
+  n.learning_set_version = -1;
+  n.session_length = n.bandwidth_usage = n.requests_count = n.error_percentage = {0., 1.};
+
+  string sql =
+      "select LEARNING_SET_VERSION, "
+      "    SESSION_LENGTH_MEAN, SESSION_LENGTH_STDDEV, "
+      "    BANDWIDTH_USAGE_MEAN, BANDWIDTH_USAGE_STDDEV, "
+      "    REQUESTS_COUNT_MEAN, REQUESTS_COUNT_STDDEV, "
+      "    ERROR_PERCENTAGE_MEAN, ERROR_PERCENTAGE_STDDEV "
+      "  from APACHE_FEATURE_NORMALIZATION "
+      " where "
+      "    AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      ";";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    if (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      n.learning_set_version = sqlite_wrapper_->ColumnInt64(statement, 0);
+      n.session_length.mean = sqlite_wrapper_->ColumnDouble(statement, 1);
+      n.session_length.standard_deviation = sqlite_wrapper_->ColumnDouble(statement, 2);
+      n.bandwidth_usage.mean = sqlite_wrapper_->ColumnDouble(statement, 3);
+      n.bandwidth_usage.standard_deviation = sqlite_wrapper_->ColumnDouble(statement, 4);
+      n.requests_count.mean = sqlite_wrapper_->ColumnDouble(statement, 5);
+      n.requests_count.standard_deviation = sqlite_wrapper_->ColumnDouble(statement, 6);
+      n.error_percentage.mean = sqlite_wrapper_->ColumnDouble(statement, 7);
+      n.error_percentage.standard_deviation = sqlite_wrapper_->ColumnDouble(statement, 8);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return n;
+}
+
+void DatabaseFunctions::SetFeatureNormalization(const RowId &agent_id,
+                                                const RowId &virtualhost_id,
+                                                const ::apache::type::FeatureNormalization &normalization) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::SetFeatureNormalization: Function call";
+
+  string sql =
+      "insert or replace into APACHE_FEATURE_NORMALIZATION (AGENT_NAME_ID, VIRTUALHOST_NAME_ID, LEARNING_SET_VERSION, "
+      "    SESSION_LENGTH_MEAN, SESSION_LENGTH_STDDEV, "
+      "    BANDWIDTH_USAGE_MEAN, BANDWIDTH_USAGE_STDDEV, "
+      "    REQUESTS_COUNT_MEAN, REQUESTS_COUNT_STDDEV, "
+      "    ERROR_PERCENTAGE_MEAN, ERROR_PERCENTAGE_STDDEV) "
+      "  values (" + to_string(agent_id) + ", " + to_string(virtualhost_id) + ", " + to_string(normalization.learning_set_version) + ", "
+      "    ?, ?, ?, ?, ?, ?, ?, ?);";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindDouble(statement, 1, normalization.session_length.mean);
+    sqlite_wrapper_->BindDouble(statement, 2, normalization.session_length.standard_deviation);
+    sqlite_wrapper_->BindDouble(statement, 3, normalization.bandwidth_usage.mean);
+    sqlite_wrapper_->BindDouble(statement, 4, normalization.bandwidth_usage.standard_deviation);
+    sqlite_wrapper_->BindDouble(statement, 5, normalization.requests_count.mean);
+    sqlite_wrapper_->BindDouble(statement, 6, normalization.requests_count.standard_deviation);
+    sqlite_wrapper_->BindDouble(statement, 7, normalization.error_percentage.mean);
+    sqlite_wrapper_->BindDouble(statement, 8, normalization.error_percentage.standard_deviation);
+    sqlite_wrapper_->Step(statement);
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
 }
 
 DatabaseFunctions::DatabaseFunctions(::database::DatabasePtr db,
@@ -938,7 +1476,184 @@ DatabaseFunctions::DatabaseFunctions(::database::DatabasePtr db,
                                      ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions) :
 db_(db),
 sqlite_wrapper_(sqlite_wrapper),
-general_database_functions_(general_database_functions) {
+general_database_functions_(general_database_functions),
+session_classification_writer_(::database::ClassificationWriter::Create(sqlite_wrapper, "APACHE_SESSION_TABLE")) {
+}
+
+void DatabaseFunctions::AddColumnIfNotExists(const std::string &table,
+                                             const std::string &column,
+                                             const std::string &definition) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::AddColumnIfNotExists: Function call";
+
+  const string sql =
+      "select count(*) from sqlite_master "
+      " where type='table' and name='" + table + "' and sql like '%" + column + "%';";
+
+  if (sqlite_wrapper_->GetFirstInt64Column(sql) == 0) {
+    BOOST_LOG_TRIVIAL(info) << "apache::database::DatabaseFunctions::AddColumnIfNotExists: Adding column " << column << " to " << table;
+    sqlite_wrapper_->Exec("alter table " + table + " add column " + column + " " + definition + ";");
+  }
+}
+
+void DatabaseFunctions::AddSessions(const std::string &table, const ::apache::type::ApacheSessions &sessions) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::DatabaseFunctions::AddSessions: Adding " << sessions.size() << " sessions to " << table;
+
+  const string sql =
+      "insert into " + table + " (AGENT_NAME, VIRTUALHOST, CLIENT_IP, UTC_HOUR, UTC_MINUTE, UTC_SECOND, UTC_DAY, UTC_MONTH, UTC_YEAR, "
+      "  SESSION_LENGTH, BANDWIDTH_USAGE, REQUESTS_COUNT, ERRORS_COUNT, ERROR_PERCENTAGE, USER_AGENT, CLASSIFICATION) "
+      " values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+  sqlite3_stmt *statement;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    for (const auto &session : sessions) {
+      sqlite_wrapper_->BindText(statement, 1, session.agent_name);
+      sqlite_wrapper_->BindText(statement, 2, session.virtualhost);
+      sqlite_wrapper_->BindText(statement, 3, session.client_ip);
+      sqlite_wrapper_->BindInt(statement, 4, session.session_start.GetTime().GetHour());
+      sqlite_wrapper_->BindInt(statement, 5, session.session_start.GetTime().GetMinute());
+      sqlite_wrapper_->BindInt(statement, 6, session.session_start.GetTime().GetSecond());
+      sqlite_wrapper_->BindInt(statement, 7, session.session_start.GetDate().GetDay());
+      sqlite_wrapper_->BindInt(statement, 8, session.session_start.GetDate().GetMonth());
+      sqlite_wrapper_->BindInt(statement, 9, session.session_start.GetDate().GetYear());
+      sqlite_wrapper_->BindInt64(statement, 10, session.session_length);
+      sqlite_wrapper_->BindInt64(statement, 11, session.bandwidth_usage);
+      sqlite_wrapper_->BindInt64(statement, 12, session.requests_count);
+      sqlite_wrapper_->BindInt64(statement, 13, session.errors_count);
+      sqlite_wrapper_->BindDouble(statement, 14, session.error_percentage);
+      sqlite_wrapper_->BindText(statement, 15, session.useragent);
+      sqlite_wrapper_->BindInt(statement, 16, static_cast<int> (session.classification));
+
+      sqlite_wrapper_->Step(statement);
+      sqlite_wrapper_->Reset(statement);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+}
+
+void DatabaseFunctions::IncrementLearningSetVersion(const RowId &agent_id,
+                                                    const RowId &virtualhost_id) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::IncrementLearningSetVersion: Function call";
+
+  string sql =
+      "insert or ignore into APACHE_LEARNING_SET_VERSIONS ( AGENT_NAME_ID, VIRTUALHOST_NAME_ID, VERSION ) "
+      "values ( " + to_string(agent_id) + ", " + to_string(virtualhost_id) + ", 0 ); "
+      "update APACHE_LEARNING_SET_VERSIONS set VERSION=VERSION+1 "
+      " where "
+      "    AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      ";";
+
+  sqlite_wrapper_->Exec(sql);
+}
+
+::apache::type::LearningSetSketches DatabaseFunctions::GetLearningSetSketches(const RowId &agent_id,
+                                                                              const RowId &virtualhost_id) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::GetLearningSetSketches: Function call";
+  ::apache::type::LearningSetSketches sketches;
+
+  const string sql =
+      "select FEATURE, SKETCH from APACHE_LEARNING_SET_SKETCHES "
+      " where "
+      "    AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      ";";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      const unsigned feature = sqlite_wrapper_->ColumnInt(statement, 0);
+
+      // a damaged sketch is left empty, the counts don't match and all
+      // sketches are rebuilt before they are used
+      if (feature < sketches.size() && !sketches[feature].Deserialize(sqlite_wrapper_->ColumnBlob(statement, 1)))
+        BOOST_LOG_TRIVIAL(warning) << "database::DatabaseFunctions::GetLearningSetSketches: Invalid sketch of feature " << feature;
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return sketches;
+}
+
+void DatabaseFunctions::SaveLearningSetSketches(const RowId &agent_id,
+                                                const RowId &virtualhost_id,
+                                                const ::apache::type::LearningSetSketches &sketches) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::SaveLearningSetSketches: Function call";
+
+  const string sql =
+      "insert or replace into APACHE_LEARNING_SET_SKETCHES ( AGENT_NAME_ID, VIRTUALHOST_NAME_ID, FEATURE, SKETCH ) "
+      "values ( " + to_string(agent_id) + ", " + to_string(virtualhost_id) + ", ?, ? );";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    for (unsigned i = 0; i < sketches.size(); ++i) {
+      // the blob is bound without copying, it must live until the step
+      const string data = sketches[i].Serialize();
+
+      sqlite_wrapper_->BindInt(statement, 1, i);
+      sqlite_wrapper_->BindBlob(statement, 2, data);
+      sqlite_wrapper_->Step(statement);
+      sqlite_wrapper_->Reset(statement);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+}
+
+void DatabaseFunctions::AddLearningSessionsToSketches(const RowId &agent_id,
+                                                      const RowId &virtualhost_id,
+                                                      const RowId &after_id,
+                                                      ::apache::type::LearningSetSketches &sketches) {
+  BOOST_LOG_TRIVIAL(debug) << "database::DatabaseFunctions::AddLearningSessionsToSketches: Function call";
+
+  const string sql =
+      "select s.SESSION_LENGTH, s.BANDWIDTH_USAGE, s.REQUESTS_COUNT, s.ERROR_PERCENTAGE "
+      " from APACHE_LEARNING_SESSIONS l "
+      " join APACHE_SESSION_TABLE s on s.ID=l.SESSION_ID "
+      " where "
+      "    l.AGENT_NAME_ID=" + to_string(agent_id) +
+      "  and " +
+      "    l.VIRTUALHOST_NAME_ID=" + to_string(virtualhost_id) +
+      "  and " +
+      "    l.ID>" + to_string(after_id) +
+      ";";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW) {
+      for (unsigned i = 0; i < sketches.size(); ++i)
+        sketches[i].Add(sqlite_wrapper_->ColumnDouble(statement, i));
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
 }
 
 string DatabaseFunctions::GetTimeRule(const ::type::Timestamp &from, const ::type::Timestamp &to) const {
@@ -11,6 +11,8 @@
 
 #include "detail/database_functions_interface.h"
 
+#include "src/apache/type/learning_set_sketches.h"
+#include "src/database/classification_writer.h"
 #include "src/database/detail/general_database_functions_interface.h"
 #include "src/database/detail/sqlite_wrapper_interface.h"
 // will be removed in the future
@@ -39,10 +41,17 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
   const ::apache::type::AnomalyDetectionConfiguration GetAnomalyDetectionConfigurations() override;
 
   void AddLogs(const ::type::ApacheLogs &log_entries) override;
-  ::database::type::RowsCount GetUnusedLogsCount(std::string agent_name, std::string virtualhost_name) override;
-  ::type::ApacheLogs GetUnusedLogs(std::string agent_name, std::string virtualhost_name,
-                                   unsigned limit, ::database::type::RowsCount offset) override;
-  void MarkLogsAsUsed(const ::type::ApacheLogs &logs) override;
+  ::database::type::RowId GetLastLogId() override;
+  ::type::ApacheLogs GetLogsAfter(const ::database::type::RowId &id, unsigned limit) override;
+
+  ::apache::type::SessionizerCheckpoint GetSessionizerCheckpoint() override;
+  void SaveSessionizerCheckpoint(const ::apache::type::ApacheSessions &closed_sessions,
+                                 const ::apache::type::SessionizerCheckpoint &checkpoint) override;
+  ::apache::type::TrafficSketchesList GetTrafficSketches(const std::string &agent_name,
+                                                         const std::string &virtualhost_name,
+                                                         const ::type::Timestamp &from,
+                                                         const ::type::Timestamp &to) override;
+  void SaveTrafficSketches(const ::apache::type::TrafficSketchesList &sketches) override;
 
   bool AddSessionStatistics(const ::apache::type::ApacheSessions &sessions) override;
   ::database::type::RowsCount GetSessionStatisticsCount(const std::string &agent_name, const std::string &virtualhost_name,
@@ -64,11 +73,23 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
                                                                         unsigned limit, long long offset) override;
   ::apache::type::ApacheSessionEntry GetOneSessionStatistic(::database::type::RowId id) override;
   void UpdateSessionStatisticClassification(const ::database::type::RowId &id, const ::database::type::Classification &classification) override;
+  void UpdateSessionStatisticsClassification(const ::database::type::RowIds &ids, const ::database::type::Classification &classification) override;
   void ClearAnomalyMarksInLearningSet(const ::database::type::RowId &agent_name_id,
                                       const ::database::type::RowId &virtualhost_name_id) override;
   void MarkLearningSetWithIqrMethod(const ::database::type::RowId &agent_name_id,
                                     const ::database::type::RowId &virtualhost_name_id) override;
 
+  ::apache::type::KnnConfiguration GetKnnConfiguration(const std::string &agent_name,
+                                                       const std::string &virtualhost_name) override;
+  void SetKnnConfiguration(const std::string &agent_name,
+                           const std::string &virtualhost_name,
+                           const ::apache::type::KnnConfiguration &configuration) override;
+  ::apache::type::RealtimeScoringConfiguration GetRealtimeScoringConfiguration(const std::string &agent_name,
+                                                                               const std::string &virtualhost_name) override;
+  void SetRealtimeScoringConfiguration(const std::string &agent_name,
+                                       const std::string &virtualhost_name,
+                                       const ::apache::type::RealtimeScoringConfiguration &configuration) override;
+
   virtual ::database::type::AgentNames GetAgentNames() override;
 
   virtual ::database::type::VirtualhostNames GetVirtualhostNames(::database::type::AgentName agent_name) override;
@@ -94,17 +115,44 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
                            const ::database::type::RowIds &sessions_ids) override;
   void RemoveAllLearningSessions(const ::database::type::RowId &agent_id,
                                  const ::database::type::RowId &virtualhost_id) override;
+  ::database::type::RowId GetLearningSetVersion(const ::database::type::RowId &agent_id,
+                                               const ::database::type::RowId &virtualhost_id) override;
+
+  ::apache::type::FeatureNormalization GetFeatureNormalization(const ::database::type::RowId &agent_id,
+                                                               const ::database::type::RowId &virtualhost_id) override;
+  void SetFeatureNormalization(const ::database::type::RowId &agent_id,
+                               const ::database::type::RowId &virtualhost_id,
+                               const ::apache::type::FeatureNormalization &normalization) override;
 
  private:
   ::database::DatabasePtr db_;
   ::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper_;
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
+  ::database::ClassificationWriterPtr session_classification_writer_;
 
   DatabaseFunctions(::database::DatabasePtr db,
                     ::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper,
                     ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions);
 
   std::string GetTimeRule(const ::type::Timestamp &from, const ::type::Timestamp &to) const;
+  void AddColumnIfNotExists(const std::string &table,
+                            const std::string &column,
+                            const std::string &definition);
+  void AddSessions(const std::string &table, const ::apache::type::ApacheSessions &sessions);
+  void IncrementLearningSetVersion(const ::database::type::RowId &agent_id,
+                                   const ::database::type::RowId &virtualhost_id);
+
+  ::apache::type::LearningSetSketches GetLearningSetSketches(const ::database::type::RowId &agent_id,
+                                                             const ::database::type::RowId &virtualhost_id);
+  void SaveLearningSetSketches(const ::database::type::RowId &agent_id,
+                               const ::database::type::RowId &virtualhost_id,
+                               const ::apache::type::LearningSetSketches &sketches);
+  // Adds features of learning set sessions with APACHE_LEARNING_SESSIONS.ID
+  // greater than after_id.
+  void AddLearningSessionsToSketches(const ::database::type::RowId &agent_id,
+                                     const ::database::type::RowId &virtualhost_id,
+                                     const ::database::type::RowId &after_id,
+                                     ::apache::type::LearningSetSketches &sketches);
 };
 
 }
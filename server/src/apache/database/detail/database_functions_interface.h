@@ -15,6 +15,11 @@
 #include "src/database/type/agent_name.h"
 #include "src/database/type/virtualhost_name.h"
 #include "src/apache/type/anomaly_detection_configuration_entry.h"
+#include "src/apache/type/knn_configuration.h"
+#include "src/apache/type/realtime_scoring_configuration.h"
+#include "src/apache/type/traffic_sketches.h"
+#include "src/apache/type/feature_normalization.h"
+#include "src/apache/type/sessionizer_checkpoint.h"
 
 namespace apache
 {
@@ -35,10 +40,19 @@ class DatabaseFunctionsInterface {
   virtual const ::apache::type::AnomalyDetectionConfiguration GetAnomalyDetectionConfigurations() = 0;
 
   virtual void AddLogs(const ::type::ApacheLogs &log_entries) = 0;
-  virtual ::database::type::RowsCount GetUnusedLogsCount(std::string agent_name, std::string virtualhost_name) = 0;
-  virtual ::type::ApacheLogs GetUnusedLogs(std::string agent_name, std::string virtualhost_name,
-                                           unsigned limit, ::database::type::RowsCount offset) = 0;
-  virtual void MarkLogsAsUsed(const ::type::ApacheLogs &logs) = 0;
+  virtual ::database::type::RowId GetLastLogId() = 0;
+  virtual ::type::ApacheLogs GetLogsAfter(const ::database::type::RowId &id, unsigned limit) = 0;
+
+  virtual ::apache::type::SessionizerCheckpoint GetSessionizerCheckpoint() = 0;
+  virtual void SaveSessionizerCheckpoint(const ::apache::type::ApacheSessions &closed_sessions,
+                                         const ::apache::type::SessionizerCheckpoint &checkpoint) = 0;
+
+  // Hours between from and to, both included; minutes and seconds are ignored.
+  virtual ::apache::type::TrafficSketchesList GetTrafficSketches(const std::string &agent_name,
+                                                                 const std::string &virtualhost_name,
+                                                                 const ::type::Timestamp &from,
+                                                                 const ::type::Timestamp &to) = 0;
+  virtual void SaveTrafficSketches(const ::apache::type::TrafficSketchesList &sketches) = 0;
 
   virtual bool AddSessionStatistics(const ::apache::type::ApacheSessions &sessions) = 0;
   virtual ::database::type::RowsCount GetSessionStatisticsCount(const std::string &agent_name, const std::string &virtualhost_name,
@@ -59,11 +73,23 @@ class DatabaseFunctionsInterface {
                                                                                 unsigned limit, long long offset) = 0;
   virtual ::apache::type::ApacheSessionEntry GetOneSessionStatistic(::database::type::RowId id) = 0;
   virtual void UpdateSessionStatisticClassification(const ::database::type::RowId &id, const ::database::type::Classification &classification) = 0;
+  virtual void UpdateSessionStatisticsClassification(const ::database::type::RowIds &ids, const ::database::type::Classification &classification) = 0;
   virtual void ClearAnomalyMarksInLearningSet(const ::database::type::RowId &agent_name_id,
                                               const ::database::type::RowId &virtualhost_name_id) = 0;
   virtual void MarkLearningSetWithIqrMethod(const ::database::type::RowId &agent_name_id,
                                             const ::database::type::RowId &virtualhost_name_id) = 0;
 
+  virtual ::apache::type::KnnConfiguration GetKnnConfiguration(const std::string &agent_name,
+                                                               const std::string &virtualhost_name) = 0;
+  virtual void SetKnnConfiguration(const std::string &agent_name,
+                                   const std::string &virtualhost_name,
+                                   const ::apache::type::KnnConfiguration &configuration) = 0;
+  virtual ::apache::type::RealtimeScoringConfiguration GetRealtimeScoringConfiguration(const std::string &agent_name,
+                                                                                       const std::string &virtualhost_name) = 0;
+  virtual void SetRealtimeScoringConfiguration(const std::string &agent_name,
+                                               const std::string &virtualhost_name,
+                                               const ::apache::type::RealtimeScoringConfiguration &configuration) = 0;
+
   virtual ::database::type::AgentNames GetAgentNames() = 0;
 
   virtual ::database::type::VirtualhostNames GetVirtualhostNames(::database::type::AgentName agent_name) = 0;
@@ -89,6 +115,14 @@ class DatabaseFunctionsInterface {
                                    const ::database::type::RowIds &sessions_ids) = 0;
   virtual void RemoveAllLearningSessions(const ::database::type::RowId &agent_id,
                                          const ::database::type::RowId &virtualhost_id) = 0;
+  virtual ::database::type::RowId GetLearningSetVersion(const ::database::type::RowId &agent_id,
+                                                       const ::database::type::RowId &virtualhost_id) = 0;
+
+  virtual ::apache::type::FeatureNormalization GetFeatureNormalization(const ::database::type::RowId &agent_id,
+                                                                       const ::database::type::RowId &virtualhost_id) = 0;
+  virtual void SetFeatureNormalization(const ::database::type::RowId &agent_id,
+                                       const ::database::type::RowId &virtualhost_id,
+                                       const ::apache::type::FeatureNormalization &normalization) = 0;
 };
 
 typedef std::shared_ptr<DatabaseFunctionsInterface> DatabaseFunctionsInterfacePtr;
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "read_connection_pool.h"
+
+#include <boost/log/trivial.hpp>
+
+#include "database_functions.h"
+#include "src/database/general_database_functions.h"
+
+namespace apache
+{
+
+namespace database
+{
+
+ReadConnectionPool::~ReadConnectionPool() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::ReadConnectionPool::~ReadConnectionPool: Function call";
+
+  released_connections_.clear();
+
+  for (auto &sqlite_wrapper : sqlite_wrappers_) {
+    try {
+      sqlite_wrapper->Close();
+    }
+    catch (std::exception &ex) {
+      BOOST_LOG_TRIVIAL(error) << "apache::database::ReadConnectionPool::~ReadConnectionPool: Failed to close connection: " << ex.what();
+    }
+  }
+}
+
+ReadConnectionPoolPtr ReadConnectionPool::Create(const std::string &database_file_path) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::ReadConnectionPool::Create: Function call";
+
+  return ReadConnectionPoolPtr(new ReadConnectionPool(database_file_path, ConnectionFactory()));
+}
+
+ReadConnectionPoolPtr ReadConnectionPool::Create(ConnectionFactory connection_factory) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::ReadConnectionPool::Create: Function call";
+
+  return ReadConnectionPoolPtr(new ReadConnectionPool("", connection_factory));
+}
+
+detail::DatabaseFunctionsInterfacePtr ReadConnectionPool::Acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!released_connections_.empty()) {
+      auto connection = released_connections_.back();
+      released_connections_.pop_back();
+      return connection;
+    }
+  }
+
+  return connection_factory_ ? connection_factory_() : OpenConnection();
+}
+
+void ReadConnectionPool::Release(detail::DatabaseFunctionsInterfacePtr connection) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  released_connections_.push_back(connection);
+}
+
+ReadConnectionPool::ReadConnectionPool(const std::string &database_file_path,
+                                       ConnectionFactory connection_factory) :
+database_file_path_(database_file_path),
+connection_factory_(connection_factory) {
+}
+
+detail::DatabaseFunctionsInterfacePtr ReadConnectionPool::OpenConnection() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::database::ReadConnectionPool::OpenConnection: Opening connection to " << database_file_path_;
+
+  auto sqlite_wrapper = ::database::SQLiteWrapper::Create();
+  sqlite_wrapper->OpenReadOnly(database_file_path_);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite_wrappers_.push_back(sqlite_wrapper);
+  }
+
+  auto db = ::database::Database::Create();
+  db->Open(sqlite_wrapper->GetSQLiteHandle());
+
+  auto general_database_functions = ::database::GeneralDatabaseFunctions::Create(db, sqlite_wrapper);
+
+  return DatabaseFunctions::Create(db, sqlite_wrapper, general_database_functions);
+}
+
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "detail/database_functions_interface.h"
+#include "src/database/sqlite_wrapper.h"
+
+namespace apache
+{
+
+namespace database
+{
+
+class ReadConnectionPool;
+typedef std::shared_ptr<ReadConnectionPool> ReadConnectionPoolPtr;
+
+// Read-only connections used by analyzer tasks running in parallel. A connection
+// is opened when no released one is available, so there are never more of them
+// than concurrently running tasks. Changes must be written through the main
+// connection.
+class ReadConnectionPool {
+ public:
+  typedef std::function<detail::DatabaseFunctionsInterfacePtr()> ConnectionFactory;
+
+  ~ReadConnectionPool();
+
+  static ReadConnectionPoolPtr Create(const std::string &database_file_path);
+  static ReadConnectionPoolPtr Create(ConnectionFactory connection_factory);
+
+  detail::DatabaseFunctionsInterfacePtr Acquire();
+  void Release(detail::DatabaseFunctionsInterfacePtr connection);
+
+ private:
+  ReadConnectionPool(const std::string &database_file_path,
+                     ConnectionFactory connection_factory);
+
+  detail::DatabaseFunctionsInterfacePtr OpenConnection();
+
+  const std::string database_file_path_;
+  ConnectionFactory connection_factory_;
+
+  std::mutex mutex_;
+  std::vector<detail::DatabaseFunctionsInterfacePtr> released_connections_;
+  std::vector< ::database::SQLiteWrapperPtr> sqlite_wrappers_;
+};
+
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include <boost/log/trivial.hpp>
 
+#include "src/apache/analyzer/apache_analyzer_object.h"
+
 namespace apache
 {
 
@@ -13,10 +15,18 @@ namespace object
 
 Apache::Apache(::database::DatabasePtr database,
                ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-               ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions) :
+               ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+               ::apache::analyzer::StreamingSessionizerPtr sessionizer,
+               ::apache::analyzer::RealtimeScorerPtr realtime_scorer,
+               ::apache::analyzer::TrafficCounterPtr traffic_counter,
+               ::analyzer::detail::AnalyzerInterfacePtr analyzer) :
 database_(database),
 general_database_functions_(general_database_functions),
-apache_database_functions_(apache_database_functions) {
+apache_database_functions_(apache_database_functions),
+sessionizer_(sessionizer),
+realtime_scorer_(realtime_scorer),
+traffic_counter_(traffic_counter),
+analyzer_(analyzer) {
 }
 
 Apache::~Apache() {
@@ -115,7 +125,10 @@ DBusHandlerResult Apache::OwnMessageHandler(DBusConnection *connection, DBusMess
     general_database_functions_->AddAgentName(agent_name);
     apache_database_functions_->AddVirtualhostName(virtualhost);
 
-    apache_database_functions_->AddLogs({log_entry});
+    sessionizer_->AddLogs({log_entry});
+    realtime_scorer_->AddLogs({log_entry});
+    traffic_counter_->AddLogs({log_entry});
+    analyzer_->AddData(::apache::analyzer::ApacheAnalyzerObject::NAME, 1);
 
     DBusMessage *reply_msg = dbus_message_new_method_return(message);
     BOOST_LOG_TRIVIAL(debug) << "objects::Apache::OwnMessageHandler: Sending reply";
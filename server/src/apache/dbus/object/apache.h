@@ -8,6 +8,10 @@
 #include "src/database/database.h"
 #include "src/database/detail/general_database_functions_interface.h"
 #include "src/apache/database/detail/database_functions_interface.h"
+#include "src/apache/analyzer/realtime_scorer.h"
+#include "src/apache/analyzer/traffic_counter.h"
+#include "src/apache/analyzer/streaming_sessionizer.h"
+#include "src/analyzer/detail/analyzer_interface.h"
 
 namespace apache
 {
@@ -22,7 +26,11 @@ class Apache : public ::dbus::Object {
  public:
   Apache(::database::DatabasePtr database,
          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-         ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions);
+         ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+         ::apache::analyzer::StreamingSessionizerPtr sessionizer,
+         ::apache::analyzer::RealtimeScorerPtr realtime_scorer,
+         ::apache::analyzer::TrafficCounterPtr traffic_counter,
+         ::analyzer::detail::AnalyzerInterfacePtr analyzer);
   virtual ~Apache();
 
   const char* GetPath();
@@ -34,6 +42,10 @@ class Apache : public ::dbus::Object {
 
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
   ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions_;
+  ::apache::analyzer::StreamingSessionizerPtr sessionizer_;
+  ::apache::analyzer::RealtimeScorerPtr realtime_scorer_;
+  ::apache::analyzer::TrafficCounterPtr traffic_counter_;
+  ::analyzer::detail::AnalyzerInterfacePtr analyzer_;
   ::database::DatabasePtr database_;
 };
 
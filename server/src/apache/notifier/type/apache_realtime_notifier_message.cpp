@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "apache_realtime_notifier_message.h"
+
+#include <boost/log/trivial.hpp>
+
+using namespace std;
+
+namespace apache
+{
+
+namespace notifier
+{
+
+namespace type
+{
+
+ApacheRealtimeNotifierMessagePtr ApacheRealtimeNotifierMessage::Create(::apache::analyzer::type::RealtimeAlerts alerts) {
+  return ApacheRealtimeNotifierMessagePtr(new ApacheRealtimeNotifierMessage(alerts));
+}
+
+std::string ApacheRealtimeNotifierMessage::GetModuleName() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::notifier::ApacheRealtimeNotifierMessage::GetModuleName: Function call";
+  return "Apache Logs Realtime Scoring";
+}
+
+std::string ApacheRealtimeNotifierMessage::GetDetectionResults() {
+  BOOST_LOG_TRIVIAL(debug) << "apache::notifier::ApacheRealtimeNotifierMessage::GetDetectionResults: Function call";
+
+  std::string results = "Suspicious clients found while receiving logs, they will be classified "
+      "with the next sessions analysis.\r\n\r\n";
+
+  for (const auto &a : alerts_) {
+    results += "    ...........................................................................\r\n";
+    results += "    Agent:                   " + a.agent_name + "\r\n";
+    results += "    Virtualhost:             " + a.virtualhost_name + "\r\n";
+    results += "    IP:                      " + a.client_ip + "\r\n";
+    results += "    Last request:            " + a.time.ToString() + "\r\n";
+    results += "    Window length (s):       " + to_string(a.window_length) + "\r\n";
+    results += "    Bandwidth usage (bytes): " + to_string(a.bandwidth_usage) + "\r\n";
+    results += "    Requests count:          " + to_string(a.requests_count) + "\r\n";
+    results += "    Error requests (%):      " + to_string(a.error_percentage) + "\r\n";
+    results += "    Score:                   " + to_string(a.score) + "\r\n";
+    results += "    ...........................................................................\r\n";
+
+    results += "\r\n";
+  }
+
+  return results;
+}
+
+ApacheRealtimeNotifierMessage::ApacheRealtimeNotifierMessage(::apache::analyzer::type::RealtimeAlerts alerts) :
+alerts_(alerts) {
+}
+
+}
+
+}
+
+}
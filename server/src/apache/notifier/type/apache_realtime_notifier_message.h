@@ -0,0 +1,42 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/notifier/type/notifier_message_interface.h"
+#include "src/apache/analyzer/type/realtime_alert.h"
+
+namespace apache
+{
+
+namespace notifier
+{
+
+namespace type
+{
+
+class ApacheRealtimeNotifierMessage;
+typedef std::shared_ptr<ApacheRealtimeNotifierMessage> ApacheRealtimeNotifierMessagePtr;
+
+class ApacheRealtimeNotifierMessage : public ::notifier::type::NotifierMessageInterface {
+ public:
+  virtual ~ApacheRealtimeNotifierMessage() = default;
+
+  static ApacheRealtimeNotifierMessagePtr Create(::apache::analyzer::type::RealtimeAlerts alerts);
+
+  std::string GetModuleName();
+  std::string GetDetectionResults();
+
+ private:
+  explicit ApacheRealtimeNotifierMessage(::apache::analyzer::type::RealtimeAlerts alerts);
+
+  const ::apache::analyzer::type::RealtimeAlerts alerts_;
+};
+
+}
+
+}
+
+}
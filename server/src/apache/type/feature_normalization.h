@@ -0,0 +1,34 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace type
+{
+
+struct FeatureScale {
+  double mean;
+  double standard_deviation;
+};
+
+// Session features are normalized with (x - mean) / standard_deviation.
+// learning_set_version is the version of the learning set the values were
+// computed from, -1 when they weren't computed yet.
+struct FeatureNormalization {
+  ::database::type::RowId learning_set_version;
+  FeatureScale session_length;
+  FeatureScale bandwidth_usage;
+  FeatureScale requests_count;
+  FeatureScale error_percentage;
+};
+
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+namespace apache
+{
+
+namespace type
+{
+
+enum class KnnMode
+{
+  EXACT,
+  APPROXIMATE
+};
+
+enum class KnnVoting
+{
+  MAJORITY,
+  DISTANCE_WEIGHTED
+};
+
+// hnsw_m and hnsw_ef are used only in approximate mode
+struct KnnConfiguration {
+  KnnMode mode;
+  unsigned hnsw_m;
+  unsigned hnsw_ef;
+  unsigned neighbours_count;
+  KnnVoting voting;
+};
+
+}
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "src/analyzer/sketch/quantile_sketch.h"
+
+namespace apache
+{
+
+namespace type
+{
+
+enum class SessionFeature
+{
+  SESSION_LENGTH,
+  BANDWIDTH_USAGE,
+  REQUESTS_COUNT,
+  ERROR_PERCENTAGE
+};
+
+constexpr unsigned SESSION_FEATURES_COUNT = 4;
+
+// Quantile sketches of learning set sessions features, indexed by
+// SessionFeature.
+typedef std::array< ::analyzer::sketch::QuantileSketch, SESSION_FEATURES_COUNT> LearningSetSketches;
+
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+namespace apache
+{
+
+namespace type
+{
+
+// Client is reported when any of its window features differs from the
+// learning set mean by more than threshold standard deviations and it sent
+// at least min_requests requests in the window.
+struct RealtimeScoringConfiguration {
+  bool enabled;
+  double threshold;
+  unsigned min_requests;
+};
+
+}
+
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "apache_session_entry.h"
+#include "src/database/type/row_id.h"
+
+namespace apache
+{
+
+namespace type
+{
+
+// Sessions which were open when the checkpoint was saved, last_log_id is
+// the id of the last log included in them.
+struct SessionizerCheckpoint {
+  ::database::type::RowId last_log_id;
+  ApacheSessions open_sessions;
+};
+
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <slas/type/timestamp.h>
+
+#include "src/analyzer/sketch/hyper_log_log.h"
+#include "src/analyzer/sketch/top_k.h"
+#include "src/database/type/rows_count.h"
+
+namespace apache
+{
+
+namespace type
+{
+
+// Traffic of a virtualhost in one hour, minutes and seconds of hour are 0.
+struct TrafficSketches {
+  std::string agent_name;
+  std::string virtualhost_name;
+  ::type::Timestamp hour;
+  ::database::type::RowsCount requests_count;
+  ::analyzer::sketch::HyperLogLog client_ips;
+  ::analyzer::sketch::HyperLogLog user_agents;
+  ::analyzer::sketch::TopK top_paths;
+  ::analyzer::sketch::TopK top_client_ips;
+};
+
+typedef std::vector<TrafficSketches> TrafficSketchesList;
+
+}
+
+}
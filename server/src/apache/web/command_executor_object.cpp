@@ -3,10 +3,14 @@
 #include <boost/log/trivial.hpp>
 #include <json/json.hpp>
 #include <algorithm>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <slas/type/time.h>
 
+#include "src/apache/analyzer/detail/prepare_statistics/knn_recall_evaluator.h"
+#include "src/analyzer/sketch/top_k.h"
+
 using namespace std;
 using namespace nlohmann;
 
@@ -16,11 +20,62 @@ namespace apache
 namespace web
 {
 
+namespace
+{
+
+json GetTopKJson(const ::analyzer::sketch::TopK &top_k) {
+  json r = json::array();
+
+  for (const auto &item : top_k.GetItems()) {
+    json t;
+    t["value"] = item.value;
+    t["count"] = item.count;
+    r.push_back(t);
+  }
+
+  return r;
+}
+
+// hnsw level multiplier is 1 / log(m)
+constexpr unsigned MIN_HNSW_M = 2;
+constexpr unsigned MAX_HNSW_M = 128;
+constexpr unsigned MAX_HNSW_EF = 4096;
+constexpr unsigned MAX_NEIGHBOURS_COUNT = 1024;
+
+bool ParseUnsigned(const std::string &text, unsigned min, unsigned max, unsigned &value) {
+  try {
+    std::size_t end = 0;
+    const long long v = std::stoll(text, &end);
+    if (end != text.size() || v < min || v > max)
+      return false;
+
+    value = static_cast<unsigned> (v);
+    return true;
+  }
+  catch (const std::logic_error &) {
+    return false;
+  }
+}
+
+json GetTrafficJson(const ::apache::type::TrafficSketches &s) {
+  json t;
+  t["requests_count"] = s.requests_count;
+  t["distinct_client_ips"] = static_cast<long long>(s.client_ips.GetEstimate() + 0.5);
+  t["distinct_user_agents"] = static_cast<long long>(s.user_agents.GetEstimate() + 0.5);
+  t["top_paths"] = GetTopKJson(s.top_paths);
+  t["top_client_ips"] = GetTopKJson(s.top_client_ips);
+
+  return t;
+}
+
+}
+
 CommandExecutorObjectPtr CommandExecutorObject::Create(::database::DatabasePtr database,
                                                        ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                                       ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions) {
+                                                       ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                                                       ::analyzer::WorkerPoolPtr worker_pool) {
   BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::Create: Function call";
-  auto p = CommandExecutorObjectPtr(new CommandExecutorObject(database, general_database_functions, apache_database_functions));
+  auto p = CommandExecutorObjectPtr(new CommandExecutorObject(database, general_database_functions, apache_database_functions, worker_pool));
   return p;
 }
 
@@ -133,6 +188,61 @@ const ::web::type::JsonMessage CommandExecutorObject::Execute(const ::web::type:
 
     result = RemoveConfiguration(args.at(0));
   }
+  else if (command == "set_apache_knn_configuration") {
+    BOOST_LOG_TRIVIAL(info) << "apache::web::CommandExecutorObject::Execute: Found 'set_apache_knn_configuration' command";
+
+    auto args = json_object["args"];
+    if (args.size() != 7) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::Execute: set_apache_knn_configuration require seven arguments";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = SetApacheKnnConfiguration(args.at(0), args.at(1), args.at(2), args.at(3), args.at(4), args.at(5), args.at(6));
+  }
+  else if (command == "set_apache_realtime_scoring_configuration") {
+    BOOST_LOG_TRIVIAL(info) << "apache::web::CommandExecutorObject::Execute: Found 'set_apache_realtime_scoring_configuration' command";
+
+    auto args = json_object["args"];
+    if (args.size() != 5) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::Execute: set_apache_realtime_scoring_configuration require five arguments";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = SetApacheRealtimeScoringConfiguration(args.at(0), args.at(1), args.at(2), args.at(3), args.at(4));
+  }
+  else if (command == "evaluate_apache_approximate_knn") {
+    BOOST_LOG_TRIVIAL(info) << "apache::web::CommandExecutorObject::Execute: Found 'evaluate_apache_approximate_knn' command";
+
+    auto args = json_object["args"];
+    if (args.size() != 4) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::Execute: evaluate_apache_approximate_knn require four arguments";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = EvaluateApacheApproximateKnn(args.at(0), args.at(1), args.at(2), args.at(3));
+  }
+  else if (command == "get_apache_hourly_traffic") {
+    BOOST_LOG_TRIVIAL(info) << "apache::web::CommandExecutorObject::Execute: Found 'get_apache_hourly_traffic' command";
+
+    auto args = json_object["args"];
+    if (args.size() != 3) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::Execute: get_apache_hourly_traffic require three arguments";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = GetApacheHourlyTraffic(args.at(0), args.at(1), args.at(2));
+  }
+  else if (command == "get_apache_traffic_summary") {
+    BOOST_LOG_TRIVIAL(info) << "apache::web::CommandExecutorObject::Execute: Found 'get_apache_traffic_summary' command";
+
+    auto args = json_object["args"];
+    if (args.size() != 4) {
+      BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::Execute: get_apache_traffic_summary require four arguments";
+      return GetInvalidArgumentErrorJson();
+    }
+
+    result = GetApacheTrafficSummary(args.at(0), args.at(1), args.at(2), args.at(3));
+  }
 
   return result;
 }
@@ -150,15 +260,22 @@ bool CommandExecutorObject::IsCommandSupported(const ::web::type::Command &comma
       || (command == "get_agents_and_virtualhosts_names_filtered_by_sessions_classification_exists")
       || (command == "get_learning_set_sessions")
       || (command == "remove_configuration")
+      || (command == "set_apache_knn_configuration")
+      || (command == "set_apache_realtime_scoring_configuration")
+      || (command == "evaluate_apache_approximate_knn")
+      || (command == "get_apache_hourly_traffic")
+      || (command == "get_apache_traffic_summary")
       ;
 }
 
 CommandExecutorObject::CommandExecutorObject(::database::DatabasePtr database,
                                              ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                             ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions) :
+                                             ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                                             ::analyzer::WorkerPoolPtr worker_pool) :
 database_(database),
 general_database_functions_(general_database_functions),
-apache_database_functions_(apache_database_functions) {
+apache_database_functions_(apache_database_functions),
+worker_pool_(worker_pool) {
 }
 
 const ::web::type::JsonMessage CommandExecutorObject::GetHostnames() {
@@ -256,6 +373,18 @@ const ::web::type::JsonMessage CommandExecutorObject::GetApacheAnomalyDetectionC
     t["begin_date"] = c.begin_date.ToString();
     t["end_date"] = c.end_date.ToString();
 
+    auto knn = apache_database_functions_->GetKnnConfiguration(c.agent_name, c.virtualhost_name);
+    t["knn_mode"] = (knn.mode == ::apache::type::KnnMode::APPROXIMATE) ? "approximate" : "exact";
+    t["hnsw_m"] = knn.hnsw_m;
+    t["hnsw_ef"] = knn.hnsw_ef;
+    t["knn_neighbours"] = knn.neighbours_count;
+    t["knn_voting"] = (knn.voting == ::apache::type::KnnVoting::DISTANCE_WEIGHTED) ? "distance_weighted" : "majority";
+
+    auto realtime = apache_database_functions_->GetRealtimeScoringConfiguration(c.agent_name, c.virtualhost_name);
+    t["realtime_scoring"] = realtime.enabled;
+    t["realtime_threshold"] = realtime.threshold;
+    t["realtime_min_requests"] = realtime.min_requests;
+
     r.push_back(t);
   }
 
@@ -447,6 +576,178 @@ const ::web::type::JsonMessage CommandExecutorObject::RemoveConfiguration(const
   return j.dump();
 }
 
+const ::web::type::JsonMessage CommandExecutorObject::SetApacheKnnConfiguration(const std::string &agent_name,
+                                                                                const std::string &virtualhost_name,
+                                                                                const std::string &mode,
+                                                                                const std::string &m,
+                                                                                const std::string &ef,
+                                                                                const std::string &neighbours_count,
+                                                                                const std::string &voting) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::SetApacheKnnConfiguration: Function call";
+
+  ::apache::type::KnnConfiguration c;
+  if (mode == "exact") {
+    c.mode = ::apache::type::KnnMode::EXACT;
+  }
+  else if (mode == "approximate") {
+    c.mode = ::apache::type::KnnMode::APPROXIMATE;
+  }
+  else {
+    BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::SetApacheKnnConfiguration: Unknown mode: " << mode;
+    return GetInvalidArgumentErrorJson();
+  }
+
+  if (voting == "majority") {
+    c.voting = ::apache::type::KnnVoting::MAJORITY;
+  }
+  else if (voting == "distance_weighted") {
+    c.voting = ::apache::type::KnnVoting::DISTANCE_WEIGHTED;
+  }
+  else {
+    BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::SetApacheKnnConfiguration: Unknown voting: " << voting;
+    return GetInvalidArgumentErrorJson();
+  }
+
+  if (!ParseUnsigned(m, MIN_HNSW_M, MAX_HNSW_M, c.hnsw_m)
+      || !ParseUnsigned(ef, 1, MAX_HNSW_EF, c.hnsw_ef)
+      || !ParseUnsigned(neighbours_count, 1, MAX_NEIGHBOURS_COUNT, c.neighbours_count)) {
+    BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::SetApacheKnnConfiguration: Wrong m, ef or neighbours count: " << m << ", " << ef << ", " << neighbours_count;
+    return GetInvalidArgumentErrorJson();
+  }
+
+  apache_database_functions_->SetKnnConfiguration(agent_name, virtualhost_name, c);
+
+  json j;
+  j["status"] = "ok";
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::SetApacheRealtimeScoringConfiguration(const std::string &agent_name,
+                                                                                            const std::string &virtualhost_name,
+                                                                                            const std::string &enabled,
+                                                                                            const std::string &threshold,
+                                                                                            const std::string &min_requests) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::SetApacheRealtimeScoringConfiguration: Function call";
+
+  ::apache::type::RealtimeScoringConfiguration c;
+  if (enabled == "true") {
+    c.enabled = true;
+  }
+  else if (enabled == "false") {
+    c.enabled = false;
+  }
+  else {
+    BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::SetApacheRealtimeScoringConfiguration: Unknown enabled value: " << enabled;
+    return GetInvalidArgumentErrorJson();
+  }
+
+  c.threshold = std::stod(threshold);
+  c.min_requests = std::stoul(min_requests);
+
+  apache_database_functions_->SetRealtimeScoringConfiguration(agent_name, virtualhost_name, c);
+
+  json j;
+  j["status"] = "ok";
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::EvaluateApacheApproximateKnn(const std::string &agent_name,
+                                                                                   const std::string &virtualhost_name,
+                                                                                   const std::string &m,
+                                                                                   const std::string &ef) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::EvaluateApacheApproximateKnn: Function call";
+
+  // neighbours count and voting are the ones used by the analyzer
+  auto configuration = apache_database_functions_->GetKnnConfiguration(agent_name, virtualhost_name);
+  if (!ParseUnsigned(m, MIN_HNSW_M, MAX_HNSW_M, configuration.hnsw_m)
+      || !ParseUnsigned(ef, 1, MAX_HNSW_EF, configuration.hnsw_ef)) {
+    BOOST_LOG_TRIVIAL(warning) << "apache::web::CommandExecutorObject::EvaluateApacheApproximateKnn: Wrong m or ef: " << m << ", " << ef;
+    return GetInvalidArgumentErrorJson();
+  }
+
+  auto agent = general_database_functions_->GetAgentNameId(agent_name);
+  auto virtualhost = apache_database_functions_->GetVirtualhostNameId(virtualhost_name);
+
+  auto count = apache_database_functions_->GetLearningSessionsCount(agent, virtualhost);
+  auto sessions = apache_database_functions_->GetLearningSessions(agent, virtualhost, count, 0);
+
+  auto evaluator = ::apache::analyzer::detail::prepare_statistics::KnnRecallEvaluator::Create(worker_pool_);
+  auto evaluation = evaluator->Evaluate(sessions, configuration);
+
+  json r;
+  r["learning_set_size"] = evaluation.learning_set_size;
+  r["queries_count"] = evaluation.queries_count;
+  r["recall"] = evaluation.recall;
+  r["classification_agreement"] = evaluation.classification_agreement;
+  r["exact_time"] = evaluation.exact_time;
+  r["approximate_time"] = evaluation.approximate_time;
+
+  json j;
+  j["status"] = "ok";
+  j["result"] = r;
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::GetApacheHourlyTraffic(const std::string &agent_name,
+                                                                             const std::string &virtualhost_name,
+                                                                             const std::string &date) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::GetApacheHourlyTraffic: Function call";
+
+  auto tbegin = ::type::Timestamp::Create(::type::Time(),
+                                          ::type::Date::Create(date));
+  auto tend = ::type::Timestamp::Create(::type::Time::Create(23, 59, 59),
+                                        ::type::Date::Create(date));
+  auto hours = apache_database_functions_->GetTrafficSketches(agent_name, virtualhost_name, tbegin, tend);
+
+  json j, r = json::array();
+  for (const auto &h : hours) {
+    json t = GetTrafficJson(h);
+    t["hour"] = h.hour.GetTime().GetHour();
+
+    r.push_back(t);
+  }
+
+  j["status"] = "ok";
+  j["result"] = r;
+
+  return j.dump();
+}
+
+const ::web::type::JsonMessage CommandExecutorObject::GetApacheTrafficSummary(const std::string &agent_name,
+                                                                              const std::string &virtualhost_name,
+                                                                              const std::string &begin_date,
+                                                                              const std::string &end_date) {
+  BOOST_LOG_TRIVIAL(debug) << "apache::web::CommandExecutorObject::GetApacheTrafficSummary: Function call";
+
+  auto tbegin = ::type::Timestamp::Create(::type::Time(),
+                                          ::type::Date::Create(begin_date));
+  auto tend = ::type::Timestamp::Create(::type::Time::Create(23, 59, 59),
+                                        ::type::Date::Create(end_date));
+  auto hours = apache_database_functions_->GetTrafficSketches(agent_name, virtualhost_name, tbegin, tend);
+
+  ::apache::type::TrafficSketches summary;
+  summary.requests_count = 0;
+  for (const auto &h : hours) {
+    summary.requests_count += h.requests_count;
+    summary.client_ips.Merge(h.client_ips);
+    summary.user_agents.Merge(h.user_agents);
+    summary.top_paths.Merge(h.top_paths);
+    summary.top_client_ips.Merge(h.top_client_ips);
+  }
+
+  json r = GetTrafficJson(summary);
+  r["hours_count"] = hours.size();
+
+  json j;
+  j["status"] = "ok";
+  j["result"] = r;
+
+  return j.dump();
+}
+
 }
 
 }
@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "src/analyzer/worker_pool.h"
 #include "src/database/database.h"
 #include "src/database/type/agent_name.h"
 #include "src/database/type/virtualhost_name.h"
@@ -25,7 +26,8 @@ class CommandExecutorObject : public ::web::type::CommandExecutorObjectInterface
 
   static CommandExecutorObjectPtr Create(::database::DatabasePtr database,
                                          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                         ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions);
+                                         ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                                         ::analyzer::WorkerPoolPtr worker_pool);
 
   const ::web::type::JsonMessage Execute(const ::web::type::JsonMessage &message);
 
@@ -34,11 +36,13 @@ class CommandExecutorObject : public ::web::type::CommandExecutorObjectInterface
  private:
   CommandExecutorObject(::database::DatabasePtr database,
                         ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                        ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions);
+                        ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions,
+                        ::analyzer::WorkerPoolPtr worker_pool);
 
   ::database::DatabasePtr database_;
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
   ::apache::database::detail::DatabaseFunctionsInterfacePtr apache_database_functions_;
+  ::analyzer::WorkerPoolPtr worker_pool_;
 
   const ::web::type::JsonMessage GetHostnames();
   const ::web::type::JsonMessage GetVirtualhostsNames(const std::string &agent_name);
@@ -65,6 +69,29 @@ class CommandExecutorObject : public ::web::type::CommandExecutorObjectInterface
   const ::web::type::JsonMessage GetLearningSetSessions(const std::string &agent_name,
                                                         const std::string &virtualhost_name);
   const ::web::type::JsonMessage RemoveConfiguration(const std::string &id);
+  const ::web::type::JsonMessage SetApacheKnnConfiguration(const std::string &agent_name,
+                                                           const std::string &virtualhost_name,
+                                                           const std::string &mode,
+                                                           const std::string &m,
+                                                           const std::string &ef,
+                                                           const std::string &neighbours_count,
+                                                           const std::string &voting);
+  const ::web::type::JsonMessage SetApacheRealtimeScoringConfiguration(const std::string &agent_name,
+                                                                       const std::string &virtualhost_name,
+                                                                       const std::string &enabled,
+                                                                       const std::string &threshold,
+                                                                       const std::string &min_requests);
+  const ::web::type::JsonMessage EvaluateApacheApproximateKnn(const std::string &agent_name,
+                                                              const std::string &virtualhost_name,
+                                                              const std::string &m,
+                                                              const std::string &ef);
+  const ::web::type::JsonMessage GetApacheHourlyTraffic(const std::string &agent_name,
+                                                        const std::string &virtualhost_name,
+                                                        const std::string &date);
+  const ::web::type::JsonMessage GetApacheTrafficSummary(const std::string &agent_name,
+                                                         const std::string &virtualhost_name,
+                                                         const std::string &begin_date,
+                                                         const std::string &end_date);
 };
 
 }
@@ -8,6 +8,7 @@
 #include "detail/daily_user_statistics_creator.h"
 #include "detail/network_trainer/network_trainer.h"
 #include "detail/classificator/classificator.h"
+#include "detail/model_registry/model_registry.h"
 #include "detail/system.h"
 
 #include <boost/log/trivial.hpp>
@@ -18,28 +19,40 @@ namespace bash
 namespace analyzer
 {
 
+const std::string BashAnalyzerObject::NAME = "bash";
+constexpr std::chrono::seconds BashAnalyzerObject::CADENCE;
+constexpr unsigned long long BashAnalyzerObject::DATA_THRESHOLD;
+
 BashAnalyzerObjectPtr BashAnalyzerObject::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                                  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                                  ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
-                                                 const std::string &neural_network_data_directory) {
+                                                 const std::string &neural_network_data_directory,
+                                                 bool save_training_data_snapshots,
+                                                 ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper,
+                                                 ::analyzer::StageMetricsPtr stage_metrics) {
   auto dusc = detail::DailyUserStatisticsCreator::Create(database_functions, general_database_functions);
-  auto nt = detail::network_trainer::NetworkTrainer::Create(database_functions, general_database_functions, neural_network_data_directory);
-  auto cr = detail::classificator::Classificator::Create(database_functions, general_database_functions, neural_network_data_directory);
+  auto model_registry = detail::model_registry::ModelRegistry::Create(database_functions, neural_network_data_directory, fann_wrapper);
+  auto nt = detail::network_trainer::NetworkTrainer::Create(database_functions, general_database_functions, neural_network_data_directory, model_registry, save_training_data_snapshots);
+  auto cr = detail::classificator::Classificator::Create(database_functions, general_database_functions, model_registry);
   auto system = detail::System::Create();
 
-  return BashAnalyzerObjectPtr(new BashAnalyzerObject(dusc, nt, cr, scripts_interface, system));
+  return BashAnalyzerObjectPtr(new BashAnalyzerObject(dusc, nt, cr, scripts_interface, system, stage_metrics));
 }
 
 BashAnalyzerObjectPtr BashAnalyzerObject::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                                  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                                  ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
                                                  detail::SystemInterfacePtr system_interface,
-                                                 const std::string &neural_network_data_directory) {
+                                                 const std::string &neural_network_data_directory,
+                                                 bool save_training_data_snapshots,
+                                                 ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper,
+                                                 ::analyzer::StageMetricsPtr stage_metrics) {
   auto dusc = detail::DailyUserStatisticsCreator::Create(database_functions, general_database_functions);
-  auto nt = detail::network_trainer::NetworkTrainer::Create(database_functions, general_database_functions, neural_network_data_directory);
-  auto cr = detail::classificator::Classificator::Create(database_functions, general_database_functions, neural_network_data_directory);
+  auto model_registry = detail::model_registry::ModelRegistry::Create(database_functions, neural_network_data_directory, fann_wrapper);
+  auto nt = detail::network_trainer::NetworkTrainer::Create(database_functions, general_database_functions, neural_network_data_directory, model_registry, save_training_data_snapshots);
+  auto cr = detail::classificator::Classificator::Create(database_functions, general_database_functions, model_registry);
 
-  return BashAnalyzerObjectPtr(new BashAnalyzerObject(dusc, nt, cr, scripts_interface, system_interface));
+  return BashAnalyzerObjectPtr(new BashAnalyzerObject(dusc, nt, cr, scripts_interface, system_interface, stage_metrics));
 }
 
 void BashAnalyzerObject::Analyze() {
@@ -47,22 +60,43 @@ void BashAnalyzerObject::Analyze() {
 
   auto today = GetCurrentDate();
 
-  scripts_interface_->CreateDailySystemStatistics();
-  daily_user_statistics_creator_->CreateStatistics(today);
-  network_trainer_->Train();
-  classificator_->Analyze();
+  {
+    ::analyzer::StageRecorder recorder(stage_metrics_, "bash.daily_system_statistics");
+    scripts_interface_->CreateDailySystemStatistics();
+  }
+
+  {
+    ::analyzer::StageRecorder recorder(stage_metrics_, "bash.daily_user_statistics");
+    daily_user_statistics_creator_->CreateStatistics(today);
+  }
+
+  {
+    ::analyzer::StageRecorder recorder(stage_metrics_, "bash.network_training");
+    network_trainer_->Train();
+  }
+
+  {
+    ::analyzer::StageRecorder recorder(stage_metrics_, "bash.classification");
+    classificator_->Analyze();
+  }
+}
+
+::analyzer::type::Schedule BashAnalyzerObject::GetSchedule() const {
+  return {NAME, CADENCE, DATA_THRESHOLD, {}};
 }
 
 BashAnalyzerObject::BashAnalyzerObject(detail::DailyUserStatisticsCreatorInterfacePtr daily_user_statistics_creator,
                                        detail::network_trainer::NetworkTrainerInterfacePtr network_trainer,
                                        detail::classificator::ClassificatorInterfacePtr classificator,
                                        ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
-                                       detail::SystemInterfacePtr system_interface) :
+                                       detail::SystemInterfacePtr system_interface,
+                                       ::analyzer::StageMetricsPtr stage_metrics) :
 daily_user_statistics_creator_(daily_user_statistics_creator),
 network_trainer_(network_trainer),
 classificator_(classificator),
 scripts_interface_(scripts_interface),
-system_interface_(system_interface) {
+system_interface_(system_interface),
+stage_metrics_(stage_metrics) {
 }
 
 ::type::Date BashAnalyzerObject::GetCurrentDate() const {
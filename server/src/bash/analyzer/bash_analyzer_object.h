@@ -6,6 +6,7 @@
 #pragma once
 
 #include "src/analyzer/analyzer_object_interface.h"
+#include "src/analyzer/stage_metrics.h"
 #include "src/bash/domain/detail/scripts_interface.h"
 #include "src/bash/analyzer/detail/daily_user_statistics_creator_interface.h"
 #include "src/bash/database/detail/database_functions_interface.h"
@@ -13,10 +14,13 @@
 #include "detail/system_interface.h"
 #include "detail/network_trainer/network_trainer_interface.h"
 #include "detail/classificator/classificator_interface.h"
+#include "src/library/fann/detail/fann_wrapper_interface.h"
 
 #include <slas/type/date.h>
 
+#include <chrono>
 #include <memory>
+#include <string>
 
 namespace bash
 {
@@ -34,22 +38,35 @@ class BashAnalyzerObject : public ::analyzer::AnalyzerObjectInterface {
   static BashAnalyzerObjectPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                       ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                       ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
-                                      const std::string &neural_network_data_directory);
+                                      const std::string &neural_network_data_directory,
+                                      bool save_training_data_snapshots,
+                                      ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper,
+                                      ::analyzer::StageMetricsPtr stage_metrics);
 
   static BashAnalyzerObjectPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                       ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                       ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
                                       detail::SystemInterfacePtr system_interface,
-                                      const std::string &neural_network_data_directory);
+                                      const std::string &neural_network_data_directory,
+                                      bool save_training_data_snapshots,
+                                      ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper,
+                                      ::analyzer::StageMetricsPtr stage_metrics);
 
   void Analyze() override;
 
+  ::analyzer::type::Schedule GetSchedule() const override;
+
+  static const std::string NAME;
+  static constexpr std::chrono::seconds CADENCE{3600};
+  static constexpr unsigned long long DATA_THRESHOLD = 50000;
+
  private:
   BashAnalyzerObject(detail::DailyUserStatisticsCreatorInterfacePtr daily_user_statistics_creator,
                      detail::network_trainer::NetworkTrainerInterfacePtr network_trainer,
                      detail::classificator::ClassificatorInterfacePtr classificator,
                      ::bash::domain::detail::ScriptsInterfacePtr scripts_interface,
-                     detail::SystemInterfacePtr system_interface);
+                     detail::SystemInterfacePtr system_interface,
+                     ::analyzer::StageMetricsPtr stage_metrics);
 
   ::type::Date GetCurrentDate() const;
 
@@ -58,6 +75,7 @@ class BashAnalyzerObject : public ::analyzer::AnalyzerObjectInterface {
   detail::classificator::ClassificatorInterfacePtr classificator_;
   ::bash::domain::detail::ScriptsInterfacePtr scripts_interface_;
   detail::SystemInterfacePtr system_interface_;
+  ::analyzer::StageMetricsPtr stage_metrics_;
 };
 
 }
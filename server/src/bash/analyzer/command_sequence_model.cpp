@@ -0,0 +1,216 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "command_sequence_model.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cmath>
+
+#include "src/analyzer/sketch/hash.h"
+#include "src/bash/notifier/type/bash_sequence_notifier_message.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace
+{
+
+std::uint64_t Combine(std::uint64_t seed, std::uint64_t value) {
+  std::uint64_t hash = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+// Count of an n-gram is never larger than count of its context, estimates
+// of both may be too large.
+double GetConditionalProbability(std::uint64_t count, std::uint64_t context_count) {
+  return static_cast<double> (std::min(count, context_count)) / context_count;
+}
+
+}
+
+constexpr unsigned CommandSequenceModel::SKETCH_WIDTH;
+constexpr unsigned CommandSequenceModel::SKETCH_DEPTH;
+constexpr std::uint64_t CommandSequenceModel::DECAY_TOTAL;
+constexpr std::size_t CommandSequenceModel::USERS_COUNT;
+constexpr unsigned long long CommandSequenceModel::WARM_UP_COMMANDS;
+constexpr double CommandSequenceModel::AVERAGE_LENGTH;
+constexpr double CommandSequenceModel::THRESHOLD;
+constexpr std::chrono::seconds CommandSequenceModel::REPORT_INTERVAL;
+constexpr double CommandSequenceModel::TRIGRAM_WEIGHT;
+constexpr double CommandSequenceModel::BIGRAM_WEIGHT;
+constexpr double CommandSequenceModel::UNIGRAM_WEIGHT;
+
+CommandSequenceModelPtr CommandSequenceModel::Create(::notifier::detail::NotifierInterfacePtr notifier) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::CommandSequenceModel::Create: Function call";
+
+  return CommandSequenceModelPtr(new CommandSequenceModel(notifier));
+}
+
+double CommandSequenceModel::AddCommand(const std::string &agent_name,
+                                        ::bash::database::type::UID user_id,
+                                        const ::type::Timestamp &time,
+                                        ::database::type::RowId command_id,
+                                        const ::bash::database::type::CommandName &command) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::CommandSequenceModel::AddCommand: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto scope = GetScope(agent_name, user_id);
+  User &user = GetUser(scope);
+
+  max_command_id_ = std::max(max_command_id_, command_id);
+  const double surprise = -std::log2(GetProbability(scope, user, command_id));
+
+  counts_.Add(GetKey(scope, command_id));
+  if (user.history_length >= 1)
+    counts_.Add(GetKey(scope, user.previous[0], command_id));
+  if (user.history_length >= 2)
+    counts_.Add(GetKey(scope, user.previous[1], user.previous[0], command_id));
+
+  ++user.counted_commands;
+
+  user.previous[1] = user.previous[0];
+  user.previous[0] = command_id;
+  user.history_length = std::min(user.history_length + 1, 2u);
+
+  if (counts_.GetTotal() >= DECAY_TOTAL)
+    Decay();
+
+  if (user.commands_count == 0)
+    user.average_surprise = surprise;
+  else
+    user.average_surprise += (surprise - user.average_surprise) / AVERAGE_LENGTH;
+  ++user.commands_count;
+
+  if (user.commands_count <= WARM_UP_COMMANDS || user.average_surprise < THRESHOLD)
+    return surprise;
+
+  const auto now = std::chrono::steady_clock::now();
+  if (user.reported && now - user.report_time < REPORT_INTERVAL)
+    return surprise;
+
+  user.reported = true;
+  user.report_time = now;
+
+  type::SequenceAlert alert;
+  alert.agent_name = agent_name;
+  alert.user_id = user_id;
+  alert.time = time;
+  alert.command = command;
+  alert.commands_count = user.commands_count;
+  alert.surprise = surprise;
+  alert.average_surprise = user.average_surprise;
+
+  BOOST_LOG_TRIVIAL(info) << "bash::analyzer::CommandSequenceModel::AddCommand: Reporting unusual commands of user " << user_id
+      << " on " << agent_name;
+  notifier_->AddMessages({::bash::notifier::type::BashSequenceNotifierMessage::Create({alert})});
+
+  return surprise;
+}
+
+double CommandSequenceModel::GetAverageSurprise(const std::string &agent_name, ::bash::database::type::UID user_id) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::CommandSequenceModel::GetAverageSurprise: Function call";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto it = users_.find(GetScope(agent_name, user_id));
+  return (it == users_.end()) ? 0 : it->second.average_surprise;
+}
+
+CommandSequenceModel::CommandSequenceModel(::notifier::detail::NotifierInterfacePtr notifier) :
+notifier_(notifier),
+counts_(SKETCH_WIDTH, SKETCH_DEPTH),
+max_command_id_(0) {
+}
+
+CommandSequenceModel::User& CommandSequenceModel::GetUser(std::uint64_t scope) {
+  auto it = users_.find(scope);
+  if (it != users_.end())
+    return it->second;
+
+  if (users_.size() >= USERS_COUNT) {
+    BOOST_LOG_TRIVIAL(warning) << "bash::analyzer::CommandSequenceModel::GetUser: Too many users, forgetting histories";
+    users_.clear();
+  }
+
+  User &user = users_[scope];
+  user.previous[0] = user.previous[1] = 0;
+  user.history_length = 0;
+  user.commands_count = 0;
+  user.counted_commands = 0;
+  user.average_surprise = 0;
+  user.reported = false;
+
+  return user;
+}
+
+void CommandSequenceModel::Decay() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::CommandSequenceModel::Decay: Halving counts";
+
+  counts_.Halve();
+  for (auto &user : users_)
+    user.second.counted_commands >>= 1;
+}
+
+// Unigram probability is add-one smoothed over command ids, bigram and
+// trigram probabilities are interpolated in when the user has the history
+// and the context was seen.
+double CommandSequenceModel::GetProbability(std::uint64_t scope, const User &user, ::database::type::RowId command_id) const {
+  const std::uint64_t commands_count = user.counted_commands;
+  const std::uint64_t unigram_count = std::min<std::uint64_t>(counts_.GetEstimate(GetKey(scope, command_id)), commands_count);
+  double probability = (unigram_count + 1.) / (commands_count + std::max<::database::type::RowId>(max_command_id_, 1));
+
+  if (user.history_length >= 1) {
+    const auto context_count = counts_.GetEstimate(GetKey(scope, user.previous[0]));
+
+    if (context_count > 0) {
+      const double weight = BIGRAM_WEIGHT / (BIGRAM_WEIGHT + UNIGRAM_WEIGHT);
+      const auto count = counts_.GetEstimate(GetKey(scope, user.previous[0], command_id));
+      probability = weight * GetConditionalProbability(count, context_count) + (1 - weight) * probability;
+    }
+  }
+
+  if (user.history_length >= 2) {
+    const auto context_count = counts_.GetEstimate(GetKey(scope, user.previous[1], user.previous[0]));
+
+    if (context_count > 0) {
+      const auto count = counts_.GetEstimate(GetKey(scope, user.previous[1], user.previous[0], command_id));
+      probability = TRIGRAM_WEIGHT * GetConditionalProbability(count, context_count) + (1 - TRIGRAM_WEIGHT) * probability;
+    }
+  }
+
+  return probability;
+}
+
+std::uint64_t CommandSequenceModel::GetScope(const std::string &agent_name, ::bash::database::type::UID user_id) {
+  return Combine(::analyzer::sketch::Hash(agent_name), static_cast<std::uint32_t> (user_id));
+}
+
+// the order is hashed first, so n-grams of different lengths don't share keys
+std::uint64_t CommandSequenceModel::GetKey(std::uint64_t scope, ::database::type::RowId first) {
+  return Combine(Combine(scope, 1), first);
+}
+
+std::uint64_t CommandSequenceModel::GetKey(std::uint64_t scope, ::database::type::RowId first, ::database::type::RowId second) {
+  return Combine(Combine(Combine(scope, 2), first), second);
+}
+
+std::uint64_t CommandSequenceModel::GetKey(std::uint64_t scope, ::database::type::RowId first,
+                                           ::database::type::RowId second, ::database::type::RowId third) {
+  return Combine(Combine(Combine(Combine(scope, 3), first), second), third);
+}
+
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <slas/type/timestamp.h>
+
+#include "type/sequence_alert.h"
+#include "src/analyzer/sketch/count_min_sketch.h"
+#include "src/bash/database/type/command_name.h"
+#include "src/bash/database/type/uid.h"
+#include "src/database/type/row_id.h"
+#include "src/notifier/detail/notifier_interface.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+class CommandSequenceModel;
+typedef std::shared_ptr<CommandSequenceModel> CommandSequenceModelPtr;
+
+// Scores commands of every (agent, user) while logs are received. Unigram,
+// bigram and trigram counts of BASH_COMMAND_TABLE ids are kept in one
+// count-min sketch, so memory doesn't grow with users or commands. The
+// sketch is halved every time it holds DECAY_TOTAL counts, its estimates
+// are too large by about e * DECAY_TOTAL / SKETCH_WIDTH at most, however
+// long the server runs, and old habits are slowly forgotten. Every
+// command gets -log2 of its interpolated probability given the user's two
+// previous commands; users whose moving average of surprise exceeds
+// THRESHOLD are reported by the notifier, at most once per REPORT_INTERVAL.
+// Counts aren't saved, the model learns again after a restart.
+class CommandSequenceModel {
+ public:
+  virtual ~CommandSequenceModel() = default;
+
+  static CommandSequenceModelPtr Create(::notifier::detail::NotifierInterfacePtr notifier);
+
+  // Returns the surprise of the command, in bits.
+  double AddCommand(const std::string &agent_name,
+                    ::bash::database::type::UID user_id,
+                    const ::type::Timestamp &time,
+                    ::database::type::RowId command_id,
+                    const ::bash::database::type::CommandName &command);
+
+  double GetAverageSurprise(const std::string &agent_name, ::bash::database::type::UID user_id);
+
+  static constexpr unsigned SKETCH_WIDTH = 1 << 18;
+  static constexpr unsigned SKETCH_DEPTH = 4;
+  static constexpr std::uint64_t DECAY_TOTAL = SKETCH_WIDTH;
+  static constexpr std::size_t USERS_COUNT = 65536;
+  static constexpr unsigned long long WARM_UP_COMMANDS = 500;
+  static constexpr double AVERAGE_LENGTH = 10;
+  static constexpr double THRESHOLD = 8;
+  static constexpr std::chrono::seconds REPORT_INTERVAL{3600};
+
+  // weights of trigram, bigram and unigram probabilities
+  static constexpr double TRIGRAM_WEIGHT = 0.6;
+  static constexpr double BIGRAM_WEIGHT = 0.3;
+  static constexpr double UNIGRAM_WEIGHT = 0.1;
+
+ private:
+  struct User {
+    ::database::type::RowId previous[2];
+    unsigned history_length;
+    unsigned long long commands_count;
+    // commands in the sketch, halved with it
+    std::uint64_t counted_commands;
+    double average_surprise;
+    bool reported;
+    std::chrono::steady_clock::time_point report_time;
+  };
+
+  explicit CommandSequenceModel(::notifier::detail::NotifierInterfacePtr notifier);
+
+  User& GetUser(std::uint64_t scope);
+  void Decay();
+  double GetProbability(std::uint64_t scope, const User &user, ::database::type::RowId command_id) const;
+
+  static std::uint64_t GetScope(const std::string &agent_name, ::bash::database::type::UID user_id);
+  static std::uint64_t GetKey(std::uint64_t scope, ::database::type::RowId first);
+  static std::uint64_t GetKey(std::uint64_t scope, ::database::type::RowId first, ::database::type::RowId second);
+  static std::uint64_t GetKey(std::uint64_t scope, ::database::type::RowId first,
+                              ::database::type::RowId second, ::database::type::RowId third);
+
+  ::notifier::detail::NotifierInterfacePtr notifier_;
+
+  ::analyzer::sketch::CountMinSketch counts_;
+  std::unordered_map<std::uint64_t, User> users_;
+  // probability of unseen commands is spread over ids up to the largest one
+  ::database::type::RowId max_command_id_;
+  std::mutex mutex_;
+};
+
+}
+
+}
@@ -12,9 +12,7 @@
 #include <fstream>
 #include <boost/log/trivial.hpp>
 
-#include "src/bash/analyzer/detail/command_summary_divider/command_summary_divider.h"
 #include "src/library/fann/fann_wrapper.h"
-#include "src/library/fann/fann_guard.h"
 
 namespace bash
 {
@@ -30,91 +28,82 @@ namespace classificator
 
 ClassificatorPtr Classificator::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                        ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                       const std::string &neural_network_data_directory) {
+                                       ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry) {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Create: Function call";
 
   auto fann_wrapper = ::library::fann::FannWrapper::Create();
 
-  return Create(database_functions, general_database_functions, neural_network_data_directory, fann_wrapper);
+  return Create(database_functions, general_database_functions, model_registry, fann_wrapper);
 }
 
 ClassificatorPtr Classificator::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                        ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                       const std::string &neural_network_data_directory,
+                                       ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
                                        ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Create: Function call";
 
-  return ClassificatorPtr(new Classificator(database_functions, general_database_functions, neural_network_data_directory, fann_wrapper));
+  return ClassificatorPtr(new Classificator(database_functions, general_database_functions, model_registry, fann_wrapper));
 }
 
 void Classificator::Analyze() {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Function call";
 
-  constexpr int MAX_ROWS_IN_MEMORY = 100;
+  // statistics of a part are run through the network as one matrix
+  constexpr int MAX_ROWS_IN_MEMORY = 1000;
 
-  command_summary_divider::CommandSummaryDivider divider;
-  unsigned selected_commands_position = 0;
-  unsigned commands_statistics_position = 0;
-  fann_type *calc_out;
-  fann_type input[100];
+  command_features::SparseRows sparse_rows;
+  std::vector<fann_type> inputs, outputs;
 
   auto configurations = database_functions_->GetAnomalyDetectionConfigurations();
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Found " << configurations.size() << " configurations";
 
-  for (const auto &c : configurations) {
-    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Create neural network";
-    struct fann *ann = fann_wrapper_->CreateFromFile(neural_network_data_directory_ + "/network-" + std::to_string(c.id) + ".data");
-    ::library::fann::FannGuard fann_guard(ann);
+  ::database::type::RowIds configurations_ids;
+  for (const auto &c : configurations)
+    configurations_ids.push_back(c.id);
+  model_registry_->Prune(configurations_ids);
 
-    auto selected_commands_ids = database_functions_->GetMarkedCommandsIds(c.id);
-      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Found " << selected_commands_ids.size() << " selected commands ids";
+  for (const auto &c : configurations) {
+    // the model is held until the configuration is classified, a new version
+    // saved in the meantime is used by the next analysis
+    auto model = model_registry_->Get(c.id);
+    if (!model) {
+      BOOST_LOG_TRIVIAL(warning) << "bash::analyzer::detail::classificator::Classificator::Analyze: Configuration " << c.id << " has no trained network, skipping";
+      continue;
+    }
 
-    for (const auto &id : selected_commands_ids)
-      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: id: " << id;
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Using model version " << model->version << " with " << model->features.GetNumberOfColumns() << " commands";
 
-    auto users = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(c.id);
+    const auto &users = model->users_ids;
+    const unsigned number_of_inputs = model->number_of_inputs;
+    const unsigned number_of_outputs = users.size();
 
     auto daily_user_statistics_count = database_functions_->CountDailyUserStatisticsForAgentWithClassification(c.agent_name_id, ::database::type::Classification::UNKNOWN);
 
     util::RunPartially(MAX_ROWS_IN_MEMORY, daily_user_statistics_count, [&](long long part_count, long long offset) {
-      auto daily_user_statistics = database_functions_->GetDailyUserStatisticsForAgentWithClassification(c.agent_name_id, ::database::type::Classification::UNKNOWN, part_count, 0);
-
-      for (const auto &statistic : daily_user_statistics) {
-        std::fill(input, input + 100, 0);
-
-        auto commands_statistics = database_functions_->GetSelectedDailyUserCommandsStatistics(statistic.id);
-        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Found " << commands_statistics.size() << " commands statistics";
+      auto daily_user_statistics = database_functions_->GetDailyUserStatisticsWithCommandsForAgentWithClassification(c.agent_name_id, ::database::type::Classification::UNKNOWN, part_count, 0);
+      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Found " << daily_user_statistics.size() << " statistics in part";
 
-        selected_commands_position = 0;
-        commands_statistics_position = 0;
-        while (selected_commands_position < selected_commands_ids.size()
-            && commands_statistics_position < commands_statistics.size()) {
-          const auto &command_statistic = commands_statistics.at(commands_statistics_position);
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Position " << selected_commands_position;
+      ::database::type::RowIds normal_ids, anomaly_ids;
+      const std::size_t rows = daily_user_statistics.size();
 
-          if (command_statistic.command_id == selected_commands_ids.at(selected_commands_position)) {
-            BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Found command with id " << command_statistic.command_id;
-
-            input[selected_commands_position] = command_statistic.summary;
-            commands_statistics_position++;
-          }
-
-          selected_commands_position++;
-        }
+      sparse_rows.Clear();
+      for (const auto &statistic : daily_user_statistics)
+        model->features.AddRow(statistic.commands_statistics, sparse_rows);
 
-        std::transform(input, input + 100, input, divider);
+      inputs.resize(rows * number_of_inputs);
+      outputs.resize(rows * number_of_outputs);
+      for (std::size_t row = 0; row < rows; ++row)
+        sparse_rows.ToDense(row, number_of_inputs, inputs.data() + row * number_of_inputs);
 
-        for (int i = 0; i < 100; i++) {
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Input value " << i << " : " << input[i];
-        }
+      Run(*model, inputs, rows, outputs);
 
-        calc_out = fann_wrapper_->Run(ann, input);
+      for (std::size_t row = 0; row < rows; ++row) {
+        const auto &statistic = daily_user_statistics[row].statistic;
+        const fann_type *calc_out = outputs.data() + row * number_of_outputs;
 
         ::database::type::RowIds::size_type user_position = 0;
         fann_type output_value = 0;
         for (::database::type::RowIds::size_type i = 0; i < users.size(); i++) {
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Output value " << i << " : " << calc_out[i];
-
           if (calc_out[i] >= output_value) {
             output_value = calc_out[i];
             user_position = i;
@@ -126,24 +115,45 @@ void Classificator::Analyze() {
         constexpr double anomaly_threshold = 0.5;
         if (output_value >= anomaly_threshold && users.at(user_position) == statistic.user_id) {
           BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Marking statistic with id " << statistic.id << " as normal";
-          database_functions_->SetDailyUserStatisticsClassification({statistic.id}, ::database::type::Classification::NORMAL);
+          normal_ids.push_back(statistic.id);
         }
         else {
           BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::classificator::Classificator::Analyze: Marking statistic with id " << statistic.id << " as anomaly";
-          database_functions_->SetDailyUserStatisticsClassification({statistic.id}, ::database::type::Classification::ANOMALY);
+          anomaly_ids.push_back(statistic.id);
         }
       }
+
+      // next part is read from the beginning of unclassified statistics,
+      // so the part must be written before it's read
+      database_functions_->SetDailyUserStatisticsClassification(normal_ids, ::database::type::Classification::NORMAL);
+      database_functions_->SetDailyUserStatisticsClassification(anomaly_ids, ::database::type::Classification::ANOMALY);
     });
   }
 }
 
+void Classificator::Run(const ::bash::analyzer::detail::model_registry::Model &model,
+                        std::vector<fann_type> &inputs,
+                        std::size_t rows,
+                        std::vector<fann_type> &outputs) {
+  if (model.dense_network) {
+    model.dense_network->Run(inputs.data(), rows, outputs.data());
+    return;
+  }
+
+  const unsigned number_of_outputs = model.users_ids.size();
+  for (std::size_t row = 0; row < rows; ++row) {
+    const fann_type *calc_out = fann_wrapper_->Run(model.network.get(), inputs.data() + row * model.number_of_inputs);
+    std::copy_n(calc_out, number_of_outputs, outputs.begin() + row * number_of_outputs);
+  }
+}
+
 Classificator::Classificator(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                              ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                             const std::string &neural_network_data_directory,
+                             ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
                              ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) :
 database_functions_(database_functions),
 general_database_functions_(general_database_functions),
-neural_network_data_directory_(neural_network_data_directory),
+model_registry_(model_registry),
 fann_wrapper_(fann_wrapper) {
 }
 
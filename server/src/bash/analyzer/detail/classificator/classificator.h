@@ -7,6 +7,10 @@
 
 #include "classificator_interface.h"
 
+#include <cstddef>
+#include <vector>
+
+#include "src/bash/analyzer/detail/model_registry/model_registry.h"
 #include "src/bash/database/detail/database_functions_interface.h"
 #include "src/database/detail/general_database_functions_interface.h"
 #include "src/library/fann/detail/fann_wrapper_interface.h"
@@ -26,17 +30,21 @@ namespace classificator
 class Classificator;
 typedef std::shared_ptr<Classificator> ClassificatorPtr;
 
+// Networks, their users and inputs of commands are taken from the model
+// registry, configurations without a trained network are skipped.
+// Unclassified statistics are read with their commands in parts and every
+// part is run through the network at once.
 class Classificator : public ClassificatorInterface {
  public:
   virtual ~Classificator() = default;
 
   static ClassificatorPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                  const std::string &neural_network_data_directory);
+                                  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry);
 
   static ClassificatorPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                  const std::string &neural_network_data_directory,
+                                  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
                                   ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
 
   void Analyze() override;
@@ -44,13 +52,19 @@ class Classificator : public ClassificatorInterface {
  private:
   ::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
-  const std::string neural_network_data_directory_;
+  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry_;
   ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper_;
 
   Classificator(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                 const std::string &neural_network_data_directory,
+                 ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
                  ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
+
+  // Networks which can't be run as a matrix are run row by row.
+  void Run(const ::bash::analyzer::detail::model_registry::Model &model,
+           std::vector<fann_type> &inputs,
+           std::size_t rows,
+           std::vector<fann_type> &outputs);
 };
 
 }
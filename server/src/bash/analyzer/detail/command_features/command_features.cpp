@@ -0,0 +1,101 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "command_features.h"
+
+#include "src/bash/analyzer/detail/command_summary_divider/command_summary_divider.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace command_features
+{
+
+constexpr unsigned CommandFeatures::EMPTY_SLOT;
+
+CommandFeatures::CommandFeatures() :
+slots_(1, Slot(0, EMPTY_SLOT)) {
+}
+
+CommandFeatures::CommandFeatures(const ::database::type::RowIds &commands_ids) :
+commands_ids_(commands_ids) {
+  std::size_t capacity = 1;
+  while (capacity < commands_ids_.size() * 2)
+    capacity *= 2;
+
+  slots_.assign(capacity, Slot(0, EMPTY_SLOT));
+
+  for (unsigned column = 0; column < commands_ids_.size(); ++column) {
+    Slot &slot = slots_[GetSlotIndex(commands_ids_[column])];
+
+    // a repeated command keeps its first column
+    if (slot.second == EMPTY_SLOT)
+      slot = Slot(commands_ids_[column], column);
+  }
+}
+
+unsigned CommandFeatures::GetNumberOfColumns() const {
+  return commands_ids_.size();
+}
+
+const ::database::type::RowIds& CommandFeatures::GetCommandsIds() const {
+  return commands_ids_;
+}
+
+bool CommandFeatures::GetColumn(::database::type::RowId command_id, unsigned &column) const {
+  const Slot &slot = slots_[GetSlotIndex(command_id)];
+  if (slot.second == EMPTY_SLOT)
+    return false;
+
+  column = slot.second;
+  return true;
+}
+
+void CommandFeatures::AddRow(const ::bash::database::detail::entity::DailyUserCommandsStatistics &commands_statistics,
+                             SparseRows &rows) const {
+  // summaries of the row are divided at once
+  thread_local std::vector<long long> summaries;
+  unsigned column;
+
+  summaries.clear();
+  for (const auto &statistic : commands_statistics) {
+    if (GetColumn(statistic.command_id, column)) {
+      rows.columns.push_back(column);
+      summaries.push_back(statistic.summary);
+    }
+  }
+
+  const std::size_t begin = rows.values.size();
+  rows.values.resize(begin + summaries.size());
+  command_summary_divider::Divide(summaries.data(), summaries.size(), rows.values.data() + begin);
+
+  rows.offsets.push_back(rows.values.size());
+}
+
+std::size_t CommandFeatures::GetSlotIndex(::database::type::RowId command_id) const {
+  const std::size_t mask = slots_.size() - 1;
+
+  // Fibonacci hashing spreads consecutive ids, linear probing finds the
+  // command or the empty slot where it belongs
+  std::size_t index = ((static_cast<unsigned long long> (command_id) * 11400714819323198485ull) >> 32) & mask;
+  while (slots_[index].second != EMPTY_SLOT && slots_[index].first != command_id)
+    index = (index + 1) & mask;
+
+  return index;
+}
+
+}
+
+}
+
+}
+
+}
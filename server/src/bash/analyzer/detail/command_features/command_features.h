@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "sparse_rows.h"
+#include "src/bash/database/detail/entity/daily_user_command_statistic.h"
+#include "src/database/type/row_id.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace command_features
+{
+
+// Maps selected commands of a configuration to network inputs, the command
+// at position i of the list gets column i. The trainer and the classificator
+// build rows of the same configuration with the same mapping. Columns are
+// looked up in an open addressing table, built once.
+class CommandFeatures {
+ public:
+  CommandFeatures();
+  explicit CommandFeatures(const ::database::type::RowIds &commands_ids);
+
+  unsigned GetNumberOfColumns() const;
+  const ::database::type::RowIds& GetCommandsIds() const;
+
+  // Returns false when the command isn't selected.
+  bool GetColumn(::database::type::RowId command_id, unsigned &column) const;
+
+  // Appends a row with summaries of the selected commands divided into
+  // intervals, statistics of other commands are skipped.
+  void AddRow(const ::bash::database::detail::entity::DailyUserCommandsStatistics &commands_statistics,
+              SparseRows &rows) const;
+
+ private:
+  typedef std::pair< ::database::type::RowId, unsigned> Slot;
+
+  static constexpr unsigned EMPTY_SLOT = static_cast<unsigned> (-1);
+
+  std::size_t GetSlotIndex(::database::type::RowId command_id) const;
+
+  ::database::type::RowIds commands_ids_;
+  // capacity is a power of two, at least twice the number of commands
+  std::vector<Slot> slots_;
+};
+
+}
+
+}
+
+}
+
+}
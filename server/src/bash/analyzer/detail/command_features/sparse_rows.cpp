@@ -0,0 +1,49 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "sparse_rows.h"
+
+#include <algorithm>
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace command_features
+{
+
+SparseRows::SparseRows() :
+offsets(1, 0) {
+}
+
+std::size_t SparseRows::Size() const {
+  return offsets.size() - 1;
+}
+
+void SparseRows::Clear() {
+  offsets.assign(1, 0);
+  columns.clear();
+  values.clear();
+}
+
+void SparseRows::ToDense(std::size_t row, unsigned number_of_columns, fann_type *dense) const {
+  std::fill(dense, dense + number_of_columns, 0);
+
+  for (std::size_t i = offsets[row]; i < offsets[row + 1]; ++i)
+    dense[columns[i]] = values[i];
+}
+
+}
+
+}
+
+}
+
+}
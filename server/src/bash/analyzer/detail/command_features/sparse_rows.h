@@ -0,0 +1,47 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <fann.h>
+#include <cstddef>
+#include <vector>
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace command_features
+{
+
+// Rows in compressed sparse row format: values of row r are
+// values[offsets[r]] .. values[offsets[r + 1] - 1], in their columns.
+struct SparseRows {
+  SparseRows();
+
+  std::size_t Size() const;
+  void Clear();
+
+  // Zeroes number_of_columns values and writes the row over them,
+  // number_of_columns may be larger than the mapping the rows come from.
+  void ToDense(std::size_t row, unsigned number_of_columns, fann_type *dense) const;
+
+  std::vector<std::size_t> offsets;
+  std::vector<unsigned> columns;
+  std::vector<fann_type> values;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "command_summary_divider.h"
+
+#include <boost/log/trivial.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SLAS_HAVE_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace command_summary_divider
+{
+
+namespace
+{
+
+template <unsigned... I>
+struct Indices {
+};
+
+template <typename First, typename Second>
+struct ConcatIndices;
+
+template <unsigned... First, unsigned... Second>
+struct ConcatIndices<Indices<First...>, Indices<Second...>> {
+  typedef Indices<First..., (sizeof...(First) + Second)...> Type;
+};
+
+// 0..N-1, halved to keep the instantiation depth low
+template <unsigned N>
+struct MakeIndices {
+  typedef typename ConcatIndices<typename MakeIndices<N / 2>::Type,
+                                 typename MakeIndices<N - N / 2>::Type>::Type Type;
+};
+
+template <>
+struct MakeIndices<0> {
+  typedef Indices<> Type;
+};
+
+template <>
+struct MakeIndices<1> {
+  typedef Indices<0> Type;
+};
+
+template <unsigned... I>
+constexpr std::array<float, sizeof...(I)> MakeTable(Indices<I...>) {
+  return {{CommandSummaryDivider::GetValue(I)...}};
+}
+
+typedef void (*DivideFunction)(const long long*, std::size_t, float*);
+
+#ifdef SLAS_HAVE_AVX2_KERNEL
+
+__attribute__((target("avx2")))
+__m256i ClampAvx2(__m256i summaries) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max = _mm256_set1_epi64x(CommandSummaryDivider::MAX_SUMMARY);
+
+  summaries = _mm256_blendv_epi8(summaries, zero, _mm256_cmpgt_epi64(zero, summaries));
+  return _mm256_blendv_epi8(summaries, max, _mm256_cmpgt_epi64(summaries, max));
+}
+
+// Summaries are taken 8 at a time, clamped and narrowed to 32 bit table
+// indices, values are gathered from the table.
+__attribute__((target("avx2")))
+void DivideAvx2Impl(const long long *summaries, std::size_t count, float *values) {
+  const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const float *table = CommandSummaryDivider::TABLE.data();
+  std::size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    const __m256i first = ClampAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*> (summaries + i)));
+    const __m256i second = ClampAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*> (summaries + i + 4)));
+
+    const __m256i indices = _mm256_inserti128_si256(
+        _mm256_permutevar8x32_epi32(first, low_halves),
+        _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(second, low_halves)), 1);
+
+    _mm256_storeu_ps(values + i, _mm256_i32gather_ps(table, indices, 4));
+  }
+
+  DivideScalar(summaries + i, count - i, values + i);
+}
+
+#endif
+
+DivideFunction SelectDivideFunction() {
+  if (IsAvx2Supported()) {
+    BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::command_summary_divider::SelectDivideFunction: Using AVX2 divider";
+    return DivideAvx2;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::command_summary_divider::SelectDivideFunction: Using scalar divider";
+  return DivideScalar;
+}
+
+}
+
+constexpr unsigned CommandSummaryDivider::NUMBER_OF_INTERVALS;
+constexpr long long CommandSummaryDivider::MAX_SUMMARY;
+
+const std::array<float, CommandSummaryDivider::MAX_SUMMARY + 1> CommandSummaryDivider::TABLE =
+    MakeTable(MakeIndices<CommandSummaryDivider::MAX_SUMMARY + 1>::Type());
+
+static_assert(CommandSummaryDivider::GetInterval(19) == 4 && CommandSummaryDivider::GetInterval(20) == 5,
+              "19 is the last summary of interval 4");
+static_assert(CommandSummaryDivider::GetIntervalBegin(CommandSummaryDivider::NUMBER_OF_INTERVALS - 1) == CommandSummaryDivider::MAX_SUMMARY,
+              "summaries from MAX_SUMMARY up are in the last interval");
+
+void Divide(const long long *summaries, std::size_t count, float *values) {
+  static const DivideFunction function = SelectDivideFunction();
+
+  function(summaries, count, values);
+}
+
+void DivideScalar(const long long *summaries, std::size_t count, float *values) {
+  CommandSummaryDivider divider;
+
+  for (std::size_t i = 0; i < count; ++i)
+    values[i] = divider(summaries[i]);
+}
+
+void DivideAvx2(const long long *summaries, std::size_t count, float *values) {
+#ifdef SLAS_HAVE_AVX2_KERNEL
+  DivideAvx2Impl(summaries, count, values);
+#else
+  DivideScalar(summaries, count, values);
+#endif
+}
+
+bool IsAvx2Supported() {
+#ifdef SLAS_HAVE_AVX2_KERNEL
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+}
+
+}
+
+}
+
+}
@@ -5,7 +5,8 @@
 
 #pragma once
 
-#include "command_summary_divider_interface.h"
+#include <array>
+#include <cstddef>
 
 namespace bash
 {
@@ -19,37 +20,58 @@ namespace detail
 namespace command_summary_divider
 {
 
-class CommandSummaryDivider : public CommandSummaryDividerInterface {
+// Summaries are divided into NUMBER_OF_INTERVALS intervals, interval i gets
+// value i / 10. Interval i > 0 begins at 2 ^ (i - 1) + i - 1 and holds
+// 2 ^ (i - 1) + 1 summaries: 1..2, 3..5, 6..10, 11..19, 20..36, ...,
+// 264..520; the last interval holds summaries from 521 up.
+class CommandSummaryDivider {
  public:
-  virtual ~CommandSummaryDivider() = default;
-
-  double operator()(long long value) override {
-    // interval size = (2 ^ x) / 2 + 1 when x > 0
-    if (value == 0)
-      return 0.0;
-    else if (1 <= value && value <= 2)
-      return 0.1;
-    else if (3 <= value && value <= 5)
-      return 0.2;
-    else if (6 <= value && value <= 10)
-      return 0.3;
-    else if (11 <= value && value <= 19)
-      return 0.4;
-    else if (19 <= value && value <= 35)
-      return 0.5;
-    else if (36 <= value && value <= 68)
-      return 0.6;
-    else if (69 <= value && value <= 133)
-      return 0.7;
-    else if (134 <= value && value <= 262)
-      return 0.8;
-    else if (263 <= value && value <= 519)
-      return 0.9;
-    else if (520 <= value)
-      return 1.0;
+  static constexpr unsigned NUMBER_OF_INTERVALS = 11;
+  static constexpr long long MAX_SUMMARY = 521;
+
+  static constexpr long long GetIntervalBegin(unsigned interval) {
+    return (interval == 0) ? 0 : (1ll << (interval - 1)) + interval - 1;
+  }
+
+  // Summary s > 0 has bit width w, 2 ^ (w - 1) <= s < 2 ^ w, so it is in
+  // interval w or w - 1.
+  static constexpr unsigned GetInterval(long long summary) {
+    return (summary <= 0) ? 0
+        : (summary >= MAX_SUMMARY) ? NUMBER_OF_INTERVALS - 1
+        : BitWidth(summary) - (summary < GetIntervalBegin(BitWidth(summary)) ? 1 : 0);
+  }
+
+  static constexpr float GetValue(long long summary) {
+    return GetInterval(summary) / 10.0f;
+  }
+
+  float operator()(long long summary) const {
+    return TABLE[Clamp(summary)];
+  }
+
+  static constexpr long long Clamp(long long summary) {
+    return (summary < 0) ? 0 : (summary > MAX_SUMMARY) ? MAX_SUMMARY : summary;
+  }
+
+  // values of summaries 0..MAX_SUMMARY, generated at compile time
+  static const std::array<float, MAX_SUMMARY + 1> TABLE;
+
+ private:
+  static constexpr unsigned BitWidth(long long summary) {
+    return 64 - __builtin_clzll(static_cast<unsigned long long> (summary));
   }
 };
 
+// Writes values of count summaries. The implementation (AVX2 or scalar)
+// is selected once, at first call.
+void Divide(const long long *summaries, std::size_t count, float *values);
+
+void DivideScalar(const long long *summaries, std::size_t count, float *values);
+
+void DivideAvx2(const long long *summaries, std::size_t count, float *values);
+
+bool IsAvx2Supported();
+
 }
 
 }
@@ -5,9 +5,7 @@
 
 #include "daily_user_statistics_creator.h"
 
-#include "src/bash/database/detail/entity/daily_user_statistic.h"
-#include "src/bash/database/detail/entity/daily_user_command_statistic.h"
-
+#include <algorithm>
 #include <boost/log/trivial.hpp>
 
 namespace bash
@@ -19,6 +17,9 @@ namespace analyzer
 namespace detail
 {
 
+const std::string DailyUserStatisticsCreator::WATERMARK_STAGE = "bash_daily_user_statistics";
+constexpr ::database::type::RowsCount DailyUserStatisticsCreator::CHUNK_LOGS;
+
 DailyUserStatisticsCreatorPtr DailyUserStatisticsCreator::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                                                  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions) {
   return DailyUserStatisticsCreatorPtr(new DailyUserStatisticsCreator(database_functions, general_database_functions));
@@ -27,50 +28,21 @@ DailyUserStatisticsCreatorPtr DailyUserStatisticsCreator::Create(::bash::databas
 void DailyUserStatisticsCreator::CreateStatistics(const ::type::Date &today) {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Function call";
 
-  ::bash::database::detail::entity::DailyUserStatistic us;
-  ::bash::database::detail::entity::DailyUserCommandStatistic ucs;
-
-  us.classification = ::database::type::Classification::UNKNOWN;
-
   auto current_date_id = general_database_functions_->GetDateId(today);
 
   auto agents = general_database_functions_->GetAgentsIds();
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Found " << agents.size() << " agents";
   for (const auto &agent : agents) {
-    us.agent_name_id = agent;
-
-    auto users = database_functions_->GetSystemUsersIdsFromLogs(agent);
-    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Found " << users.size() << " users for agent " << agent;
-    for (const auto &user : users) {
-      us.user_id = user;
-
-      auto dates = database_functions_->GetNotCalculatedDatesIdsFromLogs(agent, user);
-      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Found " << dates.size() << " dates for agent " << agent << ", user " << user;
-      for (const auto &date : dates) {
-        if (date == current_date_id) {
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Ignoring current date (id=" << current_date_id << ")";
-          continue;
-        }
-
-        us.date_id = date;
-
-        database_functions_->AddDailyUserStatistic(us);
-        us.id = database_functions_->GetDailyUserStatisticId(agent, user, date);
-
-        auto commands = database_functions_->GetCommandsIdsFromLogs(agent, user, date);
-        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Found " << commands.size() << " commands for agent " << agent << ", user " << user << ", date " << date;
-        for (const auto &command : commands) {
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Analyzing command: " << command;
-
-          ucs.daily_user_statistic_id = us.id;
-          ucs.command_id = command;
-          ucs.summary = database_functions_->CountCommandsForUserDailyStatisticFromLogs(agent, date, user, command);
+    auto watermark = general_database_functions_->GetWatermark(WATERMARK_STAGE, agent);
+    const auto last_log_id = database_functions_->GetLastLogIdBeforeDate(agent, watermark, current_date_id);
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Logs of agent " << agent
+        << " from " << watermark << " to " << last_log_id;
 
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::DailyUserStatisticsCreator::CreateStatistics: Summary for command " << command << ": " << ucs.summary;
+    while (watermark < last_log_id) {
+      const auto chunk_end = std::min<::database::type::RowId>(watermark + CHUNK_LOGS, last_log_id);
 
-          database_functions_->AddDailyUserCommandStatistic(ucs);
-        }
-      }
+      database_functions_->CreateDailyUserStatistics(agent, watermark, chunk_end, WATERMARK_STAGE);
+      watermark = chunk_end;
     }
   }
 }
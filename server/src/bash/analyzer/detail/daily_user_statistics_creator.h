@@ -9,6 +9,9 @@
 
 #include "src/bash/database/detail/database_functions_interface.h"
 #include "src/database/detail/general_database_functions_interface.h"
+#include "src/database/type/rows_count.h"
+
+#include <string>
 
 namespace bash
 {
@@ -22,6 +25,9 @@ namespace detail
 class DailyUserStatisticsCreator;
 typedef std::shared_ptr<DailyUserStatisticsCreator> DailyUserStatisticsCreatorPtr;
 
+// Logs are processed in chunks of CHUNK_LOGS, every chunk is saved together
+// with the stage watermark, so an interrupted run is continued by the next
+// one. Logs from the current day and after it stay for later runs.
 class DailyUserStatisticsCreator : public DailyUserStatisticsCreatorInterface {
  public:
   virtual ~DailyUserStatisticsCreator() = default;
@@ -31,6 +37,9 @@ class DailyUserStatisticsCreator : public DailyUserStatisticsCreatorInterface {
 
   void CreateStatistics(const ::type::Date &today) override;
 
+  static const std::string WATERMARK_STAGE;
+  static constexpr ::database::type::RowsCount CHUNK_LOGS = 10000;
+
  private:
   DailyUserStatisticsCreator(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                              ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions);
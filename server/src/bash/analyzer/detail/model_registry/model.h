@@ -0,0 +1,54 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <fann.h>
+#include <memory>
+
+#include "src/bash/analyzer/detail/command_features/command_features.h"
+#include "src/database/type/row_id.h"
+#include "src/library/fann/dense_network.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace model_registry
+{
+
+// Trained network with the users of its outputs and the commands of its
+// inputs. Running the FANN network changes its neurons, so one model can't
+// be run from two threads at once; the dense network can.
+struct Model {
+  ::database::type::RowId configuration_id;
+  unsigned version;
+
+  std::shared_ptr<struct fann> network;
+  // the same network for many rows at once, nullptr when it isn't supported
+  ::library::fann::DenseNetworkPtr dense_network;
+  unsigned number_of_inputs;
+
+  // user of every output
+  ::database::type::RowIds users_ids;
+  // inputs of commands, networks trained with a fixed number of inputs may
+  // have more inputs than commands
+  command_features::CommandFeatures features;
+};
+
+typedef std::shared_ptr<const Model> ModelPtr;
+
+}
+
+}
+
+}
+
+}
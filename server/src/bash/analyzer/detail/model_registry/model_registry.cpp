@@ -0,0 +1,162 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "model_registry.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <fstream>
+
+#include "src/library/fann/fann_wrapper.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace model_registry
+{
+
+ModelRegistryPtr ModelRegistry::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                                       const std::string &neural_network_data_directory) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::model_registry::ModelRegistry::Create: Function call";
+
+  auto fann_wrapper = ::library::fann::FannWrapper::Create();
+
+  return Create(database_functions, neural_network_data_directory, fann_wrapper);
+}
+
+ModelRegistryPtr ModelRegistry::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                                       const std::string &neural_network_data_directory,
+                                       ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::model_registry::ModelRegistry::Create: Function call";
+
+  return ModelRegistryPtr(new ModelRegistry(database_functions, neural_network_data_directory, fann_wrapper));
+}
+
+ModelPtr ModelRegistry::Get(::database::type::RowId configuration_id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(configuration_id);
+    if (it != models_.end())
+      return it->second;
+  }
+
+  // files are read without the lock, a model loaded by another thread
+  // in the meantime wins
+  auto model = Load(configuration_id);
+  if (!model)
+    return model;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return models_.emplace(configuration_id, model).first->second;
+}
+
+bool ModelRegistry::Update(::database::type::RowId configuration_id) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::model_registry::ModelRegistry::Update: Function call";
+
+  auto model = Load(configuration_id);
+  if (!model) {
+    BOOST_LOG_TRIVIAL(warning) << "bash::analyzer::detail::model_registry::ModelRegistry::Update: Can't load model of configuration " << configuration_id;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  models_[configuration_id] = model;
+
+  BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::model_registry::ModelRegistry::Update: Configuration " << configuration_id << " uses model version " << model->version;
+  return true;
+}
+
+void ModelRegistry::Prune(const ::database::type::RowIds &configurations_ids) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto it = models_.begin(); it != models_.end();) {
+    if (std::find(configurations_ids.begin(), configurations_ids.end(), it->first) == configurations_ids.end())
+      it = models_.erase(it);
+    else
+      ++it;
+  }
+}
+
+std::string ModelRegistry::GetNetworkFilePath(::database::type::RowId configuration_id) const {
+  return neural_network_data_directory_ + "/network-" + std::to_string(configuration_id) + ".data";
+}
+
+std::string ModelRegistry::GetStateFilePath(::database::type::RowId configuration_id) const {
+  return neural_network_data_directory_ + "/network-" + std::to_string(configuration_id) + ".state";
+}
+
+ModelRegistry::ModelRegistry(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                             const std::string &neural_network_data_directory,
+                             ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) :
+database_functions_(database_functions),
+neural_network_data_directory_(neural_network_data_directory),
+fann_wrapper_(fann_wrapper) {
+}
+
+ModelPtr ModelRegistry::Load(::database::type::RowId configuration_id) const {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::model_registry::ModelRegistry::Load: Loading model of configuration " << configuration_id;
+
+  network_trainer::TrainingState state;
+  if (!network_trainer::LoadTrainingState(GetStateFilePath(configuration_id), state)
+      && !LoadLegacyTrainingState(configuration_id, state))
+    return ModelPtr();
+
+  struct fann *ann = fann_wrapper_->CreateFromFile(GetNetworkFilePath(configuration_id));
+  if (ann == nullptr)
+    return ModelPtr();
+
+  auto fann_wrapper = fann_wrapper_;
+  std::shared_ptr<struct fann> network(ann, [fann_wrapper](struct fann *a) { fann_wrapper->Destroy(a); });
+
+  if (fann_wrapper_->GetNumOutput(ann) != state.users_ids.size()
+      || fann_wrapper_->GetNumInput(ann) < state.commands_ids.size()) {
+    BOOST_LOG_TRIVIAL(warning) << "bash::analyzer::detail::model_registry::ModelRegistry::Load: Network of configuration " << configuration_id << " doesn't match its state";
+    return ModelPtr();
+  }
+
+  auto model = std::make_shared<Model>();
+  model->configuration_id = configuration_id;
+  model->version = state.version;
+  model->network = network;
+  model->dense_network = fann_wrapper_->GetDenseNetwork(ann);
+  if (!model->dense_network)
+    BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::model_registry::ModelRegistry::Load: Network of configuration " << configuration_id << " will be run row by row by libfann";
+  model->number_of_inputs = fann_wrapper_->GetNumInput(ann);
+  model->users_ids = state.users_ids;
+  model->features = command_features::CommandFeatures(state.commands_ids);
+
+  return model;
+}
+
+// the same users and commands the classificator used before training
+// states were saved
+bool ModelRegistry::LoadLegacyTrainingState(::database::type::RowId configuration_id,
+                                            network_trainer::TrainingState &state) const {
+  if (std::ifstream(GetStateFilePath(configuration_id).c_str()) || !std::ifstream(GetNetworkFilePath(configuration_id).c_str()))
+    return false;
+
+  BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::model_registry::ModelRegistry::LoadLegacyTrainingState: Network of configuration " << configuration_id << " has no training state, using the database";
+
+  state = network_trainer::TrainingState();
+  state.version = 0;
+  state.users_ids = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(configuration_id);
+  state.commands_ids = database_functions_->GetMarkedCommandsIds(configuration_id);
+
+  return true;
+}
+
+}
+
+}
+
+}
+
+}
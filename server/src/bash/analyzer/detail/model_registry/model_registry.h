@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "model.h"
+#include "src/bash/analyzer/detail/network_trainer/training_state.h"
+#include "src/bash/database/detail/database_functions_interface.h"
+#include "src/library/fann/detail/fann_wrapper_interface.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace model_registry
+{
+
+class ModelRegistry;
+typedef std::shared_ptr<ModelRegistry> ModelRegistryPtr;
+
+// Networks loaded once and shared by the trainer and the classificator.
+// Models are immutable, a new version replaces the old one and users of
+// the old version keep it until they release it.
+//
+// Networks saved before training states were added have only the network
+// file, their users and commands are read from the database.
+class ModelRegistry {
+ public:
+  virtual ~ModelRegistry() = default;
+
+  static ModelRegistryPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                                 const std::string &neural_network_data_directory);
+
+  static ModelRegistryPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                                 const std::string &neural_network_data_directory,
+                                 ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
+
+  // Model is loaded on first use, nullptr is returned when the configuration
+  // has no valid network.
+  ModelPtr Get(::database::type::RowId configuration_id);
+
+  // Loads saved files again, the cached model is kept when they aren't valid.
+  // Returns true when the model was replaced.
+  bool Update(::database::type::RowId configuration_id);
+
+  // Drops models of configurations which aren't on the list.
+  void Prune(const ::database::type::RowIds &configurations_ids);
+
+  std::string GetNetworkFilePath(::database::type::RowId configuration_id) const;
+  std::string GetStateFilePath(::database::type::RowId configuration_id) const;
+
+ private:
+  ModelRegistry(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
+                const std::string &neural_network_data_directory,
+                ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
+
+  ModelPtr Load(::database::type::RowId configuration_id) const;
+  bool LoadLegacyTrainingState(::database::type::RowId configuration_id,
+                               network_trainer::TrainingState &state) const;
+
+  ::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
+  const std::string neural_network_data_directory_;
+  ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper_;
+
+  std::mutex mutex_;
+  std::map< ::database::type::RowId, ModelPtr> models_;
+};
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "memory_budget.h"
+
+#include <algorithm>
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace network_trainer
+{
+
+MemoryBudget::MemoryBudget(std::size_t size) :
+size_(size),
+available_(size) {
+}
+
+std::size_t MemoryBudget::Reserve(std::size_t size) {
+  size = std::min(size, size_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this, size]() {
+    return available_ >= size;
+  });
+  available_ -= size;
+
+  return size;
+}
+
+void MemoryBudget::Release(std::size_t size) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_ += size;
+  }
+  condition_.notify_all();
+}
+
+std::size_t MemoryBudget::GetSize() const {
+  return size_;
+}
+
+}
+
+}
+
+}
+
+}
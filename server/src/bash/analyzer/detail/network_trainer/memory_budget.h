@@ -0,0 +1,49 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace network_trainer
+{
+
+// Memory shared by concurrent jobs. A job larger than the whole budget
+// waits until it runs alone.
+class MemoryBudget {
+ public:
+  explicit MemoryBudget(std::size_t size);
+
+  // Blocks until the memory is available, returns the reserved size.
+  std::size_t Reserve(std::size_t size);
+  void Release(std::size_t size);
+
+  std::size_t GetSize() const;
+
+ private:
+  const std::size_t size_;
+  std::size_t available_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+};
+
+}
+
+}
+
+}
+
+}
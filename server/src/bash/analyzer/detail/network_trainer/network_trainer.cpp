@@ -8,13 +8,18 @@
 #include <slas/util/run_partially.h>
 
 #include <algorithm>
-#include <vector>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
 #include <boost/log/trivial.hpp>
 
-#include "src/bash/analyzer/detail/command_summary_divider/command_summary_divider.h"
+#include "src/bash/analyzer/detail/command_features/command_features.h"
 #include "src/library/fann/fann_wrapper.h"
 #include "src/library/fann/fann_guard.h"
+#include "src/library/fann/fann_train_data_guard.h"
 
 namespace bash
 {
@@ -28,186 +33,356 @@ namespace detail
 namespace network_trainer
 {
 
+namespace
+{
+
+const std::string TEMPORARY_FILE_SUFFIX = ".tmp";
+
+// rename replaces the file atomically, readers see the old or the new file
+void ReplaceFile(const std::string &from, const std::string &to) {
+  if (std::rename(from.c_str(), to.c_str()) != 0)
+    throw std::runtime_error("bash::analyzer::detail::network_trainer::ReplaceFile: Can't rename " + from + " to " + to);
+}
+
+}
+
+constexpr unsigned NetworkTrainer::NUMBER_OF_HIDDEN_NEURONS;
+constexpr unsigned NetworkTrainer::MAX_EPOCHS;
+constexpr unsigned NetworkTrainer::MAX_INCREMENTAL_EPOCHS;
+constexpr float NetworkTrainer::DESIRED_ERROR;
+constexpr unsigned NetworkTrainer::PATIENCE;
+constexpr unsigned NetworkTrainer::VALIDATION_STEP;
+constexpr unsigned NetworkTrainer::MIN_ROWS_FOR_VALIDATION;
+constexpr unsigned NetworkTrainer::MAX_PARALLEL_TRAININGS;
+constexpr std::size_t NetworkTrainer::TRAINING_MEMORY_BUDGET;
+
 NetworkTrainerPtr NetworkTrainer::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                         const std::string &neural_network_data_directory) {
+                                         const std::string &neural_network_data_directory,
+                                         ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                                         bool save_training_data_snapshots) {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::Create: Function call";
 
   auto fann_wrapper = ::library::fann::FannWrapper::Create();
 
-  return Create(database_functions, general_database_functions, neural_network_data_directory, fann_wrapper);
+  return Create(database_functions, general_database_functions, neural_network_data_directory, model_registry, save_training_data_snapshots, fann_wrapper);
 }
 
 NetworkTrainerPtr NetworkTrainer::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                          const std::string &neural_network_data_directory,
+                                         ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                                         bool save_training_data_snapshots,
                                          ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::Create: Function call";
 
-  return NetworkTrainerPtr(new NetworkTrainer(database_functions, general_database_functions, neural_network_data_directory, fann_wrapper));
+  return NetworkTrainerPtr(new NetworkTrainer(database_functions, general_database_functions, neural_network_data_directory, model_registry, save_training_data_snapshots, fann_wrapper));
 }
 
 void NetworkTrainer::Train() {
   BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::Train: Function call";
 
-  auto configurations = database_functions_->GetAnomalyDetectionConfigurations();
+  ::bash::database::type::AnomalyDetectionConfigurations configurations;
+  {
+    std::lock_guard<std::mutex> lock(database_mutex_);
+    configurations = database_functions_->GetAnomalyDetectionConfigurations();
+  }
 
+  ::analyzer::WorkerPool::Tasks tasks;
   for (const auto &c : configurations) {
     BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::Train: Is configuration changed for agent " << c.agent_name_id << "?: " << c.changed;
 
-    if (c.changed) {
-      CreateLearningSetFile(c);
-      CreateNetworkConfiguration(c);
-      database_functions_->MarkConfigurationAsUnchanged(c.id);
-    }
+    if (c.changed)
+      tasks.push_back([this, c]() { TrainConfiguration(c); });
   }
+
+  worker_pool_->Run(tasks);
 }
 
 NetworkTrainer::NetworkTrainer(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                const std::string &neural_network_data_directory,
+                               ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                               bool save_training_data_snapshots,
                                ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper) :
 database_functions_(database_functions),
 general_database_functions_(general_database_functions),
 neural_network_data_directory_(neural_network_data_directory),
-fann_wrapper_(fann_wrapper) {
+model_registry_(model_registry),
+save_training_data_snapshots_(save_training_data_snapshots),
+fann_wrapper_(fann_wrapper),
+worker_pool_(::analyzer::WorkerPool::Create(std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_PARALLEL_TRAININGS)))),
+memory_budget_(TRAINING_MEMORY_BUDGET) {
 }
 
-void NetworkTrainer::CreateLearningSetFile(const ::bash::database::type::AnomalyDetectionConfiguration &configuration) {
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Function call";
+void NetworkTrainer::TrainConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::TrainConfiguration: Function call";
 
-  auto users = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(configuration.id);
+  const std::size_t reserved = memory_budget_.Reserve(EstimateLearningSetMemory(configuration));
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found " << users.size() << " users";
+  try {
+    LearningSet learning_set;
+    TrainingState state;
+    {
+      std::lock_guard<std::mutex> lock(database_mutex_);
+      CreateLearningSet(configuration, learning_set, state);
+    }
 
-  constexpr int ANOMALY_NETWORK_VALUE = 0;
-  constexpr::database::type::RowsCount MAX_ROWS_IN_MEMORY = 100;
-  constexpr unsigned int number_of_inputs = 100;
-  unsigned int number_of_outputs = users.size();
-  long long learning_set_size = database_functions_->CountSelectedDailyStatisticsWithoutUnknownClassificationInConfiguration(configuration.id);
-  std::string file_path = neural_network_data_directory_ + "/training-" + std::to_string(configuration.id) + ".data";
+    const std::string network_file_path = GetFilePath("network", configuration, ".data");
+    const std::string state_file_path = GetFilePath("network", configuration, ".state");
+
+    // state is valid only with the network it describes
+    TrainingState previous_state = TrainingState();
+    TrainingMode mode = TrainingMode::FULL;
+    if (LoadTrainingState(state_file_path, previous_state)
+        && std::ifstream(network_file_path.c_str()))
+      mode = GetTrainingMode(previous_state, state);
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Number of inputs: " << number_of_inputs;
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Number of outputs: " << number_of_outputs;
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Learning set size: " << learning_set_size;
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Training file path: " << file_path;
+    if (mode == TrainingMode::NONE) {
+      BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::network_trainer::NetworkTrainer::TrainConfiguration: Learning set of configuration " << configuration.id << " not changed, skipping";
+    }
+    else if (learning_set.size == 0 || learning_set.number_of_inputs == 0 || learning_set.number_of_outputs == 0) {
+      BOOST_LOG_TRIVIAL(warning) << "bash::analyzer::detail::network_trainer::NetworkTrainer::TrainConfiguration: Learning set of configuration " << configuration.id << " is empty, skipping";
+    }
+    else {
+      CreateNetworkConfiguration(configuration, learning_set, mode, state);
+
+      state.version = previous_state.version + 1;
+      if (!SaveTrainingState(state_file_path + TEMPORARY_FILE_SUFFIX, state))
+        throw std::runtime_error("bash::analyzer::detail::network_trainer::NetworkTrainer::TrainConfiguration: Can't save training state");
 
-  std::vector<double> input;
-  input.resize(number_of_inputs, 0);
+      ReplaceFile(network_file_path + TEMPORARY_FILE_SUFFIX, network_file_path);
+      ReplaceFile(state_file_path + TEMPORARY_FILE_SUFFIX, state_file_path);
+      model_registry_->Update(configuration.id);
 
-  std::vector<int> output;
-  output.resize(number_of_outputs, ANOMALY_NETWORK_VALUE);
+      BOOST_LOG_TRIVIAL(info) << "bash::analyzer::detail::network_trainer::NetworkTrainer::TrainConfiguration: Configuration " << configuration.id
+          << " version " << state.version << " trained " << (state.is_warm_start ? "incrementally" : "from scratch")
+          << " on " << learning_set.size << " rows in " << state.training_time << " s, epochs: " << state.epochs
+          << ", train error: " << state.train_error << ", validation error: " << state.validation_error;
+    }
+  }
+  catch (...) {
+    memory_budget_.Release(reserved);
+    throw;
+  }
+
+  memory_budget_.Release(reserved);
+
+  std::lock_guard<std::mutex> lock(database_mutex_);
+  database_functions_->MarkConfigurationAsUnchanged(configuration.id);
+}
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Opening training file";
-  std::fstream file(file_path.c_str(), std::ios::out | std::ios::trunc);
+std::size_t NetworkTrainer::EstimateLearningSetMemory(const ::bash::database::type::AnomalyDetectionConfiguration &configuration) {
+  std::lock_guard<std::mutex> lock(database_mutex_);
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Writing training data";
-  file << learning_set_size << ' ' << number_of_inputs << ' ' << number_of_outputs << '\n';
+  const std::size_t rows = database_functions_->CountSelectedDailyStatisticsWithoutUnknownClassificationInConfiguration(configuration.id);
+  const std::size_t inputs = database_functions_->GetMarkedCommandsIds(configuration.id).size();
+  const std::size_t outputs = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(configuration.id).size();
+
+  // sparse rows hold at most every input, training and validation data given
+  // to FANN are dense; row ids
+  return rows * ((inputs + outputs) * sizeof (fann_type) * 2
+                 + inputs * (sizeof (fann_type) + sizeof (unsigned))
+                 + sizeof (LearningSetRow) * 2);
+}
+
+void NetworkTrainer::CreateLearningSet(const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                                       LearningSet &learning_set,
+                                       TrainingState &state) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Function call";
+
+  auto users = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(configuration.id);
+
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Found " << users.size() << " users";
+
+  constexpr fann_type ANOMALY_NETWORK_VALUE = 0;
+  constexpr fann_type NORMAL_NETWORK_VALUE = 1;
+  constexpr::database::type::RowsCount MAX_ROWS_IN_MEMORY = 100;
+  const unsigned int number_of_outputs = users.size();
+  long long learning_set_size = database_functions_->CountSelectedDailyStatisticsWithoutUnknownClassificationInConfiguration(configuration.id);
 
   auto selected_commands_ids = database_functions_->GetMarkedCommandsIds(configuration.id);
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found " << selected_commands_ids.size() << " selected commands ids";
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Found " << selected_commands_ids.size() << " selected commands ids";
+
+  const command_features::CommandFeatures features(selected_commands_ids);
+
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Number of inputs: " << features.GetNumberOfColumns();
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Number of outputs: " << number_of_outputs;
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Learning set size: " << learning_set_size;
+
+  auto &inputs = learning_set.inputs;
+  auto &outputs = learning_set.outputs;
+  inputs.Clear();
+  outputs.clear();
+  inputs.offsets.reserve(learning_set_size + 1);
+  outputs.reserve(learning_set_size * number_of_outputs);
+  learning_set.number_of_inputs = features.GetNumberOfColumns();
+  learning_set.number_of_outputs = number_of_outputs;
+  learning_set.size = 0;
 
-  for (const auto &id : selected_commands_ids)
-    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: id: " << id;
+  state.users_ids = users;
+  state.commands_ids = selected_commands_ids;
+  state.rows.clear();
 
-  command_summary_divider::CommandSummaryDivider divider;
-  unsigned selected_commands_position = 0;
-  unsigned commands_statistics_position = 0;
-  int user_output_position = 0;
+  unsigned user_output_position = 0;
   for (const auto &user_id : users) {
-    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Writing data for user id (from database) " << user_id;
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Adding data for user id (from database) " << user_id;
 
     auto daily_user_statistics_count = database_functions_->CountSelectedDailyUserStatisticsWithoutUnknownClassificationFromConfigurationByUser(configuration.id, user_id);
-    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found " << daily_user_statistics_count << " daily user statistics";
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Found " << daily_user_statistics_count << " daily user statistics";
 
     util::RunPartially(MAX_ROWS_IN_MEMORY, daily_user_statistics_count, [&](long long part_count, long long offset) {
       auto daily_user_statistics = database_functions_->GetSelectedDailyUserStatisticsWithoutUnknownClassificationFromConfigurationByUser(configuration.id, user_id, part_count, offset);
-      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found " << daily_user_statistics.size() << " statistics in part";
+      BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Found " << daily_user_statistics.size() << " statistics in part";
 
       for (const auto &statistic : daily_user_statistics) {
-        std::fill(input.begin(), input.end(), 0);
+        const auto output = outputs.insert(outputs.end(), number_of_outputs, ANOMALY_NETWORK_VALUE);
 
         auto commands_statistics = database_functions_->GetSelectedDailyUserCommandsStatistics(statistic.id);
-        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found " << commands_statistics.size() << " selected daily user commands statistics with statistic id " << statistic.id;
+        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Found " << commands_statistics.size() << " selected daily user commands statistics with statistic id " << statistic.id;
 
-        selected_commands_position = 0;
-        commands_statistics_position = 0;
-        while (selected_commands_position < selected_commands_ids.size()
-            && commands_statistics_position < commands_statistics.size()) {
-          const auto &command_statistic = commands_statistics.at(commands_statistics_position);
-          BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Position " << selected_commands_position;
+        // inputs of commands which weren't used are not stored
+        features.AddRow(commands_statistics, inputs);
 
-          if (command_statistic.command_id == selected_commands_ids.at(selected_commands_position)) {
-            BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Found command with id " << command_statistic.command_id;
+        if (statistic.classification == ::database::type::Classification::NORMAL)
+          output[user_output_position] = NORMAL_NETWORK_VALUE;
 
-            input.at(selected_commands_position) = command_statistic.summary;
-            commands_statistics_position++;
-          }
+        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Classification set: " << output[user_output_position];
 
-          selected_commands_position++;
-        }
-
-        std::transform(input.begin(), input.end(), input.begin(), divider);
+        state.rows.push_back(LearningSetRow(statistic.id, statistic.classification));
+        learning_set.size++;
+      }
+    });
 
-        if (statistic.classification == ::database::type::Classification::ANOMALY)
-          output.at(user_output_position) = ANOMALY_NETWORK_VALUE;
-        else if (statistic.classification == ::database::type::Classification::NORMAL)
-          output.at(user_output_position) = 1;
+    user_output_position++;
+  }
 
-        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Classification set: " << output.at(user_output_position);
+  std::sort(state.rows.begin(), state.rows.end());
 
-        BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Saving to file";
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSet: Done";
+}
 
-        for (const auto &v : input)
-          file << v << " ";
-        file << '\n';
+void NetworkTrainer::CreateNetworkConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                                                const LearningSet &learning_set,
+                                                TrainingMode mode,
+                                                TrainingState &state) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Function call";
 
-        for (const auto &v : output)
-          file << v << " ";
-        file << '\n';
-      }
+  constexpr unsigned int number_of_layers = 3;
+  const unsigned int number_of_inputs = learning_set.number_of_inputs;
+  const unsigned int number_of_outputs = learning_set.number_of_outputs;
+  const auto start_time = std::chrono::steady_clock::now();
+
+  const std::string network_configuration_file_path = GetFilePath("network", configuration, ".data");
+
+  // every VALIDATION_STEP-th row is held out, small sets are used whole
+  const bool use_validation = learning_set.size >= MIN_ROWS_FOR_VALIDATION;
+  const unsigned validation_size = use_validation ? learning_set.size / VALIDATION_STEP : 0;
+  const unsigned train_size = learning_set.size - validation_size;
+
+  auto copy_row = [&](std::size_t row, fann_type *input, fann_type *output) {
+    learning_set.inputs.ToDense(row, number_of_inputs, input);
+    std::copy_n(learning_set.outputs.begin() + row * number_of_outputs, number_of_outputs, output);
+  };
+
+  struct fann_train_data *train_data = fann_wrapper_->CreateTrainData(train_size, number_of_inputs, number_of_outputs,
+                                                                      [&](unsigned row, fann_type *input, fann_type *output) {
+    // rows skipped by the validation set: VALIDATION_STEP - 1 train rows per validation row
+    const std::size_t r = use_validation && row < validation_size * (VALIDATION_STEP - 1)
+        ? row / (VALIDATION_STEP - 1) * VALIDATION_STEP + row % (VALIDATION_STEP - 1)
+        : validation_size + row;
+    copy_row(r, input, output);
+  });
+  if (train_data == nullptr)
+    throw std::runtime_error("bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Can't create training data");
+  ::library::fann::FannTrainDataGuard train_data_guard(train_data, fann_wrapper_);
+
+  struct fann_train_data *validation_data = nullptr;
+  if (use_validation) {
+    validation_data = fann_wrapper_->CreateTrainData(validation_size, number_of_inputs, number_of_outputs,
+                                                     [&](unsigned row, fann_type *input, fann_type *output) {
+      copy_row(static_cast<std::size_t> (row) * VALIDATION_STEP + VALIDATION_STEP - 1, input, output);
     });
+    if (validation_data == nullptr)
+      throw std::runtime_error("bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Can't create validation data");
+  }
+  ::library::fann::FannTrainDataGuard validation_data_guard(validation_data, fann_wrapper_);
 
-    output.at(user_output_position) = ANOMALY_NETWORK_VALUE;
-    user_output_position++;
+  if (save_training_data_snapshots_)
+    fann_wrapper_->SaveTrainDataSnapshot(train_data, GetFilePath("training", configuration, ".snapshot"));
+
+  struct fann *ann = nullptr;
+  if (mode == TrainingMode::INCREMENTAL) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Loading network";
+    ann = fann_wrapper_->CreateFromFile(network_configuration_file_path);
+
+    if (ann != nullptr && (fann_wrapper_->GetNumInput(ann) != number_of_inputs
+                           || fann_wrapper_->GetNumOutput(ann) != number_of_outputs)) {
+      fann_wrapper_->Destroy(ann);
+      ann = nullptr;
+    }
   }
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Closing training file";
-  file.close();
+  state.is_warm_start = (ann != nullptr);
+  if (ann == nullptr) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Creating network";
+    ann = fann_wrapper_->CreateStandard(number_of_layers, number_of_inputs, NUMBER_OF_HIDDEN_NEURONS, number_of_outputs);
+    if (ann == nullptr)
+      throw std::runtime_error("bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Can't create network");
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateLearningSetFile: Done";
-}
+    fann_wrapper_->SetActivationFunctionHidden(ann, FANN_SIGMOID);
+    fann_wrapper_->SetActivationFunctionOutput(ann, FANN_SIGMOID);
+  }
+  ::library::fann::FannGuard fann_guard(ann, fann_wrapper_);
 
-void NetworkTrainer::CreateNetworkConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration) {
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Done";
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Training network";
 
-  auto users = database_functions_->GetUsersIdsFromSelectedDailyStatisticsInConfiguration(configuration.id);
+  auto destroy = [this](struct fann *a) { fann_wrapper_->Destroy(a); };
+  std::shared_ptr<struct fann> best;
+  float best_validation_error = std::numeric_limits<float>::max();
+  unsigned epochs_without_improvement = 0;
+  const unsigned max_epochs = state.is_warm_start ? MAX_INCREMENTAL_EPOCHS : MAX_EPOCHS;
 
-  constexpr::database::type::RowsCount MAX_ROWS_IN_MEMORY = 100;
-  constexpr unsigned int number_of_inputs = 100;
-  constexpr unsigned int number_of_layers = 3;
-  constexpr unsigned int number_of_hidden_neurons = 30;
-  const unsigned int number_of_outputs = users.size();
-  constexpr float desired_error = 0.001f;
-  constexpr unsigned int max_epochs = 100;
-  constexpr unsigned int epochs_between_reports = 10;
+  state.epochs = 0;
+  state.train_error = 0;
+  state.validation_error = 0;
 
-  const std::string file_path = neural_network_data_directory_ + "/training-" + std::to_string(configuration.id) + ".data";
-  const std::string network_configuration_file_path = neural_network_data_directory_ + "/network-" + std::to_string(configuration.id) + ".data";
+  while (state.epochs < max_epochs) {
+    state.train_error = fann_wrapper_->TrainEpoch(ann, train_data);
+    state.epochs++;
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Creating network";
+    if (use_validation) {
+      const float validation_error = fann_wrapper_->TestData(ann, validation_data);
 
-  struct fann *ann = fann_wrapper_->CreateStandard(number_of_layers, number_of_inputs, number_of_hidden_neurons, number_of_outputs);
-  ::library::fann::FannGuard fann_guard(ann);
+      if (validation_error < best_validation_error) {
+        best_validation_error = validation_error;
+        best = std::shared_ptr<struct fann>(fann_wrapper_->Copy(ann), destroy);
+        epochs_without_improvement = 0;
+      }
+      else if (++epochs_without_improvement >= PATIENCE) {
+        break;
+      }
+    }
+
+    if (state.train_error <= DESIRED_ERROR)
+      break;
+  }
 
-  fann_wrapper_->SetActivationFunctionHidden(ann, FANN_SIGMOID);
-  fann_wrapper_->SetActivationFunctionOutput(ann, FANN_SIGMOID);
+  if (use_validation)
+    state.validation_error = best_validation_error;
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Training network";
-  fann_wrapper_->TrainOnFile(ann, file_path, max_epochs, epochs_between_reports, desired_error);
+  state.training_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+  const std::string temporary_file_path = network_configuration_file_path + TEMPORARY_FILE_SUFFIX;
+  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Saving network to file: " << temporary_file_path;
+  if (fann_wrapper_->Save(best ? best.get() : ann, temporary_file_path) != 0)
+    throw std::runtime_error("bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Can't save network");
+}
 
-  BOOST_LOG_TRIVIAL(debug) << "bash::analyzer::detail::network_trainer::NetworkTrainer::CreateNetworkConfiguration: Saving network to file: " << network_configuration_file_path;
-  fann_wrapper_->Save(ann, network_configuration_file_path);
+std::string NetworkTrainer::GetFilePath(const std::string &prefix,
+                                        const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                                        const std::string &extension) const {
+  return neural_network_data_directory_ + "/" + prefix + "-" + std::to_string(configuration.id) + extension;
 }
 
 }
@@ -7,6 +7,15 @@
 
 #include "network_trainer_interface.h"
 
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "memory_budget.h"
+#include "training_state.h"
+#include "src/analyzer/worker_pool.h"
+#include "src/bash/analyzer/detail/command_features/sparse_rows.h"
+#include "src/bash/analyzer/detail/model_registry/model_registry.h"
 #include "src/bash/database/detail/database_functions_interface.h"
 #include "src/database/detail/general_database_functions_interface.h"
 #include "src/library/fann/detail/fann_wrapper_interface.h"
@@ -26,34 +35,90 @@ namespace network_trainer
 class NetworkTrainer;
 typedef std::shared_ptr<NetworkTrainer> NetworkTrainerPtr;
 
+// Changed configurations are trained concurrently. Learning sets are read
+// from the database one at a time and held in memory only within
+// TRAINING_MEMORY_BUDGET. A network is trained further from the saved file
+// when only new days were added to its learning set. Training stops when
+// the error on every VALIDATION_STEP-th row stops improving. Network and
+// state are written to temporary files and renamed, then the model registry
+// loads the new version.
 class NetworkTrainer : public NetworkTrainerInterface {
  public:
   virtual ~NetworkTrainer() = default;
 
   static NetworkTrainerPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
-                                  const std::string &neural_network_data_directory);
+                                  const std::string &neural_network_data_directory,
+                                  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                                  bool save_training_data_snapshots);
 
   static NetworkTrainerPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                                   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                                   const std::string &neural_network_data_directory,
+                                  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                                  bool save_training_data_snapshots,
                                   ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
 
   void Train() override;
 
+  static constexpr unsigned NUMBER_OF_HIDDEN_NEURONS = 30;
+  static constexpr unsigned MAX_EPOCHS = 500;
+  static constexpr unsigned MAX_INCREMENTAL_EPOCHS = 100;
+  static constexpr float DESIRED_ERROR = 0.001f;
+  // epochs without improvement of the validation error
+  static constexpr unsigned PATIENCE = 20;
+  static constexpr unsigned VALIDATION_STEP = 5;
+  static constexpr unsigned MIN_ROWS_FOR_VALIDATION = 20;
+  static constexpr unsigned MAX_PARALLEL_TRAININGS = 4;
+  static constexpr std::size_t TRAINING_MEMORY_BUDGET = 512 * 1024 * 1024;
+
  private:
+  struct LearningSet {
+    command_features::SparseRows inputs;
+    std::vector<fann_type> outputs;
+    unsigned number_of_inputs;
+    unsigned number_of_outputs;
+    std::size_t size;
+  };
+
   ::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
   const std::string neural_network_data_directory_;
+  ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry_;
+  const bool save_training_data_snapshots_;
   ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper_;
+  ::analyzer::WorkerPoolPtr worker_pool_;
+  MemoryBudget memory_budget_;
+  std::mutex database_mutex_;
 
   NetworkTrainer(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
                  ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
                  const std::string &neural_network_data_directory,
+                 ::bash::analyzer::detail::model_registry::ModelRegistryPtr model_registry,
+                 bool save_training_data_snapshots,
                  ::library::fann::detail::FannWrapperInterfacePtr fann_wrapper);
 
-  void CreateLearningSetFile(const ::bash::database::type::AnomalyDetectionConfiguration &configuration);
-  void CreateNetworkConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration);
+  void TrainConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration);
+
+  std::size_t EstimateLearningSetMemory(const ::bash::database::type::AnomalyDetectionConfiguration &configuration);
+
+  // Rows are appended to the learning set, one input per selected command
+  // and one output per user each; state gets users, commands and rows of
+  // the set.
+  void CreateLearningSet(const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                         LearningSet &learning_set,
+                         TrainingState &state);
+
+  // Saves the trained network to a temporary file, the report is written
+  // to state.
+  void CreateNetworkConfiguration(const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                                  const LearningSet &learning_set,
+                                  TrainingMode mode,
+                                  TrainingState &state);
+
+  std::string GetFilePath(const std::string &prefix,
+                          const ::bash::database::type::AnomalyDetectionConfiguration &configuration,
+                          const std::string &extension) const;
 };
 
 }
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "training_state.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace network_trainer
+{
+
+namespace
+{
+
+void WriteIds(std::ostream &stream, const char *name, const ::database::type::RowIds &ids) {
+  stream << name << ' ' << ids.size();
+  for (auto id : ids)
+    stream << ' ' << id;
+  stream << '\n';
+}
+
+// a damaged file can hold any size, it's checked against the rest of the
+// file before anything is allocated
+bool IsSizeValid(std::istream &stream, std::streamoff file_size, std::size_t size, std::size_t min_item_size) {
+  const std::streamoff position = stream.tellg();
+  if (position < 0 || position > file_size)
+    return false;
+
+  return size <= static_cast<std::size_t> (file_size - position) / min_item_size;
+}
+
+bool ReadIds(std::istream &stream, std::streamoff file_size, const char *name, ::database::type::RowIds &ids) {
+  std::string n;
+  std::size_t size;
+  if (!(stream >> n >> size) || n != name)
+    return false;
+
+  // " id"
+  if (!IsSizeValid(stream, file_size, size, 2))
+    return false;
+
+  ids.resize(size);
+  for (auto &id : ids)
+    stream >> id;
+
+  return static_cast<bool> (stream);
+}
+
+}
+
+TrainingMode GetTrainingMode(const TrainingState &previous, const TrainingState &current) {
+  if (previous.users_ids != current.users_ids || previous.commands_ids != current.commands_ids)
+    return TrainingMode::FULL;
+
+  if (previous.rows == current.rows)
+    return TrainingMode::NONE;
+
+  if (std::includes(current.rows.begin(), current.rows.end(), previous.rows.begin(), previous.rows.end()))
+    return TrainingMode::INCREMENTAL;
+
+  return TrainingMode::FULL;
+}
+
+bool SaveTrainingState(const std::string &file_path, const TrainingState &state) {
+  std::ofstream file(file_path.c_str(), std::ios::out | std::ios::trunc);
+
+  WriteIds(file, "users", state.users_ids);
+  WriteIds(file, "commands", state.commands_ids);
+
+  file << "rows " << state.rows.size() << '\n';
+  for (const auto &row : state.rows)
+    file << row.first << ' ' << static_cast<int> (row.second) << '\n';
+
+  file << "report " << state.is_warm_start << ' ' << state.epochs << ' ' << state.training_time
+      << ' ' << state.train_error << ' ' << state.validation_error << '\n';
+
+  file << "version " << state.version << '\n';
+
+  return static_cast<bool> (file);
+}
+
+bool LoadTrainingState(const std::string &file_path, TrainingState &state) {
+  std::ifstream file(file_path.c_str(), std::ios::in | std::ios::ate);
+  if (!file)
+    return false;
+
+  const std::streamoff file_size = file.tellg();
+  file.seekg(0);
+  TrainingState s;
+
+  if (!ReadIds(file, file_size, "users", s.users_ids) || !ReadIds(file, file_size, "commands", s.commands_ids))
+    return false;
+
+  std::string name;
+  std::size_t size;
+  if (!(file >> name >> size) || name != "rows")
+    return false;
+
+  // "\nid classification"
+  if (!IsSizeValid(file, file_size, size, 4))
+    return false;
+
+  s.rows.resize(size);
+  for (auto &row : s.rows) {
+    int classification;
+    file >> row.first >> classification;
+    row.second = static_cast< ::database::type::Classification> (classification);
+  }
+
+  if (!(file >> name >> s.is_warm_start >> s.epochs >> s.training_time >> s.train_error >> s.validation_error) || name != "report")
+    return false;
+
+  // files saved before versioning was added
+  if (!(file >> name >> s.version) || name != "version")
+    s.version = 0;
+
+  state = s;
+  return true;
+}
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/database/type/classification.h"
+#include "src/database/type/row_id.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace detail
+{
+
+namespace network_trainer
+{
+
+typedef std::pair< ::database::type::RowId, ::database::type::Classification> LearningSetRow;
+typedef std::vector<LearningSetRow> LearningSetRows;
+
+// What the saved network was trained on and how long it took, kept next
+// to the network file.
+struct TrainingState {
+  // incremented every time the network is saved
+  unsigned version;
+
+  ::database::type::RowIds users_ids;
+  ::database::type::RowIds commands_ids;
+  // daily user statistics ids with their classification, sorted by id
+  LearningSetRows rows;
+
+  bool is_warm_start;
+  unsigned epochs;
+  double training_time;
+  double train_error;
+  double validation_error;
+};
+
+enum class TrainingMode {
+  NONE,
+  INCREMENTAL,
+  FULL
+};
+
+// Network can be trained incrementally when the outputs and inputs are the
+// same and rows were only added; rows with changed classification or
+// removed rows need training from scratch.
+TrainingMode GetTrainingMode(const TrainingState &previous, const TrainingState &current);
+
+bool SaveTrainingState(const std::string &file_path, const TrainingState &state);
+bool LoadTrainingState(const std::string &file_path, TrainingState &state);
+
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <slas/type/timestamp.h>
+
+#include "src/bash/database/type/command_name.h"
+#include "src/bash/database/type/uid.h"
+
+namespace bash
+{
+
+namespace analyzer
+{
+
+namespace type
+{
+
+// average_surprise is the moving average of bits of surprise of the user's
+// last commands, command is the one which raised it above the threshold.
+struct SequenceAlert {
+  std::string agent_name;
+  ::bash::database::type::UID user_id;
+  ::type::Timestamp time;
+  ::bash::database::type::CommandName command;
+  unsigned long long commands_count;
+  double surprise;
+  double average_surprise;
+};
+
+typedef std::vector<SequenceAlert> SequenceAlerts;
+
+}
+
+}
+
+}
@@ -89,7 +89,32 @@ void DatabaseFunctions::AddCommand(const ::bash::database::type::CommandName &co
   return raw_database_functions_->GetCommandNameById(id);
 }
 
-void DatabaseFunctions::AddLog(const ::type::BashLogEntry &log_entry) {
+::bash::database::type::Commands DatabaseFunctions::GetAllCommands() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::GetAllCommands: Function call";
+
+  return raw_database_functions_->GetAllCommands();
+}
+
+void DatabaseFunctions::MergeCommands(const ::bash::database::type::Commands &commands) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::MergeCommands: Function call";
+
+  detail::type::CommandsMapping mapping;
+  for (const auto &command : commands) {
+    raw_database_functions_->AddCommand(command.second);
+    mapping[command.first] = raw_database_functions_->GetCommandId(command.second);
+  }
+
+  raw_database_functions_->MergeCommands(mapping);
+}
+
+void DatabaseFunctions::AddRawCommand(const ::bash::database::type::CommandName &raw_command,
+                                      const ::bash::database::type::CommandName &command) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::AddRawCommand: Function call";
+
+  raw_database_functions_->AddRawCommand(raw_command, raw_database_functions_->GetCommandId(command));
+}
+
+void DatabaseFunctions::AddLog(const ::type::BashLogEntry &log_entry, const ::bash::database::type::CommandName &raw_command) {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::AddLog: Function call";
 
   detail::entity::Log raw_log;
@@ -98,6 +123,7 @@ void DatabaseFunctions::AddLog(const ::type::BashLogEntry &log_entry) {
   raw_log.time_id = general_database_functions_->GetTimeId(log_entry.utc_time.GetTime());
   raw_log.user_id = GetSystemUserId(log_entry.user_id);
   raw_log.command_id = raw_database_functions_->GetCommandId(log_entry.command);
+  raw_log.raw_command_id = (raw_command == log_entry.command) ? -1 : raw_database_functions_->GetRawCommandId(raw_command);
 
   raw_database_functions_->AddLog(raw_log);
 }
@@ -183,6 +209,15 @@ void DatabaseFunctions::AddDailyUserStatistic(const ::bash::database::detail::en
   return raw_database_functions_->GetDailyUserStatisticsForAgentWithClassification(agent_name_id, classification, limit, offset);
 }
 
+::bash::database::detail::type::DailyUserStatisticsWithCommands DatabaseFunctions::GetDailyUserStatisticsWithCommandsForAgentWithClassification(::database::type::RowId agent_name_id,
+                                                                                                                                               ::database::type::Classification classification,
+                                                                                                                                               ::database::type::RowsCount limit,
+                                                                                                                                               ::database::type::RowsCount offset) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::GetDailyUserStatisticsWithCommandsForAgentWithClassification: Function call";
+
+  return raw_database_functions_->GetDailyUserStatisticsWithCommandsForAgentWithClassification(agent_name_id, classification, limit, offset);
+}
+
 ::database::type::RowId DatabaseFunctions::GetDailyUserStatisticId(::database::type::RowId agent_name_id,
                                                                    ::database::type::RowId user_id,
                                                                    ::database::type::RowId date_id) {
@@ -349,6 +384,23 @@ void DatabaseFunctions::AddSelectedCommandsIds(::database::type::RowId configura
   return raw_database_functions_->GetCommandsIdsFromLogs(agent_name_id, user_id, date_id);
 }
 
+::database::type::RowId DatabaseFunctions::GetLastLogIdBeforeDate(::database::type::RowId agent_name_id,
+                                                                  ::database::type::RowId after_log_id,
+                                                                  ::database::type::RowId date_id) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::GetLastLogIdBeforeDate: Function call";
+
+  return raw_database_functions_->GetLastLogIdBeforeDate(agent_name_id, after_log_id, date_id);
+}
+
+void DatabaseFunctions::CreateDailyUserStatistics(::database::type::RowId agent_name_id,
+                                                  ::database::type::RowId after_log_id,
+                                                  ::database::type::RowId last_log_id,
+                                                  const std::string &watermark_stage) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::CreateDailyUserStatistics: Function call";
+
+  raw_database_functions_->CreateDailyUserStatistics(agent_name_id, after_log_id, last_log_id, watermark_stage);
+}
+
 void DatabaseFunctions::AddDailyUserStatisticsToConfiguration(::database::type::RowId configuration_id,
                                                               const ::database::type::RowIds &date_range_ids) {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::DatabaseFunctions::AddDailyUserStatisticsToConfiguration: Function call";
@@ -41,8 +41,13 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
   ::database::type::RowId GetCommandId(const ::bash::database::type::CommandName &command) override;
   ::database::type::RowIds GetAllCommandsIds() override;
   ::bash::database::type::CommandName GetCommandNameById(::database::type::RowId id) override;
+  ::bash::database::type::Commands GetAllCommands() override;
+  void MergeCommands(const ::bash::database::type::Commands &commands) override;
 
-  void AddLog(const ::type::BashLogEntry &log_entry) override;
+  void AddRawCommand(const ::bash::database::type::CommandName &raw_command,
+                     const ::bash::database::type::CommandName &command) override;
+
+  void AddLog(const ::type::BashLogEntry &log_entry, const ::bash::database::type::CommandName &raw_command) override;
   ::database::type::RowsCount CountCommandsForDailySystemStatistic(::database::type::RowId agent_name_id,
                                                                    ::database::type::RowId date_id,
                                                                    ::database::type::RowId command_id) override;
@@ -72,6 +77,10 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
                                                                                                          ::database::type::Classification classification,
                                                                                                          ::database::type::RowsCount limit,
                                                                                                          ::database::type::RowsCount offset) override;
+  ::bash::database::detail::type::DailyUserStatisticsWithCommands GetDailyUserStatisticsWithCommandsForAgentWithClassification(::database::type::RowId agent_name_id,
+                                                                                                                               ::database::type::Classification classification,
+                                                                                                                               ::database::type::RowsCount limit,
+                                                                                                                               ::database::type::RowsCount offset) override;
 
   ::bash::database::type::AnomalyDetectionConfigurations GetAnomalyDetectionConfigurations() override;
   void RemoveAnomalyDetectionConfiguration(::database::type::RowId id) override;
@@ -104,6 +113,13 @@ class DatabaseFunctions : public detail::DatabaseFunctionsInterface {
   ::database::type::RowIds GetCommandsIdsFromLogs(::database::type::RowId agent_name_id,
                                                   ::database::type::RowId user_id,
                                                   ::database::type::RowId date_id) override;
+  ::database::type::RowId GetLastLogIdBeforeDate(::database::type::RowId agent_name_id,
+                                                 ::database::type::RowId after_log_id,
+                                                 ::database::type::RowId date_id) override;
+  void CreateDailyUserStatistics(::database::type::RowId agent_name_id,
+                                 ::database::type::RowId after_log_id,
+                                 ::database::type::RowId last_log_id,
+                                 const std::string &watermark_stage) override;
 
   void AddDailyUserStatisticsToConfiguration(::database::type::RowId configuration_id,
                                              const ::database::type::RowIds &date_range_ids) override;
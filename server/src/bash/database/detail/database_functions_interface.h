@@ -10,6 +10,7 @@
 #include "src/database/type/row_id.h"
 #include "src/bash/database/type/uid.h"
 #include "src/bash/database/type/command_name.h"
+#include "src/bash/database/type/commands.h"
 #include "src/bash/database/type/anomaly_detection_configuration.h"
 #include "src/bash/database/detail/entity/daily_system_statistic.h"
 #include "src/bash/database/detail/entity/daily_user_statistic.h"
@@ -18,6 +19,7 @@
 #include "src/bash/database/detail/entity/system_user.h"
 #include "src/database/entity/agent_name.h"
 #include "src/bash/database/detail/type/daily_user_named_command_statistic.h"
+#include "src/bash/database/detail/type/daily_user_statistic_with_commands.h"
 
 #include <memory>
 
@@ -45,8 +47,13 @@ class DatabaseFunctionsInterface {
   virtual ::database::type::RowId GetCommandId(const ::bash::database::type::CommandName &command) = 0;
   virtual ::database::type::RowIds GetAllCommandsIds() = 0;
   virtual ::bash::database::type::CommandName GetCommandNameById(::database::type::RowId id) = 0;
+  virtual ::bash::database::type::Commands GetAllCommands() = 0;
+  virtual void MergeCommands(const ::bash::database::type::Commands &commands) = 0;
 
-  virtual void AddLog(const ::type::BashLogEntry &log_entry) = 0;
+  virtual void AddRawCommand(const ::bash::database::type::CommandName &raw_command,
+                             const ::bash::database::type::CommandName &command) = 0;
+
+  virtual void AddLog(const ::type::BashLogEntry &log_entry, const ::bash::database::type::CommandName &raw_command) = 0;
   virtual ::database::type::RowsCount CountCommandsForDailySystemStatistic(::database::type::RowId agent_name_id,
                                                                            ::database::type::RowId date_id,
                                                                            ::database::type::RowId command_id) = 0;
@@ -76,6 +83,11 @@ class DatabaseFunctionsInterface {
                                                                                                                  ::database::type::Classification classification,
                                                                                                                  ::database::type::RowsCount limit,
                                                                                                                  ::database::type::RowsCount offset) = 0;
+  // Statistics are sorted by id, every one with all its commands statistics.
+  virtual ::bash::database::detail::type::DailyUserStatisticsWithCommands GetDailyUserStatisticsWithCommandsForAgentWithClassification(::database::type::RowId agent_name_id,
+                                                                                                                                       ::database::type::Classification classification,
+                                                                                                                                       ::database::type::RowsCount limit,
+                                                                                                                                       ::database::type::RowsCount offset) = 0;
 
   virtual ::bash::database::type::AnomalyDetectionConfigurations GetAnomalyDetectionConfigurations() = 0;
   virtual void RemoveAnomalyDetectionConfiguration(::database::type::RowId id) = 0;
@@ -109,6 +121,18 @@ class DatabaseFunctionsInterface {
                                                           ::database::type::RowId user_id,
                                                           ::database::type::RowId date_id) = 0;
 
+  // Last log of the agent before its first log from date_id after after_log_id,
+  // its last log when there is no such log, after_log_id when there are no logs.
+  virtual ::database::type::RowId GetLastLogIdBeforeDate(::database::type::RowId agent_name_id,
+                                                         ::database::type::RowId after_log_id,
+                                                         ::database::type::RowId date_id) = 0;
+  // Recreates statistics of every user and date with logs in (after_log_id, last_log_id]
+  // and moves the stage watermark to last_log_id in one transaction.
+  virtual void CreateDailyUserStatistics(::database::type::RowId agent_name_id,
+                                         ::database::type::RowId after_log_id,
+                                         ::database::type::RowId last_log_id,
+                                         const std::string &watermark_stage) = 0;
+
   virtual void AddDailyUserStatisticsToConfiguration(::database::type::RowId configuration_id,
                                                      const ::database::type::RowIds &date_range_ids) = 0;
   virtual void RemoveDailyStatisticsFromConfiguration(::database::type::RowId configuration_id) = 0;
@@ -26,6 +26,8 @@ struct Log {
   ::database::type::RowId date_id;
   ::database::type::RowId user_id;
   ::database::type::RowId command_id;
+  // -1 when the command was received as it is named
+  ::database::type::RowId raw_command_id;
 };
 
 }
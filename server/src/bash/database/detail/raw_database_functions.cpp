@@ -6,10 +6,12 @@
 #include "raw_database_functions.h"
 
 #include <boost/log/trivial.hpp>
+#include <vector>
 
 #include "src/database/exception/database_exception.h"
 #include "src/database/exception/detail/item_not_found_exception.h"
 #include "src/database/type/classification.h"
+#include "src/database/general_database_functions.h"
 
 using namespace std;
 
@@ -22,6 +24,37 @@ namespace database
 namespace detail
 {
 
+namespace
+{
+
+// Adds summaries of merged commands to summaries of commands they are
+// merged into, rows with the same key_columns are summed.
+string MergeSummariesSql(const string &table, const vector<string> &key_columns) {
+  string keys, old_keys, same_keys, same_existing_keys;
+  for (const auto &column : key_columns) {
+    keys += column + ", ";
+    old_keys += "O." + column + ", ";
+    same_keys += " and O." + column + "=" + table + "." + column;
+    same_existing_keys += " and E." + column + "=O." + column;
+  }
+
+  return
+      "update " + table + " set SUMMARY=SUMMARY+coalesce(("
+      "    select sum(O.SUMMARY) from " + table + " as O "
+      "      join BASH_MERGED_COMMANDS_TABLE as M on O.COMMAND_ID=M.OLD_ID "
+      "      where M.NEW_ID=" + table + ".COMMAND_ID" + same_keys +
+      "  ), 0) "
+      "  where COMMAND_ID in (select NEW_ID from BASH_MERGED_COMMANDS_TABLE); "
+      "insert into " + table + " (" + keys + "COMMAND_ID, SUMMARY) "
+      "  select " + old_keys + "M.NEW_ID, sum(O.SUMMARY) from " + table + " as O "
+      "    join BASH_MERGED_COMMANDS_TABLE as M on O.COMMAND_ID=M.OLD_ID "
+      "    where not exists (select 1 from " + table + " as E where E.COMMAND_ID=M.NEW_ID" + same_existing_keys + ") "
+      "    group by " + old_keys + "M.NEW_ID; "
+      "delete from " + table + " where COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); ";
+}
+
+}
+
 RawDatabaseFunctionsPtr RawDatabaseFunctions::Create(::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper) {
   return RawDatabaseFunctionsPtr(new RawDatabaseFunctions(sqlite_wrapper));
 }
@@ -35,6 +68,15 @@ void RawDatabaseFunctions::CreateTables() {
                         "  unique (COMMAND) "
                         ");");
 
+  // commands are saved as received only when their names are different
+  sqlite_wrapper_->Exec("create table if not exists BASH_RAW_COMMAND_TABLE ( "
+                        "  ID integer primary key, "
+                        "  COMMAND text, "
+                        "  COMMAND_ID integer, "
+                        "  foreign key(COMMAND_ID) references BASH_COMMAND_TABLE(ID), "
+                        "  unique (COMMAND) "
+                        ");");
+
   sqlite_wrapper_->Exec("create table if not exists BASH_SYSTEM_USER_TABLE ( "
                         "  ID integer primary key, "
                         "  SYSTEM_UID integer, "
@@ -48,15 +90,21 @@ void RawDatabaseFunctions::CreateTables() {
                         "  DATE_ID integer, "
                         "  USER_ID integer, "
                         "  COMMAND_ID integer, "
+                        "  RAW_COMMAND_ID integer, "
                         "  foreign key(AGENT_NAME_ID) references AGENT_NAMES(ID), "
                         "  foreign key(TIME_ID) references TIME_TABLE(ID), "
                         "  foreign key(DATE_ID) references DATE_TABLE(ID), "
                         "  foreign key(USER_ID) references SYSTEM_USER_TABLE(ID) "
                         ");");
 
+  AddColumnIfNotExists("BASH_LOGS_TABLE", "RAW_COMMAND_ID", "integer");
+
   sqlite_wrapper_->Exec("create index if not exists BASH_LOGS_TABLE_AGENT_DATE_COMMAND"
                         " on BASH_LOGS_TABLE (AGENT_NAME_ID, DATE_ID, COMMAND_ID);");
 
+  sqlite_wrapper_->Exec("create index if not exists BASH_LOGS_TABLE_AGENT_USER_DATE"
+                        " on BASH_LOGS_TABLE (AGENT_NAME_ID, USER_ID, DATE_ID);");
+
   sqlite_wrapper_->Exec("create table if not exists BASH_DAILY_STATISTICS_TABLE ("
                         "  ID integer primary key, "
                         "  AGENT_NAME_ID integer, "
@@ -123,6 +171,12 @@ void RawDatabaseFunctions::CreateTables() {
                         "  foreign key(DATE_ID) references DATE_TABLE(ID) "
                         ");");
 
+  sqlite_wrapper_->Exec("create index if not exists BASH_DAILY_USER_STATISTICS_TABLE_AGENT_NAME_ID_CLASSIFICATION"
+                        " on BASH_DAILY_USER_STATISTICS_TABLE (AGENT_NAME_ID, CLASSIFICATION);");
+
+  sqlite_wrapper_->Exec("create index if not exists BASH_DAILY_USER_STATISTICS_TABLE_AGENT_NAME_ID_USER_ID_DATE_ID"
+                        " on BASH_DAILY_USER_STATISTICS_TABLE (AGENT_NAME_ID, USER_ID, DATE_ID);");
+
   sqlite_wrapper_->Exec("create table if not exists BASH_DAILY_USER_COMMAND_STATISTICS_TABLE ("
                         "  ID integer primary key, "
                         "  STATISTIC_ID integer, "
@@ -132,6 +186,9 @@ void RawDatabaseFunctions::CreateTables() {
                         "  foreign key(COMMAND_ID) references BASH_COMMAND_TABLE(ID) "
                         ");");
 
+  sqlite_wrapper_->Exec("create index if not exists BASH_DAILY_USER_COMMAND_STATISTICS_TABLE_STATISTIC_ID_COMMAND_ID"
+                        " on BASH_DAILY_USER_COMMAND_STATISTICS_TABLE (STATISTIC_ID, COMMAND_ID);");
+
   sqlite_wrapper_->Exec("create table if not exists BASH_ANOMALY_DETECTION_CONFIGURATION_SELECTED_STATISTICS_TABLE ("
                         "  ID integer primary key, "
                         "  CONFIGURATION_ID integer, "
@@ -336,6 +393,141 @@ void RawDatabaseFunctions::AddCommand(const ::bash::database::type::CommandName
   return name;
 }
 
+::bash::database::type::Commands RawDatabaseFunctions::GetAllCommands() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetAllCommands: Function call";
+
+  ::bash::database::type::Commands commands;
+
+  const char *sql = "select ID, COMMAND from BASH_COMMAND_TABLE;";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    while (sqlite_wrapper_->Step(statement) == SQLITE_ROW)
+      commands[sqlite_wrapper_->ColumnInt64(statement, 0)] = sqlite_wrapper_->ColumnText(statement, 1);
+  }
+  catch (::database::exception::DatabaseException &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetAllCommands: Exception catched: " << ex.what();
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return commands;
+}
+
+// Logs, statistics and selected commands of merged commands are moved to
+// commands they are merged into, names of merged commands are kept in
+// BASH_RAW_COMMAND_TABLE. Configurations with merged commands are trained
+// again.
+void RawDatabaseFunctions::MergeCommands(const type::CommandsMapping &mapping) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::MergeCommands: Function call";
+
+  string sql =
+      "begin transaction; "
+      "create temp table if not exists BASH_MERGED_COMMANDS_TABLE ( "
+      "  OLD_ID integer primary key, "
+      "  NEW_ID integer "
+      "); "
+      "delete from BASH_MERGED_COMMANDS_TABLE; ";
+
+  for (const auto &m : mapping)
+    sql += "insert into BASH_MERGED_COMMANDS_TABLE (OLD_ID, NEW_ID) values (" + to_string(m.first) + ", " + to_string(m.second) + "); ";
+
+  sql +=
+      "insert or ignore into BASH_RAW_COMMAND_TABLE (COMMAND, COMMAND_ID) "
+      "  select C.COMMAND, M.NEW_ID from BASH_COMMAND_TABLE as C "
+      "    join BASH_MERGED_COMMANDS_TABLE as M on C.ID=M.OLD_ID; "
+      "update BASH_RAW_COMMAND_TABLE set COMMAND_ID=( "
+      "    select M.NEW_ID from BASH_MERGED_COMMANDS_TABLE as M where M.OLD_ID=BASH_RAW_COMMAND_TABLE.COMMAND_ID "
+      "  ) "
+      "  where COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); "
+      "update BASH_LOGS_TABLE set RAW_COMMAND_ID=( "
+      "    select R.ID from BASH_RAW_COMMAND_TABLE as R "
+      "      join BASH_COMMAND_TABLE as C on R.COMMAND=C.COMMAND "
+      "      where C.ID=BASH_LOGS_TABLE.COMMAND_ID "
+      "  ) "
+      "  where RAW_COMMAND_ID is null and COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); "
+      "update BASH_LOGS_TABLE set COMMAND_ID=( "
+      "    select M.NEW_ID from BASH_MERGED_COMMANDS_TABLE as M where M.OLD_ID=BASH_LOGS_TABLE.COMMAND_ID "
+      "  ) "
+      "  where COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); ";
+
+  sql += MergeSummariesSql("BASH_DAILY_STATISTICS_TABLE", {"AGENT_NAME_ID", "DATE_ID"});
+  sql += MergeSummariesSql("BASH_DATE_RANGE_COMMANDS_STATISTICS_TABLE", {"AGENT_NAME_ID", "BEGIN_DATE_ID", "END_DATE_ID"});
+  sql += MergeSummariesSql("BASH_DAILY_USER_COMMAND_STATISTICS_TABLE", {"STATISTIC_ID"});
+
+  sql +=
+      "update BASH_ANOMALY_DETECTION_CONFIGURATION_TABLE set CHANGED=1 "
+      "  where ID in (select CONFIGURATION_ID from BASH_SELECTED_COMMANDS_TABLE "
+      "                 where COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE)); "
+      "insert or ignore into BASH_SELECTED_COMMANDS_TABLE (CONFIGURATION_ID, COMMAND_ID) "
+      "  select S.CONFIGURATION_ID, M.NEW_ID from BASH_SELECTED_COMMANDS_TABLE as S "
+      "    join BASH_MERGED_COMMANDS_TABLE as M on S.COMMAND_ID=M.OLD_ID; "
+      "delete from BASH_SELECTED_COMMANDS_TABLE where COMMAND_ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); "
+      "delete from BASH_COMMAND_TABLE where ID in (select OLD_ID from BASH_MERGED_COMMANDS_TABLE); "
+      "drop table BASH_MERGED_COMMANDS_TABLE; "
+      "end transaction;";
+
+  sqlite_wrapper_->Exec(sql);
+}
+
+void RawDatabaseFunctions::AddRawCommand(const ::bash::database::type::CommandName &raw_command, ::database::type::RowId command_id) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::AddRawCommand: Function call";
+
+  const char *sql =
+      "insert or ignore into BASH_RAW_COMMAND_TABLE ( "
+      "  COMMAND, "
+      "  COMMAND_ID "
+      ") "
+      "values ( ?, ? );";
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindText(statement, 1, raw_command);
+    sqlite_wrapper_->BindInt64(statement, 2, command_id);
+    sqlite_wrapper_->Step(statement);
+  }
+  catch (::database::exception::DatabaseException &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::AddRawCommand: Exception catched: " << ex.what();
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+}
+
+::database::type::RowId RawDatabaseFunctions::GetRawCommandId(const ::bash::database::type::CommandName &raw_command) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetRawCommandId: Function call";
+
+  const char *sql = "select ID from BASH_RAW_COMMAND_TABLE where COMMAND=?;";
+
+  ::database::type::RowId id = -1;
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    sqlite_wrapper_->BindText(statement, 1, raw_command);
+
+    if (sqlite_wrapper_->Step(statement) == SQLITE_ROW)
+      id = sqlite_wrapper_->ColumnInt64(statement, 0);
+  }
+  catch (::database::exception::DatabaseException &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetRawCommandId: Exception catched: " << ex.what();
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return id;
+}
+
 void RawDatabaseFunctions::AddLog(const entity::Log & log) {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::AddLog: Function call";
 
@@ -345,14 +537,16 @@ void RawDatabaseFunctions::AddLog(const entity::Log & log) {
       "  TIME_ID, "
       "  DATE_ID, "
       "  USER_ID, "
-      "  COMMAND_ID "
+      "  COMMAND_ID, "
+      "  RAW_COMMAND_ID "
       ") "
       "values ( " +
       to_string(log.agent_name_id) + ", " +
       to_string(log.time_id) + ", " +
       to_string(log.date_id) + ", " +
       to_string(log.user_id) + ", " +
-      to_string(log.command_id) +
+      to_string(log.command_id) + ", " +
+      ((log.raw_command_id < 0) ? string("null") : to_string(log.raw_command_id)) +
       ");";
 
   sqlite_wrapper_->Exec(sql);
@@ -626,22 +820,7 @@ entity::DailyUserStatistic RawDatabaseFunctions::GetDailyUserStatisticById(const
 void RawDatabaseFunctions::SetDailyUserStatisticsClassification(const ::database::type::RowIds &ids, ::database::type::Classification classification) {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::SetDailyUserStatisticsClassification: Function call";
 
-  string sql =
-      "update BASH_DAILY_USER_STATISTICS_TABLE "
-      " set CLASSIFICATION= " + to_string(static_cast<int> (classification)) +
-      " where ID in (";
-
-  auto end = ids.end();
-  for (auto it = ids.begin(); it != end; ++it) {
-    sql += to_string(*it);
-
-    if (it != end - 1)
-      sql += ", ";
-  }
-
-  sql += ");";
-
-  sqlite_wrapper_->Exec(sql);
+  daily_user_statistics_classification_writer_->Write(ids, classification);
 }
 
 void RawDatabaseFunctions::AddDailyUserCommandStatistic(const ::bash::database::detail::entity::DailyUserCommandStatistic &ucs) {
@@ -801,6 +980,77 @@ void RawDatabaseFunctions::AddDailyUserCommandStatistic(const ::bash::database::
   return statistics;
 }
 
+::bash::database::detail::type::DailyUserStatisticsWithCommands RawDatabaseFunctions::GetDailyUserStatisticsWithCommandsForAgentWithClassification(::database::type::RowId agent_name_id,
+                                                                                                                                                  ::database::type::Classification classification,
+                                                                                                                                                  ::database::type::RowsCount limit,
+                                                                                                                                                  ::database::type::RowsCount offset) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetDailyUserStatisticsWithCommandsForAgentWithClassification: Function call";
+
+  // left join keeps statistics without commands, their command id is null (read as 0)
+  string sql =
+      "select BDUST.ID, BDUST.AGENT_NAME_ID, BDUST.USER_ID, BDUST.DATE_ID, BDUST.CLASSIFICATION, "
+      " BDUCST.ID, BDUCST.COMMAND_ID, BDUCST.SUMMARY "
+      " from (select ID, AGENT_NAME_ID, USER_ID, DATE_ID, CLASSIFICATION "
+      "  from BASH_DAILY_USER_STATISTICS_TABLE "
+      "  where AGENT_NAME_ID=" + to_string(agent_name_id) +
+      "  and CLASSIFICATION=" + to_string(static_cast<int> (classification)) +
+      "  order by ID"
+      "  limit " + to_string(limit) +
+      "  offset " + to_string(offset) +
+      " ) as BDUST "
+      " left join BASH_DAILY_USER_COMMAND_STATISTICS_TABLE as BDUCST "
+      " on BDUCST.STATISTIC_ID=BDUST.ID "
+      " order by BDUST.ID, BDUCST.COMMAND_ID"
+      ";";
+
+  ::bash::database::detail::type::DailyUserStatisticsWithCommands statistics;
+  ::bash::database::detail::entity::DailyUserCommandStatistic command_stat;
+
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    do {
+      auto ret = sqlite_wrapper_->Step(statement);
+
+      if (ret == SQLITE_ROW) {
+        const ::database::type::RowId id = sqlite_wrapper_->ColumnInt64(statement, 0);
+
+        if (statistics.empty() || statistics.back().statistic.id != id) {
+          ::bash::database::detail::type::DailyUserStatisticWithCommands s;
+          s.statistic.id = id;
+          s.statistic.agent_name_id = sqlite_wrapper_->ColumnInt64(statement, 1);
+          s.statistic.user_id = sqlite_wrapper_->ColumnInt64(statement, 2);
+          s.statistic.date_id = sqlite_wrapper_->ColumnInt64(statement, 3);
+          s.statistic.classification = static_cast< ::database::type::Classification> (sqlite_wrapper_->ColumnInt(statement, 4));
+
+          statistics.push_back(s);
+        }
+
+        command_stat.id = sqlite_wrapper_->ColumnInt64(statement, 5);
+        command_stat.daily_user_statistic_id = id;
+        command_stat.command_id = sqlite_wrapper_->ColumnInt64(statement, 6);
+        command_stat.summary = sqlite_wrapper_->ColumnInt64(statement, 7);
+
+        if (command_stat.command_id != 0)
+          statistics.back().commands_statistics.push_back(command_stat);
+      }
+      else
+        break;
+    }
+    while (true);
+  }
+  catch (::database::exception::DatabaseException &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetDailyUserStatisticsWithCommandsForAgentWithClassification: Exception catched: " << ex.what();
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  return statistics;
+}
+
 entity::AnomalyDetectionConfigurations RawDatabaseFunctions::GetAnomalyDetectionConfigurations() {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetAnomalyDetectionConfiguration: Function call";
 
@@ -1252,6 +1502,90 @@ void RawDatabaseFunctions::RemoveAllCommandsFromConfiguration(::database::type::
   return ids;
 }
 
+::database::type::RowId RawDatabaseFunctions::GetLastLogIdBeforeDate(::database::type::RowId agent_name_id,
+                                                                     ::database::type::RowId after_log_id,
+                                                                     ::database::type::RowId date_id) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::GetLastLogIdBeforeDate: Function call";
+
+  string sql = "select coalesce("
+      " (select min(ID) - 1 from BASH_LOGS_TABLE "
+      "   where AGENT_NAME_ID=" + to_string(agent_name_id) +
+      "   and DATE_ID=" + to_string(date_id) +
+      "   and ID>" + to_string(after_log_id) + "), "
+      " (select max(ID) from BASH_LOGS_TABLE "
+      "   where AGENT_NAME_ID=" + to_string(agent_name_id) +
+      "   and ID>" + to_string(after_log_id) + "), " +
+      to_string(after_log_id) +
+      ");";
+
+  return sqlite_wrapper_->GetFirstInt64Column(sql);
+}
+
+// Logs from the range are added to the counts of their days and the
+// watermark is moved in the same transaction, so every log is counted once.
+void RawDatabaseFunctions::CreateDailyUserStatistics(::database::type::RowId agent_name_id,
+                                                     ::database::type::RowId after_log_id,
+                                                     ::database::type::RowId last_log_id,
+                                                     const std::string &watermark_stage) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::CreateDailyUserStatistics: Function call";
+
+  const string agent = to_string(agent_name_id);
+  const string range =
+      " and L.ID>" + to_string(after_log_id) +
+      " and L.ID<=" + to_string(last_log_id);
+  const string days =
+      "(select distinct USER_ID, DATE_ID from BASH_LOGS_TABLE as L "
+      "  where AGENT_NAME_ID=" + agent + range + ") as DAYS ";
+
+  string sql;
+
+  // the first chunk counts all logs again, counts made from whole days
+  // before the watermark existed are removed
+  if (after_log_id == 0)
+    sql += "delete from BASH_DAILY_USER_COMMAND_STATISTICS_TABLE "
+        " where STATISTIC_ID in (select ID from BASH_DAILY_USER_STATISTICS_TABLE where AGENT_NAME_ID=" + agent + "); ";
+
+  sql +=
+      "insert into BASH_DAILY_USER_STATISTICS_TABLE (AGENT_NAME_ID, USER_ID, DATE_ID, CLASSIFICATION) "
+      " select " + agent + ", DAYS.USER_ID, DAYS.DATE_ID, " + to_string(static_cast<int> (::database::type::Classification::UNKNOWN)) +
+      " from " + days +
+      " where not exists (select 1 from BASH_DAILY_USER_STATISTICS_TABLE as S "
+      "   where S.AGENT_NAME_ID=" + agent + " and S.USER_ID=DAYS.USER_ID and S.DATE_ID=DAYS.DATE_ID); "
+
+      "update BASH_DAILY_USER_COMMAND_STATISTICS_TABLE "
+      " set SUMMARY=SUMMARY + (select count(*) from BASH_LOGS_TABLE as L "
+      "   join BASH_DAILY_USER_STATISTICS_TABLE as S on L.USER_ID=S.USER_ID and L.DATE_ID=S.DATE_ID "
+      "   where S.ID=BASH_DAILY_USER_COMMAND_STATISTICS_TABLE.STATISTIC_ID "
+      "   and L.COMMAND_ID=BASH_DAILY_USER_COMMAND_STATISTICS_TABLE.COMMAND_ID "
+      "   and L.AGENT_NAME_ID=" + agent + range + ") "
+      " where STATISTIC_ID in (select S.ID from BASH_DAILY_USER_STATISTICS_TABLE as S "
+      "   join " + days + " on S.USER_ID=DAYS.USER_ID and S.DATE_ID=DAYS.DATE_ID "
+      "   where S.AGENT_NAME_ID=" + agent + "); "
+
+      "insert into BASH_DAILY_USER_COMMAND_STATISTICS_TABLE (STATISTIC_ID, COMMAND_ID, SUMMARY) "
+      " select S.ID, L.COMMAND_ID, count(*) from BASH_LOGS_TABLE as L "
+      " join BASH_DAILY_USER_STATISTICS_TABLE as S on S.AGENT_NAME_ID=L.AGENT_NAME_ID and S.USER_ID=L.USER_ID and S.DATE_ID=L.DATE_ID "
+      " where L.AGENT_NAME_ID=" + agent + range +
+      " and not exists (select 1 from BASH_DAILY_USER_COMMAND_STATISTICS_TABLE as C "
+      "   where C.STATISTIC_ID=S.ID and C.COMMAND_ID=L.COMMAND_ID) "
+      " group by S.ID, L.COMMAND_ID; " +
+
+      ::database::GeneralDatabaseFunctions::GetSetWatermarkSql(watermark_stage, agent_name_id, last_log_id);
+
+  sqlite_wrapper_->BeginTransaction();
+
+  try {
+    sqlite_wrapper_->Exec(sql);
+  }
+  catch (::database::exception::DatabaseException &ex) {
+    BOOST_LOG_TRIVIAL(error) << "bash::database::detail::RawDatabaseFunctions::CreateDailyUserStatistics: Exception catched: " << ex.what();
+    sqlite_wrapper_->RollbackTransaction();
+    throw;
+  }
+
+  sqlite_wrapper_->CommitTransaction();
+}
+
 void RawDatabaseFunctions::AddDailyUserStatisticsToConfiguration(::database::type::RowId configuration_id,
                                                                  const ::database::type::RowIds &date_range_ids) {
   BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::AddDailyUserStatisticsToConfiguration: Function call";
@@ -1653,7 +1987,23 @@ void RawDatabaseFunctions::RemoveDailyStatisticsFromConfiguration(::database::ty
 }
 
 RawDatabaseFunctions::RawDatabaseFunctions(::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper) :
-sqlite_wrapper_(sqlite_wrapper) {
+sqlite_wrapper_(sqlite_wrapper),
+daily_user_statistics_classification_writer_(::database::ClassificationWriter::Create(sqlite_wrapper, "BASH_DAILY_USER_STATISTICS_TABLE")) {
+}
+
+void RawDatabaseFunctions::AddColumnIfNotExists(const std::string &table,
+                                                const std::string &column,
+                                                const std::string &definition) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::database::detail::RawDatabaseFunctions::AddColumnIfNotExists: Function call";
+
+  const string sql =
+      "select count(*) from sqlite_master "
+      " where type='table' and name='" + table + "' and sql like '%" + column + "%';";
+
+  if (sqlite_wrapper_->GetFirstInt64Column(sql) == 0) {
+    BOOST_LOG_TRIVIAL(info) << "bash::database::detail::RawDatabaseFunctions::AddColumnIfNotExists: Adding column " << column << " to " << table;
+    sqlite_wrapper_->Exec("alter table " + table + " add column " + column + " " + definition + ";");
+  }
 }
 
 }
@@ -7,6 +7,7 @@
 
 #include "raw_database_functions_interface.h"
 
+#include "src/database/classification_writer.h"
 #include "src/database/detail/sqlite_wrapper_interface.h"
 
 namespace bash
@@ -38,6 +39,11 @@ class RawDatabaseFunctions : public RawDatabaseFunctionsInterface {
   ::database::type::RowId GetCommandId(const ::bash::database::type::CommandName &command) override;
   ::database::type::RowIds GetAllCommandsIds() override;
   ::bash::database::type::CommandName GetCommandNameById(::database::type::RowId id) override;
+  ::bash::database::type::Commands GetAllCommands() override;
+  void MergeCommands(const type::CommandsMapping &mapping) override;
+
+  void AddRawCommand(const ::bash::database::type::CommandName &raw_command, ::database::type::RowId command_id) override;
+  ::database::type::RowId GetRawCommandId(const ::bash::database::type::CommandName &raw_command) override;
 
   void AddLog(const entity::Log &log) override;
   ::database::type::RowsCount CountCommandsForDailySystemStatistic(::database::type::RowId agent_name_id,
@@ -69,6 +75,10 @@ class RawDatabaseFunctions : public RawDatabaseFunctionsInterface {
                                                                                                          ::database::type::Classification classification,
                                                                                                          ::database::type::RowsCount limit,
                                                                                                          ::database::type::RowsCount offset) override;
+  ::bash::database::detail::type::DailyUserStatisticsWithCommands GetDailyUserStatisticsWithCommandsForAgentWithClassification(::database::type::RowId agent_name_id,
+                                                                                                                               ::database::type::Classification classification,
+                                                                                                                               ::database::type::RowsCount limit,
+                                                                                                                               ::database::type::RowsCount offset) override;
 
   entity::AnomalyDetectionConfigurations GetAnomalyDetectionConfigurations() override;
   void RemoveAnomalyDetectionConfiguration(::database::type::RowId id) override;
@@ -101,6 +111,13 @@ class RawDatabaseFunctions : public RawDatabaseFunctionsInterface {
   ::database::type::RowIds GetCommandsIdsFromLogs(::database::type::RowId agent_name_id,
                                                   ::database::type::RowId user_id,
                                                   ::database::type::RowId date_id) override;
+  ::database::type::RowId GetLastLogIdBeforeDate(::database::type::RowId agent_name_id,
+                                                 ::database::type::RowId after_log_id,
+                                                 ::database::type::RowId date_id) override;
+  void CreateDailyUserStatistics(::database::type::RowId agent_name_id,
+                                 ::database::type::RowId after_log_id,
+                                 ::database::type::RowId last_log_id,
+                                 const std::string &watermark_stage) override;
 
   void AddDailyUserStatisticsToConfiguration(::database::type::RowId configuration_id,
                                              const ::database::type::RowIds &date_range_ids) override;
@@ -126,8 +143,13 @@ class RawDatabaseFunctions : public RawDatabaseFunctionsInterface {
 
  private:
   ::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper_;
+  ::database::ClassificationWriterPtr daily_user_statistics_classification_writer_;
 
   RawDatabaseFunctions(::database::detail::SQLiteWrapperInterfacePtr sqlite_wrapper);
+
+  void AddColumnIfNotExists(const std::string &table,
+                            const std::string &column,
+                            const std::string &definition);
 };
 
 }
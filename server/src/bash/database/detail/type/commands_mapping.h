@@ -0,0 +1,33 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/database/type/row_id.h"
+
+#include <map>
+
+namespace bash
+{
+
+namespace database
+{
+
+namespace detail
+{
+
+namespace type
+{
+
+// ids of merged commands to ids of commands they are merged into
+typedef std::map<::database::type::RowId, ::database::type::RowId> CommandsMapping;
+
+}
+
+}
+
+}
+
+}
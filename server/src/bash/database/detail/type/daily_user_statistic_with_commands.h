@@ -0,0 +1,38 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/bash/database/detail/entity/daily_user_statistic.h"
+#include "src/bash/database/detail/entity/daily_user_command_statistic.h"
+
+#include <vector>
+
+namespace bash
+{
+
+namespace database
+{
+
+namespace detail
+{
+
+namespace type
+{
+
+struct DailyUserStatisticWithCommands {
+  ::bash::database::detail::entity::DailyUserStatistic statistic;
+  ::bash::database::detail::entity::DailyUserCommandsStatistics commands_statistics;
+};
+
+typedef std::vector<DailyUserStatisticWithCommands> DailyUserStatisticsWithCommands;
+
+}
+
+}
+
+}
+
+}
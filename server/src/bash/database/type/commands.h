@@ -0,0 +1,28 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <map>
+
+#include "command_name.h"
+#include "src/database/type/row_id.h"
+
+namespace bash
+{
+
+namespace database
+{
+
+namespace type
+{
+
+typedef std::map<::database::type::RowId, CommandName> Commands;
+
+}
+
+}
+
+}
@@ -1,5 +1,6 @@
 #include "bash.h"
 #include "src/bash/domain/scripts.h"
+#include "src/bash/analyzer/bash_analyzer_object.h"
 
 #include <boost/log/trivial.hpp>
 
@@ -12,8 +13,10 @@ namespace dbus
 namespace object
 {
 
-Bash::Bash(::bash::domain::detail::ScriptsInterfacePtr scripts) :
-scripts_(scripts) {
+Bash::Bash(::bash::domain::detail::ScriptsInterfacePtr scripts,
+           ::analyzer::detail::AnalyzerInterfacePtr analyzer) :
+scripts_(scripts),
+analyzer_(analyzer) {
 }
 
 Bash::~Bash() {
@@ -92,6 +95,7 @@ DBusHandlerResult Bash::OwnMessageHandler(DBusConnection *connection, DBusMessag
     log_entry.command = command;
 
     scripts_->AddLog(log_entry);
+    analyzer_->AddData(::bash::analyzer::BashAnalyzerObject::NAME, 1);
 
     DBusMessage *reply_msg = dbus_message_new_method_return(message);
     BOOST_LOG_TRIVIAL(debug) << "objects::Bash::OwnMessageHandler: Sending reply";
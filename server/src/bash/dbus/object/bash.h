@@ -7,6 +7,7 @@
 #include <slas/type/bash_log_entry.h>
 
 #include "src/bash/domain/detail/scripts_interface.h"
+#include "src/analyzer/detail/analyzer_interface.h"
 
 namespace bash
 {
@@ -19,7 +20,8 @@ namespace object
 
 class Bash : public ::dbus::Object {
  public:
-  Bash(::bash::domain::detail::ScriptsInterfacePtr scripts);
+  Bash(::bash::domain::detail::ScriptsInterfacePtr scripts,
+       ::analyzer::detail::AnalyzerInterfacePtr analyzer);
   virtual ~Bash();
 
   const char* GetPath();
@@ -30,6 +32,7 @@ class Bash : public ::dbus::Object {
   DBusHandlerResult OwnMessageHandler(DBusConnection *connection, DBusMessage *message);
 
   ::bash::domain::detail::ScriptsInterfacePtr scripts_;
+  ::analyzer::detail::AnalyzerInterfacePtr analyzer_;
 };
 
 typedef std::shared_ptr<Bash> BashPtr;
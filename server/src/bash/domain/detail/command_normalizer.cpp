@@ -0,0 +1,168 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "command_normalizer.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cctype>
+
+#include "src/bash/domain/exception/detail/wrong_command_rule.h"
+
+namespace bash
+{
+
+namespace domain
+{
+
+namespace detail
+{
+
+const ::bash::database::type::CommandName CommandNormalizer::OTHER_COMMAND = "<other>";
+constexpr unsigned CommandNormalizer::MIN_GENERATED_DIGITS;
+constexpr std::size_t CommandNormalizer::MAX_NAME_LENGTH;
+
+CommandNormalizerPtr CommandNormalizer::Create(const CommandRules &rules, std::size_t max_commands) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::domain::detail::CommandNormalizer::Create: Function call";
+
+  return CommandNormalizerPtr(new CommandNormalizer(rules, max_commands));
+}
+
+::bash::database::type::CommandName CommandNormalizer::Normalize(const std::string &command) {
+  const auto name = GetName(command);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (vocabulary_.count(name) == 0) {
+    if (vocabulary_.size() >= max_commands_)
+      return OTHER_COMMAND;
+
+    vocabulary_.insert(name);
+  }
+
+  return name;
+}
+
+std::size_t CommandNormalizer::GetVocabularySize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  return vocabulary_.size();
+}
+
+CommandRules CommandNormalizer::ParseRules(const std::string &rules) {
+  BOOST_LOG_TRIVIAL(debug) << "bash::domain::detail::CommandNormalizer::ParseRules: Function call";
+
+  CommandRules parsed;
+  std::size_t begin = 0;
+
+  while (begin < rules.size()) {
+    auto end = rules.find(',', begin);
+    if (end == std::string::npos)
+      end = rules.size();
+
+    const std::string rule = rules.substr(begin, end - begin);
+    const auto separator = rule.find('=');
+
+    if (separator == std::string::npos || separator == 0 || separator + 1 == rule.size()) {
+      BOOST_LOG_TRIVIAL(error) << "bash::domain::detail::CommandNormalizer::ParseRules: Wrong rule: " << rule;
+      throw exception::detail::WrongCommandRule();
+    }
+
+    parsed.push_back({rule.substr(0, separator), rule.substr(separator + 1)});
+    begin = end + 1;
+  }
+
+  return parsed;
+}
+
+bool CommandNormalizer::Match(const std::string &pattern, const std::string &text) {
+  std::size_t p = 0, t = 0;
+  std::size_t star = std::string::npos, star_text = 0;
+
+  // on mismatch the last '*' takes one more character
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      ++p;
+      ++t;
+    }
+    else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_text = t;
+    }
+    else if (star != std::string::npos) {
+      p = star + 1;
+      t = ++star_text;
+    }
+    else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+
+  return p == pattern.size();
+}
+
+CommandNormalizer::CommandNormalizer(const CommandRules &rules, std::size_t max_commands) :
+rules_(rules),
+max_commands_(max_commands) {
+  vocabulary_.insert(OTHER_COMMAND);
+}
+
+::bash::database::type::CommandName CommandNormalizer::GetName(const std::string &command) const {
+  const auto rule_name = FindRule(command);
+  if (rule_name)
+    return *rule_name;
+
+  const auto slash = command.find_last_of('/');
+  const std::string base_name = (slash == std::string::npos || slash + 1 == command.size()) ? command : command.substr(slash + 1);
+
+  ::bash::database::type::CommandName name;
+  name.reserve(base_name.size());
+
+  for (std::size_t i = 0; i < base_name.size() && name.size() < MAX_NAME_LENGTH;) {
+    std::size_t digits = 0;
+    while (i + digits < base_name.size() && std::isdigit(static_cast<unsigned char> (base_name[i + digits])))
+      ++digits;
+
+    if (digits >= MIN_GENERATED_DIGITS) {
+      name += '#';
+      i += digits;
+    }
+    else if (digits > 0) {
+      name.append(base_name, i, digits);
+      i += digits;
+    }
+    else {
+      name += base_name[i++];
+    }
+  }
+
+  name.resize(std::min(name.size(), MAX_NAME_LENGTH));
+
+  if (name != command) {
+    const auto name_rule_name = FindRule(name);
+    if (name_rule_name)
+      return *name_rule_name;
+  }
+
+  return name;
+}
+
+const ::bash::database::type::CommandName* CommandNormalizer::FindRule(const std::string &command) const {
+  for (const auto &rule : rules_) {
+    if (Match(rule.pattern, command))
+      return &rule.name;
+  }
+
+  return nullptr;
+}
+
+}
+
+}
+
+}
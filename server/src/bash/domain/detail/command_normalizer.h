@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "src/bash/database/type/command_name.h"
+
+namespace bash
+{
+
+namespace domain
+{
+
+namespace detail
+{
+
+// '*' in a pattern matches any characters, '?' matches one character.
+struct CommandRule {
+  std::string pattern;
+  ::bash::database::type::CommandName name;
+};
+
+typedef std::vector<CommandRule> CommandRules;
+
+class CommandNormalizer;
+typedef std::shared_ptr<CommandNormalizer> CommandNormalizerPtr;
+
+// Maps commands sent by agents to a bounded vocabulary. A command matching
+// a rule gets the name of the first such rule. Otherwise the path is
+// removed and runs of at least MIN_GENERATED_DIGITS digits are replaced by
+// '#': /bin/ls and ./ls become ls, ./deploy-1234.sh becomes deploy-#.sh;
+// rules are checked again with the new name. After max_commands different
+// names every new name becomes OTHER_COMMAND.
+class CommandNormalizer {
+ public:
+  virtual ~CommandNormalizer() = default;
+
+  static CommandNormalizerPtr Create(const CommandRules &rules, std::size_t max_commands);
+
+  ::bash::database::type::CommandName Normalize(const std::string &command);
+
+  std::size_t GetVocabularySize();
+
+  // "pattern=name,pattern=name,...", throws WrongCommandRule
+  static CommandRules ParseRules(const std::string &rules);
+
+  static bool Match(const std::string &pattern, const std::string &text);
+
+  static const ::bash::database::type::CommandName OTHER_COMMAND;
+  static constexpr unsigned MIN_GENERATED_DIGITS = 4;
+  static constexpr std::size_t MAX_NAME_LENGTH = 64;
+
+ private:
+  CommandNormalizer(const CommandRules &rules, std::size_t max_commands);
+
+  ::bash::database::type::CommandName GetName(const std::string &command) const;
+  const ::bash::database::type::CommandName* FindRule(const std::string &command) const;
+
+  const CommandRules rules_;
+  const std::size_t max_commands_;
+
+  std::unordered_set<::bash::database::type::CommandName> vocabulary_;
+  std::mutex mutex_;
+};
+
+}
+
+}
+
+}
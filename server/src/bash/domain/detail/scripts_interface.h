@@ -31,6 +31,7 @@ class ScriptsInterface {
   virtual ~ScriptsInterface() = default;
 
   virtual void AddLog(const ::type::BashLogEntry &log_entry) = 0;
+  virtual void NormalizeCommands() = 0;
 
   virtual void CreateDailySystemStatistics() = 0;
 
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/bash/domain/exception/domain_exception.h"
+
+namespace bash
+{
+
+namespace domain
+{
+
+namespace exception
+{
+
+namespace detail
+{
+
+class WrongCommandRule : public DomainException {
+ public:
+  virtual ~WrongCommandRule() = default;
+
+  char const* what() const throw () {
+    return "Wrong command rule, expected pattern=name.";
+  }
+};
+
+}
+
+}
+
+}
+
+}
@@ -20,8 +20,10 @@ namespace domain
 {
 
 ScriptsPtr Scripts::Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
-                           ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions) {
-  return ScriptsPtr(new Scripts(database_functions, general_database_functions));
+                           ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                           ::bash::analyzer::CommandSequenceModelPtr command_sequence_model,
+                           detail::CommandNormalizerPtr command_normalizer) {
+  return ScriptsPtr(new Scripts(database_functions, general_database_functions, command_sequence_model, command_normalizer));
 }
 
 void Scripts::AddLog(const ::type::BashLogEntry &log_entry) {
@@ -39,13 +41,41 @@ void Scripts::AddLog(const ::type::BashLogEntry &log_entry) {
     BOOST_LOG_TRIVIAL(warning) << "bash::domain::Scripts::AddLog: Command field is empty, not added!";
   }
   else {
+    ::type::BashLogEntry normalized_log_entry = log_entry;
+    normalized_log_entry.command = command_normalizer_->Normalize(command);
+
     general_database_functions_->AddDate(log_entry.utc_time.GetDate());
     general_database_functions_->AddTime(log_entry.utc_time.GetTime());
     general_database_functions_->AddAgentName(log_entry.agent_name);
     database_functions_->AddSystemUser(log_entry.user_id);
-    database_functions_->AddCommand(command);
+    database_functions_->AddCommand(normalized_log_entry.command);
+    if (command != normalized_log_entry.command)
+      database_functions_->AddRawCommand(command, normalized_log_entry.command);
+
+    database_functions_->AddLog(normalized_log_entry, command);
+
+    command_sequence_model_->AddCommand(log_entry.agent_name, log_entry.user_id, log_entry.utc_time,
+                                        database_functions_->GetCommandId(normalized_log_entry.command),
+                                        normalized_log_entry.command);
+  }
+}
+
+void Scripts::NormalizeCommands() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::domain::Scripts::NormalizeCommands: Function call";
+
+  // commands are normalized in order of ids, so older commands stay in a
+  // full vocabulary
+  ::bash::database::type::Commands merged_commands;
+  for (const auto &command : database_functions_->GetAllCommands()) {
+    const auto name = command_normalizer_->Normalize(command.second);
+
+    if (name != command.second)
+      merged_commands[command.first] = name;
+  }
 
-    database_functions_->AddLog(log_entry);
+  if (!merged_commands.empty()) {
+    BOOST_LOG_TRIVIAL(info) << "bash::domain::Scripts::NormalizeCommands: Merging " << merged_commands.size() << " commands";
+    database_functions_->MergeCommands(merged_commands);
   }
 }
 
@@ -440,9 +470,13 @@ void Scripts::SelectDefaultCommands(::database::type::RowId configuration_id) {
 }
 
 Scripts::Scripts(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
-                 ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions) :
+                 ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                 ::bash::analyzer::CommandSequenceModelPtr command_sequence_model,
+                 detail::CommandNormalizerPtr command_normalizer) :
 database_functions_(database_functions),
-general_database_functions_(general_database_functions) {
+general_database_functions_(general_database_functions),
+command_sequence_model_(command_sequence_model),
+command_normalizer_(command_normalizer) {
 }
 
 }
@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include "detail/command_normalizer.h"
 #include "detail/scripts_interface.h"
+#include "src/bash/analyzer/command_sequence_model.h"
 #include "src/bash/database/detail/database_functions_interface.h"
 #include "src/database/detail/general_database_functions_interface.h"
 
@@ -23,9 +25,12 @@ class Scripts : public detail::ScriptsInterface {
   virtual ~Scripts() = default;
 
   static ScriptsPtr Create(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
-                           ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions);
+                           ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+                           ::bash::analyzer::CommandSequenceModelPtr command_sequence_model,
+                           detail::CommandNormalizerPtr command_normalizer);
 
   void AddLog(const ::type::BashLogEntry &log_entry) override;
+  void NormalizeCommands() override;
 
   void CreateDailySystemStatistics() override;
 
@@ -76,9 +81,13 @@ class Scripts : public detail::ScriptsInterface {
  private:
   ::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions_;
   ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions_;
+  ::bash::analyzer::CommandSequenceModelPtr command_sequence_model_;
+  detail::CommandNormalizerPtr command_normalizer_;
 
   Scripts(::bash::database::detail::DatabaseFunctionsInterfacePtr database_functions,
-          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions);
+          ::database::detail::GeneralDatabaseFunctionsInterfacePtr general_database_functions,
+          ::bash::analyzer::CommandSequenceModelPtr command_sequence_model,
+          detail::CommandNormalizerPtr command_normalizer);
 };
 
 }
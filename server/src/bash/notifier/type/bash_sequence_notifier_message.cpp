@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "bash_sequence_notifier_message.h"
+
+#include <boost/log/trivial.hpp>
+
+using namespace std;
+
+namespace bash
+{
+
+namespace notifier
+{
+
+namespace type
+{
+
+BashSequenceNotifierMessagePtr BashSequenceNotifierMessage::Create(::bash::analyzer::type::SequenceAlerts alerts) {
+  return BashSequenceNotifierMessagePtr(new BashSequenceNotifierMessage(alerts));
+}
+
+std::string BashSequenceNotifierMessage::GetModuleName() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::notifier::BashSequenceNotifierMessage::GetModuleName: Function call";
+  return "Bash Command Sequences";
+}
+
+std::string BashSequenceNotifierMessage::GetDetectionResults() {
+  BOOST_LOG_TRIVIAL(debug) << "bash::notifier::BashSequenceNotifierMessage::GetDetectionResults: Function call";
+
+  std::string results = "Users running unusual sequences of commands found while receiving logs, they will be "
+      "classified with the next daily statistics analysis.\r\n\r\n";
+
+  for (const auto &a : alerts_) {
+    results += "    ...........................................................................\r\n";
+    results += "    Agent:                   " + a.agent_name + "\r\n";
+    results += "    User ID:                 " + to_string(a.user_id) + "\r\n";
+    results += "    Time:                    " + a.time.ToString() + "\r\n";
+    results += "    Command:                 " + a.command + "\r\n";
+    results += "    Commands count:          " + to_string(a.commands_count) + "\r\n";
+    results += "    Surprise (bits):         " + to_string(a.surprise) + "\r\n";
+    results += "    Average surprise (bits): " + to_string(a.average_surprise) + "\r\n";
+    results += "    ...........................................................................\r\n";
+
+    results += "\r\n";
+  }
+
+  return results;
+}
+
+BashSequenceNotifierMessage::BashSequenceNotifierMessage(::bash::analyzer::type::SequenceAlerts alerts) :
+alerts_(alerts) {
+}
+
+}
+
+}
+
+}
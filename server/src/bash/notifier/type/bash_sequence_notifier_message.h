@@ -0,0 +1,42 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/notifier/type/notifier_message_interface.h"
+#include "src/bash/analyzer/type/sequence_alert.h"
+
+namespace bash
+{
+
+namespace notifier
+{
+
+namespace type
+{
+
+class BashSequenceNotifierMessage;
+typedef std::shared_ptr<BashSequenceNotifierMessage> BashSequenceNotifierMessagePtr;
+
+class BashSequenceNotifierMessage : public ::notifier::type::NotifierMessageInterface {
+ public:
+  virtual ~BashSequenceNotifierMessage() = default;
+
+  static BashSequenceNotifierMessagePtr Create(::bash::analyzer::type::SequenceAlerts alerts);
+
+  std::string GetModuleName();
+  std::string GetDetectionResults();
+
+ private:
+  explicit BashSequenceNotifierMessage(::bash::analyzer::type::SequenceAlerts alerts);
+
+  const ::bash::analyzer::type::SequenceAlerts alerts_;
+};
+
+}
+
+}
+
+}
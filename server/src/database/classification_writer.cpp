@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "classification_writer.h"
+
+#include <chrono>
+#include <boost/log/trivial.hpp>
+#include <slas/util/run_partially.h>
+
+#include "src/database/exception/database_exception.h"
+
+namespace database
+{
+
+constexpr type::RowsCount ClassificationWriter::MAX_ROWS_IN_TRANSACTION;
+
+ClassificationWriterPtr ClassificationWriter::Create(detail::SQLiteWrapperInterfacePtr sqlite_wrapper,
+                                                     const std::string &table_name) {
+  BOOST_LOG_TRIVIAL(debug) << "database::ClassificationWriter::Create: Function call";
+
+  return ClassificationWriterPtr(new ClassificationWriter(sqlite_wrapper, table_name));
+}
+
+void ClassificationWriter::Write(const type::RowIds &ids, type::Classification classification) {
+  BOOST_LOG_TRIVIAL(debug) << "database::ClassificationWriter::Write: Function call";
+
+  if (ids.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto begin = std::chrono::steady_clock::now();
+
+  const std::string sql = "update " + table_name_ + " set CLASSIFICATION=? where ID=?;";
+  sqlite3_stmt *statement = nullptr;
+  sqlite_wrapper_->Prepare(sql, &statement);
+
+  try {
+    util::RunPartially(MAX_ROWS_IN_TRANSACTION, ids.size(), [&](long long part_count, long long offset) {
+      WritePart(statement, ids, offset, part_count, classification);
+    });
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->Finalize(statement);
+    throw;
+  }
+
+  sqlite_wrapper_->Finalize(statement);
+
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+  updated_rows_count_ += ids.size();
+  update_seconds_ += elapsed.count();
+
+  BOOST_LOG_TRIVIAL(info) << "database::ClassificationWriter::Write: Updated " << ids.size() << " rows in " << table_name_
+      << " (" << ids.size() / elapsed.count() << " rows/s, " << updated_rows_count_ << " rows total)";
+}
+
+type::RowsCount ClassificationWriter::GetUpdatedRowsCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return updated_rows_count_;
+}
+
+double ClassificationWriter::GetRowsPerSecond() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (update_seconds_ <= 0)
+    return 0;
+
+  return updated_rows_count_ / update_seconds_;
+}
+
+ClassificationWriter::ClassificationWriter(detail::SQLiteWrapperInterfacePtr sqlite_wrapper,
+                                           const std::string &table_name) :
+sqlite_wrapper_(sqlite_wrapper),
+table_name_(table_name),
+updated_rows_count_(0),
+update_seconds_(0) {
+}
+
+void ClassificationWriter::WritePart(sqlite3_stmt *statement, const type::RowIds &ids,
+                                     type::RowsCount offset, type::RowsCount count,
+                                     type::Classification classification) {
+  BOOST_LOG_TRIVIAL(debug) << "database::ClassificationWriter::WritePart: Updating " << count << " rows (offset=" << offset << ")";
+
+  sqlite_wrapper_->BeginTransaction();
+
+  try {
+    for (auto i = offset; i < offset + count; ++i) {
+      sqlite_wrapper_->BindInt(statement, 1, static_cast<int> (classification));
+      sqlite_wrapper_->BindInt64(statement, 2, ids[i]);
+      sqlite_wrapper_->Step(statement);
+      sqlite_wrapper_->Reset(statement);
+    }
+  }
+  catch (exception::DatabaseException &ex) {
+    sqlite_wrapper_->RollbackTransaction();
+    throw;
+  }
+
+  sqlite_wrapper_->CommitTransaction();
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "detail/sqlite_wrapper_interface.h"
+#include "type/classification.h"
+#include "type/row_id.h"
+#include "type/rows_count.h"
+
+namespace database
+{
+
+class ClassificationWriter;
+typedef std::shared_ptr<ClassificationWriter> ClassificationWriterPtr;
+
+// Sets CLASSIFICATION column of rows with given ids. One prepared statement
+// is executed for all rows, every MAX_ROWS_IN_TRANSACTION rows are committed
+// in a separate transaction.
+//
+// The writer uses the shared connection. Apache sessions are written by the
+// analyzer tasks (through DatabaseWriter), bash daily statistics by the bash
+// analyzer thread and the dbus thread (Scripts). Write calls are serialized
+// and every transaction holds the connection, so statements of other threads
+// are executed between parts, never inside of them.
+class ClassificationWriter {
+ public:
+  static constexpr type::RowsCount MAX_ROWS_IN_TRANSACTION = 1000;
+
+  virtual ~ClassificationWriter() = default;
+
+  static ClassificationWriterPtr Create(detail::SQLiteWrapperInterfacePtr sqlite_wrapper,
+                                        const std::string &table_name);
+
+  void Write(const type::RowIds &ids, type::Classification classification);
+
+  // Totals since the writer was created.
+  type::RowsCount GetUpdatedRowsCount() const;
+  double GetRowsPerSecond() const;
+
+ private:
+  ClassificationWriter(detail::SQLiteWrapperInterfacePtr sqlite_wrapper,
+                       const std::string &table_name);
+
+  void WritePart(sqlite3_stmt *statement, const type::RowIds &ids,
+                 type::RowsCount offset, type::RowsCount count,
+                 type::Classification classification);
+
+  detail::SQLiteWrapperInterfacePtr sqlite_wrapper_;
+  const std::string table_name_;
+
+  type::RowsCount updated_rows_count_;
+  double update_seconds_;
+  mutable std::mutex mutex_;
+};
+
+}
@@ -341,13 +341,22 @@ void Database::SetApacheAnomalyDetectionConfiguration(const ::apache::type::Anom
   }
 
   string sql =
-      "insert or replace into APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE (ID, AGENT_NAME, VIRTUALHOST_NAME, BEGIN_DATE_ID, END_DATE_ID) "
+      "insert or replace into APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE (ID, AGENT_NAME, VIRTUALHOST_NAME, BEGIN_DATE_ID, END_DATE_ID, KNN_MODE, HNSW_M, HNSW_EF, KNN_NEIGHBOURS, KNN_VOTING, REALTIME_SCORING, REALTIME_THRESHOLD, REALTIME_MIN_REQUESTS) "
       "values ("
       "  ( select ID from  APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=? and VIRTUALHOST_NAME=? ), "
       "  ?, "
       "  ?, "
       "  ( select ID from DATE_TABLE where DAY=" + to_string(configuration.begin_date.GetDay()) + " and MONTH=" + to_string(configuration.begin_date.GetMonth()) + " and YEAR=" + to_string(configuration.begin_date.GetYear()) + " ),"
-      "  ( select ID from DATE_TABLE where DAY=" + to_string(configuration.end_date.GetDay()) + " and MONTH=" + to_string(configuration.end_date.GetMonth()) + " and YEAR=" + to_string(configuration.end_date.GetYear()) + " )"
+      "  ( select ID from DATE_TABLE where DAY=" + to_string(configuration.end_date.GetDay()) + " and MONTH=" + to_string(configuration.end_date.GetMonth()) + " and YEAR=" + to_string(configuration.end_date.GetYear()) + " ),"
+      // replace removes the old row, KNN and realtime scoring settings are copied from it
+      "  ifnull(( select KNN_MODE from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 0),"
+      "  ifnull(( select HNSW_M from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 16),"
+      "  ifnull(( select HNSW_EF from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 64),"
+      "  ifnull(( select KNN_NEIGHBOURS from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 3),"
+      "  ifnull(( select KNN_VOTING from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 0),"
+      "  ifnull(( select REALTIME_SCORING from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 0),"
+      "  ifnull(( select REALTIME_THRESHOLD from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 4),"
+      "  ifnull(( select REALTIME_MIN_REQUESTS from APACHE_ANOMALY_DETECTION_CONFIGURATION_TABLE where AGENT_NAME=?1 and VIRTUALHOST_NAME=?2 ), 20)"
       ");";
 
   sqlite3_stmt *statement;
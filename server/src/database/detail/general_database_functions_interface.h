@@ -6,6 +6,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <slas/type/time.h>
 #include <slas/type/date.h>
@@ -42,6 +43,10 @@ class GeneralDatabaseFunctionsInterface {
   virtual ::database::type::RowId AddAndGetAgentNameId(const std::string &name) = 0;
   virtual ::database::type::RowId GetAgentNameId(const std::string &name) = 0;
   virtual std::string GetAgentNameById(const ::database::type::RowId &id) = 0;
+
+  // last row or date processed by an analyzer stage for an agent, 0 when not set
+  virtual ::database::type::RowId GetWatermark(const std::string &stage, ::database::type::RowId agent_name_id) = 0;
+  virtual void SetWatermark(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark) = 0;
 };
 
 typedef std::shared_ptr<GeneralDatabaseFunctionsInterface> GeneralDatabaseFunctionsInterfacePtr;
@@ -39,11 +39,21 @@ int SQLite::BindText(sqlite3_stmt *pStmt, int pos, const char *value, int num, v
   return sqlite3_bind_text(pStmt, pos, value, num, destructor);
 }
 
+int SQLite::BindBlob(sqlite3_stmt *pStmt, int pos, const void *value, int num, void (*destructor) (void*)) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::BindBlob: Function call";
+  return sqlite3_bind_blob(pStmt, pos, value, num, destructor);
+}
+
 int SQLite::Step(sqlite3_stmt *pStmt) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLite::Step: Function call";
   return sqlite3_step(pStmt);
 }
 
+int SQLite::Reset(sqlite3_stmt *pStmt) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::Reset: Function call";
+  return sqlite3_reset(pStmt);
+}
+
 double SQLite::ColumnDouble(sqlite3_stmt *pStmt, int iCol) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLite::ColumnDouble: Function call";
   return sqlite3_column_double(pStmt, iCol);
@@ -64,6 +74,16 @@ const unsigned char* SQLite::ColumnText(sqlite3_stmt *pStmt, int iCol) {
   return sqlite3_column_text(pStmt, iCol);
 }
 
+const void* SQLite::ColumnBlob(sqlite3_stmt *pStmt, int iCol) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::ColumnBlob: Function call";
+  return sqlite3_column_blob(pStmt, iCol);
+}
+
+int SQLite::ColumnBytes(sqlite3_stmt *pStmt, int iCol) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::ColumnBytes: Function call";
+  return sqlite3_column_bytes(pStmt, iCol);
+}
+
 int SQLite::Finalize(sqlite3_stmt *pStmt) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLite::Finalize: Function call";
   return sqlite3_finalize(pStmt);
@@ -79,6 +99,16 @@ int SQLite::Exec(sqlite3 *pDb, const char *sql, int (*callback) (void *, int, ch
   return sqlite3_exec(pDb, sql, callback, arg, errmsg);
 }
 
+int SQLite::TotalChanges(sqlite3 *pDb) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::TotalChanges: Function call";
+  return sqlite3_total_changes(pDb);
+}
+
+int SQLite::GetAutocommit(sqlite3 *pDb) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLite::GetAutocommit: Function call";
+  return sqlite3_get_autocommit(pDb);
+}
+
 }
 
 }
@@ -22,8 +22,10 @@ class SQLite : public SQLiteInterface {
   int BindInt64(sqlite3_stmt *pStmt, int pos, sqlite3_int64 value) override;
 
   int BindText(sqlite3_stmt *pStmt, int pos, const char *value, int num, void (*destructor) (void*)) override;
+  int BindBlob(sqlite3_stmt *pStmt, int pos, const void *value, int num, void (*destructor) (void*)) override;
 
   int Step(sqlite3_stmt *pStmt) override;
+  int Reset(sqlite3_stmt *pStmt) override;
 
   double ColumnDouble(sqlite3_stmt *pStmt, int iCol) override;
 
@@ -32,12 +34,18 @@ class SQLite : public SQLiteInterface {
   sqlite3_int64 ColumnInt64(sqlite3_stmt *pStmt, int iCol) override;
 
   const unsigned char* ColumnText(sqlite3_stmt *pStmt, int iCol) override;
+  const void* ColumnBlob(sqlite3_stmt *pStmt, int iCol) override;
+  int ColumnBytes(sqlite3_stmt *pStmt, int iCol) override;
 
   int Finalize(sqlite3_stmt *pStmt) override;
 
   int Close(sqlite3 *pDb) override;
 
   int Exec(sqlite3 *pDb, const char *sql, int (*callback) (void *, int, char **, char **), void *arg, char **errmsg) override;
+
+  int TotalChanges(sqlite3 *pDb) override;
+
+  int GetAutocommit(sqlite3 *pDb) override;
 };
 
 }
@@ -26,8 +26,12 @@ class SQLiteInterface {
 
   virtual int BindText(sqlite3_stmt *pStmt, int pos, const char *value, int num, void (*destructor) (void*)) = 0;
 
+  virtual int BindBlob(sqlite3_stmt *pStmt, int pos, const void *value, int num, void (*destructor) (void*)) = 0;
+
   virtual int Step(sqlite3_stmt *pStmt) = 0;
 
+  virtual int Reset(sqlite3_stmt *pStmt) = 0;
+
   virtual double ColumnDouble(sqlite3_stmt *pStmt, int iCol) = 0;
 
   virtual int ColumnInt(sqlite3_stmt *pStmt, int iCol) = 0;
@@ -36,11 +40,19 @@ class SQLiteInterface {
 
   virtual const unsigned char* ColumnText(sqlite3_stmt *pStmt, int iCol) = 0;
 
+  virtual const void* ColumnBlob(sqlite3_stmt *pStmt, int iCol) = 0;
+
+  virtual int ColumnBytes(sqlite3_stmt *pStmt, int iCol) = 0;
+
   virtual int Finalize(sqlite3_stmt *pStmt) = 0;
 
   virtual int Close(sqlite3 *pDb) = 0;
 
   virtual int Exec(sqlite3 *pDb, const char *sql, int (*callback) (void *, int, char **, char **), void *arg, char **errmsg) = 0;
+
+  virtual int TotalChanges(sqlite3 *pDb) = 0;
+
+  virtual int GetAutocommit(sqlite3 *pDb) = 0;
 };
 
 SQLiteInterface::~SQLiteInterface() {
@@ -29,19 +29,26 @@ class SQLiteWrapperInterface {
   virtual void BindInt(sqlite3_stmt *pStmt, int pos, int value) = 0;
   virtual void BindInt64(sqlite3_stmt *pStmt, int pos, sqlite3_int64 value) = 0;
   virtual void BindText(sqlite3_stmt *pStmt, int pos, const std::string &value) = 0;
+  virtual void BindBlob(sqlite3_stmt *pStmt, int pos, const std::string &value) = 0;
 
   virtual double ColumnDouble(sqlite3_stmt *pStmt, int iCol) = 0;
   virtual int ColumnInt(sqlite3_stmt *pStmt, int iCol) = 0;
   virtual sqlite3_int64 ColumnInt64(sqlite3_stmt *pStmt, int iCol) = 0;
   virtual const std::string ColumnText(sqlite3_stmt *pStmt, int iCol) = 0;
+  virtual const std::string ColumnBlob(sqlite3_stmt *pStmt, int iCol) = 0;
 
   virtual int Step(sqlite3_stmt *pStmt) = 0;
+  virtual void Reset(sqlite3_stmt *pStmt) = 0;
   virtual void Finalize(sqlite3_stmt *pStmt) = 0;
 
   virtual void Exec(const std::string &sql, int (*callback) (void *, int, char **, char **) = nullptr, void *arg = nullptr) = 0;
   virtual long long GetFirstInt64Column(const std::string &sql) = 0;
   virtual long long GetFirstInt64Column(const std::string &sql, long long default_return_value) = 0;
 
+  virtual void BeginTransaction() = 0;
+  virtual void CommitTransaction() = 0;
+  virtual void RollbackTransaction() = 0;
+
   virtual sqlite3* GetSQLiteHandle() = 0;
 };
 
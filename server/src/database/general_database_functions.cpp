@@ -46,6 +46,14 @@ void GeneralDatabaseFunctions::CreateTables() {
                         "  AGENT_NAME text, "
                         "  unique (AGENT_NAME) "
                         ");");
+
+  sqlite_wrapper_->Exec("create table if not exists ANALYZER_WATERMARKS_TABLE ( "
+                        "  STAGE text not null, "
+                        "  AGENT_NAME_ID integer not null, "
+                        "  WATERMARK integer not null, "
+                        "  primary key (STAGE, AGENT_NAME_ID), "
+                        "  foreign key(AGENT_NAME_ID) references AGENT_NAMES(ID) "
+                        ");");
 }
 
 void GeneralDatabaseFunctions::AddTime(const ::type::Time &t) {
@@ -376,6 +384,28 @@ std::string GeneralDatabaseFunctions::GetAgentNameById(const ::database::type::R
   return name;
 }
 
+::database::type::RowId GeneralDatabaseFunctions::GetWatermark(const std::string &stage, ::database::type::RowId agent_name_id) {
+  BOOST_LOG_TRIVIAL(debug) << "database::GeneralDatabaseFunctions::GetWatermark: Function call";
+
+  string sql = "select WATERMARK from ANALYZER_WATERMARKS_TABLE "
+      " where STAGE='" + stage + "'"
+      " and AGENT_NAME_ID=" + to_string(agent_name_id) +
+      ";";
+
+  return sqlite_wrapper_->GetFirstInt64Column(sql, 0);
+}
+
+void GeneralDatabaseFunctions::SetWatermark(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark) {
+  BOOST_LOG_TRIVIAL(debug) << "database::GeneralDatabaseFunctions::SetWatermark: Function call";
+
+  sqlite_wrapper_->Exec(GetSetWatermarkSql(stage, agent_name_id, watermark));
+}
+
+std::string GeneralDatabaseFunctions::GetSetWatermarkSql(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark) {
+  return "insert or replace into ANALYZER_WATERMARKS_TABLE (STAGE, AGENT_NAME_ID, WATERMARK) "
+      " values ('" + stage + "', " + to_string(agent_name_id) + ", " + to_string(watermark) + ");";
+}
+
 GeneralDatabaseFunctions::GeneralDatabaseFunctions(::database::DatabasePtr database,
                                                    detail::SQLiteWrapperInterfacePtr sqlite_wrapper) :
 database_(database),
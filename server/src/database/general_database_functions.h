@@ -45,6 +45,12 @@ class GeneralDatabaseFunctions : public detail::GeneralDatabaseFunctionsInterfac
   ::database::type::RowId GetAgentNameId(const std::string &name) override;
   std::string GetAgentNameById(const ::database::type::RowId &id) override;
 
+  ::database::type::RowId GetWatermark(const std::string &stage, ::database::type::RowId agent_name_id) override;
+  void SetWatermark(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark) override;
+
+  // lets stages move the watermark in the transaction which saves their results
+  static std::string GetSetWatermarkSql(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark);
+
  private:
   GeneralDatabaseFunctions(DatabasePtr database,
                            detail::SQLiteWrapperInterfacePtr sqlite_wrapper);
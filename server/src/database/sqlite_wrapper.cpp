@@ -3,6 +3,7 @@
 #include <boost/log/trivial.hpp>
 
 #include "detail/sqlite.h"
+#include "statement_counters.h"
 #include "src/database/exception/detail/cant_open_database_exception.h"
 #include "src/database/exception/detail/cant_close_database_exception.h"
 #include "src/database/exception/detail/cant_execute_sql_statement_exception.h"
@@ -33,6 +34,18 @@ void SQLiteWrapper::Open(const std::string &file_path) {
   is_open_ = true;
 }
 
+void SQLiteWrapper::OpenReadOnly(const std::string &file_path) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::OpenReadOnly: Function call";
+
+  int ret = sqlite_interface_->Open(file_path.c_str(), &db_handle_, SQLITE_OPEN_READONLY, nullptr);
+  if (ret != SQLITE_OK) {
+    BOOST_LOG_TRIVIAL(error) << "database::SQLiteWrapper::OpenReadOnly: Open error: " << ret;
+    throw exception::detail::CantOpenDatabaseException();
+  }
+
+  is_open_ = true;
+}
+
 bool SQLiteWrapper::IsOpen() const {
   return is_open_;
 }
@@ -63,6 +76,10 @@ void SQLiteWrapper::Prepare(const std::string &sql, sqlite3_stmt **ppStmt) {
 
   int ret = sqlite_interface_->Prepare(db_handle_, sql.c_str(), -1, ppStmt, nullptr);
   CheckForError(ret, "Prepare function error");
+
+  auto counters = StatementCountersScope::GetCurrent();
+  if (counters != nullptr)
+    ++counters->statements;
 }
 
 void SQLiteWrapper::BindDouble(sqlite3_stmt* pStmt, int pos, double value) {
@@ -101,6 +118,15 @@ void SQLiteWrapper::BindText(sqlite3_stmt *pStmt, int pos, const std::string &va
   CheckForError(ret, "BindText function error");
 }
 
+void SQLiteWrapper::BindBlob(sqlite3_stmt *pStmt, int pos, const std::string &value) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::BindBlob: Function call";
+
+  CheckIsOpen();
+
+  int ret = sqlite_interface_->BindBlob(pStmt, pos, value.data(), value.size(), SQLITE_STATIC);
+  CheckForError(ret, "BindBlob function error");
+}
+
 double SQLiteWrapper::ColumnDouble(sqlite3_stmt *pStmt, int iCol) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::ColumnDouble: Function call";
 
@@ -139,17 +165,54 @@ const std::string SQLiteWrapper::ColumnText(sqlite3_stmt *pStmt, int iCol) {
     return ctext;
 }
 
+const std::string SQLiteWrapper::ColumnBlob(sqlite3_stmt *pStmt, int iCol) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::ColumnBlob: Function call";
+
+  CheckIsOpen();
+
+  // bytes count must be read after the pointer, the value may be converted
+  const char *blob = static_cast<const char*> (sqlite_interface_->ColumnBlob(pStmt, iCol));
+  const int bytes = sqlite_interface_->ColumnBytes(pStmt, iCol);
+
+  if (blob == nullptr)
+    return std::string();
+  else
+    return std::string(blob, bytes);
+}
+
 int SQLiteWrapper::Step(sqlite3_stmt *pStmt) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::Step: Function call";
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
 
   CheckIsOpen();
 
+  auto counters = StatementCountersScope::GetCurrent();
+  if (counters == nullptr) {
+    int ret = sqlite_interface_->Step(pStmt);
+    CheckForError(ret, "Step function error");
+    return ret;
+  }
+
+  const int changes = sqlite_interface_->TotalChanges(db_handle_);
   int ret = sqlite_interface_->Step(pStmt);
   CheckForError(ret, "Step function error");
 
+  counters->rows_written += sqlite_interface_->TotalChanges(db_handle_) - changes;
+  if (ret == SQLITE_ROW)
+    ++counters->rows_read;
+
   return ret;
 }
 
+void SQLiteWrapper::Reset(sqlite3_stmt *pStmt) {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::Reset: Function call";
+
+  CheckIsOpen();
+
+  int ret = sqlite_interface_->Reset(pStmt);
+  CheckForError(ret, "Reset function error");
+}
+
 void SQLiteWrapper::Finalize(sqlite3_stmt *pStmt) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::Finalize: Function call";
 
@@ -161,11 +224,27 @@ void SQLiteWrapper::Finalize(sqlite3_stmt *pStmt) {
 
 void SQLiteWrapper::Exec(const std::string &sql, int (*callback) (void *, int, char **, char **), void *arg) {
   BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::Exec: Function call";
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
 
   CheckIsOpen();
 
+  auto counters = StatementCountersScope::GetCurrent();
+  if (counters == nullptr) {
+    int ret = sqlite_interface_->Exec(db_handle_, sql.c_str(), callback, arg, nullptr);
+    if (ret != SQLITE_OK)
+      RollbackUnfinishedTransaction();
+    CheckForError(ret, "Exec function error");
+    return;
+  }
+
+  const int changes = sqlite_interface_->TotalChanges(db_handle_);
   int ret = sqlite_interface_->Exec(db_handle_, sql.c_str(), callback, arg, nullptr);
+  if (ret != SQLITE_OK)
+    RollbackUnfinishedTransaction();
   CheckForError(ret, "Exec function error");
+
+  ++counters->statements;
+  counters->rows_written += sqlite_interface_->TotalChanges(db_handle_) - changes;
 }
 
 long long SQLiteWrapper::GetFirstInt64Column(const std::string &sql) {
@@ -223,9 +302,60 @@ long long SQLiteWrapper::GetFirstInt64Column(const std::string &sql, long long d
   return value;
 }
 
+void SQLiteWrapper::BeginTransaction() {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::BeginTransaction: Function call";
+
+  // released by CommitTransaction or RollbackTransaction
+  mutex_.lock();
+
+  try {
+    Exec("begin transaction;");
+  }
+  catch (...) {
+    mutex_.unlock();
+    throw;
+  }
+
+  ++transactions_count_;
+}
+
+void SQLiteWrapper::CommitTransaction() {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::CommitTransaction: Function call";
+
+  try {
+    Exec("commit transaction;");
+  }
+  catch (...) {
+    RollbackTransaction();
+    throw;
+  }
+
+  --transactions_count_;
+  mutex_.unlock();
+}
+
+void SQLiteWrapper::RollbackTransaction() {
+  BOOST_LOG_TRIVIAL(debug) << "database::SQLiteWrapper::RollbackTransaction: Function call";
+
+  --transactions_count_;
+
+  try {
+    // sqlite rolls back by itself after some errors
+    if (sqlite_interface_->GetAutocommit(db_handle_) == 0)
+      Exec("rollback transaction;");
+  }
+  catch (...) {
+    mutex_.unlock();
+    throw;
+  }
+
+  mutex_.unlock();
+}
+
 SQLiteWrapper::SQLiteWrapper(detail::SQLiteInterfacePtr sqlite_interface) :
 sqlite_interface_(move(sqlite_interface)),
-is_open_(false) {
+is_open_(false),
+transactions_count_(0) {
 }
 
 sqlite3* SQLiteWrapper::GetSQLiteHandle() {
@@ -250,4 +380,14 @@ void SQLiteWrapper::CheckForError(int return_value, const char *description) {
   }
 }
 
+// Exec stops at the first failed statement, a transaction begun by its sql
+// would stay open and take in statements of all threads.
+void SQLiteWrapper::RollbackUnfinishedTransaction() {
+  if (transactions_count_ > 0 || sqlite_interface_->GetAutocommit(db_handle_) != 0)
+    return;
+
+  BOOST_LOG_TRIVIAL(warning) << "database::SQLiteWrapper::RollbackUnfinishedTransaction: Rolling back transaction left by a failed statement";
+  sqlite_interface_->Exec(db_handle_, "rollback transaction;", nullptr, nullptr, nullptr);
+}
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "detail/sqlite_interface.h"
@@ -12,12 +13,19 @@ namespace database
 class SQLiteWrapper;
 typedef std::shared_ptr<SQLiteWrapper> SQLiteWrapperPtr;
 
+// The connection is shared by threads. Statements are executed one at
+// a time and a transaction holds the connection for the thread which began
+// it, statements of other threads wait until it's committed or rolled back,
+// so they never become a part of it.
 class SQLiteWrapper : public detail::SQLiteWrapperInterface {
  public:
   static SQLiteWrapperPtr Create();
   static SQLiteWrapperPtr Create(detail::SQLiteInterfacePtr sqlite_interface);
 
   void Open(const std::string &file_path) override;
+  // Additional connection to an existing database, statements changing
+  // the database fail.
+  void OpenReadOnly(const std::string &file_path);
   bool IsOpen() const override;
   bool Close() override;
 
@@ -27,30 +35,42 @@ class SQLiteWrapper : public detail::SQLiteWrapperInterface {
   void BindInt(sqlite3_stmt *pStmt, int pos, int value) override;
   void BindInt64(sqlite3_stmt *pStmt, int pos, sqlite3_int64 value) override;
   void BindText(sqlite3_stmt *pStmt, int pos, const std::string &value) override;
+  void BindBlob(sqlite3_stmt *pStmt, int pos, const std::string &value) override;
 
   double ColumnDouble(sqlite3_stmt *pStmt, int iCol) override;
   int ColumnInt(sqlite3_stmt *pStmt, int iCol) override;
   sqlite3_int64 ColumnInt64(sqlite3_stmt *pStmt, int iCol) override;
   const std::string ColumnText(sqlite3_stmt *pStmt, int iCol) override;
+  const std::string ColumnBlob(sqlite3_stmt *pStmt, int iCol) override;
 
   int Step(sqlite3_stmt *pStmt) override;
+  void Reset(sqlite3_stmt *pStmt) override;
   void Finalize(sqlite3_stmt *pStmt) override;
 
   void Exec(const std::string &sql, int (*callback) (void *, int, char **, char **) = nullptr, void *arg = nullptr) override;
   long long GetFirstInt64Column(const std::string &sql) override;
   long long GetFirstInt64Column(const std::string &sql, long long default_return_value) override;
 
+  // Transactions started with Exec ("begin transaction; ... end transaction;")
+  // have to end in the same Exec call, when it fails they are rolled back.
+  void BeginTransaction() override;
+  void CommitTransaction() override;
+  void RollbackTransaction() override;
+
   sqlite3* GetSQLiteHandle() override;
 
  private:
   detail::SQLiteInterfacePtr sqlite_interface_;
   bool is_open_;
   sqlite3 *db_handle_;
+  std::recursive_mutex mutex_;
+  unsigned transactions_count_;
 
   SQLiteWrapper(detail::SQLiteInterfacePtr sqlite_interface);
 
   void CheckIsOpen();
   void CheckForError(int return_value, const char *description);
+  void RollbackUnfinishedTransaction();
 };
 
 }
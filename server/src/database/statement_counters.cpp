@@ -0,0 +1,31 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "statement_counters.h"
+
+namespace database
+{
+
+namespace
+{
+
+thread_local StatementCounters *current_counters = nullptr;
+
+}
+
+StatementCountersScope::StatementCountersScope(StatementCounters *counters) :
+previous_(current_counters) {
+  current_counters = counters;
+}
+
+StatementCountersScope::~StatementCountersScope() {
+  current_counters = previous_;
+}
+
+StatementCounters* StatementCountersScope::GetCurrent() {
+  return current_counters;
+}
+
+}
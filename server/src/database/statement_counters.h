@@ -0,0 +1,43 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <atomic>
+
+namespace database
+{
+
+struct StatementCounters {
+  StatementCounters() :
+  statements(0),
+  rows_read(0),
+  rows_written(0) {
+  }
+
+  std::atomic<long long> statements;
+  std::atomic<long long> rows_read;
+  std::atomic<long long> rows_written;
+};
+
+// While a scope exists SQLiteWrapper calls made by its thread are counted
+// in the given counters. Scopes may be nested, the previous counters are
+// restored at the end.
+class StatementCountersScope {
+ public:
+  explicit StatementCountersScope(StatementCounters *counters);
+  ~StatementCountersScope();
+
+  StatementCountersScope(const StatementCountersScope&) = delete;
+  StatementCountersScope& operator=(const StatementCountersScope&) = delete;
+
+  // nullptr when calls of the current thread are not counted
+  static StatementCounters* GetCurrent();
+
+ private:
+  StatementCounters *previous_;
+};
+
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "dense_fann_wrapper.h"
+#include "fann_wrapper.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace library
+{
+
+namespace fann
+{
+
+DenseFannWrapperPtr DenseFannWrapper::Create(DenseNetwork::Precision precision) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseFannWrapper::Create: Function call";
+
+  return Create(FannWrapper::Create(), precision);
+}
+
+DenseFannWrapperPtr DenseFannWrapper::Create(detail::FannWrapperInterfacePtr fann_wrapper,
+                                             DenseNetwork::Precision precision) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseFannWrapper::Create: Function call";
+
+  return DenseFannWrapperPtr(new DenseFannWrapper(fann_wrapper, precision));
+}
+
+struct fann* DenseFannWrapper::CreateStandard(unsigned num_layers, unsigned num_input,
+                                              unsigned num_neurons_hidden, unsigned num_output) {
+  return fann_wrapper_->CreateStandard(num_layers, num_input, num_neurons_hidden, num_output);
+}
+
+void DenseFannWrapper::SetActivationFunctionHidden(struct fann *ann,
+                                                   enum fann_activationfunc_enum activation_function) {
+  SetChanged(ann);
+  fann_wrapper_->SetActivationFunctionHidden(ann, activation_function);
+}
+
+void DenseFannWrapper::SetActivationFunctionOutput(struct fann *ann,
+                                                   enum fann_activationfunc_enum activation_function) {
+  SetChanged(ann);
+  fann_wrapper_->SetActivationFunctionOutput(ann, activation_function);
+}
+
+void DenseFannWrapper::TrainOnFile(struct fann *ann,
+                                   const std::string &filename,
+                                   unsigned int max_epochs,
+                                   unsigned int epochs_between_reports,
+                                   float desired_error) {
+  SetChanged(ann);
+  fann_wrapper_->TrainOnFile(ann, filename, max_epochs, epochs_between_reports, desired_error);
+}
+
+struct fann_train_data* DenseFannWrapper::CreateTrainData(unsigned num_data, unsigned num_input, unsigned num_output,
+                                                         const TrainDataCallback &callback) {
+  return fann_wrapper_->CreateTrainData(num_data, num_input, num_output, callback);
+}
+
+struct fann_train_data* DenseFannWrapper::CreateTrainData(unsigned num_input, unsigned num_output,
+                                                         const std::vector<fann_type> &inputs,
+                                                         const std::vector<fann_type> &outputs) {
+  return fann_wrapper_->CreateTrainData(num_input, num_output, inputs, outputs);
+}
+
+void DenseFannWrapper::TrainOnData(struct fann *ann,
+                                   struct fann_train_data *data,
+                                   unsigned int max_epochs,
+                                   unsigned int epochs_between_reports,
+                                   float desired_error) {
+  SetChanged(ann);
+  fann_wrapper_->TrainOnData(ann, data, max_epochs, epochs_between_reports, desired_error);
+}
+
+float DenseFannWrapper::TrainEpoch(struct fann *ann, struct fann_train_data *data) {
+  SetChanged(ann);
+  return fann_wrapper_->TrainEpoch(ann, data);
+}
+
+float DenseFannWrapper::TestData(struct fann *ann, struct fann_train_data *data) {
+  return fann_wrapper_->TestData(ann, data);
+}
+
+bool DenseFannWrapper::SaveTrainDataSnapshot(struct fann_train_data *data, const std::string &file_path) {
+  return fann_wrapper_->SaveTrainDataSnapshot(data, file_path);
+}
+
+struct fann_train_data* DenseFannWrapper::LoadTrainDataSnapshot(const std::string &file_path) {
+  return fann_wrapper_->LoadTrainDataSnapshot(file_path);
+}
+
+void DenseFannWrapper::DestroyTrainData(struct fann_train_data *data) {
+  fann_wrapper_->DestroyTrainData(data);
+}
+
+struct fann* DenseFannWrapper::CreateFromFile(const std::string &configuration_file) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseFannWrapper::CreateFromFile: Function call";
+
+  struct fann *ann = fann_wrapper_->CreateFromFile(configuration_file);
+  if (ann == nullptr)
+    return nullptr;
+
+  auto network = DenseNetwork::CreateFromFile(configuration_file, precision_);
+  if (!network) {
+    BOOST_LOG_TRIVIAL(info) << "library::fann::DenseFannWrapper::CreateFromFile: Network from " << configuration_file << " will be run by libfann";
+    return ann;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  networks_[ann] = network;
+
+  return ann;
+}
+
+struct fann* DenseFannWrapper::Copy(struct fann *ann) {
+  struct fann *copy = fann_wrapper_->Copy(ann);
+
+  if (copy == nullptr)
+    return nullptr;
+
+  // a network which isn't built yet is built for the copy separately
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = networks_.find(ann);
+  if (it != networks_.end())
+    networks_[copy] = it->second;
+  else if (changed_networks_.count(ann) != 0)
+    changed_networks_.insert(copy);
+
+  return copy;
+}
+
+unsigned DenseFannWrapper::GetNumInput(struct fann *ann) {
+  return fann_wrapper_->GetNumInput(ann);
+}
+
+unsigned DenseFannWrapper::GetNumOutput(struct fann *ann) {
+  return fann_wrapper_->GetNumOutput(ann);
+}
+
+std::vector<unsigned> DenseFannWrapper::GetLayerArray(struct fann *ann) {
+  return fann_wrapper_->GetLayerArray(ann);
+}
+
+std::vector<unsigned> DenseFannWrapper::GetBiasArray(struct fann *ann) {
+  return fann_wrapper_->GetBiasArray(ann);
+}
+
+std::vector<struct fann_connection> DenseFannWrapper::GetConnectionArray(struct fann *ann) {
+  return fann_wrapper_->GetConnectionArray(ann);
+}
+
+enum fann_activationfunc_enum DenseFannWrapper::GetActivationFunction(struct fann *ann, int layer, int neuron) {
+  return fann_wrapper_->GetActivationFunction(ann, layer, neuron);
+}
+
+fann_type DenseFannWrapper::GetActivationSteepness(struct fann *ann, int layer, int neuron) {
+  return fann_wrapper_->GetActivationSteepness(ann, layer, neuron);
+}
+
+int DenseFannWrapper::Save(struct fann *ann, const std::string &configuration_file) {
+  return fann_wrapper_->Save(ann, configuration_file);
+}
+
+fann_type* DenseFannWrapper::Run(struct fann *ann, fann_type *input) {
+  auto network = GetDenseNetwork(ann);
+  if (!network)
+    return fann_wrapper_->Run(ann, input);
+
+  thread_local std::vector<fann_type> outputs;
+  outputs.resize(network->GetNumOutput());
+  network->Run(input, 1, outputs.data());
+
+  return outputs.data();
+}
+
+std::shared_ptr<DenseNetwork> DenseFannWrapper::GetDenseNetwork(struct fann *ann) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (changed_networks_.erase(ann) != 0) {
+    auto network = DenseNetwork::Create(ann, fann_wrapper_, precision_);
+    if (network)
+      networks_[ann] = network;
+  }
+
+  auto it = networks_.find(ann);
+  return (it == networks_.end()) ? DenseNetworkPtr() : it->second;
+}
+
+void DenseFannWrapper::Destroy(struct fann *ann) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    networks_.erase(ann);
+    changed_networks_.erase(ann);
+  }
+
+  fann_wrapper_->Destroy(ann);
+}
+
+void DenseFannWrapper::SetChanged(struct fann *ann) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  networks_.erase(ann);
+  changed_networks_.insert(ann);
+}
+
+DenseFannWrapper::DenseFannWrapper(detail::FannWrapperInterfacePtr fann_wrapper,
+                                   DenseNetwork::Precision precision) :
+fann_wrapper_(fann_wrapper),
+precision_(precision) {
+}
+
+}
+
+}
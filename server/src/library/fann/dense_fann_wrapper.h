@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "dense_network.h"
+#include "detail/fann_wrapper_interface.h"
+
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace library
+{
+
+namespace fann
+{
+
+class DenseFannWrapper;
+typedef std::shared_ptr<DenseFannWrapper> DenseFannWrapperPtr;
+
+// Runs networks loaded from files with DenseNetwork instead of libfann,
+// other calls go to the wrapped object. Networks DenseNetwork doesn't
+// support are run by libfann. A network changed by training or by new
+// activation functions is built again from libfann on its next Run.
+// Outputs returned by Run are valid until the next Run in the same thread.
+class DenseFannWrapper : public detail::FannWrapperInterface {
+ public:
+  virtual ~DenseFannWrapper() = default;
+
+  static DenseFannWrapperPtr Create(DenseNetwork::Precision precision);
+  static DenseFannWrapperPtr Create(detail::FannWrapperInterfacePtr fann_wrapper,
+                                    DenseNetwork::Precision precision);
+
+  struct fann* CreateStandard(unsigned num_layers, unsigned num_input,
+                              unsigned num_neurons_hidden, unsigned num_output) override;
+
+  void SetActivationFunctionHidden(struct fann *ann,
+                                   enum fann_activationfunc_enum activation_function) override;
+
+  void SetActivationFunctionOutput(struct fann *ann,
+                                   enum fann_activationfunc_enum activation_function) override;
+
+  void TrainOnFile(struct fann *ann,
+                   const std::string &filename,
+                   unsigned int max_epochs,
+                   unsigned int epochs_between_reports,
+                   float desired_error) override;
+
+  struct fann_train_data* CreateTrainData(unsigned num_data, unsigned num_input, unsigned num_output,
+                                         const TrainDataCallback &callback) override;
+
+  struct fann_train_data* CreateTrainData(unsigned num_input, unsigned num_output,
+                                         const std::vector<fann_type> &inputs,
+                                         const std::vector<fann_type> &outputs) override;
+
+  void TrainOnData(struct fann *ann,
+                   struct fann_train_data *data,
+                   unsigned int max_epochs,
+                   unsigned int epochs_between_reports,
+                   float desired_error) override;
+
+  float TrainEpoch(struct fann *ann, struct fann_train_data *data) override;
+
+  float TestData(struct fann *ann, struct fann_train_data *data) override;
+
+  bool SaveTrainDataSnapshot(struct fann_train_data *data, const std::string &file_path) override;
+  struct fann_train_data* LoadTrainDataSnapshot(const std::string &file_path) override;
+
+  void DestroyTrainData(struct fann_train_data *data) override;
+
+  struct fann* CreateFromFile(const std::string &configuration_file) override;
+
+  struct fann* Copy(struct fann *ann) override;
+
+  unsigned GetNumInput(struct fann *ann) override;
+
+  unsigned GetNumOutput(struct fann *ann) override;
+
+  std::vector<unsigned> GetLayerArray(struct fann *ann) override;
+
+  std::vector<unsigned> GetBiasArray(struct fann *ann) override;
+
+  std::vector<struct fann_connection> GetConnectionArray(struct fann *ann) override;
+
+  enum fann_activationfunc_enum GetActivationFunction(struct fann *ann, int layer, int neuron) override;
+
+  fann_type GetActivationSteepness(struct fann *ann, int layer, int neuron) override;
+
+  int Save(struct fann *ann, const std::string &configuration_file) override;
+
+  fann_type* Run(struct fann *ann, fann_type *input) override;
+
+  std::shared_ptr<DenseNetwork> GetDenseNetwork(struct fann *ann) override;
+
+  void Destroy(struct fann *ann) override;
+
+ private:
+  DenseFannWrapper(detail::FannWrapperInterfacePtr fann_wrapper,
+                   DenseNetwork::Precision precision);
+
+  void SetChanged(struct fann *ann);
+
+  detail::FannWrapperInterfacePtr fann_wrapper_;
+  const DenseNetwork::Precision precision_;
+
+  std::mutex mutex_;
+  std::map<struct fann*, DenseNetworkPtr> networks_;
+  std::set<struct fann*> changed_networks_;
+};
+
+}
+
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "dense_network.h"
+#include "matrix_kernel.h"
+#include "network_file.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace library
+{
+
+namespace fann
+{
+
+static_assert(std::is_same<fann_type, float>::value, "DenseNetwork needs the float version of FANN");
+
+constexpr unsigned DenseNetwork::ROWS_BLOCK;
+constexpr unsigned DenseNetwork::INPUTS_BLOCK;
+
+DenseNetworkPtr DenseNetwork::Create(struct fann *ann, detail::FannWrapperInterfacePtr fann_wrapper,
+                                     Precision precision) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseNetwork::Create: Function call";
+
+  const auto layer_sizes = fann_wrapper->GetLayerArray(ann);
+  const auto bias = fann_wrapper->GetBiasArray(ann);
+  if (layer_sizes.size() < 2 || bias.size() != layer_sizes.size())
+    return DenseNetworkPtr();
+
+  // neurons are numbered layer after layer, the bias neuron is the last one in its layer
+  std::vector<unsigned> first_neuron(layer_sizes.size() + 1, 0);
+  for (std::size_t l = 0; l < layer_sizes.size(); ++l)
+    first_neuron[l + 1] = first_neuron[l] + layer_sizes[l] + bias[l];
+
+  Layers layers(layer_sizes.size() - 1);
+  for (std::size_t l = 1; l < layer_sizes.size(); ++l) {
+    Layer &layer = layers[l - 1];
+    layer.num_input = layer_sizes[l - 1];
+    layer.num_output = layer_sizes[l];
+    layer.weights.assign(static_cast<std::size_t> (layer.num_input) * layer.num_output, 0);
+    layer.bias.assign(layer.num_output, 0);
+    layer.activation_function = fann_wrapper->GetActivationFunction(ann, l, 0);
+    layer.steepness = fann_wrapper->GetActivationSteepness(ann, l, 0);
+
+    for (unsigned neuron = 1; neuron < layer.num_output; ++neuron) {
+      if (fann_wrapper->GetActivationFunction(ann, l, neuron) != layer.activation_function
+          || fann_wrapper->GetActivationSteepness(ann, l, neuron) != layer.steepness)
+        return DenseNetworkPtr();
+    }
+
+    if (!IsActivationFunctionSupported(layer.activation_function) || layer.steepness <= 0)
+      return DenseNetworkPtr();
+  }
+
+  for (const auto &connection : fann_wrapper->GetConnectionArray(ann)) {
+    const auto to_layer = std::upper_bound(first_neuron.begin(), first_neuron.end(), connection.to_neuron) - first_neuron.begin() - 1;
+    if (to_layer < 1 || to_layer >= static_cast<long> (layer_sizes.size()))
+      return DenseNetworkPtr();
+
+    Layer &layer = layers[to_layer - 1];
+    const unsigned to = connection.to_neuron - first_neuron[to_layer];
+    const unsigned from_begin = first_neuron[to_layer - 1];
+    if (to >= layer.num_output || connection.from_neuron < from_begin || connection.from_neuron >= first_neuron[to_layer])
+      return DenseNetworkPtr();
+
+    const unsigned from = connection.from_neuron - from_begin;
+    if (from == layer.num_input)
+      layer.bias[to] = connection.weight;
+    else
+      layer.weights[static_cast<std::size_t> (from) * layer.num_output + to] = connection.weight;
+  }
+
+  return Create(layers, precision);
+}
+
+DenseNetworkPtr DenseNetwork::Create(const Layers &layers, Precision precision) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseNetwork::Create: Function call";
+
+  if (layers.empty())
+    throw std::invalid_argument("library::fann::DenseNetwork::Create: Network without layers");
+
+  for (std::size_t l = 0; l < layers.size(); ++l) {
+    const Layer &layer = layers[l];
+    if (layer.weights.size() != static_cast<std::size_t> (layer.num_input) * layer.num_output
+        || layer.bias.size() != layer.num_output
+        || (l > 0 && layers[l - 1].num_output != layer.num_input))
+      throw std::invalid_argument("library::fann::DenseNetwork::Create: Layer sizes don't match");
+  }
+
+  return DenseNetworkPtr(new DenseNetwork(layers, precision));
+}
+
+DenseNetworkPtr DenseNetwork::CreateFromFile(const std::string &file_path, Precision precision) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::DenseNetwork::CreateFromFile: Function call";
+
+  std::ifstream file(file_path.c_str());
+  Layers layers;
+  if (!file || !ReadNetworkFile(file, layers)) {
+    BOOST_LOG_TRIVIAL(warning) << "library::fann::DenseNetwork::CreateFromFile: Can't read network from " << file_path;
+    return DenseNetworkPtr();
+  }
+
+  return Create(layers, precision);
+}
+
+unsigned DenseNetwork::GetNumInput() const {
+  return layers_.front().num_input;
+}
+
+unsigned DenseNetwork::GetNumOutput() const {
+  return layers_.back().num_output;
+}
+
+DenseNetwork::Precision DenseNetwork::GetPrecision() const {
+  return precision_;
+}
+
+void DenseNetwork::Run(const fann_type *inputs, std::size_t rows, fann_type *outputs) const {
+  std::vector<float> buffers[2] = {
+    std::vector<float>(static_cast<std::size_t> (ROWS_BLOCK) * max_layer_size_),
+    std::vector<float>(static_cast<std::size_t> (ROWS_BLOCK) * max_layer_size_)
+  };
+
+  for (std::size_t row = 0; row < rows; row += ROWS_BLOCK) {
+    const std::size_t block_rows = std::min<std::size_t>(ROWS_BLOCK, rows - row);
+    const float *layer_input = inputs + row * GetNumInput();
+    std::size_t input_stride = GetNumInput();
+
+    for (std::size_t l = 0; l < layers_.size(); ++l) {
+      const Layer &layer = layers_[l];
+      const bool is_last = (l + 1 == layers_.size());
+      float *layer_output = is_last ? outputs + row * layer.num_output : buffers[l % 2].data();
+
+      if (precision_ == Precision::INT8)
+        RunQuantizedLayer(l, layer_input, input_stride, block_rows, layer_output);
+      else
+        RunLayer(l, layer_input, input_stride, block_rows, layer_output);
+
+      Activate(layer, layer_output, block_rows * layer.num_output);
+
+      layer_input = layer_output;
+      input_stride = layer.num_output;
+    }
+  }
+}
+
+bool DenseNetwork::IsActivationFunctionSupported(enum fann_activationfunc_enum activation_function) {
+  return activation_function == FANN_LINEAR
+      || activation_function == FANN_SIGMOID
+      || activation_function == FANN_SIGMOID_SYMMETRIC;
+}
+
+DenseNetwork::DenseNetwork(const Layers &layers, Precision precision) :
+layers_(layers),
+precision_(precision),
+max_layer_size_(0) {
+  for (const auto &layer : layers_) {
+    max_layer_size_ = std::max(max_layer_size_, layer.num_output);
+
+    if (precision_ == Precision::INT8)
+      quantized_layers_.push_back(Quantize(layer));
+  }
+}
+
+DenseNetwork::QuantizedLayer DenseNetwork::Quantize(const Layer &layer) {
+  QuantizedLayer quantized;
+  quantized.weights.resize(layer.weights.size());
+  quantized.scales.assign(layer.num_output, 0);
+
+  for (unsigned p = 0; p < layer.num_input; ++p)
+    for (unsigned j = 0; j < layer.num_output; ++j)
+      quantized.scales[j] = std::max(quantized.scales[j], std::fabs(layer.weights[static_cast<std::size_t> (p) * layer.num_output + j]));
+
+  for (auto &scale : quantized.scales)
+    scale = (scale > 0) ? scale / 127 : 1;
+
+  for (unsigned p = 0; p < layer.num_input; ++p) {
+    for (unsigned j = 0; j < layer.num_output; ++j) {
+      const std::size_t i = static_cast<std::size_t> (p) * layer.num_output + j;
+      quantized.weights[i] = static_cast<std::int8_t> (std::lround(layer.weights[i] / quantized.scales[j]));
+    }
+  }
+
+  return quantized;
+}
+
+void DenseNetwork::RunLayer(std::size_t l, const float *inputs, std::size_t input_stride,
+                            std::size_t rows, float *outputs) const {
+  const Layer &layer = layers_[l];
+
+  for (std::size_t i = 0; i < rows; ++i)
+    std::copy(layer.bias.begin(), layer.bias.end(), outputs + i * layer.num_output);
+
+  for (unsigned p = 0; p < layer.num_input; p += INPUTS_BLOCK) {
+    MultiplyAdd(inputs + p, input_stride,
+                layer.weights.data() + static_cast<std::size_t> (p) * layer.num_output,
+                outputs, rows,
+                std::min(INPUTS_BLOCK, layer.num_input - p), layer.num_output);
+  }
+}
+
+void DenseNetwork::RunQuantizedLayer(std::size_t l, const float *inputs, std::size_t input_stride,
+                                     std::size_t rows, float *outputs) const {
+  const Layer &layer = layers_[l];
+  const QuantizedLayer &quantized = quantized_layers_[l];
+
+  std::fill(outputs, outputs + rows * layer.num_output, 0);
+
+  for (unsigned p = 0; p < layer.num_input; p += INPUTS_BLOCK) {
+    MultiplyAddInt8(inputs + p, input_stride,
+                    quantized.weights.data() + static_cast<std::size_t> (p) * layer.num_output,
+                    outputs, rows,
+                    std::min(INPUTS_BLOCK, layer.num_input - p), layer.num_output);
+  }
+
+  for (std::size_t i = 0; i < rows; ++i) {
+    float *row = outputs + i * layer.num_output;
+    for (unsigned j = 0; j < layer.num_output; ++j)
+      row[j] = row[j] * quantized.scales[j] + layer.bias[j];
+  }
+}
+
+void DenseNetwork::Activate(const Layer &layer, float *values, std::size_t count) {
+  // the same as fann_run: the sum is multiplied by steepness and limited
+  // to +-150 / steepness before the activation function
+  const float max_sum = 150 / layer.steepness;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const float sum = std::max(-max_sum, std::min(max_sum, layer.steepness * values[i]));
+
+    switch (layer.activation_function) {
+      case FANN_SIGMOID:
+        values[i] = 1.0f / (1.0f + std::exp(-2.0f * sum));
+        break;
+
+      case FANN_SIGMOID_SYMMETRIC:
+        values[i] = 2.0f / (1.0f + std::exp(-2.0f * sum)) - 1.0f;
+        break;
+
+      default:
+        values[i] = sum;
+        break;
+    }
+  }
+}
+
+}
+
+}
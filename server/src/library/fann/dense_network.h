@@ -0,0 +1,104 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "detail/fann_wrapper_interface.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace library
+{
+
+namespace fann
+{
+
+class DenseNetwork;
+typedef std::shared_ptr<DenseNetwork> DenseNetworkPtr;
+
+// Weights of a layered FANN network, run on many rows at once. Every layer
+// is a matrix product computed in blocks of ROWS_BLOCK rows and INPUTS_BLOCK
+// inputs, so the blocks stay in cache. Results are equal to fann_run up to
+// float rounding. Run doesn't change the network, so it may be called from
+// many threads.
+//
+// With INT8 precision every column of weights is scaled to -127..127 and
+// stored in one byte, products are summed in floats and scaled back.
+class DenseNetwork {
+ public:
+  enum class Precision {
+    FLOAT32,
+    INT8
+  };
+
+  struct Layer {
+    unsigned num_input;
+    unsigned num_output;
+    // num_input rows of num_output weights
+    std::vector<float> weights;
+    std::vector<float> bias;
+    enum fann_activationfunc_enum activation_function;
+    float steepness;
+  };
+
+  typedef std::vector<Layer> Layers;
+
+  virtual ~DenseNetwork() = default;
+
+  // Returns nullptr when the network has connections skipping layers or
+  // activation functions which aren't supported.
+  static DenseNetworkPtr Create(struct fann *ann, detail::FannWrapperInterfacePtr fann_wrapper,
+                                Precision precision = Precision::FLOAT32);
+  static DenseNetworkPtr Create(const Layers &layers, Precision precision = Precision::FLOAT32);
+
+  // Reads a network saved by fann_save, libfann isn't used. Returns nullptr
+  // when the file can't be read or the network isn't supported.
+  static DenseNetworkPtr CreateFromFile(const std::string &file_path, Precision precision = Precision::FLOAT32);
+
+  unsigned GetNumInput() const;
+  unsigned GetNumOutput() const;
+  Precision GetPrecision() const;
+
+  // inputs has rows * GetNumInput() values, rows * GetNumOutput() values
+  // are written to outputs.
+  void Run(const fann_type *inputs, std::size_t rows, fann_type *outputs) const;
+
+  static bool IsActivationFunctionSupported(enum fann_activationfunc_enum activation_function);
+
+  static constexpr unsigned ROWS_BLOCK = 64;
+  static constexpr unsigned INPUTS_BLOCK = 256;
+
+ private:
+  struct QuantizedLayer {
+    std::vector<std::int8_t> weights;
+    // per output
+    std::vector<float> scales;
+  };
+
+  DenseNetwork(const Layers &layers, Precision precision);
+
+  static QuantizedLayer Quantize(const Layer &layer);
+
+  // outputs of layer l without activation, for rows inputs input_stride apart
+  void RunLayer(std::size_t l, const float *inputs, std::size_t input_stride,
+                std::size_t rows, float *outputs) const;
+  void RunQuantizedLayer(std::size_t l, const float *inputs, std::size_t input_stride,
+                         std::size_t rows, float *outputs) const;
+
+  static void Activate(const Layer &layer, float *values, std::size_t count);
+
+  Layers layers_;
+  std::vector<QuantizedLayer> quantized_layers_;
+  Precision precision_;
+  unsigned max_layer_size_;
+};
+
+}
+
+}
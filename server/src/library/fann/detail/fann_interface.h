@@ -38,6 +38,40 @@ class FannInterface {
                            unsigned int epochs_between_reports,
                            float desired_error) = 0;
 
+  virtual struct fann_train_data* CreateTrain(unsigned num_data, unsigned num_input, unsigned num_output) = 0;
+
+  virtual void TrainOnData(struct fann *ann,
+                           struct fann_train_data *data,
+                           unsigned int max_epochs,
+                           unsigned int epochs_between_reports,
+                           float desired_error) = 0;
+
+  virtual void DestroyTrain(struct fann_train_data *data) = 0;
+
+  virtual float TrainEpoch(struct fann *ann, struct fann_train_data *data) = 0;
+
+  virtual float TestData(struct fann *ann, struct fann_train_data *data) = 0;
+
+  virtual struct fann* Copy(struct fann *ann) = 0;
+
+  virtual unsigned GetNumInput(struct fann *ann) = 0;
+
+  virtual unsigned GetNumOutput(struct fann *ann) = 0;
+
+  virtual unsigned GetNumLayers(struct fann *ann) = 0;
+
+  virtual void GetLayerArray(struct fann *ann, unsigned *layers) = 0;
+
+  virtual void GetBiasArray(struct fann *ann, unsigned *bias) = 0;
+
+  virtual unsigned GetTotalConnections(struct fann *ann) = 0;
+
+  virtual void GetConnectionArray(struct fann *ann, struct fann_connection *connections) = 0;
+
+  virtual enum fann_activationfunc_enum GetActivationFunction(struct fann *ann, int layer, int neuron) = 0;
+
+  virtual fann_type GetActivationSteepness(struct fann *ann, int layer, int neuron) = 0;
+
   virtual struct fann* CreateFromFile(const char *configuration_file) = 0;
 
   virtual int Save(struct fann *ann, const char *configuration_file) = 0;
@@ -7,8 +7,10 @@
 
 #include "fann_interface.h"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace library
 {
@@ -16,11 +18,16 @@ namespace library
 namespace fann
 {
 
+class DenseNetwork;
+
 namespace detail
 {
 
 class FannWrapperInterface {
  public:
+  // Fills input and output of one row, arrays are zeroed.
+  typedef std::function<void(unsigned row, fann_type *input, fann_type *output)> TrainDataCallback;
+
   virtual ~FannWrapperInterface() = default;
 
   virtual struct fann* CreateStandard(unsigned num_layers, unsigned num_input,
@@ -38,12 +45,60 @@ class FannWrapperInterface {
                            unsigned int epochs_between_reports,
                            float desired_error) = 0;
 
+  virtual struct fann_train_data* CreateTrainData(unsigned num_data, unsigned num_input, unsigned num_output,
+                                                 const TrainDataCallback &callback) = 0;
+
+  // Rows are stored one after another, num_input (num_output) values each.
+  virtual struct fann_train_data* CreateTrainData(unsigned num_input, unsigned num_output,
+                                                 const std::vector<fann_type> &inputs,
+                                                 const std::vector<fann_type> &outputs) = 0;
+
+  virtual void TrainOnData(struct fann *ann,
+                           struct fann_train_data *data,
+                           unsigned int max_epochs,
+                           unsigned int epochs_between_reports,
+                           float desired_error) = 0;
+
+  // Returns mean square error of the epoch.
+  virtual float TrainEpoch(struct fann *ann, struct fann_train_data *data) = 0;
+
+  // Returns mean square error, the network isn't changed.
+  virtual float TestData(struct fann *ann, struct fann_train_data *data) = 0;
+
+  // Binary copy of the data, for debugging.
+  virtual bool SaveTrainDataSnapshot(struct fann_train_data *data, const std::string &file_path) = 0;
+  virtual struct fann_train_data* LoadTrainDataSnapshot(const std::string &file_path) = 0;
+
+  virtual void DestroyTrainData(struct fann_train_data *data) = 0;
+
   virtual struct fann* CreateFromFile(const std::string &configuration_file) = 0;
 
+  virtual struct fann* Copy(struct fann *ann) = 0;
+
+  virtual unsigned GetNumInput(struct fann *ann) = 0;
+
+  virtual unsigned GetNumOutput(struct fann *ann) = 0;
+
+  // Neurons in every layer without bias neurons, input layer first.
+  virtual std::vector<unsigned> GetLayerArray(struct fann *ann) = 0;
+
+  virtual std::vector<unsigned> GetBiasArray(struct fann *ann) = 0;
+
+  virtual std::vector<struct fann_connection> GetConnectionArray(struct fann *ann) = 0;
+
+  // Layer 0 is the input layer.
+  virtual enum fann_activationfunc_enum GetActivationFunction(struct fann *ann, int layer, int neuron) = 0;
+
+  virtual fann_type GetActivationSteepness(struct fann *ann, int layer, int neuron) = 0;
+
   virtual int Save(struct fann *ann, const std::string &configuration_file) = 0;
 
   virtual fann_type* Run(struct fann *ann, fann_type *input) = 0;
 
+  // Network which runs instead of libfann for ann created by the wrapper,
+  // nullptr when rows are run by libfann.
+  virtual std::shared_ptr<DenseNetwork> GetDenseNetwork(struct fann *ann) = 0;
+
   virtual void Destroy(struct fann *ann) = 0;
 };
 
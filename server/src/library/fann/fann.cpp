@@ -38,6 +38,70 @@ void Fann::TrainOnFile(struct fann *ann,
   fann_train_on_file(ann, filename, max_epochs, epochs_between_reports, desired_error);
 }
 
+struct fann_train_data* Fann::CreateTrain(unsigned num_data, unsigned num_input, unsigned num_output) {
+  return fann_create_train(num_data, num_input, num_output);
+}
+
+void Fann::TrainOnData(struct fann *ann,
+                       struct fann_train_data *data,
+                       unsigned int max_epochs,
+                       unsigned int epochs_between_reports,
+                       float desired_error) {
+  fann_train_on_data(ann, data, max_epochs, epochs_between_reports, desired_error);
+}
+
+void Fann::DestroyTrain(struct fann_train_data *data) {
+  fann_destroy_train(data);
+}
+
+float Fann::TrainEpoch(struct fann *ann, struct fann_train_data *data) {
+  return fann_train_epoch(ann, data);
+}
+
+float Fann::TestData(struct fann *ann, struct fann_train_data *data) {
+  return fann_test_data(ann, data);
+}
+
+struct fann* Fann::Copy(struct fann *ann) {
+  return fann_copy(ann);
+}
+
+unsigned Fann::GetNumInput(struct fann *ann) {
+  return fann_get_num_input(ann);
+}
+
+unsigned Fann::GetNumOutput(struct fann *ann) {
+  return fann_get_num_output(ann);
+}
+
+unsigned Fann::GetNumLayers(struct fann *ann) {
+  return fann_get_num_layers(ann);
+}
+
+void Fann::GetLayerArray(struct fann *ann, unsigned *layers) {
+  fann_get_layer_array(ann, layers);
+}
+
+void Fann::GetBiasArray(struct fann *ann, unsigned *bias) {
+  fann_get_bias_array(ann, bias);
+}
+
+unsigned Fann::GetTotalConnections(struct fann *ann) {
+  return fann_get_total_connections(ann);
+}
+
+void Fann::GetConnectionArray(struct fann *ann, struct fann_connection *connections) {
+  fann_get_connection_array(ann, connections);
+}
+
+enum fann_activationfunc_enum Fann::GetActivationFunction(struct fann *ann, int layer, int neuron) {
+  return fann_get_activation_function(ann, layer, neuron);
+}
+
+fann_type Fann::GetActivationSteepness(struct fann *ann, int layer, int neuron) {
+  return fann_get_activation_steepness(ann, layer, neuron);
+}
+
 struct fann* Fann::CreateFromFile(const char *configuration_file) {
   return fann_create_from_file(configuration_file);
 }
@@ -37,6 +37,40 @@ class Fann : public detail::FannInterface {
                    unsigned int epochs_between_reports,
                    float desired_error) override;
 
+  struct fann_train_data* CreateTrain(unsigned num_data, unsigned num_input, unsigned num_output) override;
+
+  void TrainOnData(struct fann *ann,
+                   struct fann_train_data *data,
+                   unsigned int max_epochs,
+                   unsigned int epochs_between_reports,
+                   float desired_error) override;
+
+  void DestroyTrain(struct fann_train_data *data) override;
+
+  float TrainEpoch(struct fann *ann, struct fann_train_data *data) override;
+
+  float TestData(struct fann *ann, struct fann_train_data *data) override;
+
+  struct fann* Copy(struct fann *ann) override;
+
+  unsigned GetNumInput(struct fann *ann) override;
+
+  unsigned GetNumOutput(struct fann *ann) override;
+
+  unsigned GetNumLayers(struct fann *ann) override;
+
+  void GetLayerArray(struct fann *ann, unsigned *layers) override;
+
+  void GetBiasArray(struct fann *ann, unsigned *bias) override;
+
+  unsigned GetTotalConnections(struct fann *ann) override;
+
+  void GetConnectionArray(struct fann *ann, struct fann_connection *connections) override;
+
+  enum fann_activationfunc_enum GetActivationFunction(struct fann *ann, int layer, int neuron) override;
+
+  fann_type GetActivationSteepness(struct fann *ann, int layer, int neuron) override;
+
   struct fann* CreateFromFile(const char *configuration_file) override;
 
   int Save(struct fann *ann, const char *configuration_file) override;
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "fann_train_data_guard.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace library
+{
+
+namespace fann
+{
+
+FannTrainDataGuard::FannTrainDataGuard(struct fann_train_data *data, detail::FannWrapperInterfacePtr fann_wrapper) :
+data_(data),
+fann_wrapper_(fann_wrapper) {
+}
+
+FannTrainDataGuard::~FannTrainDataGuard() {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannTrainDataGuard::~FannTrainDataGuard: Function call";
+
+  if (data_ != nullptr)
+    fann_wrapper_->DestroyTrainData(data_);
+}
+
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "detail/fann_wrapper_interface.h"
+
+namespace library
+{
+
+namespace fann
+{
+
+class FannTrainDataGuard {
+ public:
+  FannTrainDataGuard(struct fann_train_data *data, detail::FannWrapperInterfacePtr fann_wrapper);
+  virtual ~FannTrainDataGuard();
+
+ private:
+  struct fann_train_data *data_;
+  detail::FannWrapperInterfacePtr fann_wrapper_;
+};
+
+}
+
+}
@@ -6,7 +6,12 @@
 #include "fann_wrapper.h"
 #include "fann.h"
 
+#include <algorithm>
 #include <boost/log/trivial.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
 
 namespace library
 {
@@ -14,11 +19,32 @@ namespace library
 namespace fann
 {
 
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = {'S', 'L', 'A', 'S', 'F', 'T', 'D', '1'};
+
+struct SnapshotHeader {
+  char magic[8];
+  std::uint32_t num_data;
+  std::uint32_t num_input;
+  std::uint32_t num_output;
+  std::uint32_t value_size;
+};
+
+}
+
 FannWrapperPtr FannWrapper::Create() {
   BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::Create: Function call";
 
   auto fann = Fann::Create();
-  return FannWrapperPtr(new FannWrapper(fann));
+  return Create(fann);
+}
+
+FannWrapperPtr FannWrapper::Create(detail::FannInterfacePtr fann_interface) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::Create: Function call";
+
+  return FannWrapperPtr(new FannWrapper(fann_interface));
 }
 
 struct fann* FannWrapper::CreateStandard(unsigned num_layers, unsigned num_input,
@@ -52,12 +78,182 @@ void FannWrapper::TrainOnFile(struct fann *ann,
   fann_interface_->TrainOnFile(ann, filename.c_str(), max_epochs, epochs_between_reports, desired_error);
 }
 
+struct fann_train_data* FannWrapper::CreateTrainData(unsigned num_data, unsigned num_input, unsigned num_output,
+                                                    const TrainDataCallback &callback) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::CreateTrainData: Creating " << num_data << " rows";
+
+  struct fann_train_data *data = fann_interface_->CreateTrain(num_data, num_input, num_output);
+  if (data == nullptr)
+    return nullptr;
+
+  try {
+    for (unsigned row = 0; row < num_data; ++row) {
+      std::fill(data->input[row], data->input[row] + num_input, 0);
+      std::fill(data->output[row], data->output[row] + num_output, 0);
+      callback(row, data->input[row], data->output[row]);
+    }
+  }
+  catch (...) {
+    fann_interface_->DestroyTrain(data);
+    throw;
+  }
+
+  return data;
+}
+
+struct fann_train_data* FannWrapper::CreateTrainData(unsigned num_input, unsigned num_output,
+                                                    const std::vector<fann_type> &inputs,
+                                                    const std::vector<fann_type> &outputs) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::CreateTrainData: Function call";
+
+  if (num_input == 0 || num_output == 0 || inputs.size() % num_input != 0
+      || inputs.size() / num_input != outputs.size() / num_output || outputs.size() % num_output != 0)
+    throw std::invalid_argument("library::fann::FannWrapper::CreateTrainData: Inputs and outputs sizes don't match");
+
+  const unsigned num_data = inputs.size() / num_input;
+
+  return CreateTrainData(num_data, num_input, num_output, [&](unsigned row, fann_type *input, fann_type *output) {
+    std::copy_n(inputs.begin() + static_cast<std::size_t> (row) * num_input, num_input, input);
+    std::copy_n(outputs.begin() + static_cast<std::size_t> (row) * num_output, num_output, output);
+  });
+}
+
+void FannWrapper::TrainOnData(struct fann *ann,
+                              struct fann_train_data *data,
+                              unsigned int max_epochs,
+                              unsigned int epochs_between_reports,
+                              float desired_error) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::TrainOnData: Function call";
+
+  fann_interface_->TrainOnData(ann, data, max_epochs, epochs_between_reports, desired_error);
+}
+
+float FannWrapper::TrainEpoch(struct fann *ann, struct fann_train_data *data) {
+  return fann_interface_->TrainEpoch(ann, data);
+}
+
+float FannWrapper::TestData(struct fann *ann, struct fann_train_data *data) {
+  return fann_interface_->TestData(ann, data);
+}
+
+bool FannWrapper::SaveTrainDataSnapshot(struct fann_train_data *data, const std::string &file_path) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::SaveTrainDataSnapshot: Saving to " << file_path;
+
+  SnapshotHeader header;
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof (header.magic));
+  header.num_data = data->num_data;
+  header.num_input = data->num_input;
+  header.num_output = data->num_output;
+  header.value_size = sizeof (fann_type);
+
+  std::ofstream file(file_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+  file.write(reinterpret_cast<const char*> (&header), sizeof (header));
+
+  for (unsigned row = 0; row < data->num_data; ++row) {
+    file.write(reinterpret_cast<const char*> (data->input[row]), data->num_input * sizeof (fann_type));
+    file.write(reinterpret_cast<const char*> (data->output[row]), data->num_output * sizeof (fann_type));
+  }
+
+  return static_cast<bool> (file);
+}
+
+struct fann_train_data* FannWrapper::LoadTrainDataSnapshot(const std::string &file_path) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::LoadTrainDataSnapshot: Loading from " << file_path;
+
+  std::ifstream file(file_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+  const std::streamoff file_size = file ? static_cast<std::streamoff> (file.tellg()) : 0;
+  file.seekg(0);
+
+  SnapshotHeader header;
+  if (!file.read(reinterpret_cast<char*> (&header), sizeof (header))
+      || std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof (header.magic)) != 0
+      || header.value_size != sizeof (fann_type)) {
+    BOOST_LOG_TRIVIAL(warning) << "library::fann::FannWrapper::LoadTrainDataSnapshot: Invalid snapshot: " << file_path;
+    return nullptr;
+  }
+
+  // a damaged header must not make FANN allocate more than the file holds
+  const std::uint64_t data_size = file_size - sizeof (header);
+  const std::uint64_t row_size = (static_cast<std::uint64_t> (header.num_input) + header.num_output) * sizeof (fann_type);
+  if (header.num_input == 0 || header.num_output == 0
+      || data_size % row_size != 0 || data_size / row_size != header.num_data) {
+    BOOST_LOG_TRIVIAL(warning) << "library::fann::FannWrapper::LoadTrainDataSnapshot: Size doesn't match the header: " << file_path;
+    return nullptr;
+  }
+
+  struct fann_train_data *data = fann_interface_->CreateTrain(header.num_data, header.num_input, header.num_output);
+  if (data == nullptr)
+    return nullptr;
+
+  for (unsigned row = 0; row < header.num_data && file; ++row) {
+    file.read(reinterpret_cast<char*> (data->input[row]), header.num_input * sizeof (fann_type));
+    file.read(reinterpret_cast<char*> (data->output[row]), header.num_output * sizeof (fann_type));
+  }
+
+  if (!file) {
+    BOOST_LOG_TRIVIAL(warning) << "library::fann::FannWrapper::LoadTrainDataSnapshot: Truncated snapshot: " << file_path;
+    fann_interface_->DestroyTrain(data);
+    return nullptr;
+  }
+
+  return data;
+}
+
+void FannWrapper::DestroyTrainData(struct fann_train_data *data) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::DestroyTrainData: Function call";
+
+  fann_interface_->DestroyTrain(data);
+}
+
 struct fann* FannWrapper::CreateFromFile(const std::string &configuration_file) {
   BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::CreateFromFile: Function call";
 
   return fann_interface_->CreateFromFile(configuration_file.c_str());
 }
 
+struct fann* FannWrapper::Copy(struct fann *ann) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::Copy: Function call";
+
+  return fann_interface_->Copy(ann);
+}
+
+unsigned FannWrapper::GetNumInput(struct fann *ann) {
+  return fann_interface_->GetNumInput(ann);
+}
+
+unsigned FannWrapper::GetNumOutput(struct fann *ann) {
+  return fann_interface_->GetNumOutput(ann);
+}
+
+std::vector<unsigned> FannWrapper::GetLayerArray(struct fann *ann) {
+  std::vector<unsigned> layers(fann_interface_->GetNumLayers(ann));
+  fann_interface_->GetLayerArray(ann, layers.data());
+
+  return layers;
+}
+
+std::vector<unsigned> FannWrapper::GetBiasArray(struct fann *ann) {
+  std::vector<unsigned> bias(fann_interface_->GetNumLayers(ann));
+  fann_interface_->GetBiasArray(ann, bias.data());
+
+  return bias;
+}
+
+std::vector<struct fann_connection> FannWrapper::GetConnectionArray(struct fann *ann) {
+  std::vector<struct fann_connection> connections(fann_interface_->GetTotalConnections(ann));
+  fann_interface_->GetConnectionArray(ann, connections.data());
+
+  return connections;
+}
+
+enum fann_activationfunc_enum FannWrapper::GetActivationFunction(struct fann *ann, int layer, int neuron) {
+  return fann_interface_->GetActivationFunction(ann, layer, neuron);
+}
+
+fann_type FannWrapper::GetActivationSteepness(struct fann *ann, int layer, int neuron) {
+  return fann_interface_->GetActivationSteepness(ann, layer, neuron);
+}
+
 int FannWrapper::Save(struct fann *ann, const std::string &configuration_file) {
   BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::Save: Function call";
 
@@ -70,6 +266,10 @@ fann_type* FannWrapper::Run(struct fann *ann, fann_type *input) {
   return fann_interface_->Run(ann, input);
 }
 
+std::shared_ptr<DenseNetwork> FannWrapper::GetDenseNetwork(struct fann *) {
+  return std::shared_ptr<DenseNetwork>();
+}
+
 void FannWrapper::Destroy(struct fann *ann) {
   BOOST_LOG_TRIVIAL(debug) << "library::fann::FannWrapper::Destroy: Function call";
 
@@ -22,6 +22,7 @@ class FannWrapper : public detail::FannWrapperInterface {
   virtual ~FannWrapper() = default;
 
   static FannWrapperPtr Create();
+  static FannWrapperPtr Create(detail::FannInterfacePtr fann_interface);
 
   struct fann* CreateStandard(unsigned num_layers, unsigned num_input,
                               unsigned num_neurons_hidden, unsigned num_output) override;
@@ -38,12 +39,52 @@ class FannWrapper : public detail::FannWrapperInterface {
                    unsigned int epochs_between_reports,
                    float desired_error) override;
 
+  struct fann_train_data* CreateTrainData(unsigned num_data, unsigned num_input, unsigned num_output,
+                                         const TrainDataCallback &callback) override;
+
+  struct fann_train_data* CreateTrainData(unsigned num_input, unsigned num_output,
+                                         const std::vector<fann_type> &inputs,
+                                         const std::vector<fann_type> &outputs) override;
+
+  void TrainOnData(struct fann *ann,
+                   struct fann_train_data *data,
+                   unsigned int max_epochs,
+                   unsigned int epochs_between_reports,
+                   float desired_error) override;
+
+  float TrainEpoch(struct fann *ann, struct fann_train_data *data) override;
+
+  float TestData(struct fann *ann, struct fann_train_data *data) override;
+
+  bool SaveTrainDataSnapshot(struct fann_train_data *data, const std::string &file_path) override;
+  struct fann_train_data* LoadTrainDataSnapshot(const std::string &file_path) override;
+
+  void DestroyTrainData(struct fann_train_data *data) override;
+
   struct fann* CreateFromFile(const std::string &configuration_file) override;
 
+  struct fann* Copy(struct fann *ann) override;
+
+  unsigned GetNumInput(struct fann *ann) override;
+
+  unsigned GetNumOutput(struct fann *ann) override;
+
+  std::vector<unsigned> GetLayerArray(struct fann *ann) override;
+
+  std::vector<unsigned> GetBiasArray(struct fann *ann) override;
+
+  std::vector<struct fann_connection> GetConnectionArray(struct fann *ann) override;
+
+  enum fann_activationfunc_enum GetActivationFunction(struct fann *ann, int layer, int neuron) override;
+
+  fann_type GetActivationSteepness(struct fann *ann, int layer, int neuron) override;
+
   int Save(struct fann *ann, const std::string &configuration_file) override;
 
   fann_type* Run(struct fann *ann, fann_type *input) override;
 
+  std::shared_ptr<DenseNetwork> GetDenseNetwork(struct fann *ann) override;
+
   void Destroy(struct fann *ann) override;
 
  private:
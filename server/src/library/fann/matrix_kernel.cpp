@@ -0,0 +1,209 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "matrix_kernel.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SLAS_HAVE_AVX2_FMA_KERNEL
+#include <immintrin.h>
+#endif
+
+namespace library
+{
+
+namespace fann
+{
+
+namespace
+{
+
+typedef void (*MultiplyAddFunction)(const float*, std::size_t, const float*, float*, std::size_t, unsigned, unsigned);
+typedef void (*MultiplyAddInt8Function)(const float*, std::size_t, const std::int8_t*, float*, std::size_t, unsigned, unsigned);
+
+void MultiplyAddInt8Columns(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                            std::size_t rows, unsigned k, unsigned n, unsigned begin) {
+  for (std::size_t i = 0; i < rows; ++i) {
+    const float *a_row = a + i * a_stride;
+    float *c_row = c + i * n;
+
+    for (unsigned p = 0; p < k; ++p) {
+      const float value = a_row[p];
+      if (value == 0)
+        continue;
+
+      const std::int8_t *b_row = b + static_cast<std::size_t> (p) * n;
+      for (unsigned j = begin; j < n; ++j)
+        c_row[j] += value * b_row[j];
+    }
+  }
+}
+
+#ifdef SLAS_HAVE_AVX2_FMA_KERNEL
+
+__attribute__((target("avx2,fma")))
+__m256i Mask(int count) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Columns are taken 32 at a time, a row of c stays in four registers while
+// the row of a is multiplied with b. Masked loads handle the last columns.
+__attribute__((target("avx2,fma")))
+void MultiplyAddAvx2Impl(const float *a, std::size_t a_stride, const float *b, float *c,
+                         std::size_t rows, unsigned k, unsigned n) {
+  for (unsigned j = 0; j < n; j += 32) {
+    const int width = std::min(32u, n - j);
+    const __m256i m0 = Mask(width);
+    const __m256i m1 = Mask(width - 8);
+    const __m256i m2 = Mask(width - 16);
+    const __m256i m3 = Mask(width - 24);
+
+    for (std::size_t i = 0; i < rows; ++i) {
+      const float *a_row = a + i * a_stride;
+      float *c_row = c + i * n + j;
+
+      __m256 c0 = _mm256_maskload_ps(c_row, m0);
+      __m256 c1 = _mm256_maskload_ps(c_row + 8, m1);
+      __m256 c2 = _mm256_maskload_ps(c_row + 16, m2);
+      __m256 c3 = _mm256_maskload_ps(c_row + 24, m3);
+
+      for (unsigned p = 0; p < k; ++p) {
+        if (a_row[p] == 0)
+          continue;
+
+        const __m256 value = _mm256_set1_ps(a_row[p]);
+        const float *b_row = b + static_cast<std::size_t> (p) * n + j;
+
+        c0 = _mm256_fmadd_ps(value, _mm256_maskload_ps(b_row, m0), c0);
+        c1 = _mm256_fmadd_ps(value, _mm256_maskload_ps(b_row + 8, m1), c1);
+        c2 = _mm256_fmadd_ps(value, _mm256_maskload_ps(b_row + 16, m2), c2);
+        c3 = _mm256_fmadd_ps(value, _mm256_maskload_ps(b_row + 24, m3), c3);
+      }
+
+      _mm256_maskstore_ps(c_row, m0, c0);
+      _mm256_maskstore_ps(c_row + 8, m1, c1);
+      _mm256_maskstore_ps(c_row + 16, m2, c2);
+      _mm256_maskstore_ps(c_row + 24, m3, c3);
+    }
+  }
+}
+
+// Columns are taken 8 at a time, weights are widened to floats in the
+// register. The last n % 8 columns are computed without vectors, so the
+// int8 rows are never read past their end.
+__attribute__((target("avx2,fma")))
+void MultiplyAddInt8Avx2Impl(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                             std::size_t rows, unsigned k, unsigned n) {
+  const unsigned vectorized_n = n - n % 8;
+
+  for (unsigned j = 0; j < vectorized_n; j += 8) {
+    for (std::size_t i = 0; i < rows; ++i) {
+      const float *a_row = a + i * a_stride;
+      float *c_row = c + i * n + j;
+      __m256 sum = _mm256_loadu_ps(c_row);
+
+      for (unsigned p = 0; p < k; ++p) {
+        if (a_row[p] == 0)
+          continue;
+
+        const std::int8_t *b_row = b + static_cast<std::size_t> (p) * n + j;
+        const __m256 weights = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*> (b_row))));
+
+        sum = _mm256_fmadd_ps(_mm256_set1_ps(a_row[p]), weights, sum);
+      }
+
+      _mm256_storeu_ps(c_row, sum);
+    }
+  }
+
+  MultiplyAddInt8Columns(a, a_stride, b, c, rows, k, n, vectorized_n);
+}
+
+#endif
+
+MultiplyAddFunction SelectMultiplyAddFunction() {
+  if (IsAvx2FmaSupported()) {
+    BOOST_LOG_TRIVIAL(info) << "library::fann::SelectMultiplyAddFunction: Using AVX2 matrix kernel";
+    return MultiplyAddAvx2;
+  }
+
+  BOOST_LOG_TRIVIAL(info) << "library::fann::SelectMultiplyAddFunction: Using scalar matrix kernel";
+  return MultiplyAddScalar;
+}
+
+MultiplyAddInt8Function SelectMultiplyAddInt8Function() {
+  return IsAvx2FmaSupported() ? MultiplyAddInt8Avx2 : MultiplyAddInt8Scalar;
+}
+
+}
+
+void MultiplyAdd(const float *a, std::size_t a_stride, const float *b, float *c,
+                 std::size_t rows, unsigned k, unsigned n) {
+  static const MultiplyAddFunction function = SelectMultiplyAddFunction();
+
+  function(a, a_stride, b, c, rows, k, n);
+}
+
+void MultiplyAddScalar(const float *a, std::size_t a_stride, const float *b, float *c,
+                       std::size_t rows, unsigned k, unsigned n) {
+  for (std::size_t i = 0; i < rows; ++i) {
+    const float *a_row = a + i * a_stride;
+    float *c_row = c + i * n;
+
+    for (unsigned p = 0; p < k; ++p) {
+      const float value = a_row[p];
+      if (value == 0)
+        continue;
+
+      const float *b_row = b + static_cast<std::size_t> (p) * n;
+      for (unsigned j = 0; j < n; ++j)
+        c_row[j] += value * b_row[j];
+    }
+  }
+}
+
+void MultiplyAddAvx2(const float *a, std::size_t a_stride, const float *b, float *c,
+                     std::size_t rows, unsigned k, unsigned n) {
+#ifdef SLAS_HAVE_AVX2_FMA_KERNEL
+  MultiplyAddAvx2Impl(a, a_stride, b, c, rows, k, n);
+#else
+  MultiplyAddScalar(a, a_stride, b, c, rows, k, n);
+#endif
+}
+
+void MultiplyAddInt8(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                     std::size_t rows, unsigned k, unsigned n) {
+  static const MultiplyAddInt8Function function = SelectMultiplyAddInt8Function();
+
+  function(a, a_stride, b, c, rows, k, n);
+}
+
+void MultiplyAddInt8Scalar(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                           std::size_t rows, unsigned k, unsigned n) {
+  MultiplyAddInt8Columns(a, a_stride, b, c, rows, k, n, 0);
+}
+
+void MultiplyAddInt8Avx2(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                         std::size_t rows, unsigned k, unsigned n) {
+#ifdef SLAS_HAVE_AVX2_FMA_KERNEL
+  MultiplyAddInt8Avx2Impl(a, a_stride, b, c, rows, k, n);
+#else
+  MultiplyAddInt8Scalar(a, a_stride, b, c, rows, k, n);
+#endif
+}
+
+bool IsAvx2FmaSupported() {
+#ifdef SLAS_HAVE_AVX2_FMA_KERNEL
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+  return false;
+#endif
+}
+
+}
+
+}
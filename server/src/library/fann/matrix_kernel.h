@@ -0,0 +1,45 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace library
+{
+
+namespace fann
+{
+
+// c += a * b, where a has rows x k values with rows a_stride apart, b has
+// k x n values and c has rows x n values. Zeros in a are skipped, so sparse
+// inputs cost less. The implementation (AVX2/FMA or scalar) is selected
+// once, at first call.
+void MultiplyAdd(const float *a, std::size_t a_stride, const float *b, float *c,
+                 std::size_t rows, unsigned k, unsigned n);
+
+void MultiplyAddScalar(const float *a, std::size_t a_stride, const float *b, float *c,
+                       std::size_t rows, unsigned k, unsigned n);
+
+void MultiplyAddAvx2(const float *a, std::size_t a_stride, const float *b, float *c,
+                     std::size_t rows, unsigned k, unsigned n);
+
+// c += a * b, where b has int8 weights; columns of c must be scaled by
+// the caller.
+void MultiplyAddInt8(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                     std::size_t rows, unsigned k, unsigned n);
+
+void MultiplyAddInt8Scalar(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                           std::size_t rows, unsigned k, unsigned n);
+
+void MultiplyAddInt8Avx2(const float *a, std::size_t a_stride, const std::int8_t *b, float *c,
+                         std::size_t rows, unsigned k, unsigned n);
+
+bool IsAvx2FmaSupported();
+
+}
+
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include "network_file.h"
+
+#include <boost/log/trivial.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace library
+{
+
+namespace fann
+{
+
+namespace
+{
+
+const std::string FLOAT_VERSION_PREFIX = "FANN_FLO_";
+const std::string NEURONS_KEY = "neurons (num_inputs, activation_function, activation_steepness)";
+const std::string CONNECTIONS_KEY = "connections (connected_to_neuron, weight)";
+
+struct Neuron {
+  unsigned num_inputs;
+  unsigned activation_function;
+  float steepness;
+};
+
+struct Connection {
+  unsigned from_neuron;
+  float weight;
+};
+
+// (num_inputs, activation_function, activation_steepness) (...) ...
+bool ReadNeurons(const std::string &text, std::vector<Neuron> &neurons) {
+  std::istringstream stream(text);
+  Neuron neuron;
+  char open, first_comma, second_comma, close;
+
+  while (stream >> open) {
+    if (open != '('
+        || !(stream >> neuron.num_inputs >> first_comma >> neuron.activation_function >> second_comma >> neuron.steepness >> close)
+        || first_comma != ',' || second_comma != ',' || close != ')')
+      return false;
+
+    neurons.push_back(neuron);
+  }
+
+  return true;
+}
+
+// (connected_to_neuron, weight) (...) ...
+bool ReadConnections(const std::string &text, std::vector<Connection> &connections) {
+  std::istringstream stream(text);
+  Connection connection;
+  char open, comma, close;
+
+  while (stream >> open) {
+    if (open != '('
+        || !(stream >> connection.from_neuron >> comma >> connection.weight >> close)
+        || comma != ',' || close != ')')
+      return false;
+
+    connections.push_back(connection);
+  }
+
+  return true;
+}
+
+}
+
+bool ReadNetworkFile(std::istream &stream, DenseNetwork::Layers &layers) {
+  BOOST_LOG_TRIVIAL(debug) << "library::fann::ReadNetworkFile: Function call";
+
+  std::string line;
+  if (!std::getline(stream, line) || line.compare(0, FLOAT_VERSION_PREFIX.size(), FLOAT_VERSION_PREFIX) != 0)
+    return false;
+
+  std::map<std::string, std::string> values;
+  while (std::getline(stream, line)) {
+    const auto separator = line.find('=');
+    if (separator != std::string::npos)
+      values[line.substr(0, separator)] = line.substr(separator + 1);
+  }
+
+  // shortcut networks connect every layer with all previous layers
+  if (values.count("network_type") && values["network_type"] != "0")
+    return false;
+
+  // sizes of layers with their bias neurons
+  std::vector<unsigned> layer_sizes;
+  std::istringstream layer_sizes_stream(values["layer_sizes"]);
+  unsigned layer_size;
+  while (layer_sizes_stream >> layer_size) {
+    if (layer_size < 2)
+      return false;
+    layer_sizes.push_back(layer_size);
+  }
+
+  std::vector<Neuron> neurons;
+  std::vector<Connection> connections;
+  if (layer_sizes.size() < 2
+      || !ReadNeurons(values[NEURONS_KEY], neurons)
+      || !ReadConnections(values[CONNECTIONS_KEY], connections))
+    return false;
+
+  // neurons are numbered layer after layer, the bias neuron is the last one in its layer
+  std::vector<unsigned> first_neuron(layer_sizes.size() + 1, 0);
+  for (std::size_t l = 0; l < layer_sizes.size(); ++l)
+    first_neuron[l + 1] = first_neuron[l] + layer_sizes[l];
+
+  if (neurons.size() != first_neuron.back())
+    return false;
+
+  DenseNetwork::Layers read_layers(layer_sizes.size() - 1);
+  for (std::size_t l = 1; l < layer_sizes.size(); ++l) {
+    DenseNetwork::Layer &layer = read_layers[l - 1];
+    layer.num_input = layer_sizes[l - 1] - 1;
+    layer.num_output = layer_sizes[l] - 1;
+    layer.weights.assign(static_cast<std::size_t> (layer.num_input) * layer.num_output, 0);
+    layer.bias.assign(layer.num_output, 0);
+
+    const Neuron &first = neurons[first_neuron[l]];
+    layer.activation_function = static_cast<enum fann_activationfunc_enum> (first.activation_function);
+    layer.steepness = first.steepness;
+
+    for (unsigned neuron = 1; neuron < layer.num_output; ++neuron) {
+      const Neuron &n = neurons[first_neuron[l] + neuron];
+      if (n.activation_function != first.activation_function || n.steepness != first.steepness)
+        return false;
+    }
+
+    if (!DenseNetwork::IsActivationFunctionSupported(layer.activation_function) || layer.steepness <= 0)
+      return false;
+  }
+
+  // connections are saved neuron after neuron, num_inputs of every neuron
+  std::size_t connection = 0;
+  for (std::size_t l = 0; l < layer_sizes.size(); ++l) {
+    for (unsigned neuron = 0; neuron < layer_sizes[l]; ++neuron) {
+      const unsigned num_inputs = neurons[first_neuron[l] + neuron].num_inputs;
+      if (num_inputs == 0)
+        continue;
+
+      if (l == 0 || neuron + 1 == layer_sizes[l] || connection + num_inputs > connections.size())
+        return false;
+
+      DenseNetwork::Layer &layer = read_layers[l - 1];
+      for (unsigned i = 0; i < num_inputs; ++i, ++connection) {
+        const unsigned from_neuron = connections[connection].from_neuron;
+        if (from_neuron < first_neuron[l - 1] || from_neuron >= first_neuron[l])
+          return false;
+
+        const unsigned from = from_neuron - first_neuron[l - 1];
+        if (from == layer.num_input)
+          layer.bias[neuron] = connections[connection].weight;
+        else
+          layer.weights[static_cast<std::size_t> (from) * layer.num_output + neuron] = connections[connection].weight;
+      }
+    }
+  }
+
+  if (connection != connections.size())
+    return false;
+
+  layers.swap(read_layers);
+  return true;
+}
+
+}
+
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include <istream>
+
+#include "dense_network.h"
+
+namespace library
+{
+
+namespace fann
+{
+
+// Reads layers of a network saved by fann_save in the floating point
+// format. Returns false when the stream isn't a FANN network file or the
+// network has connections skipping layers, different activation functions
+// in one layer or activation functions DenseNetwork doesn't support.
+bool ReadNetworkFile(std::istream &stream, DenseNetwork::Layers &layers);
+
+}
+
+}
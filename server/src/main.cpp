@@ -6,6 +6,7 @@
 #include <thread>
 
 #include <slas/dbus/bus.h>
+#include <slas/network/network.h>
 #include <slas/type/exception/exception.h>
 #include <slas/util/demonize.h>
 #include <slas/util/configure_logger.h>
@@ -25,15 +26,24 @@
 #include "src/bash/dbus/object/bash.h"
 
 #include "analyzer/analyzer.h"
+#include "analyzer/stage_metrics.h"
+#include "analyzer/worker_pool.h"
+#include "analyzer/web/command_executor_object.h"
 #include "apache/analyzer/apache_analyzer_object.h"
+#include "apache/analyzer/sessionizer_analyzer_object.h"
+#include "apache/analyzer/traffic_counter.h"
 
 #include "src/bash/database/database_functions.h"
 #include "src/bash/domain/scripts.h"
+#include "src/bash/domain/detail/command_normalizer.h"
 #include "src/bash/domain/web_scripts.h"
 #include "src/bash/web/command_executor_object.h"
 
 #include "notifier/notifier.h"
 #include "bash/analyzer/bash_analyzer_object.h"
+#include "bash/analyzer/command_sequence_model.h"
+#include "library/fann/dense_fann_wrapper.h"
+#include "library/fann/fann_wrapper.h"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -70,6 +80,19 @@ database::DatabasePtr CreateDatabase(database::SQLiteWrapperPtr sqlite_wrapper)
   return database;
 }
 
+library::fann::detail::FannWrapperInterfacePtr CreateFannWrapper(program_options::type::InferenceEngine engine) {
+  switch (engine) {
+    case program_options::type::InferenceEngine::DENSE:
+      return library::fann::DenseFannWrapper::Create(library::fann::DenseNetwork::Precision::FLOAT32);
+
+    case program_options::type::InferenceEngine::DENSE_INT8:
+      return library::fann::DenseFannWrapper::Create(library::fann::DenseNetwork::Precision::INT8);
+
+    default:
+      return library::fann::FannWrapper::Create();
+  }
+}
+
 int
 main(int argc, char *argv[]) {
   program_options::Parser p;
@@ -80,6 +103,7 @@ main(int argc, char *argv[]) {
   database::DatabasePtr database;
   database::GeneralDatabaseFunctionsPtr general_database_functions;
   apache::database::DatabaseFunctionsPtr apache_database_functions;
+  apache::analyzer::TrafficCounterPtr apache_traffic_counter;
 
   try {
     p.SetCommandLineOptions(argc, argv);
@@ -122,6 +146,9 @@ main(int argc, char *argv[]) {
 
     sqlite_wrapper = database::SQLiteWrapper::Create();
     sqlite_wrapper->Open(options.GetDatabasefilePath());
+    // analyzer tasks read through their own connections while changes are
+    // written through this one
+    sqlite_wrapper->Exec("PRAGMA journal_mode=WAL;");
     database = CreateDatabase(sqlite_wrapper);
     general_database_functions = database::GeneralDatabaseFunctions::Create(database,
                                                                             sqlite_wrapper);
@@ -131,14 +158,31 @@ main(int argc, char *argv[]) {
                                                                             general_database_functions);
     apache_database_functions->CreateTables();
 
+    auto apache_sessionizer = apache::analyzer::StreamingSessionizer::Create(apache_database_functions);
+    apache_sessionizer->Restore();
+
+    apache_traffic_counter = apache::analyzer::TrafficCounter::Create(apache_database_functions);
+
+    // web commands and dbus objects need it, analyzer objects are added later
+    analyzer_worker = analyzer::Analyzer::Create();
+    auto stage_metrics = analyzer::StageMetrics::Create();
+    // shared by the apache analyzer and the web commands evaluating it
+    auto apache_worker_pool = analyzer::WorkerPool::Create();
+
     auto options_command_object = program_options::web::CommandExecutorObject::Create(options);
     auto command_executor = web::CommandExecutor::Create();
     auto apache_web_command_executor = apache::web::CommandExecutorObject::Create(database,
                                                                                   general_database_functions,
-                                                                                  apache_database_functions);
+                                                                                  apache_database_functions,
+                                                                                  apache_worker_pool);
     command_executor->RegisterCommandObject(options_command_object);
     command_executor->RegisterCommandObject(apache_web_command_executor);
-    command_receiver = web::CommandReceiver::Create(command_executor);
+    command_executor->RegisterCommandObject(analyzer::web::CommandExecutorObject::Create(analyzer_worker, stage_metrics));
+    command_receiver = web::CommandReceiver::Create(command_executor,
+                                                    network::Network::Create(options.GetWebListenBacklog()),
+                                                    options.GetWebWorkers(),
+                                                    std::chrono::seconds(options.GetWebCommandTimeout()),
+                                                    web::CommandReceiver::ParseCommandTimeouts(options.GetWebCommandTimeouts()));
     command_receiver->OpenPort(options.GetWebAddress(), options.GetWebPort());
 
     bus = std::make_shared<dbus::Bus>(dbus::Bus::Options(options.GetDbusAddress(),
@@ -151,18 +195,33 @@ main(int argc, char *argv[]) {
                                                                                general_database_functions);
     bash_database_functions->CreateTables();
 
+    // messages are queued until the notifier loop is started
+    notifier_worker = notifier::Notifier::Create(options);
+
+    auto bash_command_normalizer = ::bash::domain::detail::CommandNormalizer::Create(::bash::domain::detail::CommandNormalizer::ParseRules(options.GetBashCommandRules()),
+                                                                                      options.GetBashMaxCommands());
+
     auto bash_scripts = ::bash::domain::Scripts::Create(bash_database_functions,
-                                                        general_database_functions);
+                                                        general_database_functions,
+                                                        ::bash::analyzer::CommandSequenceModel::Create(notifier_worker),
+                                                        bash_command_normalizer);
+    bash_scripts->NormalizeCommands();
 
     auto bash_web_scripts = ::bash::domain::WebScripts::Create(bash_scripts);
 
     auto bash_web_command_executor = bash::web::CommandExecutorObject::Create(bash_web_scripts);
     command_executor->RegisterCommandObject(bash_web_command_executor);
 
-    bash_object = std::make_shared<bash::dbus::object::Bash>(bash_scripts);
+    bash_object = std::make_shared<bash::dbus::object::Bash>(bash_scripts, analyzer_worker);
     bus->RegisterObject(bash_object);
 
-    apache_object = std::make_shared<apache::dbus::object::Apache>(database, general_database_functions, apache_database_functions);
+    auto apache_realtime_scorer = apache::analyzer::RealtimeScorer::Create(general_database_functions,
+                                                                         apache_database_functions,
+                                                                         notifier_worker);
+
+    apache_object = std::make_shared<apache::dbus::object::Apache>(database, general_database_functions, apache_database_functions,
+                                                                   apache_sessionizer, apache_realtime_scorer,
+                                                                   apache_traffic_counter, analyzer_worker);
     bus->RegisterObject(apache_object);
 
     util::CreatePidFile(options.GetPidfilePath());
@@ -180,20 +239,31 @@ main(int argc, char *argv[]) {
     act_usr.sa_flags = SA_SIGINFO;
     sigaction(SIGUSR1, &act_usr, nullptr);
 
-    notifier_worker = notifier::Notifier::Create(options);
+    // web clients may close connections before their responses are sent
+    signal(SIGPIPE, SIG_IGN);
+
     notifier_thread = std::thread([]() {
       notifier_worker->Loop();
     });
 
-    analyzer_worker = analyzer::Analyzer::Create();
+    analyzer_worker->AddObject(apache::analyzer::SessionizerAnalyzerObject::Create(apache_sessionizer, stage_metrics));
+
     analyzer_worker->AddObject(apache::analyzer::ApacheAnalyzerObject::Create(general_database_functions,
                                                                               apache_database_functions,
-                                                                              notifier_worker));
+                                                                              notifier_worker,
+                                                                              apache::database::ReadConnectionPool::Create(options.GetDatabasefilePath()),
+                                                                              apache_worker_pool,
+                                                                              apache_sessionizer,
+                                                                              options.GetDatabasefilePath(),
+                                                                              stage_metrics));
 
     analyzer_worker->AddObject(bash::analyzer::BashAnalyzerObject::Create(bash_database_functions,
                                                                           general_database_functions,
                                                                           bash_scripts,
-                                                                          options.GetNeuralNetworkDataDirectory()));
+                                                                          options.GetNeuralNetworkDataDirectory(),
+                                                                          options.IsDebug(),
+                                                                          CreateFannWrapper(options.GetBashInferenceEngine()),
+                                                                          stage_metrics));
 
     analyzer_thread = std::thread([]() {
       analyzer_worker->StartLoop();
@@ -223,6 +293,10 @@ main(int argc, char *argv[]) {
     if (bus)
       bus->Disconnect();
 
+    // logs counted after the last save
+    if (apache_traffic_counter)
+      apache_traffic_counter->Flush();
+
     if (sqlite_wrapper)
       sqlite_wrapper->Close();
 
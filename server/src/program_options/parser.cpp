@@ -23,8 +23,15 @@ help_options_("Help options") {
       ("logfile", value<string>(), "logfile path")
       ("databasefile", value<string>(), "database file path")
       ("neural_network_data_directory", value<string>(), "neural network data directory")
+      ("bash_inference_engine", value<string>()->default_value("DENSE"), "bash networks are run by FANN, DENSE or DENSE_INT8")
+      ("bash_command_rules", value<string>()->default_value("/tmp/*=<tmp>,/var/tmp/*=<tmp>,/dev/shm/*=<tmp>"), "bash command naming rules, pattern=name,...")
+      ("bash_max_commands", value<unsigned>()->default_value(4096), "maximum number of different bash commands")
       ("web_address", value<string>(), "web listen address")
       ("web_port", value<unsigned>(), "web listen port")
+      ("web_listen_backlog", value<unsigned>()->default_value(20), "web pending connections queue length")
+      ("web_workers", value<unsigned>()->default_value(4), "number of threads executing web commands")
+      ("web_command_timeout", value<unsigned>()->default_value(50), "web command timeout in seconds")
+      ("web_command_timeouts", value<string>()->default_value(""), "web command timeouts in seconds, command=seconds,...")
       ("mail_server_secure", value<string>(), "connection type NONE, SSL, STARTTLS")
       ("mail_server_address", value<string>(), "smtp server address")
       ("mail_server_port", value<unsigned>(), "mail server port")
@@ -87,8 +94,15 @@ Options Parser::Parse() {
                                     !static_cast<bool> (variables.count("nodaemon")),
                                     variables["databasefile"].as<string>(),
                                     variables["neural_network_data_directory"].as<string>(),
+                                    ToInferenceEngine(variables["bash_inference_engine"].as<string>()),
+                                    variables["bash_command_rules"].as<string>(),
+                                    variables["bash_max_commands"].as<unsigned>(),
                                     variables["web_address"].as<string>(),
                                     variables["web_port"].as<unsigned>(),
+                                    variables["web_listen_backlog"].as<unsigned>(),
+                                    variables["web_workers"].as<unsigned>(),
+                                    variables["web_command_timeout"].as<unsigned>(),
+                                    variables["web_command_timeouts"].as<string>(),
                                     ToSecurityOption(variables["mail_server_secure"].as<string>()),
                                     variables["mail_server_address"].as<string>(),
                                     variables["mail_server_port"].as<unsigned>(),
@@ -110,4 +124,13 @@ type::SecurityOption Parser::ToSecurityOption(const std::string &s) {
   return stso.at(s);
 }
 
+type::InferenceEngine Parser::ToInferenceEngine(const std::string &s) {
+  std::map<string, type::InferenceEngine> stie;
+  stie["FANN"] = type::InferenceEngine::FANN;
+  stie["DENSE"] = type::InferenceEngine::DENSE;
+  stie["DENSE_INT8"] = type::InferenceEngine::DENSE_INT8;
+
+  return stie.at(s);
+}
+
 }
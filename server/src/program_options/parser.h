@@ -30,6 +30,7 @@ class Parser {
   options_description general_options_, help_options_, all_options_;
 
   type::SecurityOption ToSecurityOption(const std::string &s);
+  type::InferenceEngine ToInferenceEngine(const std::string &s);
 };
 
 }
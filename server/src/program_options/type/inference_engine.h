@@ -0,0 +1,22 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+namespace program_options
+{
+
+namespace type
+{
+
+enum class InferenceEngine {
+  FANN,
+  DENSE,
+  DENSE_INT8
+};
+
+}
+
+}
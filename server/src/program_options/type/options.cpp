@@ -7,7 +7,12 @@ namespace type
 {
 
 Options::Options()
-: web_port_(0),
+: bash_inference_engine_(InferenceEngine::DENSE),
+bash_max_commands_(0),
+web_port_(0),
+web_listen_backlog_(0),
+web_workers_(0),
+web_command_timeout_(0),
 dbus_port_(0),
 show_help_message_(false),
 daemon_(false) {
@@ -23,8 +28,15 @@ const Options Options::Create(const std::string &run_as_user,
                               bool daemon,
                               const std::string &databasefile_path,
                               const std::string &neural_network_data_directory,
+                              InferenceEngine bash_inference_engine,
+                              const std::string &bash_command_rules,
+                              unsigned bash_max_commands,
                               const std::string &web_address,
                               unsigned web_port,
+                              unsigned web_listen_backlog,
+                              unsigned web_workers,
+                              unsigned web_command_timeout,
+                              const std::string &web_command_timeouts,
                               SecurityOption mail_server_secure,
                               std::string mail_server_address,
                               unsigned mail_server_port,
@@ -44,8 +56,15 @@ const Options Options::Create(const std::string &run_as_user,
   options.daemon_ = daemon;
   options.databasefile_path_ = databasefile_path;
   options.neural_network_data_directory_ = neural_network_data_directory;
+  options.bash_inference_engine_ = bash_inference_engine;
+  options.bash_command_rules_ = bash_command_rules;
+  options.bash_max_commands_ = bash_max_commands;
   options.web_address_ = web_address;
   options.web_port_ = web_port;
+  options.web_listen_backlog_ = web_listen_backlog;
+  options.web_workers_ = web_workers;
+  options.web_command_timeout_ = web_command_timeout;
+  options.web_command_timeouts_ = web_command_timeouts;
   options.mail_server_secure_ = mail_server_secure;
   options.mail_server_address_ = mail_server_address;
   options.mail_server_port_ = mail_server_port;
@@ -102,6 +121,18 @@ const std::string& Options::GetNeuralNetworkDataDirectory() const {
   return neural_network_data_directory_;
 }
 
+InferenceEngine Options::GetBashInferenceEngine() const {
+  return bash_inference_engine_;
+}
+
+const std::string& Options::GetBashCommandRules() const {
+  return bash_command_rules_;
+}
+
+unsigned Options::GetBashMaxCommands() const {
+  return bash_max_commands_;
+}
+
 const std::string& Options::GetWebAddress() const {
   return web_address_;
 }
@@ -110,6 +141,22 @@ const unsigned& Options::GetWebPort() const {
   return web_port_;
 }
 
+unsigned Options::GetWebListenBacklog() const {
+  return web_listen_backlog_;
+}
+
+unsigned Options::GetWebWorkers() const {
+  return web_workers_;
+}
+
+unsigned Options::GetWebCommandTimeout() const {
+  return web_command_timeout_;
+}
+
+const std::string& Options::GetWebCommandTimeouts() const {
+  return web_command_timeouts_;
+}
+
 SecurityOption Options::GetMailServerSecure() const {
   return mail_server_secure_;
 }
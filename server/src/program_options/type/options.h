@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include "inference_engine.h"
 #include "security_option.h"
 
 namespace program_options
@@ -24,8 +25,15 @@ class Options {
                               bool daemon,
                               const std::string &databasefile_path,
                               const std::string &neural_network_data_directory,
+                              InferenceEngine bash_inference_engine,
+                              const std::string &bash_command_rules,
+                              unsigned bash_max_commands,
                               const std::string &web_address,
                               unsigned web_port,
+                              unsigned web_listen_backlog,
+                              unsigned web_workers,
+                              unsigned web_command_timeout,
+                              const std::string &web_command_timeouts,
                               SecurityOption mail_server_secure,
                               std::string mail_server_address,
                               unsigned mail_server_port,
@@ -49,9 +57,16 @@ class Options {
 
   const std::string& GetDatabasefilePath() const;
   const std::string& GetNeuralNetworkDataDirectory() const;
+  InferenceEngine GetBashInferenceEngine() const;
+  const std::string& GetBashCommandRules() const;
+  unsigned GetBashMaxCommands() const;
 
   const std::string& GetWebAddress() const;
   const unsigned& GetWebPort() const;
+  unsigned GetWebListenBacklog() const;
+  unsigned GetWebWorkers() const;
+  unsigned GetWebCommandTimeout() const;
+  const std::string& GetWebCommandTimeouts() const;
 
   SecurityOption GetMailServerSecure() const;
   const std::string& GetMailServerAddress() const;
@@ -67,9 +82,16 @@ class Options {
   std::string logfile_path_;
   std::string databasefile_path_;
   std::string neural_network_data_directory_;
+  InferenceEngine bash_inference_engine_;
+  std::string bash_command_rules_;
+  unsigned bash_max_commands_;
 
   std::string web_address_;
   unsigned web_port_;
+  unsigned web_listen_backlog_;
+  unsigned web_workers_;
+  unsigned web_command_timeout_;
+  std::string web_command_timeouts_;
 
   SecurityOption mail_server_secure_;
   std::string mail_server_address_;
@@ -1,16 +1,42 @@
 #include "command_receiver.h"
 
+#include <algorithm>
 #include <boost/log/trivial.hpp>
+#include <cerrno>
+#include <cstring>
+#include <json/json.hpp>
 #include <slas/network/network.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
+#include "exception/detail/cant_listen_exception.h"
 #include "exception/detail/connection_is_already_open_exception.h"
 #include "exception/detail/port_is_closed_exception.h"
+#include "exception/detail/wrong_command_timeout_exception.h"
 
 using namespace std;
+using namespace nlohmann;
 
 namespace web
 {
 
+namespace
+{
+
+constexpr int MAX_EVENTS = 16;
+constexpr int CHECK_INTERVAL_MS = 200;
+
+const ::web::type::JsonMessage TIMEOUT_ERROR_JSON = "{ \"status\" : \"error\", \"message\" : \"Timeout\" }";
+const ::web::type::JsonMessage COMMAND_FAILED_ERROR_JSON = "{ \"status\" : \"error\", \"message\" : \"Command failed\" }";
+
+}
+
+constexpr unsigned CommandReceiver::WORKERS_COUNT;
+constexpr std::chrono::seconds CommandReceiver::COMMAND_TIMEOUT;
+constexpr std::chrono::seconds CommandReceiver::IDLE_TIMEOUT;
+constexpr std::size_t CommandReceiver::MAX_CONNECTIONS;
+
 CommandReceiverPtr CommandReceiver::Create(detail::CommandExecutorInterfacePtr command_executor) {
   auto n = network::Network::Create();
   return Create(command_executor, n);
@@ -18,7 +44,15 @@ CommandReceiverPtr CommandReceiver::Create(detail::CommandExecutorInterfacePtr c
 
 CommandReceiverPtr CommandReceiver::Create(detail::CommandExecutorInterfacePtr command_executor,
                                            network::detail::NetworkInterfacePtr network) {
-  auto p = CommandReceiverPtr(new CommandReceiver(command_executor, network));
+  return Create(command_executor, network, WORKERS_COUNT, COMMAND_TIMEOUT, type::CommandTimeouts());
+}
+
+CommandReceiverPtr CommandReceiver::Create(detail::CommandExecutorInterfacePtr command_executor,
+                                           network::detail::NetworkInterfacePtr network,
+                                           unsigned workers_count,
+                                           std::chrono::seconds command_timeout,
+                                           const type::CommandTimeouts &command_timeouts) {
+  auto p = CommandReceiverPtr(new CommandReceiver(command_executor, network, workers_count, command_timeout, command_timeouts));
   return p;
 }
 
@@ -55,24 +89,50 @@ void CommandReceiver::StartListen() {
     throw web::exception::detail::PortIsClosedException();
   }
 
-  network::WaitStatus wait_status;
-  network::ConnectionData client_connection;
-  is_listen_ = true;
-  while (is_listen_) {
-    wait_status = network_->WaitForData(socket_, 3);
+  epoll_socket_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_socket_ < 0) {
+    BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::StartListen: epoll_create1 error: " << strerror(errno);
+    throw exception::detail::CantListenException();
+  }
 
-    if (wait_status == network::WaitStatus::NEW_DATA) {
-      BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::StartListen: New data on socket";
-      client_connection = network_->Accept(socket_);
+  struct epoll_event event;
+  memset(&event, 0, sizeof (event));
+  event.events = EPOLLIN;
+  event.data.fd = socket_;
+  if (epoll_ctl(epoll_socket_, EPOLL_CTL_ADD, socket_, &event) < 0) {
+    BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::StartListen: epoll_ctl error: " << strerror(errno);
+    close(epoll_socket_);
+    epoll_socket_ = -1;
+    throw exception::detail::CantListenException();
+  }
 
-      ReadAndExecuteCommand(client_connection.socket);
+  StartWorkers();
 
-      network_->Close(client_connection.socket);
+  struct epoll_event events[MAX_EVENTS];
+  is_listen_ = true;
+  while (is_listen_) {
+    int count = epoll_wait(epoll_socket_, events, MAX_EVENTS, CHECK_INTERVAL_MS);
+
+    if (count < 0 && errno != EINTR) {
+      BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::StartListen: epoll_wait error: " << strerror(errno);
+      is_listen_ = false;
     }
-    else {
-      BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::StartListen: Timedout";
+
+    for (int i = 0; i < count; ++i) {
+      if (events[i].data.fd == socket_)
+        AcceptConnection();
+      else
+        QueueConnection(events[i].data.fd);
     }
+
+    CheckConnections();
   }
+
+  StopWorkers();
+  CloseConnections();
+
+  close(epoll_socket_);
+  epoll_socket_ = -1;
 }
 
 void CommandReceiver::StopListen() {
@@ -84,31 +144,299 @@ bool CommandReceiver::IsListen() const {
   return is_listen_;
 }
 
+type::CommandTimeouts CommandReceiver::ParseCommandTimeouts(const std::string &timeouts) {
+  BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ParseCommandTimeouts: Function call";
+
+  type::CommandTimeouts parsed;
+  std::size_t begin = 0;
+
+  while (begin < timeouts.size()) {
+    auto end = timeouts.find(',', begin);
+    if (end == std::string::npos)
+      end = timeouts.size();
+
+    const std::string timeout = timeouts.substr(begin, end - begin);
+    const auto separator = timeout.find('=');
+    const std::string seconds = (separator == std::string::npos) ? std::string() : timeout.substr(separator + 1);
+
+    if (separator == 0 || seconds.empty() || seconds.find_first_not_of("0123456789") != std::string::npos) {
+      BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::ParseCommandTimeouts: Wrong timeout: " << timeout;
+      throw exception::detail::WrongCommandTimeoutException();
+    }
+
+    parsed[timeout.substr(0, separator)] = std::chrono::seconds(std::stoll(seconds));
+    begin = end + 1;
+  }
+
+  return parsed;
+}
+
 CommandReceiver::CommandReceiver(detail::CommandExecutorInterfacePtr command_executor,
-                                 network::detail::NetworkInterfacePtr network)
+                                 network::detail::NetworkInterfacePtr network,
+                                 unsigned workers_count,
+                                 std::chrono::seconds command_timeout,
+                                 const type::CommandTimeouts &command_timeouts)
 : command_executor_(command_executor),
 network_(network),
+workers_count_(std::max(workers_count, 1u)),
+command_timeout_(command_timeout),
+command_timeouts_(command_timeouts),
 socket_(-1),
-is_listen_(false) {
+epoll_socket_(-1),
+is_listen_(false),
+is_stopping_(false) {
+}
+
+void CommandReceiver::AcceptConnection() {
+  BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::AcceptConnection: Function call";
+  network::ConnectionData client_connection;
+
+  try {
+    client_connection = network_->Accept(socket_);
+  }
+  catch (const ::interface::Exception &ex) {
+    BOOST_LOG_TRIVIAL(warning) << "web::CommandReceiver::AcceptConnection: Can't accept connection: " << ex.what();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (connections_.size() >= MAX_CONNECTIONS) {
+    BOOST_LOG_TRIVIAL(warning) << "web::CommandReceiver::AcceptConnection: Too many connections, closing new one";
+    CloseSocket(client_connection.socket);
+    return;
+  }
+
+  connections_[client_connection.socket] = Connection{false, false, false, false, std::chrono::steady_clock::now(), {}};
+
+  if (!Watch(client_connection.socket, EPOLL_CTL_ADD)) {
+    connections_.erase(client_connection.socket);
+    CloseSocket(client_connection.socket);
+  }
+}
+
+void CommandReceiver::QueueConnection(int client_socket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = connections_.find(client_socket);
+  if (it == connections_.end())
+    return;
+
+  it->second.is_busy = true;
+  ready_sockets_.push_back(client_socket);
+  ready_condition_.notify_one();
+}
+
+void CommandReceiver::CheckConnections() {
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<int> timed_out_sockets;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = connections_.begin(); it != connections_.end();) {
+      const int client_socket = it->first;
+      Connection &connection = it->second;
+
+      if (connection.is_executing && !connection.is_timed_out && connection.deadline <= now) {
+        BOOST_LOG_TRIVIAL(warning) << "web::CommandReceiver::CheckConnections: Command timed out";
+        connection.is_timed_out = true;
+        connection.is_sending_timeout = true;
+        timed_out_sockets.push_back(client_socket);
+      }
+      else if (!connection.is_busy && connection.last_activity + IDLE_TIMEOUT <= now) {
+        BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::CheckConnections: Closing idle connection";
+        CloseSocket(client_socket);
+        it = connections_.erase(it);
+        continue;
+      }
+
+      ++it;
+    }
+  }
+
+  // sent without the lock, so a slow client doesn't stop the workers;
+  // is_sending_timeout keeps the socket open until the error is sent
+  for (int client_socket : timed_out_sockets) {
+    try {
+      network_->SendText(client_socket, TIMEOUT_ERROR_JSON);
+    }
+    catch (const ::interface::Exception &ex) {
+      BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::CheckConnections: Can't send timeout error: " << ex.what();
+    }
+
+    shutdown(client_socket, SHUT_RDWR);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Connection &connection = connections_.at(client_socket);
+    connection.is_sending_timeout = false;
+
+    // the command ended while the error was sent, otherwise the worker
+    // closes the socket when the command ends
+    if (!connection.is_executing) {
+      CloseSocket(client_socket);
+      connections_.erase(client_socket);
+    }
+  }
+}
+
+void CommandReceiver::CloseConnections() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto &connection : connections_)
+    CloseSocket(connection.first);
+
+  connections_.clear();
+  ready_sockets_.clear();
+}
+
+void CommandReceiver::StartWorkers() {
+  is_stopping_ = false;
+
+  for (unsigned i = 0; i < workers_count_; ++i)
+    workers_.push_back(std::thread(&CommandReceiver::WorkerLoop, this));
+}
+
+void CommandReceiver::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  ready_condition_.notify_all();
+
+  for (auto &worker : workers_)
+    worker.join();
+
+  workers_.clear();
+}
+
+void CommandReceiver::WorkerLoop() {
+  while (true) {
+    int client_socket;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_condition_.wait(lock, [this]() {
+        return is_stopping_ || !ready_sockets_.empty();
+      });
+
+      if (is_stopping_)
+        return;
+
+      client_socket = ready_sockets_.front();
+      ready_sockets_.pop_front();
+    }
+
+    ReadAndExecuteCommand(client_socket);
+  }
 }
 
 void CommandReceiver::ReadAndExecuteCommand(int client_socket) {
   BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ReadAndExecuteCommand: Function call";
-  network::WaitStatus wait_status;
-  wait_status = network_->WaitForData(client_socket, 3);
-
   ::web::type::JsonMessage new_message, message_result;
-  if (wait_status == network::WaitStatus::NEW_DATA) {
-    BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ReadAndExecuteCommand: New data on socket";
+
+  try {
     new_message = network_->ReceiveText(client_socket);
+  }
+  catch (const ::interface::Exception &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ReadAndExecuteCommand: Connection closed: " << ex.what();
+    CloseConnection(client_socket);
+    return;
+  }
 
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Connection &connection = connections_.at(client_socket);
+    connection.is_executing = true;
+    connection.deadline = std::chrono::steady_clock::now() + GetCommandTimeout(new_message);
+  }
+
+  try {
     message_result = command_executor_->Execute(new_message);
+  }
+  catch (const std::exception &ex) {
+    BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::ReadAndExecuteCommand: Command failed: " << ex.what();
+    message_result = COMMAND_FAILED_ERROR_JSON;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Connection &connection = connections_.at(client_socket);
+    connection.is_executing = false;
+
+    if (connection.is_timed_out) {
+      if (!connection.is_sending_timeout) {
+        CloseSocket(client_socket);
+        connections_.erase(client_socket);
+      }
+      return;
+    }
+  }
 
+  try {
     network_->SendText(client_socket, message_result);
   }
-  else {
-    BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ReadAndExecuteCommand: Timedout";
+  catch (const ::interface::Exception &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::ReadAndExecuteCommand: Can't send result: " << ex.what();
+    CloseConnection(client_socket);
+    return;
   }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Connection &connection = connections_.at(client_socket);
+  connection.is_busy = false;
+  connection.last_activity = std::chrono::steady_clock::now();
+
+  if (!Watch(client_socket, EPOLL_CTL_MOD)) {
+    CloseSocket(client_socket);
+    connections_.erase(client_socket);
+  }
+}
+
+void CommandReceiver::CloseConnection(int client_socket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  CloseSocket(client_socket);
+  connections_.erase(client_socket);
+}
+
+void CommandReceiver::CloseSocket(int client_socket) {
+  try {
+    network_->Close(client_socket);
+  }
+  catch (const ::interface::Exception &ex) {
+    BOOST_LOG_TRIVIAL(warning) << "web::CommandReceiver::CloseSocket: Can't close socket: " << ex.what();
+  }
+}
+
+// one shot, so a request is read by one worker and the socket isn't
+// watched until the response is sent
+bool CommandReceiver::Watch(int client_socket, int operation) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof (event));
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.fd = client_socket;
+
+  if (epoll_ctl(epoll_socket_, operation, client_socket, &event) < 0) {
+    BOOST_LOG_TRIVIAL(error) << "web::CommandReceiver::Watch: epoll_ctl error: " << strerror(errno);
+    return false;
+  }
+
+  return true;
+}
+
+std::chrono::seconds CommandReceiver::GetCommandTimeout(const ::web::type::JsonMessage &message) const {
+  try {
+    const type::Command command = json::parse(message).at("command");
+
+    auto it = command_timeouts_.find(command);
+    if (it != command_timeouts_.end())
+      return it->second;
+  }
+  catch (const std::exception &ex) {
+    BOOST_LOG_TRIVIAL(debug) << "web::CommandReceiver::GetCommandTimeout: Can't get command: " << ex.what();
+  }
+
+  return command_timeout_;
 }
 
 }
@@ -1,11 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <slas/network/detail/network_interface.h>
 
 #include "detail/command_receiver_interface.h"
 #include "detail/command_executor_interface.h"
+#include "type/command_timeouts.h"
 
 namespace web
 {
@@ -13,6 +24,13 @@ namespace web
 class CommandReceiver;
 typedef std::shared_ptr<CommandReceiver> CommandReceiverPtr;
 
+// The listening thread waits for connections and requests with epoll,
+// requests are read and executed by workers_count threads. A connection
+// stays open after a response, so a client may send many requests. When
+// a command runs longer than its timeout, the client gets an error and
+// the connection is closed after the command ends. The command can't be
+// stopped, so it keeps its worker until it returns; when all workers run
+// timed out commands, new requests wait in the queue.
 class CommandReceiver : public detail::CommandReceiverInterface {
  public:
   virtual ~CommandReceiver() = default;
@@ -20,6 +38,11 @@ class CommandReceiver : public detail::CommandReceiverInterface {
   static CommandReceiverPtr Create(detail::CommandExecutorInterfacePtr command_executor);
   static CommandReceiverPtr Create(detail::CommandExecutorInterfacePtr command_executor,
                                    network::detail::NetworkInterfacePtr network);
+  static CommandReceiverPtr Create(detail::CommandExecutorInterfacePtr command_executor,
+                                   network::detail::NetworkInterfacePtr network,
+                                   unsigned workers_count,
+                                   std::chrono::seconds command_timeout,
+                                   const type::CommandTimeouts &command_timeouts);
 
   void OpenPort(const std::string &address, const int port) override;
   void ClosePort() override;
@@ -29,18 +52,64 @@ class CommandReceiver : public detail::CommandReceiverInterface {
   void StopListen() override;
   bool IsListen() const override;
 
+  // "command=seconds,command=seconds,...", throws WrongCommandTimeoutException
+  static type::CommandTimeouts ParseCommandTimeouts(const std::string &timeouts);
+
+  static constexpr unsigned WORKERS_COUNT = 4;
+  // shorter than the web interface timeout, so it gets the error
+  static constexpr std::chrono::seconds COMMAND_TIMEOUT{50};
+  static constexpr std::chrono::seconds IDLE_TIMEOUT{300};
+  static constexpr std::size_t MAX_CONNECTIONS = 64;
+
  protected:
   CommandReceiver(detail::CommandExecutorInterfacePtr command_executor,
-                  network::detail::NetworkInterfacePtr network);
+                  network::detail::NetworkInterfacePtr network,
+                  unsigned workers_count,
+                  std::chrono::seconds command_timeout,
+                  const type::CommandTimeouts &command_timeouts);
 
  private:
+  struct Connection {
+    bool is_busy;
+    bool is_executing;
+    bool is_timed_out;
+    bool is_sending_timeout;
+    std::chrono::steady_clock::time_point last_activity;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
   detail::CommandExecutorInterfacePtr command_executor_;
   network::detail::NetworkInterfacePtr network_;
+  const unsigned workers_count_;
+  const std::chrono::seconds command_timeout_;
+  const type::CommandTimeouts command_timeouts_;
 
   int socket_;
-  bool is_listen_;
+  int epoll_socket_;
+  std::atomic<bool> is_listen_;
+
+  std::map<int, Connection> connections_;
+  std::deque<int> ready_sockets_;
+  std::vector<std::thread> workers_;
+  bool is_stopping_;
+  std::mutex mutex_;
+  std::condition_variable ready_condition_;
+
+  void AcceptConnection();
+  void QueueConnection(int client_socket);
+  void CheckConnections();
+  void CloseConnections();
+
+  void StartWorkers();
+  void StopWorkers();
+  void WorkerLoop();
 
   void ReadAndExecuteCommand(int client_socket);
+  void CloseConnection(int client_socket);
+  void CloseSocket(int client_socket);
+  bool Watch(int client_socket, int operation);
+
+  std::chrono::seconds GetCommandTimeout(const ::web::type::JsonMessage &message) const;
 };
 
 }
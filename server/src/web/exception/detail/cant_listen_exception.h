@@ -0,0 +1,31 @@
+#pragma once
+
+#include "src/web/exception/web_exception.h"
+
+namespace web
+{
+
+namespace exception
+{
+
+namespace detail
+{
+
+class CantListenException : public WebException
+{
+ public:
+  inline char const* what() const throw () override;
+};
+
+
+char const* CantListenException::what() const throw ()
+{
+  return "Can't listen for commands.";
+}
+
+
+}
+
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "src/web/exception/web_exception.h"
+
+namespace web
+{
+
+namespace exception
+{
+
+namespace detail
+{
+
+class WrongCommandTimeoutException : public WebException
+{
+ public:
+  inline char const* what() const throw () override;
+};
+
+
+char const* WrongCommandTimeoutException::what() const throw ()
+{
+  return "Wrong command timeout, expected command=seconds.";
+}
+
+
+}
+
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+
+#include "command.h"
+
+namespace web
+{
+
+namespace type
+{
+
+typedef std::map<Command, std::chrono::seconds> CommandTimeouts;
+
+}
+
+}
@@ -1,3 +1,5 @@
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <unistd.h>
 #include <gmock/gmock.h>
@@ -10,6 +12,18 @@ using namespace testing;
 using namespace std;
 using namespace analyzer;
 
+namespace
+{
+
+type::Schedule GetSchedule(const string &name,
+                           chrono::seconds cadence = chrono::seconds(0),
+                           unsigned long long data_threshold = 0,
+                           const vector<string> &dependencies = {}) {
+  return type::Schedule{name, cadence, data_threshold, dependencies};
+}
+
+}
+
 class AnalyzerTest : public ::testing::Test {
  public:
   virtual ~AnalyzerTest() = default;
@@ -18,6 +32,20 @@ class AnalyzerTest : public ::testing::Test {
     mock_object1 = ::mock::analyzer::AnalyzerObject::Create();
     mock_object2 = ::mock::analyzer::AnalyzerObject::Create();
     analyzer = Analyzer::Create();
+
+    EXPECT_CALL(*mock_object1, GetSchedule()).WillRepeatedly(Return(GetSchedule("object1")));
+    EXPECT_CALL(*mock_object2, GetSchedule()).WillRepeatedly(Return(GetSchedule("object2")));
+  }
+
+  void StartLoop() {
+    loop_thread = thread([this]() {
+      analyzer->StartLoop();
+    });
+  }
+
+  void StopLoop() {
+    analyzer->StopLoop();
+    loop_thread.join();
   }
 
   void TearDown() override {
@@ -26,6 +54,7 @@ class AnalyzerTest : public ::testing::Test {
   ::mock::analyzer::AnalyzerObjectPtr mock_object1;
   ::mock::analyzer::AnalyzerObjectPtr mock_object2;
   AnalyzerPtr analyzer;
+  thread loop_thread;
 };
 
 TEST_F(AnalyzerTest, Create) {
@@ -103,3 +132,127 @@ TEST_F(AnalyzerTest, StartStopLoopAndAddOneObjectWithoutExecutingAnalyzing) {
   EXPECT_FALSE(analyzer->IsLoopRunning());
   EXPECT_FALSE(analyzer->IsAnalyzing());
 }
+
+TEST_F(AnalyzerTest, RunObjectWhenCadencePasses) {
+  EXPECT_CALL(*mock_object1, GetSchedule()).WillRepeatedly(Return(GetSchedule("object1", chrono::seconds(1))));
+  EXPECT_CALL(*mock_object1, Analyze()).Times(AtLeast(1));
+
+  analyzer->AddObject(mock_object1);
+  StartLoop();
+
+  sleep(2);
+
+  StopLoop();
+
+  auto statuses = analyzer->GetStatuses();
+  ASSERT_EQ(1u, statuses.size());
+  EXPECT_EQ("object1", statuses[0].name);
+  EXPECT_LE(1u, statuses[0].runs_count);
+  EXPECT_LT(chrono::system_clock::time_point(), statuses[0].last_run);
+  EXPECT_LT(statuses[0].last_run, statuses[0].next_run);
+}
+
+TEST_F(AnalyzerTest, StartAnalyzingOneObject) {
+  EXPECT_CALL(*mock_object1, Analyze()).Times(0);
+  EXPECT_CALL(*mock_object2, Analyze()).Times(1);
+
+  analyzer->AddObject(mock_object1);
+  analyzer->AddObject(mock_object2);
+
+  EXPECT_FALSE(analyzer->StartAnalyzing("unknown"));
+  EXPECT_TRUE(analyzer->StartAnalyzing("object2"));
+  EXPECT_TRUE(analyzer->IsAnalyzing());
+
+  auto statuses = analyzer->GetStatuses();
+  ASSERT_EQ(2u, statuses.size());
+  EXPECT_FALSE(statuses[0].is_due);
+  EXPECT_EQ(chrono::system_clock::time_point(), statuses[0].next_run);
+  EXPECT_TRUE(statuses[1].is_due);
+
+  StartLoop();
+
+  while (analyzer->IsAnalyzing())
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  StopLoop();
+
+  statuses = analyzer->GetStatuses();
+  EXPECT_EQ(0u, statuses[0].runs_count);
+  EXPECT_EQ(1u, statuses[1].runs_count);
+}
+
+TEST_F(AnalyzerTest, StartAnalyzingWhenDataThresholdIsReached) {
+  EXPECT_CALL(*mock_object1, GetSchedule()).WillRepeatedly(Return(GetSchedule("object1", chrono::seconds(0), 10)));
+  EXPECT_CALL(*mock_object1, Analyze()).Times(1);
+
+  analyzer->AddObject(mock_object1);
+  analyzer->AddData("object1", 9);
+  analyzer->AddData("unknown", 100);
+  EXPECT_FALSE(analyzer->IsAnalyzing());
+  EXPECT_EQ(9u, analyzer->GetStatuses()[0].pending_data);
+
+  analyzer->AddData("object1", 1);
+  EXPECT_TRUE(analyzer->IsAnalyzing());
+
+  StartLoop();
+
+  while (analyzer->IsAnalyzing())
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  StopLoop();
+
+  EXPECT_EQ(0u, analyzer->GetStatuses()[0].pending_data);
+}
+
+TEST_F(AnalyzerTest, IndependentObjectsRunConcurrently) {
+  atomic<int> started(0);
+  atomic<int> seen_together(0);
+  auto analyze = [&]() {
+    ++started;
+    for (int i = 0; i < 200 && started < 2; ++i)
+      this_thread::sleep_for(chrono::milliseconds(10));
+
+    if (started == 2)
+      ++seen_together;
+  };
+  EXPECT_CALL(*mock_object1, Analyze()).WillOnce(Invoke(analyze));
+  EXPECT_CALL(*mock_object2, Analyze()).WillOnce(Invoke(analyze));
+
+  analyzer->AddObject(mock_object1);
+  analyzer->AddObject(mock_object2);
+  analyzer->StartAnalyzing();
+  StartLoop();
+
+  while (analyzer->IsAnalyzing())
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  StopLoop();
+
+  EXPECT_EQ(2, seen_together);
+}
+
+TEST_F(AnalyzerTest, DependentObjectWaitsForDependencies) {
+  EXPECT_CALL(*mock_object2, GetSchedule()).WillRepeatedly(Return(GetSchedule("object2", chrono::seconds(0), 0, {"object1"})));
+
+  atomic<bool> object1_finished(false);
+  atomic<bool> object1_finished_first(false);
+  EXPECT_CALL(*mock_object1, Analyze()).WillOnce(Invoke([&]() {
+    this_thread::sleep_for(chrono::milliseconds(200));
+    object1_finished = true;
+  }));
+  EXPECT_CALL(*mock_object2, Analyze()).WillOnce(Invoke([&]() {
+    object1_finished_first = object1_finished.load();
+  }));
+
+  analyzer->AddObject(mock_object2);
+  analyzer->AddObject(mock_object1);
+  analyzer->StartAnalyzing();
+  StartLoop();
+
+  while (analyzer->IsAnalyzing())
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+  StopLoop();
+
+  EXPECT_TRUE(object1_finished_first);
+}
@@ -0,0 +1,54 @@
+#include <string>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/sketch/count_min_sketch.h"
+#include "src/analyzer/sketch/hash.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer::sketch;
+
+TEST(CountMinSketchTest, EstimatesAreNeverTooSmall) {
+  CountMinSketch sketch;
+  for (int i = 0; i < 1000; ++i)
+    sketch.Add(Hash(to_string(i)), i % 7 + 1);
+
+  for (int i = 0; i < 1000; ++i) {
+    const auto estimate = sketch.GetEstimate(Hash(to_string(i)));
+    EXPECT_GE(estimate, static_cast<uint64_t>(i % 7 + 1));
+    // e / width of total with high probability
+    EXPECT_LE(estimate, i % 7 + 1 + sketch.GetTotal() * 3 / 256);
+  }
+}
+
+TEST(CountMinSketchTest, MergeAndSerialize) {
+  CountMinSketch a, b;
+  a.Add(Hash("x"), 5);
+  b.Add(Hash("x"), 3);
+  b.Add(Hash("y"));
+
+  EXPECT_TRUE(a.Merge(b));
+  EXPECT_EQ(9u, a.GetTotal());
+  EXPECT_LE(8u, a.GetEstimate(Hash("x")));
+  EXPECT_FALSE(a.Merge(CountMinSketch(128, 4)));
+
+  CountMinSketch restored;
+  EXPECT_TRUE(restored.Deserialize(a.Serialize()));
+  EXPECT_EQ(a.GetEstimate(Hash("x")), restored.GetEstimate(Hash("x")));
+  EXPECT_EQ(9u, restored.GetTotal());
+
+  EXPECT_FALSE(restored.Deserialize(a.Serialize().substr(0, 5)));
+  EXPECT_EQ(9u, restored.GetTotal());
+}
+
+TEST(CountMinSketchTest, Halve) {
+  CountMinSketch sketch;
+  sketch.Add(Hash("x"), 9);
+  sketch.Add(Hash("y"), 1);
+
+  sketch.Halve();
+
+  EXPECT_EQ(5u, sketch.GetTotal());
+  EXPECT_LE(4u, sketch.GetEstimate(Hash("x")));
+  EXPECT_GE(5u, sketch.GetEstimate(Hash("x")));
+}
@@ -0,0 +1,67 @@
+#include <cmath>
+#include <string>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/sketch/hash.h"
+#include "src/analyzer/sketch/hyper_log_log.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer::sketch;
+
+TEST(HyperLogLogTest, SmallCardinality) {
+  HyperLogLog sketch;
+  for (int repeat = 0; repeat < 3; ++repeat)
+    for (int i = 0; i < 100; ++i)
+      sketch.Add(Hash("10.0.0." + to_string(i)));
+
+  EXPECT_NEAR(100., sketch.GetEstimate(), 3.);
+}
+
+TEST(HyperLogLogTest, LargeCardinality) {
+  HyperLogLog sketch;
+  for (int i = 0; i < 200000; ++i)
+    sketch.Add(Hash(to_string(i)));
+
+  // standard error is 1.04 / sqrt(4096) ~ 1.6%
+  EXPECT_NEAR(200000., sketch.GetEstimate(), 200000. * 0.05);
+}
+
+TEST(HyperLogLogTest, MergeEqualsUnion) {
+  HyperLogLog a, b, all;
+  for (int i = 0; i < 30000; ++i) {
+    const auto hash = Hash(to_string(i));
+    (i % 3 == 0 ? a : b).Add(hash);
+    all.Add(hash);
+  }
+
+  EXPECT_TRUE(a.Merge(b));
+  EXPECT_DOUBLE_EQ(all.GetEstimate(), a.GetEstimate());
+  EXPECT_FALSE(a.Merge(HyperLogLog(10)));
+}
+
+TEST(HyperLogLogTest, SerializeSparseAndDense) {
+  HyperLogLog sparse, dense;
+  for (int i = 0; i < 50; ++i)
+    sparse.Add(Hash(to_string(i)));
+  for (int i = 0; i < 100000; ++i)
+    dense.Add(Hash(to_string(i)));
+
+  EXPECT_LT(sparse.Serialize().size(), dense.Serialize().size());
+
+  for (const auto *s : {&sparse, &dense}) {
+    HyperLogLog restored;
+    EXPECT_TRUE(restored.Deserialize(s->Serialize()));
+    EXPECT_DOUBLE_EQ(s->GetEstimate(), restored.GetEstimate());
+  }
+}
+
+TEST(HyperLogLogTest, DeserializeInvalidData) {
+  HyperLogLog sketch;
+  sketch.Add(Hash("a"));
+  const auto estimate = sketch.GetEstimate();
+
+  EXPECT_FALSE(sketch.Deserialize(""));
+  EXPECT_FALSE(sketch.Deserialize(string("\x07\x0c", 2)));
+  EXPECT_DOUBLE_EQ(estimate, sketch.GetEstimate());
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/sketch/quantile_sketch.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer::sketch;
+
+namespace
+{
+
+double GetRank(const vector<double> &sorted, double value) {
+  return (upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) * 1. / sorted.size();
+}
+
+}
+
+TEST(QuantileSketchTest, ExactWhenSmall) {
+  QuantileSketch sketch;
+  for (int v : {7, 1, 5, 3, 9, 2, 8, 4})
+    sketch.Add(v);
+
+  // same elements as sorted[ceil(n * q) - 1]
+  EXPECT_EQ(8u, sketch.GetCount());
+  EXPECT_DOUBLE_EQ(2., sketch.GetQuantile(0.25));
+  EXPECT_DOUBLE_EQ(4., sketch.GetQuantile(0.5));
+  EXPECT_DOUBLE_EQ(7., sketch.GetQuantile(0.75));
+  EXPECT_DOUBLE_EQ(1., sketch.GetQuantile(0.));
+  EXPECT_DOUBLE_EQ(9., sketch.GetQuantile(1.));
+}
+
+TEST(QuantileSketchTest, Empty) {
+  QuantileSketch sketch;
+
+  EXPECT_TRUE(sketch.IsEmpty());
+  EXPECT_DOUBLE_EQ(0., sketch.GetQuantile(0.5));
+}
+
+TEST(QuantileSketchTest, RankErrorOfLargeSet) {
+  QuantileSketch sketch;
+  vector<double> values;
+  mt19937 generator(1);
+  lognormal_distribution<double> distribution(5., 1.);
+
+  for (int i = 0; i < 200000; ++i) {
+    values.push_back(distribution(generator));
+    sketch.Add(values.back());
+  }
+  sort(values.begin(), values.end());
+
+  for (double q : {0.01, 0.25, 0.5, 0.75, 0.99})
+    EXPECT_NEAR(q, GetRank(values, sketch.GetQuantile(q)), 0.02) << "q=" << q;
+}
+
+TEST(QuantileSketchTest, Merge) {
+  QuantileSketch a, b, all;
+  vector<double> values;
+  mt19937 generator(2);
+  uniform_real_distribution<double> distribution(0., 1000.);
+
+  for (int i = 0; i < 50000; ++i) {
+    const double v = distribution(generator);
+    values.push_back(v);
+    (i % 3 == 0 ? a : b).Add(v);
+  }
+  a.Merge(b);
+  sort(values.begin(), values.end());
+
+  EXPECT_EQ(50000u, a.GetCount());
+  for (double q : {0.25, 0.5, 0.75})
+    EXPECT_NEAR(q, GetRank(values, a.GetQuantile(q)), 0.02) << "q=" << q;
+}
+
+TEST(QuantileSketchTest, SerializeAndDeserialize) {
+  QuantileSketch sketch, restored;
+  for (int i = 0; i < 10000; ++i)
+    sketch.Add(i % 977);
+
+  ASSERT_TRUE(restored.Deserialize(sketch.Serialize()));
+
+  EXPECT_EQ(sketch.GetCount(), restored.GetCount());
+  for (double q : {0., 0.25, 0.5, 0.75, 1.})
+    EXPECT_DOUBLE_EQ(sketch.GetQuantile(q), restored.GetQuantile(q));
+
+  restored.Add(5000);
+  EXPECT_EQ(10001u, restored.GetCount());
+}
+
+TEST(QuantileSketchTest, DeserializeInvalidData) {
+  QuantileSketch sketch;
+  sketch.Add(1.);
+  const string data = sketch.Serialize();
+
+  EXPECT_FALSE(sketch.Deserialize(""));
+  EXPECT_FALSE(sketch.Deserialize(data.substr(0, data.size() - 1)));
+  EXPECT_FALSE(sketch.Deserialize(data + "x"));
+  EXPECT_EQ(1u, sketch.GetCount());
+}
@@ -0,0 +1,57 @@
+#include <string>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/sketch/top_k.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer::sketch;
+
+TEST(TopKTest, FindsMostFrequentValues) {
+  TopK top(3);
+  for (int i = 0; i < 2000; ++i) {
+    top.Add("/rare/" + to_string(i));
+    if (i % 2 == 0)
+      top.Add("/index.html");
+    if (i % 4 == 0)
+      top.Add("/login");
+    if (i % 8 == 0)
+      top.Add("/admin");
+  }
+
+  auto items = top.GetItems();
+  ASSERT_EQ(3u, items.size());
+  EXPECT_EQ("/index.html", items[0].value);
+  EXPECT_EQ("/login", items[1].value);
+  EXPECT_EQ("/admin", items[2].value);
+  EXPECT_LE(1000u, items[0].count);
+  EXPECT_EQ(2000u + 1000 + 500 + 250, top.GetTotal());
+}
+
+TEST(TopKTest, MergeAndSerialize) {
+  TopK a(2), b(2);
+  for (int i = 0; i < 10; ++i)
+    a.Add("a");
+  for (int i = 0; i < 6; ++i) {
+    a.Add("c");
+    b.Add("c");
+  }
+  for (int i = 0; i < 8; ++i)
+    b.Add("b");
+
+  EXPECT_TRUE(a.Merge(b));
+  auto items = a.GetItems();
+  ASSERT_EQ(2u, items.size());
+  EXPECT_EQ("c", items[0].value);
+  EXPECT_EQ(12u, items[0].count);
+  EXPECT_EQ("a", items[1].value);
+
+  TopK restored;
+  EXPECT_TRUE(restored.Deserialize(a.Serialize()));
+  ASSERT_EQ(2u, restored.GetItems().size());
+  EXPECT_EQ("c", restored.GetItems()[0].value);
+  EXPECT_EQ(a.GetTotal(), restored.GetTotal());
+
+  EXPECT_FALSE(restored.Deserialize("invalid"));
+  EXPECT_EQ(a.GetTotal(), restored.GetTotal());
+}
@@ -0,0 +1,81 @@
+#include <stdexcept>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/stage_metrics.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer;
+
+namespace
+{
+
+type::StageRun CreateRun(const string &stage) {
+  return type::StageRun{stage, chrono::system_clock::now(), 0, 0, 0, 0, 0, false};
+}
+
+}
+
+TEST(StageMetricsTest, KeepsLastRuns) {
+  auto metrics = StageMetrics::Create(3);
+  EXPECT_TRUE(metrics->GetRuns().empty());
+
+  metrics->Add(CreateRun("a"));
+  metrics->Add(CreateRun("b"));
+  ASSERT_EQ(2u, metrics->GetRuns().size());
+  EXPECT_EQ("a", metrics->GetRuns()[0].stage);
+
+  metrics->Add(CreateRun("c"));
+  metrics->Add(CreateRun("d"));
+  metrics->Add(CreateRun("e"));
+
+  auto runs = metrics->GetRuns();
+  ASSERT_EQ(3u, runs.size());
+  EXPECT_EQ("c", runs[0].stage);
+  EXPECT_EQ("d", runs[1].stage);
+  EXPECT_EQ("e", runs[2].stage);
+}
+
+TEST(StageMetricsTest, RecorderAddsRun) {
+  auto metrics = StageMetrics::Create();
+
+  {
+    StageRecorder recorder(metrics, "stage");
+    auto counters = ::database::StatementCountersScope::GetCurrent();
+    ASSERT_NE(nullptr, counters);
+    counters->statements += 2;
+    counters->rows_read += 5;
+  }
+  EXPECT_EQ(nullptr, ::database::StatementCountersScope::GetCurrent());
+
+  auto runs = metrics->GetRuns();
+  ASSERT_EQ(1u, runs.size());
+  EXPECT_EQ("stage", runs[0].stage);
+  EXPECT_GE(runs[0].wall_seconds, 0);
+  EXPECT_EQ(2, runs[0].statements);
+  EXPECT_EQ(5, runs[0].rows_read);
+  EXPECT_EQ(0, runs[0].rows_written);
+  EXPECT_GT(runs[0].peak_memory_kb, 0);
+  EXPECT_FALSE(runs[0].failed);
+}
+
+TEST(StageMetricsTest, RecorderMarksFailedRun) {
+  auto metrics = StageMetrics::Create();
+
+  try {
+    StageRecorder recorder(metrics, "stage");
+    throw runtime_error("stage error");
+  }
+  catch (const runtime_error&) {
+  }
+
+  auto runs = metrics->GetRuns();
+  ASSERT_EQ(1u, runs.size());
+  EXPECT_TRUE(runs[0].failed);
+}
+
+TEST(StageMetricsTest, RecorderWithoutMetrics) {
+  StageRecorder recorder(StageMetricsPtr(), "stage");
+
+  EXPECT_EQ(nullptr, ::database::StatementCountersScope::GetCurrent());
+}
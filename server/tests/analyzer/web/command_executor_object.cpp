@@ -0,0 +1,114 @@
+#include <gmock/gmock.h>
+#include <json/json.hpp>
+
+#include "src/analyzer/analyzer.h"
+#include "src/analyzer/web/command_executor_object.h"
+
+#include "tests/mock/analyzer/analyzer_object.h"
+
+using namespace nlohmann;
+using namespace testing;
+using namespace std;
+using namespace analyzer;
+
+class AnalyzerCommandExecutorObjectTest : public ::testing::Test {
+ public:
+  virtual ~AnalyzerCommandExecutorObjectTest() = default;
+
+  void SetUp() override {
+    mock_object1 = ::mock::analyzer::AnalyzerObject::Create();
+    mock_object2 = ::mock::analyzer::AnalyzerObject::Create();
+
+    EXPECT_CALL(*mock_object1, GetSchedule()).WillRepeatedly(Return(type::Schedule{"object1", chrono::seconds(60), 0, {}}));
+    EXPECT_CALL(*mock_object2, GetSchedule()).WillRepeatedly(Return(type::Schedule{"object2", chrono::seconds(0), 0, {}}));
+
+    analyzer = Analyzer::Create();
+    analyzer->AddObject(mock_object1);
+    analyzer->AddObject(mock_object2);
+
+    stage_metrics = StageMetrics::Create();
+    command_object = ::analyzer::web::CommandExecutorObject::Create(analyzer, stage_metrics);
+  }
+
+  ::mock::analyzer::AnalyzerObjectPtr mock_object1;
+  ::mock::analyzer::AnalyzerObjectPtr mock_object2;
+  AnalyzerPtr analyzer;
+  StageMetricsPtr stage_metrics;
+  ::analyzer::web::CommandExecutorObjectPtr command_object;
+};
+
+TEST_F(AnalyzerCommandExecutorObjectTest, IsCommandSupported) {
+  EXPECT_TRUE(command_object->IsCommandSupported("start_analyzing"));
+  EXPECT_TRUE(command_object->IsCommandSupported("get_analyzer_schedule"));
+  EXPECT_TRUE(command_object->IsCommandSupported("get_analyzer_metrics"));
+  EXPECT_FALSE(command_object->IsCommandSupported("random_unknown_command"));
+}
+
+TEST_F(AnalyzerCommandExecutorObjectTest, Execute_StartAnalyzingOneObject) {
+  auto j = json::parse(command_object->Execute("{ \"command\" : \"start_analyzing\", \"args\" : [ \"object2\" ] }"));
+  string status = j["status"];
+  EXPECT_EQ("ok", status);
+
+  auto statuses = analyzer->GetStatuses();
+  EXPECT_FALSE(statuses[0].is_due);
+  EXPECT_TRUE(statuses[1].is_due);
+
+  EXPECT_EQ(::web::type::CommandExecutorObjectInterface::GetInvalidArgumentErrorJson(),
+            command_object->Execute("{ \"command\" : \"start_analyzing\", \"args\" : [ \"unknown\" ] }"));
+}
+
+TEST_F(AnalyzerCommandExecutorObjectTest, Execute_StartAnalyzingAllObjects) {
+  auto j = json::parse(command_object->Execute("{ \"command\" : \"start_analyzing\", \"args\" : [] }"));
+  string status = j["status"];
+  EXPECT_EQ("ok", status);
+
+  for (const auto &s : analyzer->GetStatuses())
+    EXPECT_TRUE(s.is_due);
+}
+
+TEST_F(AnalyzerCommandExecutorObjectTest, Execute_GetAnalyzerSchedule) {
+  auto j = json::parse(command_object->Execute("{ \"command\" : \"get_analyzer_schedule\" }"));
+  string status = j["status"];
+  EXPECT_EQ("ok", status);
+
+  auto result = j["result"];
+  ASSERT_EQ(2u, result.size());
+
+  string name = result[0]["name"];
+  long long last_run = result[0]["last_run"];
+  long long next_run = result[0]["next_run"];
+  EXPECT_EQ("object1", name);
+  EXPECT_EQ(0, last_run);
+  EXPECT_NEAR(time(nullptr) + 60, next_run, 5);
+
+  long long second_next_run = result[1]["next_run"];
+  EXPECT_EQ(0, second_next_run);
+}
+
+TEST_F(AnalyzerCommandExecutorObjectTest, Execute_GetAnalyzerMetrics) {
+  stage_metrics->Add(type::StageRun{"bash.classification", chrono::system_clock::time_point(chrono::seconds(100)), 1.5, 10, 20, 30, 4096, false});
+
+  auto j = json::parse(command_object->Execute("{ \"command\" : \"get_analyzer_metrics\" }"));
+  string status = j["status"];
+  EXPECT_EQ("ok", status);
+
+  auto result = j["result"];
+  ASSERT_EQ(1u, result.size());
+
+  string stage = result[0]["stage"];
+  long long start = result[0]["start"];
+  double wall_seconds = result[0]["wall_seconds"];
+  long long statements = result[0]["statements"];
+  long long rows_read = result[0]["rows_read"];
+  long long rows_written = result[0]["rows_written"];
+  long long peak_memory_kb = result[0]["peak_memory_kb"];
+  bool failed = result[0]["failed"];
+  EXPECT_EQ("bash.classification", stage);
+  EXPECT_EQ(100, start);
+  EXPECT_DOUBLE_EQ(1.5, wall_seconds);
+  EXPECT_EQ(10, statements);
+  EXPECT_EQ(20, rows_read);
+  EXPECT_EQ(30, rows_written);
+  EXPECT_EQ(4096, peak_memory_kb);
+  EXPECT_FALSE(failed);
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <gmock/gmock.h>
+
+#include "src/analyzer/worker_pool.h"
+
+using namespace testing;
+using namespace std;
+using namespace analyzer;
+
+TEST(WorkerPoolTest, RunAllTasks) {
+  auto pool = WorkerPool::Create(4);
+  vector<int> done(1000, 0);
+
+  WorkerPool::Tasks tasks;
+  for (size_t i = 0; i < done.size(); ++i)
+    tasks.push_back([&done, i]() { done[i] += 1; });
+
+  pool->Run(tasks);
+
+  EXPECT_EQ(1000, count(done.begin(), done.end(), 1));
+}
+
+TEST(WorkerPoolTest, RunFromInsideTask) {
+  auto pool = WorkerPool::Create(2);
+  atomic<int> counter(0);
+
+  WorkerPool::Tasks tasks;
+  for (int i = 0; i < 8; ++i) {
+    tasks.push_back([&pool, &counter]() {
+      pool->RunPartially(100, [&counter](long long begin, long long end) {
+        counter += end - begin;
+      });
+    });
+  }
+
+  pool->Run(tasks);
+
+  EXPECT_EQ(800, counter);
+}
+
+TEST(WorkerPoolTest, IdleThreadsStealTasks) {
+  auto pool = WorkerPool::Create(4);
+  atomic<int> started(0);
+  atomic<int> counter(0);
+
+  // all small tasks are queued by one task, they can finish only if other
+  // threads take them while it waits
+  pool->Run({[&]() {
+    WorkerPool::Tasks tasks;
+    for (int i = 0; i < 4; ++i) {
+      tasks.push_back([&]() {
+        ++started;
+        while (started < 4)
+          this_thread::yield();
+        ++counter;
+      });
+    }
+    pool->Run(tasks);
+  }});
+
+  EXPECT_EQ(4, counter);
+}
+
+TEST(WorkerPoolTest, RethrowTaskException) {
+  auto pool = WorkerPool::Create(2);
+  atomic<int> counter(0);
+
+  WorkerPool::Tasks tasks = {
+    [&counter]() { ++counter; },
+    []() { throw runtime_error("task error"); },
+    [&counter]() { ++counter; }
+  };
+
+  EXPECT_THROW(pool->Run(tasks), runtime_error);
+  EXPECT_EQ(2, counter);
+}
+
+TEST(WorkerPoolTest, TasksUseCallerStatementCounters) {
+  auto pool = WorkerPool::Create(4);
+  ::database::StatementCounters counters;
+  atomic<int> counted(0);
+
+  WorkerPool::Tasks tasks;
+  for (int i = 0; i < 100; ++i) {
+    tasks.push_back([&counters, &counted]() {
+      if (::database::StatementCountersScope::GetCurrent() == &counters)
+        ++counted;
+    });
+  }
+
+  {
+    ::database::StatementCountersScope scope(&counters);
+    pool->Run(tasks);
+  }
+  EXPECT_EQ(100, counted);
+
+  pool->RunPartially(100, [&counted](long long, long long) {
+    if (::database::StatementCountersScope::GetCurrent() != nullptr)
+      ++counted;
+  });
+  EXPECT_EQ(100, counted);
+}
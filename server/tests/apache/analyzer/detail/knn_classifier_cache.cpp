@@ -0,0 +1,76 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/knn_classifier_cache.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail;
+using namespace ::apache::type;
+
+class KnnClassifierCacheTest : public ::testing::Test {
+ public:
+  virtual ~KnnClassifierCacheTest() = default;
+
+  void SetUp() override {
+    cache = KnnClassifierCache::Create();
+    classifier = prepare_statistics::KnnClassifier::Create(::analyzer::WorkerPool::Create(1));
+
+    configuration.mode = KnnMode::APPROXIMATE;
+    configuration.hnsw_m = 16;
+    configuration.hnsw_ef = 64;
+    configuration.neighbours_count = 3;
+    configuration.voting = KnnVoting::MAJORITY;
+  }
+
+  KnnClassifierCachePtr cache;
+  prepare_statistics::KnnClassifierPtr classifier;
+  KnnConfiguration configuration;
+};
+
+TEST_F(KnnClassifierCacheTest, GetWhenEmpty) {
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 3, configuration));
+}
+
+TEST_F(KnnClassifierCacheTest, GetSameVersion) {
+  cache->Put(1, 2, 3, configuration, classifier);
+
+  // neighbours count and voting don't change the index
+  configuration.neighbours_count = 5;
+  configuration.voting = KnnVoting::DISTANCE_WEIGHTED;
+
+  EXPECT_EQ(classifier, cache->Get(1, 2, 3, configuration));
+  EXPECT_EQ(nullptr, cache->Get(1, 3, 3, configuration));
+}
+
+TEST_F(KnnClassifierCacheTest, GetOtherVersionOrConfiguration) {
+  cache->Put(1, 2, 3, configuration, classifier);
+
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 4, configuration));
+
+  auto c = configuration;
+  c.hnsw_m = 8;
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 3, c));
+
+  c = configuration;
+  c.hnsw_ef = 32;
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 3, c));
+
+  c = configuration;
+  c.mode = KnnMode::EXACT;
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 3, c));
+}
+
+TEST_F(KnnClassifierCacheTest, PutReplacesClassifier) {
+  auto other = prepare_statistics::KnnClassifier::Create(::analyzer::WorkerPool::Create(1));
+
+  cache->Put(1, 2, 3, configuration, classifier);
+  cache->Put(1, 2, 4, configuration, other);
+
+  EXPECT_EQ(nullptr, cache->Get(1, 2, 3, configuration));
+  EXPECT_EQ(other, cache->Get(1, 2, 4, configuration));
+}
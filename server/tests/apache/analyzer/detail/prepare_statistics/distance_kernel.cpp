@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <vector>
+
+#include "src/apache/analyzer/detail/prepare_statistics/distance_kernel.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+
+class DistanceKernelTest : public ::testing::Test {
+ public:
+  virtual ~DistanceKernelTest() = default;
+
+  LearningSet learning_set;
+  ApacheSessionEntry session;
+
+  void SetUp() override {
+    session.id = 1;
+    session.session_length = 50;
+    session.bandwidth_usage = 50;
+    session.requests_count = 50;
+    session.error_percentage = 50;
+
+    // 11 rows - two full AVX2 vectors and a scalar tail
+    for (int i = 0; i < 11; ++i) {
+      ApacheSessionEntry s;
+      s.id = i + 2;
+      s.session_length = 10 * i;
+      s.bandwidth_usage = 1000000 * i;
+      s.requests_count = 3 * i;
+      s.error_percentage = 9.5 * i;
+      s.classification = ::database::type::Classification::NORMAL;
+
+      learning_set.Add(s);
+    }
+  }
+
+  double Expected(int i) const {
+    double a = learning_set.session_length.at(i) - session.session_length;
+    double b = learning_set.bandwidth_usage.at(i) - session.bandwidth_usage;
+    double c = learning_set.requests_count.at(i) - session.requests_count;
+    double d = learning_set.error_percentage.at(i) - session.error_percentage;
+
+    return a * a + b * b + c * c + d * d;
+  }
+};
+
+TEST_F(DistanceKernelTest, Scalar) {
+  vector<double> distances(learning_set.Size());
+
+  SquaredDistancesScalar(learning_set, SessionFeatures::Create(session), distances.data());
+
+  for (unsigned i = 0; i < learning_set.Size(); ++i)
+    EXPECT_DOUBLE_EQ(Expected(i), distances.at(i));
+}
+
+TEST_F(DistanceKernelTest, Avx2) {
+  vector<double> distances(learning_set.Size());
+
+  SquaredDistancesAvx2(learning_set, SessionFeatures::Create(session), distances.data());
+
+  for (unsigned i = 0; i < learning_set.Size(); ++i)
+    EXPECT_DOUBLE_EQ(Expected(i), distances.at(i));
+}
+
+TEST_F(DistanceKernelTest, SelectedKernel) {
+  vector<double> distances(learning_set.Size());
+
+  SquaredDistances(learning_set, SessionFeatures::Create(session), distances.data());
+
+  for (unsigned i = 0; i < learning_set.Size(); ++i)
+    EXPECT_DOUBLE_EQ(Expected(i), distances.at(i));
+}
+
+TEST_F(DistanceKernelTest, EmptyLearningSet) {
+  LearningSet empty;
+  double distance = -1;
+
+  SquaredDistances(empty, SessionFeatures::Create(session), &distance);
+
+  EXPECT_EQ(-1, distance);
+}
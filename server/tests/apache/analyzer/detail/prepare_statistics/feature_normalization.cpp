@@ -0,0 +1,105 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <cmath>
+
+#include "src/apache/analyzer/detail/prepare_statistics/feature_normalization.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+
+class FeatureNormalizationTest : public ::testing::Test {
+ public:
+  virtual ~FeatureNormalizationTest() = default;
+
+  ApacheSessions sessions;
+
+  void SetUp() override {
+    sessions = {Session(10, 1000, 5, 0),
+                Session(20, 3000, 5, 10),
+                Session(30, 5000, 5, 20),
+                Session(40, 7000, 5, 30)};
+  }
+
+  ApacheSessionEntry Session(long long length, long long bandwidth, long long requests, double errors) const {
+    ApacheSessionEntry s;
+    s.session_length = length;
+    s.bandwidth_usage = bandwidth;
+    s.requests_count = requests;
+    s.error_percentage = errors;
+    s.classification = ::database::type::Classification::NORMAL;
+
+    return s;
+  }
+};
+
+TEST_F(FeatureNormalizationTest, Statistics) {
+  FeatureStatistics statistics;
+  statistics.Add(ApacheSessions(sessions.begin(), sessions.begin() + 2));
+  statistics.Add(ApacheSessions(sessions.begin() + 2, sessions.end()));
+
+  auto n = statistics.GetNormalization();
+
+  EXPECT_EQ(4u, statistics.Count());
+  EXPECT_EQ(-1, n.learning_set_version);
+  EXPECT_DOUBLE_EQ(25., n.session_length.mean);
+  EXPECT_DOUBLE_EQ(sqrt(125.), n.session_length.standard_deviation);
+  EXPECT_DOUBLE_EQ(4000., n.bandwidth_usage.mean);
+  EXPECT_DOUBLE_EQ(sqrt(5000000.), n.bandwidth_usage.standard_deviation);
+  EXPECT_DOUBLE_EQ(5., n.requests_count.mean);
+  EXPECT_DOUBLE_EQ(1., n.requests_count.standard_deviation);
+  EXPECT_DOUBLE_EQ(15., n.error_percentage.mean);
+}
+
+TEST_F(FeatureNormalizationTest, StatisticsWithoutSessions) {
+  auto n = FeatureStatistics().GetNormalization();
+
+  EXPECT_DOUBLE_EQ(0., n.session_length.mean);
+  EXPECT_DOUBLE_EQ(1., n.session_length.standard_deviation);
+}
+
+TEST_F(FeatureNormalizationTest, NormalizeLearningSet) {
+  FeatureStatistics statistics;
+  statistics.Add(sessions);
+  auto n = statistics.GetNormalization();
+
+  LearningSet learning_set;
+  learning_set.Add(sessions.at(0));
+  learning_set.Add(sessions.at(1));
+  Normalize(learning_set, 0, n);
+  learning_set.Add(sessions.at(3));
+  Normalize(learning_set, 2, n);
+
+  auto expected = Normalize(SessionFeatures::Create(sessions.at(3)), n);
+
+  EXPECT_DOUBLE_EQ(-1.5 / sqrt(1.25), learning_set.session_length.at(0));
+  EXPECT_DOUBLE_EQ(0., learning_set.requests_count.at(1));
+  EXPECT_DOUBLE_EQ(expected.session_length, learning_set.session_length.at(2));
+  EXPECT_DOUBLE_EQ(expected.bandwidth_usage, learning_set.bandwidth_usage.at(2));
+  EXPECT_DOUBLE_EQ(expected.error_percentage, learning_set.error_percentage.at(2));
+}
+
+TEST_F(FeatureNormalizationTest, Renormalize) {
+  FeatureStatistics statistics;
+  statistics.Add(sessions);
+  auto n = statistics.GetNormalization();
+
+  LearningSet learning_set;
+  for (const auto &s : sessions)
+    learning_set.Add(s);
+  const auto original = learning_set;
+
+  Renormalize(learning_set, GetIdentityNormalization(), n);
+  EXPECT_NEAR(Normalize(SessionFeatures::Create(sessions.at(2)), n).bandwidth_usage, learning_set.bandwidth_usage.at(2), 1e-12);
+
+  Renormalize(learning_set, n, GetIdentityNormalization());
+  for (size_t i = 0; i < learning_set.Size(); ++i) {
+    EXPECT_NEAR(original.session_length.at(i), learning_set.session_length.at(i), 1e-9);
+    EXPECT_NEAR(original.bandwidth_usage.at(i), learning_set.bandwidth_usage.at(i), 1e-9);
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <random>
+
+#include "src/apache/analyzer/detail/prepare_statistics/hnsw_index.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+using ::database::type::Classification;
+
+class HnswIndexTest : public ::testing::Test {
+ public:
+  virtual ~HnswIndexTest() = default;
+
+  LearningSet learning_set;
+  mt19937 generator;
+
+  void SetUp() override {
+    for (int i = 0; i < 2000; ++i)
+      learning_set.Add(RandomSession(i + 1));
+  }
+
+  ApacheSessionEntry RandomSession(::database::type::RowId id) {
+    uniform_int_distribution<int> distribution(0, 100);
+
+    ApacheSessionEntry s;
+    s.id = id;
+    s.session_length = distribution(generator);
+    s.bandwidth_usage = distribution(generator);
+    s.requests_count = distribution(generator);
+    s.error_percentage = distribution(generator) / 7.;
+    s.classification = (id % 3 == 0) ? Classification::ANOMALY : Classification::NORMAL;
+
+    return s;
+  }
+
+  Neighbours BruteForce(const ApacheSessionEntry &session) const {
+    NearestNeighboursTable table;
+    table.SetSession(session);
+
+    for (size_t i = 0; i < learning_set.Size(); ++i) {
+      ApacheSessionEntry s;
+      s.id = learning_set.id.at(i);
+      s.session_length = learning_set.session_length.at(i);
+      s.bandwidth_usage = learning_set.bandwidth_usage.at(i);
+      s.requests_count = learning_set.requests_count.at(i);
+      s.error_percentage = learning_set.error_percentage.at(i);
+      s.classification = learning_set.classification.at(i);
+
+      table.Add(s);
+    }
+
+    return table.Get();
+  }
+
+  double Recall(const HnswIndexPtr &index) {
+    size_t expected = 0, found = 0;
+
+    for (int i = 0; i < 100; ++i) {
+      auto session = RandomSession(0);
+      auto exact = BruteForce(session);
+
+      NearestNeighboursTable table;
+      index->Search(learning_set, SessionFeatures::Create(session), table);
+
+      for (const auto &n : table.Get())
+        found += static_cast<size_t> (n.distance <= exact.back().distance);
+      expected += exact.size();
+    }
+
+    return static_cast<double> (found) / expected;
+  }
+};
+
+TEST_F(HnswIndexTest, SearchInEmptyIndex) {
+  auto index = HnswIndex::Create(16, 64);
+
+  NearestNeighboursTable table;
+  index->Search(learning_set, SessionFeatures::Create(RandomSession(0)), table);
+
+  EXPECT_EQ(0u, index->Size());
+  EXPECT_TRUE(table.Get().empty());
+}
+
+TEST_F(HnswIndexTest, SearchHasHighRecall) {
+  auto index = HnswIndex::Create(16, 64);
+  index->Update(learning_set);
+
+  EXPECT_EQ(learning_set.Size(), index->Size());
+  EXPECT_GE(Recall(index), 0.95);
+}
+
+TEST_F(HnswIndexTest, UpdateInsertsNewRows) {
+  auto index = HnswIndex::Create(16, 64);
+  index->Update(learning_set);
+
+  for (int i = 0; i < 500; ++i)
+    learning_set.Add(RandomSession(learning_set.Size() + 1));
+  index->Update(learning_set);
+
+  EXPECT_EQ(learning_set.Size(), index->Size());
+  EXPECT_GE(Recall(index), 0.95);
+}
+
+TEST_F(HnswIndexTest, SearchFindsExactMatch) {
+  auto index = HnswIndex::Create(8, 32);
+  index->Update(learning_set);
+
+  ApacheSessionEntry s;
+  s.session_length = learning_set.session_length.at(123);
+  s.bandwidth_usage = learning_set.bandwidth_usage.at(123);
+  s.requests_count = learning_set.requests_count.at(123);
+  s.error_percentage = learning_set.error_percentage.at(123);
+
+  NearestNeighboursTable table;
+  index->Search(learning_set, SessionFeatures::Create(s), table);
+
+  ASSERT_FALSE(table.Get().empty());
+  EXPECT_DOUBLE_EQ(0., table.Get().front().distance);
+}
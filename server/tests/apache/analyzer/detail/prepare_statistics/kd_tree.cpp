@@ -0,0 +1,161 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include "src/apache/analyzer/detail/prepare_statistics/kd_tree.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+using ::database::type::Classification;
+
+class KdTreeTest : public ::testing::Test {
+ public:
+  virtual ~KdTreeTest() = default;
+
+  const string INDEX_FILE_PATH = "kd_tree_test.index";
+
+  LearningSet learning_set;
+  mt19937 generator;
+
+  void SetUp() override {
+    for (int i = 0; i < 1000; ++i)
+      learning_set.Add(RandomSession(i + 1));
+  }
+
+  void TearDown() override {
+    remove(INDEX_FILE_PATH.c_str());
+  }
+
+  ApacheSessionEntry RandomSession(::database::type::RowId id) {
+    uniform_int_distribution<int> distribution(0, 100);
+
+    ApacheSessionEntry s;
+    s.id = id;
+    s.session_length = distribution(generator);
+    s.bandwidth_usage = distribution(generator) * 1000;
+    s.requests_count = distribution(generator);
+    s.error_percentage = distribution(generator) / 7.;
+    s.classification = (id % 3 == 0) ? Classification::ANOMALY : Classification::NORMAL;
+
+    return s;
+  }
+
+  Neighbours BruteForce(const LearningSet &set, const ApacheSessionEntry &session) const {
+    NearestNeighboursTable table;
+    table.SetSession(session);
+
+    for (size_t i = 0; i < set.Size(); ++i) {
+      ApacheSessionEntry s;
+      s.id = set.id.at(i);
+      s.session_length = set.session_length.at(i);
+      s.bandwidth_usage = set.bandwidth_usage.at(i);
+      s.requests_count = set.requests_count.at(i);
+      s.error_percentage = set.error_percentage.at(i);
+      s.classification = set.classification.at(i);
+
+      table.Add(s);
+    }
+
+    return table.Get();
+  }
+
+  Neighbours Search(const KdTreePtr &tree, const LearningSet &set, const ApacheSessionEntry &session) const {
+    NearestNeighboursTable table;
+    tree->Search(set, SessionFeatures::Create(session), table);
+
+    return table.Get();
+  }
+};
+
+TEST_F(KdTreeTest, SearchIsExact) {
+  const auto original = learning_set;
+  auto tree = KdTree::Create(learning_set);
+
+  ASSERT_EQ(original.Size(), learning_set.Size());
+
+  for (int i = 0; i < 200; ++i) {
+    const auto session = RandomSession(10000 + i);
+    const auto expected = BruteForce(original, session);
+    const auto found = Search(tree, learning_set, session);
+
+    ASSERT_EQ(expected.size(), found.size());
+    for (size_t j = 0; j < expected.size(); ++j)
+      EXPECT_EQ(expected.at(j).distance, found.at(j).distance);
+  }
+}
+
+TEST_F(KdTreeTest, SmallLearningSet) {
+  LearningSet small;
+  small.Add(RandomSession(1));
+  small.Add(RandomSession(2));
+
+  auto tree = KdTree::Create(small);
+  auto found = Search(tree, small, RandomSession(3));
+
+  EXPECT_EQ(2, found.size());
+}
+
+TEST_F(KdTreeTest, EmptyLearningSet) {
+  LearningSet empty;
+
+  auto tree = KdTree::Create(empty);
+  auto found = Search(tree, empty, RandomSession(3));
+
+  EXPECT_EQ(0, found.size());
+}
+
+TEST_F(KdTreeTest, SaveAndLoad) {
+  auto tree = KdTree::Create(learning_set);
+  ASSERT_TRUE(tree->Save(INDEX_FILE_PATH, 7, learning_set));
+
+  LearningSet loaded_set;
+  auto loaded = KdTree::Load(INDEX_FILE_PATH, 7, loaded_set);
+
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(learning_set.id, loaded_set.id);
+  EXPECT_EQ(learning_set.bandwidth_usage, loaded_set.bandwidth_usage);
+  EXPECT_EQ(learning_set.classification, loaded_set.classification);
+
+  const auto session = RandomSession(5000);
+  EXPECT_EQ(Search(tree, learning_set, session), Search(loaded, loaded_set, session));
+}
+
+TEST_F(KdTreeTest, LoadOutdatedVersion) {
+  auto tree = KdTree::Create(learning_set);
+  ASSERT_TRUE(tree->Save(INDEX_FILE_PATH, 7, learning_set));
+
+  LearningSet loaded_set;
+  EXPECT_EQ(nullptr, KdTree::Load(INDEX_FILE_PATH, 8, loaded_set));
+  EXPECT_EQ(0, loaded_set.Size());
+}
+
+TEST_F(KdTreeTest, LoadMissingFile) {
+  LearningSet loaded_set;
+
+  EXPECT_EQ(nullptr, KdTree::Load(INDEX_FILE_PATH, 1, loaded_set));
+}
+
+TEST_F(KdTreeTest, LoadTruncatedFile) {
+  auto tree = KdTree::Create(learning_set);
+  ASSERT_TRUE(tree->Save(INDEX_FILE_PATH, 7, learning_set));
+
+  {
+    ifstream in(INDEX_FILE_PATH, ios::binary);
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    ofstream out(INDEX_FILE_PATH, ios::binary | ios::trunc);
+    out.write(content.data(), content.size() / 2);
+  }
+
+  LearningSet loaded_set;
+  EXPECT_EQ(nullptr, KdTree::Load(INDEX_FILE_PATH, 7, loaded_set));
+}
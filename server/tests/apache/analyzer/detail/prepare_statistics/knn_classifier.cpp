@@ -0,0 +1,201 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/prepare_statistics/feature_normalization.h"
+#include "src/apache/analyzer/detail/prepare_statistics/knn_classifier.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+using ::database::type::Classification;
+
+class KnnClassifierTest : public ::testing::Test {
+ public:
+  virtual ~KnnClassifierTest() = default;
+
+  KnnClassifierPtr classifier;
+
+  void SetUp() override {
+    classifier = KnnClassifier::Create(::analyzer::WorkerPool::Create(2));
+  }
+
+  ApacheSessionEntry Session(::database::type::RowId id, double value, Classification classification) const {
+    ApacheSessionEntry s;
+    s.id = id;
+    s.session_length = value;
+    s.bandwidth_usage = value;
+    s.requests_count = value;
+    s.error_percentage = value;
+    s.classification = classification;
+
+    return s;
+  }
+};
+
+TEST_F(KnnClassifierTest, SetLearningSetSkipsUnknownClassification) {
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL),
+                              Session(2, 20, Classification::UNKNOWN),
+                              Session(3, 30, Classification::ANOMALY)});
+
+  EXPECT_EQ(2, classifier->GetLearningSet().Size());
+  EXPECT_EQ(1, classifier->GetLearningSet().id.at(0));
+  EXPECT_EQ(3, classifier->GetLearningSet().id.at(1));
+}
+
+TEST_F(KnnClassifierTest, ClassifyWithoutLearningSet) {
+  auto classifications = classifier->Classify({Session(1, 10, Classification::UNKNOWN)});
+
+  ASSERT_EQ(1, classifications.size());
+  EXPECT_EQ(Classification::UNKNOWN, classifications.at(0));
+}
+
+TEST_F(KnnClassifierTest, Classify) {
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL),
+                              Session(2, 11, Classification::NORMAL),
+                              Session(3, 12, Classification::NORMAL),
+                              Session(4, 1000, Classification::ANOMALY),
+                              Session(5, 1001, Classification::ANOMALY),
+                              Session(6, 1002, Classification::ANOMALY)});
+
+  ApacheSessions sessions;
+  for (int i = 0; i < 50; ++i) {
+    sessions.push_back(Session(100 + 2 * i, 9 + i % 5, Classification::UNKNOWN));
+    sessions.push_back(Session(101 + 2 * i, 999 + i % 5, Classification::UNKNOWN));
+  }
+
+  auto classifications = classifier->Classify(sessions);
+
+  ASSERT_EQ(sessions.size(), classifications.size());
+  for (unsigned i = 0; i < sessions.size(); i += 2) {
+    EXPECT_EQ(Classification::NORMAL, classifications.at(i));
+    EXPECT_EQ(Classification::ANOMALY, classifications.at(i + 1));
+  }
+}
+
+TEST_F(KnnClassifierTest, GetSessionClassification) {
+  Neighbour normal, anomaly;
+  normal.classification = Classification::NORMAL;
+  anomaly.classification = Classification::ANOMALY;
+
+  EXPECT_EQ(Classification::UNKNOWN, KnnClassifier::GetSessionClassification({}));
+  EXPECT_EQ(Classification::NORMAL, KnnClassifier::GetSessionClassification({normal, anomaly}));
+  EXPECT_EQ(Classification::ANOMALY, KnnClassifier::GetSessionClassification({anomaly, normal, anomaly}));
+}
+
+TEST_F(KnnClassifierTest, ClassifyWithIndex) {
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL),
+                              Session(2, 11, Classification::NORMAL),
+                              Session(3, 12, Classification::NORMAL),
+                              Session(4, 1000, Classification::ANOMALY),
+                              Session(5, 1001, Classification::ANOMALY),
+                              Session(6, 1002, Classification::ANOMALY)});
+  ApacheSessions sessions = {Session(7, 9, Classification::UNKNOWN),
+                             Session(8, 999, Classification::UNKNOWN)};
+
+  auto expected = classifier->Classify(sessions);
+
+  classifier->BuildIndex();
+  ASSERT_TRUE(classifier->HasIndex());
+
+  EXPECT_EQ(expected, classifier->Classify(sessions));
+}
+
+TEST_F(KnnClassifierTest, AddToLearningSetDropsIndex) {
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL)});
+  classifier->BuildIndex();
+
+  classifier->AddToLearningSet({Session(2, 20, Classification::NORMAL)});
+
+  EXPECT_FALSE(classifier->HasIndex());
+}
+
+TEST_F(KnnClassifierTest, ClassifyWithApproximateSearch) {
+  classifier->EnableApproximateSearch(4, 16);
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL),
+                              Session(2, 11, Classification::NORMAL),
+                              Session(3, 12, Classification::NORMAL)});
+  classifier->AddToLearningSet({Session(4, 1000, Classification::ANOMALY),
+                                Session(5, 1001, Classification::ANOMALY),
+                                Session(6, 1002, Classification::ANOMALY)});
+  ASSERT_TRUE(classifier->IsApproximateSearchEnabled());
+
+  auto classifications = classifier->Classify({Session(7, 9, Classification::UNKNOWN),
+                                               Session(8, 999, Classification::UNKNOWN)});
+
+  ASSERT_EQ(2, classifications.size());
+  EXPECT_EQ(Classification::NORMAL, classifications.at(0));
+  EXPECT_EQ(Classification::ANOMALY, classifications.at(1));
+}
+
+TEST_F(KnnClassifierTest, BuildIndexDisablesApproximateSearch) {
+  classifier->EnableApproximateSearch(4, 16);
+  classifier->SetLearningSet({Session(1, 10, Classification::NORMAL)});
+
+  classifier->BuildIndex();
+
+  EXPECT_TRUE(classifier->HasIndex());
+  EXPECT_FALSE(classifier->IsApproximateSearchEnabled());
+}
+
+TEST_F(KnnClassifierTest, GetSessionClassificationWithDistanceWeightedVoting) {
+  Neighbour near, far, exact;
+  near.classification = Classification::NORMAL;
+  near.distance = 1;
+  far.classification = Classification::ANOMALY;
+  far.distance = 100;
+  exact.classification = Classification::ANOMALY;
+  exact.distance = 0;
+
+  const auto WEIGHTED = ::apache::type::KnnVoting::DISTANCE_WEIGHTED;
+
+  EXPECT_EQ(Classification::UNKNOWN, KnnClassifier::GetSessionClassification({}, WEIGHTED));
+  EXPECT_EQ(Classification::ANOMALY, KnnClassifier::GetSessionClassification({near, far, far}));
+  EXPECT_EQ(Classification::NORMAL, KnnClassifier::GetSessionClassification({near, far, far}, WEIGHTED));
+  EXPECT_EQ(Classification::ANOMALY, KnnClassifier::GetSessionClassification({exact, near, far}, WEIGHTED));
+}
+
+TEST_F(KnnClassifierTest, ClassifyWithNeighboursCount) {
+  classifier->SetLearningSet({Session(1, 10, Classification::ANOMALY),
+                              Session(2, 20, Classification::NORMAL),
+                              Session(3, 21, Classification::NORMAL),
+                              Session(4, 22, Classification::NORMAL)});
+  ApacheSessions sessions = {Session(5, 9, Classification::UNKNOWN)};
+
+  classifier->SetNeighboursCount(1);
+  EXPECT_EQ(Classification::ANOMALY, classifier->Classify(sessions).at(0));
+
+  classifier->SetNeighboursCount(3);
+  EXPECT_EQ(Classification::NORMAL, classifier->Classify(sessions).at(0));
+}
+
+TEST_F(KnnClassifierTest, ClassifyWithNormalization) {
+  auto session = [this](::database::type::RowId id, long long bandwidth, double errors, Classification c) {
+    auto s = Session(id, 0, c);
+    s.bandwidth_usage = bandwidth;
+    s.error_percentage = errors;
+    return s;
+  };
+
+  // raw bandwidth hides the error percentage difference
+  ApacheSessions learning_set = {session(1, 104000, 0, Classification::NORMAL),
+                                 session(2, 104600, 1, Classification::NORMAL),
+                                 session(3, 105000, 2, Classification::NORMAL),
+                                 session(4, 100000, 90, Classification::ANOMALY),
+                                 session(5, 102000, 95, Classification::ANOMALY),
+                                 session(6, 109000, 99, Classification::ANOMALY)};
+  ApacheSessions sessions = {session(7, 104500, 97, Classification::UNKNOWN)};
+
+  classifier->SetLearningSet(learning_set);
+  EXPECT_EQ(Classification::NORMAL, classifier->Classify(sessions).at(0));
+
+  FeatureStatistics statistics;
+  statistics.Add(learning_set);
+  classifier->SetNormalization(statistics.GetNormalization());
+
+  EXPECT_EQ(Classification::ANOMALY, classifier->Classify(sessions).at(0));
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <random>
+
+#include "src/apache/analyzer/detail/prepare_statistics/knn_recall_evaluator.h"
+
+using namespace testing;
+using namespace std;
+using namespace ::apache::analyzer::detail::prepare_statistics;
+using namespace ::apache::type;
+using ::database::type::Classification;
+
+namespace
+{
+
+ApacheSessions GetRandomSessions() {
+  mt19937 generator;
+  uniform_int_distribution<int> distribution(0, 100);
+
+  ApacheSessions sessions;
+  for (int i = 0; i < 1000; ++i) {
+    ApacheSessionEntry s;
+    s.id = i + 1;
+    s.session_length = distribution(generator);
+    s.bandwidth_usage = distribution(generator);
+    s.requests_count = distribution(generator);
+    s.error_percentage = distribution(generator);
+    s.classification = (s.error_percentage > 50) ? Classification::ANOMALY : Classification::NORMAL;
+
+    sessions.push_back(s);
+  }
+
+  return sessions;
+}
+
+KnnConfiguration GetConfiguration() {
+  KnnConfiguration c;
+  c.mode = KnnMode::APPROXIMATE;
+  c.hnsw_m = 16;
+  c.hnsw_ef = 64;
+  c.neighbours_count = 3;
+  c.voting = KnnVoting::MAJORITY;
+
+  return c;
+}
+
+}
+
+TEST(KnnRecallEvaluatorTest, Evaluate) {
+  auto sessions = GetRandomSessions();
+
+  auto evaluator = KnnRecallEvaluator::Create(::analyzer::WorkerPool::Create(2));
+  auto evaluation = evaluator->Evaluate(sessions, GetConfiguration());
+
+  EXPECT_EQ(900u, evaluation.learning_set_size);
+  EXPECT_EQ(100u, evaluation.queries_count);
+  EXPECT_GE(evaluation.recall, 0.95);
+  EXPECT_LE(evaluation.recall, 1.);
+  EXPECT_GE(evaluation.classification_agreement, 0.95);
+}
+
+TEST(KnnRecallEvaluatorTest, EvaluateWithoutSessions) {
+  auto evaluator = KnnRecallEvaluator::Create(::analyzer::WorkerPool::Create(2));
+  auto evaluation = evaluator->Evaluate({}, GetConfiguration());
+
+  EXPECT_EQ(0u, evaluation.learning_set_size);
+  EXPECT_EQ(0u, evaluation.queries_count);
+  EXPECT_DOUBLE_EQ(1., evaluation.recall);
+}
+
+TEST(KnnRecallEvaluatorTest, EvaluateWithDistanceWeightedVoting) {
+  auto configuration = GetConfiguration();
+  configuration.neighbours_count = 7;
+  configuration.voting = KnnVoting::DISTANCE_WEIGHTED;
+
+  auto evaluator = KnnRecallEvaluator::Create(::analyzer::WorkerPool::Create(2));
+  auto evaluation = evaluator->Evaluate(GetRandomSessions(), configuration);
+
+  EXPECT_EQ(900u, evaluation.learning_set_size);
+  EXPECT_GE(evaluation.recall, 0.95);
+  EXPECT_GE(evaluation.classification_agreement, 0.95);
+}
+
+TEST(KnnRecallEvaluatorTest, UnknownSessionsDontChangeNormalization) {
+  auto sessions = GetRandomSessions();
+
+  // never used as queries, so they can change only the normalization
+  for (size_t i = 0; i < sessions.size(); i += KnnRecallEvaluator::QUERY_STEP)
+    sessions[i].classification = Classification::UNKNOWN;
+
+  auto outliers = sessions;
+  for (size_t i = 0; i < outliers.size(); i += KnnRecallEvaluator::QUERY_STEP) {
+    outliers[i].session_length = 1000000;
+    outliers[i].bandwidth_usage = 1000000;
+    outliers[i].requests_count = 1000000;
+    outliers[i].error_percentage = 1000000;
+  }
+
+  auto evaluator = KnnRecallEvaluator::Create(::analyzer::WorkerPool::Create(2));
+  auto evaluation = evaluator->Evaluate(sessions, GetConfiguration());
+  auto outliers_evaluation = evaluator->Evaluate(outliers, GetConfiguration());
+
+  EXPECT_EQ(800u, evaluation.learning_set_size);
+  EXPECT_EQ(evaluation.learning_set_size, outliers_evaluation.learning_set_size);
+  EXPECT_DOUBLE_EQ(evaluation.normalization.session_length.mean, outliers_evaluation.normalization.session_length.mean);
+  EXPECT_DOUBLE_EQ(evaluation.normalization.error_percentage.standard_deviation, outliers_evaluation.normalization.error_percentage.standard_deviation);
+  EXPECT_LT(outliers_evaluation.normalization.bandwidth_usage.mean, 100.);
+  EXPECT_DOUBLE_EQ(evaluation.recall, outliers_evaluation.recall);
+  EXPECT_DOUBLE_EQ(evaluation.classification_agreement, outliers_evaluation.classification_agreement);
+}
@@ -5,6 +5,7 @@
 
 #include <gmock/gmock.h>
 #include <iostream>
+#include <limits>
 
 #include "src/apache/analyzer/detail/prepare_statistics/nearest_neighbours_table.h"
 
@@ -39,7 +40,7 @@ class NearestNeighboursTableTest : public ::testing::Test {
     s1.session_length = 150;
 
     n1.classification = ::database::type::Classification::NORMAL;
-    n1.distance = 200;
+    n1.distance = 40000;
     n1.session_id = 2;
 
     s2.id = 3;
@@ -50,7 +51,7 @@ class NearestNeighboursTableTest : public ::testing::Test {
     s2.session_length = 200;
 
     n2.classification = ::database::type::Classification::ANOMALY;
-    n2.distance = 300;
+    n2.distance = 90000;
     n2.session_id = 3;
 
     s3.id = 4;
@@ -61,7 +62,7 @@ class NearestNeighboursTableTest : public ::testing::Test {
     s3.session_length = 250;
 
     n3.classification = ::database::type::Classification::NORMAL;
-    n3.distance = 400;
+    n3.distance = 160000;
     n3.session_id = 4;
 
     s4.id = 5;
@@ -72,7 +73,7 @@ class NearestNeighboursTableTest : public ::testing::Test {
     s4.session_length = 300;
 
     n4.classification = ::database::type::Classification::ANOMALY;
-    n4.distance = 500;
+    n4.distance = 250000;
     n4.session_id = 5;
 
     s5.id = 6;
@@ -83,7 +84,7 @@ class NearestNeighboursTableTest : public ::testing::Test {
     s5.session_length = 200;
 
     n5.classification = ::database::type::Classification::UNKNOWN;
-    n5.distance = 300;
+    n5.distance = 90000;
     n5.session_id = 6;
   }
 
@@ -212,3 +213,53 @@ TEST_F(NearestNeighboursTableTest, AddElementWithUnknownClassification) {
   EXPECT_EQ(n5, neighbours.at(1));
   EXPECT_EQ(n4, neighbours.at(2));
 }
+
+TEST_F(NearestNeighboursTableTest, GetWorstDistance) {
+  nearest_neighbours.SetSession(session);
+
+  nearest_neighbours.Add(s1);
+  nearest_neighbours.Add(s3);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), nearest_neighbours.GetWorstDistance());
+
+  nearest_neighbours.Add(s4);
+  EXPECT_EQ(n4.distance, nearest_neighbours.GetWorstDistance());
+
+  nearest_neighbours.Add(s2);
+  EXPECT_EQ(n3.distance, nearest_neighbours.GetWorstDistance());
+}
+
+TEST_F(NearestNeighboursTableTest, ConfigurableNeighboursCount) {
+  NearestNeighboursTable table(4);
+  table.SetSession(session);
+
+  table.Add(s4);
+  table.Add(s3);
+  table.Add(s2);
+  table.Add(s1);
+  table.Add(s5);
+
+  auto &neighbours = table.Get();
+
+  EXPECT_EQ(4, table.GetNeighboursCount());
+  ASSERT_EQ(4, neighbours.size());
+  EXPECT_EQ(n1, neighbours.at(0));
+  EXPECT_EQ(n2, neighbours.at(1));
+  EXPECT_EQ(n5, neighbours.at(2));
+  EXPECT_EQ(n3, neighbours.at(3));
+  EXPECT_EQ(n3.distance, table.GetWorstDistance());
+}
+
+TEST_F(NearestNeighboursTableTest, AddThisSameElementBetweenEqualDistances) {
+  nearest_neighbours.SetSession(session);
+
+  nearest_neighbours.Add(s2);
+  nearest_neighbours.Add(s5);
+  nearest_neighbours.Add(s2);
+  nearest_neighbours.Add(s5);
+
+  auto &neighbours = nearest_neighbours.Get();
+
+  ASSERT_EQ(2, neighbours.size());
+  EXPECT_EQ(n2.session_id, neighbours.at(0).session_id);
+  EXPECT_EQ(n5.session_id, neighbours.at(1).session_id);
+}
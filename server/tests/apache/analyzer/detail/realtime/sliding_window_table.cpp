@@ -0,0 +1,60 @@
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/realtime/sliding_window_table.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer::detail::realtime;
+
+TEST(SlidingWindowTableTest, CountRequestsInWindow) {
+  SlidingWindowTable table(16, 10, 3);
+
+  table.Add(1, 100, false, 10);
+  table.Add(1, 115, true, 20);
+  auto features = table.Add(1, 125, false, 30).features;
+
+  EXPECT_EQ(3, features.requests_count);
+  EXPECT_EQ(1, features.errors_count);
+  EXPECT_EQ(60, features.bandwidth_usage);
+
+  // bucket [100, 110) leaves the window
+  features = table.Add(1, 130, false, 1).features;
+
+  EXPECT_EQ(3, features.requests_count);
+  EXPECT_EQ(1, features.errors_count);
+  EXPECT_EQ(51, features.bandwidth_usage);
+
+  // after a long break only the new request is counted
+  features = table.Add(1, 1000, true, 5).features;
+
+  EXPECT_EQ(1, features.requests_count);
+  EXPECT_EQ(1, features.errors_count);
+  EXPECT_EQ(5, features.bandwidth_usage);
+  EXPECT_EQ(30, table.GetWindowLength());
+}
+
+TEST(SlidingWindowTableTest, LateRequests) {
+  SlidingWindowTable table(16, 10, 3);
+
+  table.Add(1, 200, false, 10);
+  EXPECT_EQ(2, table.Add(1, 185, false, 10).features.requests_count);
+  EXPECT_EQ(2, table.Add(1, 150, false, 10).features.requests_count);
+}
+
+TEST(SlidingWindowTableTest, DropLeastRecentlySeenClient) {
+  SlidingWindowTable table(2, 10, 3);
+
+  table.Add(1, 100, false, 10);
+  table.Add(2, 100, false, 10);
+  table.Add(1, 101, false, 10).last_report_time = 101;
+  table.Add(3, 102, false, 10);
+
+  EXPECT_EQ(2u, table.Size());
+  EXPECT_EQ(3, table.Add(1, 103, false, 10).features.requests_count);
+  EXPECT_EQ(101, table.Add(1, 103, false, 10).last_report_time);
+
+  auto window = table.Add(2, 104, false, 10);
+  EXPECT_EQ(1, window.features.requests_count);
+  EXPECT_EQ(SlidingWindowTable::NEVER_REPORTED, window.last_report_time);
+  EXPECT_EQ(2u, table.Size());
+}
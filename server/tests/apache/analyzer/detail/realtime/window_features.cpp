@@ -0,0 +1,34 @@
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/realtime/window_features.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer::detail::realtime;
+
+namespace
+{
+
+::apache::type::FeatureNormalization GetNormalization() {
+  ::apache::type::FeatureNormalization n;
+  n.learning_set_version = 1;
+  n.session_length = {100., 10.};
+  n.bandwidth_usage = {1000., 100.};
+  n.requests_count = {10., 2.};
+  n.error_percentage = {5., 5.};
+
+  return n;
+}
+
+}
+
+TEST(WindowFeaturesTest, GetAnomalyScore) {
+  EXPECT_DOUBLE_EQ(5., GetAnomalyScore(WindowFeatures{20, 1, 1000}, GetNormalization()));
+  EXPECT_DOUBLE_EQ(3., GetAnomalyScore(WindowFeatures{10, 0, 1300}, GetNormalization()));
+  EXPECT_DOUBLE_EQ(9., GetAnomalyScore(WindowFeatures{10, 5, 1000}, GetNormalization()));
+}
+
+TEST(WindowFeaturesTest, GetAnomalyScore_WhenBelowMean) {
+  EXPECT_DOUBLE_EQ(0., GetAnomalyScore(WindowFeatures{2, 0, 10}, GetNormalization()));
+  EXPECT_DOUBLE_EQ(0., GetAnomalyScore(WindowFeatures{0, 0, 0}, GetNormalization()));
+}
@@ -0,0 +1,48 @@
+#include <map>
+#include <random>
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/sessionizer/session_table.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer::detail::sessionizer;
+
+TEST(SessionTableTest, FindInsertedKeys) {
+  SessionTable table;
+
+  table.Insert(1, 10);
+  table.Insert(0xffffffff00000000ULL, 20);
+
+  EXPECT_EQ(10u, table.Find(1));
+  EXPECT_EQ(20u, table.Find(0xffffffff00000000ULL));
+  EXPECT_EQ(SessionTable::NOT_FOUND, table.Find(2));
+  EXPECT_EQ(2u, table.Size());
+}
+
+TEST(SessionTableTest, EraseKeepsOtherKeysReachable) {
+  SessionTable table;
+  map<SessionTable::Key, SessionTable::Value> expected;
+  mt19937_64 generator(0);
+
+  // small key space makes collisions and erasing in the middle of probe
+  // sequences common
+  for (int i = 0; i < 20000; ++i) {
+    const SessionTable::Key key = generator() % 500;
+
+    if (expected.count(key)) {
+      table.Erase(key);
+      expected.erase(key);
+    }
+    else {
+      table.Insert(key, i);
+      expected[key] = i;
+    }
+  }
+
+  EXPECT_EQ(expected.size(), table.Size());
+  for (SessionTable::Key key = 0; key < 500; ++key) {
+    auto it = expected.find(key);
+    EXPECT_EQ((it == expected.end()) ? SessionTable::NOT_FOUND : it->second, table.Find(key));
+  }
+}
@@ -0,0 +1,157 @@
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/sessionizer/sessionizer.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer::detail::sessionizer;
+
+namespace
+{
+
+::type::ApacheLogEntry CreateLog(const string &client_ip, int hour, int minute, int second, int status_code = 200) {
+  ::type::ApacheLogEntry log;
+
+  log.id = 0;
+  log.agent_name = "agent";
+  log.virtualhost = "example.com";
+  log.client_ip = client_ip;
+  log.time.Set(hour, minute, second, 10, 5, 2016);
+  log.request = "GET / HTTP/1.1";
+  log.status_code = status_code;
+  log.bytes = 100;
+  log.user_agent = "Mozilla/5.0";
+
+  return log;
+}
+
+}
+
+TEST(SessionizerTest, ToSeconds) {
+  ::type::Timestamp t;
+
+  t.Set(0, 0, 0, 1, 1, 1970);
+  EXPECT_EQ(0, Sessionizer::ToSeconds(t));
+
+  t.Set(12, 30, 15, 29, 2, 2016);
+  EXPECT_EQ(1456749015, Sessionizer::ToSeconds(t));
+}
+
+TEST(SessionizerTest, AddLogsToOpenSession) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 0, 0));
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 20, 0, 404));
+  sessionizer->Add(CreateLog("10.0.0.2", 10, 30, 0));
+
+  auto sessions = sessionizer->GetOpenSessions();
+  ASSERT_EQ(2u, sessions.size());
+  EXPECT_TRUE(sessionizer->GetClosedSessions().empty());
+
+  const auto &session = (sessions[0].client_ip == "10.0.0.1") ? sessions[0] : sessions[1];
+  EXPECT_EQ(2, session.requests_count);
+  EXPECT_EQ(1, session.errors_count);
+  EXPECT_DOUBLE_EQ(50., session.error_percentage);
+  EXPECT_EQ(200, session.bandwidth_usage);
+  EXPECT_EQ(1200, session.session_length);
+}
+
+TEST(SessionizerTest, CloseSessionWhenLogDoesNotFit) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 0, 0));
+  sessionizer->Add(CreateLog("10.0.0.1", 11, 0, 0));
+
+  ASSERT_EQ(1u, sessionizer->GetClosedSessions().size());
+  EXPECT_EQ(1, sessionizer->GetClosedSessions()[0].requests_count);
+  EXPECT_EQ(1u, sessionizer->GetOpenSessionsCount());
+}
+
+TEST(SessionizerTest, CloseExpiredSessions) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 0, 0));
+  sessionizer->Add(CreateLog("10.0.0.2", 10, 30, 0));
+  const auto now = sessionizer->GetLatestLogTime();
+
+  sessionizer->CloseExpiredSessions(now + 1799);
+  EXPECT_TRUE(sessionizer->GetClosedSessions().empty());
+
+  sessionizer->CloseExpiredSessions(now + 1800);
+  ASSERT_EQ(1u, sessionizer->GetClosedSessions().size());
+  EXPECT_EQ("10.0.0.1", sessionizer->GetClosedSessions()[0].client_ip);
+  EXPECT_EQ(1u, sessionizer->GetOpenSessionsCount());
+
+  sessionizer->ClearClosedSessions();
+  EXPECT_TRUE(sessionizer->GetClosedSessions().empty());
+}
+
+TEST(SessionizerTest, SessionEndsAtMidnight) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("10.0.0.1", 23, 50, 0));
+  sessionizer->CloseExpiredSessions(sessionizer->GetLatestLogTime() + 600);
+
+  EXPECT_EQ(1u, sessionizer->GetClosedSessions().size());
+  EXPECT_EQ(0u, sessionizer->GetOpenSessionsCount());
+}
+
+TEST(SessionizerTest, TimerOfReplacedSessionIsIgnored) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 0, 0));
+  sessionizer->Add(CreateLog("10.0.0.1", 11, 30, 0));
+  sessionizer->CloseExpiredSessions(sessionizer->GetLatestLogTime());
+
+  EXPECT_EQ(1u, sessionizer->GetClosedSessions().size());
+  EXPECT_EQ(1u, sessionizer->GetOpenSessionsCount());
+}
+
+TEST(SessionizerTest, RestoreOpenSessions) {
+  auto sessionizer = Sessionizer::Create();
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 0, 0));
+  sessionizer->Add(CreateLog("10.0.0.1", 10, 10, 0));
+
+  auto restored = Sessionizer::Create();
+  restored->RestoreOpenSessions(sessionizer->GetOpenSessions());
+  restored->Add(CreateLog("10.0.0.1", 10, 20, 0));
+
+  auto sessions = restored->GetOpenSessions();
+  ASSERT_EQ(1u, sessions.size());
+  EXPECT_EQ(3, sessions[0].requests_count);
+  EXPECT_EQ(sessionizer->GetLatestLogTime(), restored->GetLatestLogTime() - 600);
+}
+
+TEST(SessionizerTest, SessionsOfDifferentVirtualhostsAndUserAgents) {
+  auto sessionizer = Sessionizer::Create();
+  auto log = CreateLog("10.0.0.1", 10, 0, 0);
+
+  sessionizer->Add(log);
+  log.user_agent = "curl/7.50";
+  sessionizer->Add(log);
+  log.virtualhost = "example.org";
+  sessionizer->Add(log);
+  sessionizer->Add(log);
+
+  EXPECT_EQ(3u, sessionizer->GetOpenSessionsCount());
+}
+
+TEST(SessionizerTest, KeepClientAddressAndSessionStart) {
+  auto sessionizer = Sessionizer::Create();
+
+  sessionizer->Add(CreateLog("2001:0db8:0000::0001", 23, 59, 59));
+  sessionizer->Add(CreateLog("2001:db8::1", 23, 59, 59));
+  sessionizer->Add(CreateLog("proxy.example.com", 0, 0, 1));
+
+  auto sessions = sessionizer->GetOpenSessions();
+  ASSERT_EQ(2u, sessions.size());
+
+  const auto &session = (sessions[0].client_ip == "2001:db8::1") ? sessions[0] : sessions[1];
+  EXPECT_EQ("2001:db8::1", session.client_ip);
+  EXPECT_EQ(2, session.requests_count);
+  EXPECT_EQ(23, session.session_start.GetTime().GetHour());
+  EXPECT_EQ(59, session.session_start.GetTime().GetSecond());
+  EXPECT_EQ(10, session.session_start.GetDate().GetDay());
+  EXPECT_EQ(5, session.session_start.GetDate().GetMonth());
+  EXPECT_EQ(2016, session.session_start.GetDate().GetYear());
+}
@@ -0,0 +1,50 @@
+#include <vector>
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/detail/sessionizer/timer_wheel.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer::detail::sessionizer;
+
+TEST(TimerWheelTest, FireOnlyExpiredTimers) {
+  TimerWheel<int> wheel(8, 10);
+  vector<int> fired;
+
+  wheel.Add(1, 15);
+  wheel.Add(2, 25);
+  wheel.Add(3, 100);
+  wheel.Advance(0, [&fired](int key, long long) { fired.push_back(key); });
+  wheel.Advance(20, [&fired](int key, long long) { fired.push_back(key); });
+
+  EXPECT_THAT(fired, ElementsAre(1));
+  EXPECT_EQ(2u, wheel.Size());
+}
+
+TEST(TimerWheelTest, FireTimersMoreThanOneTurnAhead) {
+  TimerWheel<int> wheel(4, 10);
+  vector<int> fired;
+
+  wheel.Advance(0, [](int, long long) { });
+  wheel.Add(1, 45);
+  wheel.Add(2, 5);
+  wheel.Advance(30, [&fired](int key, long long) { fired.push_back(key); });
+
+  EXPECT_THAT(fired, ElementsAre(2));
+
+  wheel.Advance(45, [&fired](int key, long long) { fired.push_back(key); });
+
+  EXPECT_THAT(fired, ElementsAre(2, 1));
+  EXPECT_EQ(0u, wheel.Size());
+}
+
+TEST(TimerWheelTest, FireTimerAddedInThePast) {
+  TimerWheel<int> wheel(4, 10);
+  vector<int> fired;
+
+  wheel.Advance(100, [](int, long long) { });
+  wheel.Add(1, 20);
+  wheel.Advance(100, [&fired](int key, long long) { fired.push_back(key); });
+
+  EXPECT_THAT(fired, ElementsAre(1));
+}
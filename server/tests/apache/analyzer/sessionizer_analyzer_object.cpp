@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/sessionizer_analyzer_object.h"
+
+#include "tests/mock/apache/database/database_functions.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer;
+
+class SessionizerAnalyzerObjectTest : public ::testing::Test {
+ public:
+  ::mock::apache::database::DatabaseFunctionsPtr database_functions;
+  StreamingSessionizerPtr sessionizer;
+  SessionizerAnalyzerObjectPtr analyzer_object;
+  ::type::ApacheLogEntry log_entry;
+
+  virtual ~SessionizerAnalyzerObjectTest() = default;
+
+  void SetUp() {
+    database_functions = ::mock::apache::database::DatabaseFunctions::Create();
+    sessionizer = StreamingSessionizer::Create(database_functions);
+    analyzer_object = SessionizerAnalyzerObject::Create(sessionizer, nullptr);
+
+    log_entry.id = 0;
+    log_entry.agent_name = "agent";
+    log_entry.virtualhost = "vh";
+    log_entry.client_ip = "127.0.0.1";
+    log_entry.time = ::type::Timestamp::Create(10, 15, 0, 3, 1, 2016);
+    log_entry.request = "GET /index.php HTTP/1.1";
+    log_entry.status_code = 200;
+    log_entry.bytes = 100;
+    log_entry.user_agent = "browser";
+  }
+};
+
+TEST_F(SessionizerAnalyzerObjectTest, GetSchedule) {
+  const auto schedule = analyzer_object->GetSchedule();
+
+  EXPECT_EQ(SessionizerAnalyzerObject::NAME, schedule.name);
+  EXPECT_EQ(StreamingSessionizer::CHECKPOINT_INTERVAL, schedule.cadence);
+  EXPECT_EQ(0u, schedule.data_threshold);
+  EXPECT_TRUE(schedule.dependencies.empty());
+}
+
+TEST_F(SessionizerAnalyzerObjectTest, AnalyzeSavesCheckpointOfNewLogs) {
+  EXPECT_CALL(*database_functions, AddLogs(_));
+  EXPECT_CALL(*database_functions, GetLastLogId()).WillOnce(Return(7));
+  sessionizer->AddLogs({log_entry});
+
+  EXPECT_CALL(*database_functions, SaveSessionizerCheckpoint(_, Field(&::apache::type::SessionizerCheckpoint::last_log_id, 7)));
+  analyzer_object->Analyze();
+
+  // nothing changed since the last checkpoint
+  analyzer_object->Analyze();
+}
+
+TEST_F(SessionizerAnalyzerObjectTest, AnalyzeSavesCheckpointEveryRun) {
+  EXPECT_CALL(*database_functions, AddLogs(_)).Times(2);
+  EXPECT_CALL(*database_functions, GetLastLogId()).WillOnce(Return(7)).WillOnce(Return(8));
+  EXPECT_CALL(*database_functions, SaveSessionizerCheckpoint(_, _)).Times(2);
+
+  sessionizer->AddLogs({log_entry});
+  analyzer_object->Analyze();
+
+  // the next run doesn't wait for CHECKPOINT_INTERVAL since the last one,
+  // the analyzer already runs the object at that cadence
+  sessionizer->AddLogs({log_entry});
+  analyzer_object->Analyze();
+}
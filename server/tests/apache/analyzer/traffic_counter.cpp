@@ -0,0 +1,67 @@
+#include <gmock/gmock.h>
+
+#include "src/apache/analyzer/traffic_counter.h"
+
+#include "tests/mock/apache/database/database_functions.h"
+
+using namespace testing;
+using namespace std;
+using namespace apache::analyzer;
+
+TEST(TrafficCounterTest, GetPath) {
+  EXPECT_EQ("/index.php", TrafficCounter::GetPath("GET /index.php?id=1 HTTP/1.1"));
+  EXPECT_EQ("/a/b", TrafficCounter::GetPath("POST /a/b HTTP/1.0"));
+  EXPECT_EQ("/", TrafficCounter::GetPath("GET /#top HTTP/1.1"));
+  EXPECT_EQ("/x", TrafficCounter::GetPath("GET /x"));
+  EXPECT_EQ("-", TrafficCounter::GetPath("-"));
+}
+
+class TrafficCounterFlushTest : public ::testing::Test {
+ public:
+  ::mock::apache::database::DatabaseFunctionsPtr database_functions;
+  TrafficCounterPtr traffic_counter;
+  ::type::ApacheLogEntry log_entry;
+
+  virtual ~TrafficCounterFlushTest() = default;
+
+  void SetUp() {
+    database_functions = ::mock::apache::database::DatabaseFunctions::Create();
+    traffic_counter = TrafficCounter::Create(database_functions);
+
+    log_entry.agent_name = "agent";
+    log_entry.virtualhost = "vh";
+    log_entry.client_ip = "127.0.0.1";
+    log_entry.time = ::type::Timestamp::Create(10, 15, 0, 3, 1, 2016);
+    log_entry.request = "GET /index.php HTTP/1.1";
+    log_entry.user_agent = "browser";
+
+    EXPECT_CALL(*database_functions, GetTrafficSketches(_, _, _, _)).WillRepeatedly(Return(::apache::type::TrafficSketchesList()));
+  }
+};
+
+TEST_F(TrafficCounterFlushTest, AddLogs_DoesntSaveBeforeSaveInterval) {
+  EXPECT_CALL(*database_functions, SaveTrafficSketches(_)).Times(0);
+
+  traffic_counter->AddLogs({log_entry, log_entry});
+}
+
+TEST_F(TrafficCounterFlushTest, Flush) {
+  ::apache::type::TrafficSketchesList saved;
+  EXPECT_CALL(*database_functions, SaveTrafficSketches(_)).WillOnce(SaveArg<0>(&saved));
+
+  traffic_counter->AddLogs({log_entry, log_entry});
+  traffic_counter->Flush();
+
+  ASSERT_EQ(1u, saved.size());
+  EXPECT_EQ("agent", saved[0].agent_name);
+  EXPECT_EQ("vh", saved[0].virtualhost_name);
+  EXPECT_EQ(2, saved[0].requests_count);
+}
+
+TEST_F(TrafficCounterFlushTest, Flush_WhenNothingChanged) {
+  EXPECT_CALL(*database_functions, SaveTrafficSketches(_)).Times(1);
+
+  traffic_counter->AddLogs({log_entry});
+  traffic_counter->Flush();
+  traffic_counter->Flush();
+}
@@ -8,6 +8,8 @@
 #include "src/apache/database/database_functions.h"
 #include "src/database/exception/detail/item_not_found_exception.h"
 #include "src/database/exception/detail/cant_execute_sql_statement_exception.h"
+#include "src/database/general_database_functions.h"
+#include "src/database/sqlite_wrapper.h"
 
 #include "tests/mock/database/sqlite_wrapper.h"
 #include "tests/mock/database/general_database_functions.h"
@@ -186,3 +188,155 @@ TEST_F(apache_database_DatabaseFunctionsTest, GetLearningSessionsIds_WhenStepThr
 
   EXPECT_THROW(database_functions->GetLearningSessionsIds(1, 2, 10, 0), ::database::exception::detail::CantExecuteSqlStatementException);
 }
+
+TEST_F(apache_database_DatabaseFunctionsTest, GetKnnConfiguration) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1, StrEq(example_agent_name.c_str())));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2, StrEq(example_virtualhost_name.c_str())));
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_ROW));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 0)).WillOnce(Return(1));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1)).WillOnce(Return(8));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2)).WillOnce(Return(32));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 3)).WillOnce(Return(5));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 4)).WillOnce(Return(1));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  auto c = database_functions->GetKnnConfiguration(example_agent_name, example_virtualhost_name);
+
+  EXPECT_EQ(::apache::type::KnnMode::APPROXIMATE, c.mode);
+  EXPECT_EQ(8, c.hnsw_m);
+  EXPECT_EQ(32, c.hnsw_ef);
+  EXPECT_EQ(5, c.neighbours_count);
+  EXPECT_EQ(::apache::type::KnnVoting::DISTANCE_WEIGHTED, c.voting);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, GetKnnConfiguration_WhenRowNotFound) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, _, _)).Times(2);
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_DONE));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  auto c = database_functions->GetKnnConfiguration(example_agent_name, example_virtualhost_name);
+
+  EXPECT_EQ(::apache::type::KnnMode::EXACT, c.mode);
+  EXPECT_EQ(3, c.neighbours_count);
+  EXPECT_EQ(::apache::type::KnnVoting::MAJORITY, c.voting);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, GetRealtimeScoringConfiguration) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1, StrEq(example_agent_name.c_str())));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2, StrEq(example_virtualhost_name.c_str())));
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_ROW));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 0)).WillOnce(Return(1));
+  EXPECT_CALL(*sqlite_wrapper, ColumnDouble(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1)).WillOnce(Return(2.5));
+  EXPECT_CALL(*sqlite_wrapper, ColumnInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2)).WillOnce(Return(50));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  auto c = database_functions->GetRealtimeScoringConfiguration(example_agent_name, example_virtualhost_name);
+
+  EXPECT_TRUE(c.enabled);
+  EXPECT_DOUBLE_EQ(2.5, c.threshold);
+  EXPECT_EQ(50, c.min_requests);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, GetRealtimeScoringConfiguration_WhenRowNotFound) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BindText(DB_STATEMENT_EXAMPLE_PTR_VALUE, _, _)).Times(2);
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_DONE));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  auto c = database_functions->GetRealtimeScoringConfiguration(example_agent_name, example_virtualhost_name);
+
+  EXPECT_FALSE(c.enabled);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, GetFeatureNormalization_WhenRowNotFound) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_DONE));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  auto n = database_functions->GetFeatureNormalization(1, 2);
+
+  EXPECT_EQ(-1, n.learning_set_version);
+  EXPECT_DOUBLE_EQ(0., n.bandwidth_usage.mean);
+  EXPECT_DOUBLE_EQ(1., n.bandwidth_usage.standard_deviation);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, SetFeatureNormalization_WhenStepThrowException) {
+  ::apache::type::FeatureNormalization n = {3, {1., 2.}, {3., 4.}, {5., 6.}, {7., 8.}};
+
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BindDouble(DB_STATEMENT_EXAMPLE_PTR_VALUE, _, _)).Times(7);
+  EXPECT_CALL(*sqlite_wrapper, BindDouble(DB_STATEMENT_EXAMPLE_PTR_VALUE, 4, 4.));
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Throw(::database::exception::detail::CantExecuteSqlStatementException()));
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  EXPECT_THROW(database_functions->SetFeatureNormalization(1, 2, n), ::database::exception::detail::CantExecuteSqlStatementException);
+}
+
+TEST_F(apache_database_DatabaseFunctionsTest, RemoveAllLearningSessions_IncrementsLearningSetVersion) {
+  InSequence s;
+  EXPECT_CALL(*sqlite_wrapper, Exec(HasSubstr("delete from APACHE_LEARNING_SESSIONS"), _, _));
+  EXPECT_CALL(*sqlite_wrapper, Exec(AllOf(HasSubstr("APACHE_LEARNING_SET_VERSIONS"),
+                                          HasSubstr("VERSION=VERSION+1")), _, _));
+
+  database_functions->RemoveAllLearningSessions(1, 2);
+}
+
+// sessions are marked in a real database, the fences depend on all of them
+class apache_database_DatabaseFunctionsIqrTest : public ::testing::Test {
+ public:
+  ::database::SQLiteWrapperPtr sqlite_wrapper;
+  ::apache::database::DatabaseFunctionsPtr database_functions;
+
+  virtual ~apache_database_DatabaseFunctionsIqrTest() = default;
+
+  void SetUp() {
+    sqlite_wrapper = ::database::SQLiteWrapper::Create();
+    sqlite_wrapper->Open(":memory:");
+    auto general_database_functions = ::database::GeneralDatabaseFunctions::Create(nullptr, sqlite_wrapper);
+    general_database_functions->CreateTables();
+    database_functions = ::apache::database::DatabaseFunctions::Create(nullptr, sqlite_wrapper, general_database_functions);
+    database_functions->CreateTables();
+  }
+
+  void TearDown() {
+    sqlite_wrapper->Close();
+  }
+
+  ::database::type::RowIds GetAnomalies() {
+    ::database::type::RowIds ids;
+    sqlite3_stmt *statement = nullptr;
+    sqlite_wrapper->Prepare("select ID from APACHE_SESSION_TABLE where CLASSIFICATION=" +
+                            to_string(static_cast<int> (::database::type::Classification::ANOMALY)) + " order by ID;", &statement);
+    while (sqlite_wrapper->Step(statement) == SQLITE_ROW)
+      ids.push_back(sqlite_wrapper->ColumnInt64(statement, 0));
+    sqlite_wrapper->Finalize(statement);
+
+    return ids;
+  }
+};
+
+TEST_F(apache_database_DatabaseFunctionsIqrTest, MarkLearningSetWithIqrMethod_WhenMostSessionsHaveNoErrors) {
+  // most sessions have no errors and are one request long, session 100
+  // sends many more requests than the others
+  sqlite_wrapper->Exec("with recursive N(X) as (select 1 union all select X + 1 from N where X<100) "
+                       "insert into APACHE_SESSION_TABLE (ID, AGENT_NAME, VIRTUALHOST, SESSION_LENGTH, BANDWIDTH_USAGE, REQUESTS_COUNT, ERRORS_COUNT, ERROR_PERCENTAGE) "
+                       " select X, 'agent', 'vh', "
+                       "   case when X % 5=0 then X * 10 else 0 end, "
+                       "   1000 + X, "
+                       "   case when X=100 then 1000 else 10 + X % 10 end, "
+                       "   case when X % 10=1 then 1 else 0 end, "
+                       "   case when X % 10=1 then 5 else 0 end "
+                       " from N;");
+
+  ::database::type::RowIds ids;
+  for (::database::type::RowId id = 1; id <= 100; ++id)
+    ids.push_back(id);
+  database_functions->SetLearningSessions(1, 1, ids);
+
+  database_functions->MarkLearningSetWithIqrMethod(1, 1);
+
+  EXPECT_EQ(::database::type::RowIds({100}), GetAnomalies());
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+#include <json/json.hpp>
+
+#include "src/apache/web/command_executor_object.h"
+
+#include "tests/mock/apache/database/database_functions.h"
+#include "tests/mock/database/general_database_functions.h"
+
+using namespace nlohmann;
+using namespace testing;
+using namespace std;
+
+class apache_web_CommandExecutorObjectTest : public ::testing::Test {
+ public:
+  virtual ~apache_web_CommandExecutorObjectTest() = default;
+
+  void SetUp() override {
+    general_database_functions = ::mock::database::GeneralDatabaseFunctions::Create();
+    apache_database_functions = ::mock::apache::database::DatabaseFunctions::Create();
+    command_object = ::apache::web::CommandExecutorObject::Create(nullptr,
+                                                                  general_database_functions,
+                                                                  apache_database_functions,
+                                                                  ::analyzer::WorkerPool::Create(2));
+  }
+
+  string SetKnnConfiguration(const string &m, const string &ef, const string &neighbours_count) {
+    json j;
+    j["command"] = "set_apache_knn_configuration";
+    j["args"] = {"agent", "vh", "approximate", m, ef, neighbours_count, "majority"};
+
+    return command_object->Execute(j.dump());
+  }
+
+  ::mock::database::GeneralDatabaseFunctionsPtr general_database_functions;
+  ::mock::apache::database::DatabaseFunctionsPtr apache_database_functions;
+  ::apache::web::CommandExecutorObjectPtr command_object;
+};
+
+TEST_F(apache_web_CommandExecutorObjectTest, SetApacheKnnConfiguration) {
+  ::apache::type::KnnConfiguration c;
+  EXPECT_CALL(*apache_database_functions, SetKnnConfiguration("agent", "vh", _)).WillOnce(SaveArg<2>(&c));
+
+  auto j = json::parse(SetKnnConfiguration("16", "64", "5"));
+
+  EXPECT_EQ("ok", j["status"].get<string>());
+  EXPECT_EQ(::apache::type::KnnMode::APPROXIMATE, c.mode);
+  EXPECT_EQ(16u, c.hnsw_m);
+  EXPECT_EQ(64u, c.hnsw_ef);
+  EXPECT_EQ(5u, c.neighbours_count);
+  EXPECT_EQ(::apache::type::KnnVoting::MAJORITY, c.voting);
+}
+
+TEST_F(apache_web_CommandExecutorObjectTest, SetApacheKnnConfiguration_WhenNumbersAreWrong) {
+  EXPECT_CALL(*apache_database_functions, SetKnnConfiguration(_, _, _)).Times(0);
+
+  const auto error = ::web::type::CommandExecutorObjectInterface::GetInvalidArgumentErrorJson();
+  EXPECT_EQ(error, SetKnnConfiguration("abc", "64", "5"));
+  EXPECT_EQ(error, SetKnnConfiguration("16", "", "5"));
+  EXPECT_EQ(error, SetKnnConfiguration("16", "64", "-1"));
+  EXPECT_EQ(error, SetKnnConfiguration("16", "64", "0"));
+  EXPECT_EQ(error, SetKnnConfiguration("16", "64", "5x"));
+  EXPECT_EQ(error, SetKnnConfiguration("1", "64", "5"));
+  EXPECT_EQ(error, SetKnnConfiguration("16", "99999999999999999999", "5"));
+  EXPECT_EQ(error, SetKnnConfiguration("4294967297", "64", "5"));
+}
+
+TEST_F(apache_web_CommandExecutorObjectTest, EvaluateApacheApproximateKnn_WhenNumbersAreWrong) {
+  EXPECT_CALL(*apache_database_functions, GetKnnConfiguration("agent", "vh")).WillRepeatedly(Return(::apache::type::KnnConfiguration()));
+  EXPECT_CALL(*apache_database_functions, GetLearningSessions(_, _, _, _)).Times(0);
+
+  const auto error = ::web::type::CommandExecutorObjectInterface::GetInvalidArgumentErrorJson();
+  EXPECT_EQ(error, command_object->Execute("{ \"command\" : \"evaluate_apache_approximate_knn\", \"args\" : [ \"agent\", \"vh\", \"abc\", \"64\" ] }"));
+  EXPECT_EQ(error, command_object->Execute("{ \"command\" : \"evaluate_apache_approximate_knn\", \"args\" : [ \"agent\", \"vh\", \"16\", \"-1\" ] }"));
+}
@@ -0,0 +1,111 @@
+#include <gmock/gmock.h>
+
+#include "src/bash/analyzer/command_sequence_model.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::analyzer;
+
+namespace
+{
+
+class MockNotifier : public ::notifier::detail::NotifierInterface {
+ public:
+  MOCK_METHOD0(Loop, void());
+  MOCK_METHOD0(StopLoop, void());
+  MOCK_CONST_METHOD0(IsRunning, bool());
+  MOCK_METHOD1(AddMessages, void(::notifier::type::NotifierMessages messages));
+};
+
+const ::type::Timestamp TIME = ::type::Timestamp::Create(10, 0, 0, 1, 2, 2017);
+
+// commands 1, 2, 3, 1, 2, 3, ...
+double AddCycle(CommandSequenceModelPtr model, const string &agent_name, int user_id, unsigned long long count) {
+  double surprise = 0;
+  for (unsigned long long i = 0; i < count; ++i)
+    surprise = model->AddCommand(agent_name, user_id, TIME, i % 3 + 1, "ls");
+
+  return surprise;
+}
+
+}
+
+TEST(CommandSequenceModelTest, RepeatedSequenceIsNotSurprising) {
+  auto notifier = make_shared<MockNotifier>();
+  auto model = CommandSequenceModel::Create(notifier);
+  EXPECT_CALL(*notifier, AddMessages(_)).Times(0);
+
+  const double first = AddCycle(model, "agent", 1000, 3);
+  const double last = AddCycle(model, "agent", 1000, 300);
+
+  EXPECT_GT(first, 1);
+  EXPECT_LT(last, 1);
+  EXPECT_LT(model->GetAverageSurprise("agent", 1000), 1);
+
+  // seen command after an unseen transition
+  EXPECT_GT(model->AddCommand("agent", 1000, TIME, 3, "ls"), 1);
+  EXPECT_GT(model->AddCommand("agent", 1000, TIME, 50, "nc"), 5);
+}
+
+TEST(CommandSequenceModelTest, UsersAreScoredSeparately) {
+  auto notifier = make_shared<MockNotifier>();
+  auto model = CommandSequenceModel::Create(notifier);
+  EXPECT_CALL(*notifier, AddMessages(_)).Times(0);
+
+  AddCycle(model, "agent", 1000, 300);
+  AddCycle(model, "agent", 1001, 2);
+  AddCycle(model, "other", 1000, 2);
+
+  const double trained = model->AddCommand("agent", 1000, TIME, 1, "ls");
+  EXPECT_LT(trained, model->AddCommand("agent", 1001, TIME, 3, "ls"));
+  EXPECT_LT(trained, model->AddCommand("other", 1000, TIME, 3, "ls"));
+
+  EXPECT_DOUBLE_EQ(0, model->GetAverageSurprise("agent", 1002));
+}
+
+TEST(CommandSequenceModelTest, NoReportsDuringWarmUp) {
+  auto notifier = make_shared<MockNotifier>();
+  auto model = CommandSequenceModel::Create(notifier);
+  EXPECT_CALL(*notifier, AddMessages(_)).Times(0);
+
+  for (unsigned long long i = 0; i < CommandSequenceModel::WARM_UP_COMMANDS; ++i)
+    model->AddCommand("agent", 1000, TIME, i + 1, "ls");
+
+  EXPECT_GT(model->GetAverageSurprise("agent", 1000), CommandSequenceModel::THRESHOLD);
+}
+
+TEST(CommandSequenceModelTest, ReportsUnusualCommandsOnce) {
+  auto notifier = make_shared<MockNotifier>();
+  auto model = CommandSequenceModel::Create(notifier);
+
+  AddCycle(model, "agent", 1000, CommandSequenceModel::WARM_UP_COMMANDS);
+  EXPECT_LT(model->GetAverageSurprise("agent", 1000), CommandSequenceModel::THRESHOLD);
+
+  ::notifier::type::NotifierMessages messages;
+  EXPECT_CALL(*notifier, AddMessages(_)).WillOnce(SaveArg<0>(&messages));
+
+  for (int i = 0; i < 100; ++i)
+    model->AddCommand("agent", 1000, TIME, 1000 + i, "nc");
+
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ("Bash Command Sequences", messages.front()->GetModuleName());
+  EXPECT_THAT(messages.front()->GetDetectionResults(), HasSubstr("User ID:                 1000"));
+}
+
+TEST(CommandSequenceModelTest, NovelTransitionIsSurprisingAfterManyCommands) {
+  auto notifier = make_shared<MockNotifier>();
+  auto model = CommandSequenceModel::Create(notifier);
+  EXPECT_CALL(*notifier, AddMessages(_)).Times(AnyNumber());
+
+  // many times more n-grams than counters, estimates of a sketch which
+  // isn't aged would be far too large
+  unsigned long long random = 1;
+  for (unsigned long long i = 0; i < 2000000; ++i) {
+    random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+    model->AddCommand("agent", 2000 + i % 1000, TIME, 1000 + (random >> 33) % 100000, "ls");
+  }
+
+  AddCycle(model, "agent", 1000, 3000);
+
+  EXPECT_GT(model->AddCommand("agent", 1000, TIME, 50, "nc"), CommandSequenceModel::THRESHOLD);
+}
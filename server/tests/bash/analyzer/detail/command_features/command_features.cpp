@@ -0,0 +1,76 @@
+#include <gmock/gmock.h>
+
+#include "src/bash/analyzer/detail/command_features/command_features.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::analyzer::detail::command_features;
+using bash::database::detail::entity::DailyUserCommandStatistic;
+using bash::database::detail::entity::DailyUserCommandsStatistics;
+
+namespace
+{
+
+DailyUserCommandStatistic CreateStatistic(::database::type::RowId command_id, ::database::type::RowsCount summary) {
+  DailyUserCommandStatistic s;
+  s.id = 0;
+  s.daily_user_statistic_id = 0;
+  s.command_id = command_id;
+  s.summary = summary;
+  return s;
+}
+
+}
+
+TEST(CommandFeaturesTest, ColumnsFollowCommandsOrder) {
+  ::database::type::RowIds commands_ids;
+  // more commands than the old fixed number of inputs, not sorted
+  for (int i = 0; i < 300; ++i)
+    commands_ids.push_back(1000 - i * 3);
+
+  CommandFeatures features(commands_ids);
+  unsigned column;
+
+  EXPECT_EQ(commands_ids.size(), features.GetNumberOfColumns());
+  for (unsigned i = 0; i < commands_ids.size(); ++i) {
+    ASSERT_TRUE(features.GetColumn(commands_ids[i], column));
+    EXPECT_EQ(i, column);
+  }
+
+  EXPECT_FALSE(features.GetColumn(999, column));
+  EXPECT_FALSE(features.GetColumn(0, column));
+}
+
+TEST(CommandFeaturesTest, EmptyMapping) {
+  CommandFeatures features;
+  unsigned column;
+
+  EXPECT_EQ(0u, features.GetNumberOfColumns());
+  EXPECT_FALSE(features.GetColumn(1, column));
+}
+
+TEST(CommandFeaturesTest, AddRowSkipsNotSelectedCommands) {
+  CommandFeatures features({7, 3, 5});
+  SparseRows rows;
+
+  features.AddRow({CreateStatistic(3, 1), CreateStatistic(4, 100), CreateStatistic(5, 600)}, rows);
+  features.AddRow({}, rows);
+  features.AddRow({CreateStatistic(7, 4)}, rows);
+
+  ASSERT_EQ(3u, rows.Size());
+  EXPECT_THAT(rows.offsets, ElementsAre(0, 2, 2, 3));
+  EXPECT_THAT(rows.columns, ElementsAre(1, 2, 0));
+
+  fann_type dense[4] = {9, 9, 9, 9};
+  rows.ToDense(0, 4, dense);
+  EXPECT_THAT(dense, ElementsAre(0, FloatEq(0.1f), FloatEq(1.0f), 0));
+
+  rows.ToDense(1, 4, dense);
+  EXPECT_THAT(dense, ElementsAre(0, 0, 0, 0));
+
+  rows.ToDense(2, 3, dense);
+  EXPECT_THAT(dense, ElementsAre(FloatEq(0.2f), 0, 0, 0));
+
+  rows.Clear();
+  EXPECT_EQ(0u, rows.Size());
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <gmock/gmock.h>
+
+#include "src/bash/analyzer/detail/command_summary_divider/command_summary_divider.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::analyzer::detail::command_summary_divider;
+
+namespace
+{
+
+// first summary of every interval
+const vector<long long> INTERVALS_BEGINS = {0, 1, 3, 6, 11, 20, 37, 70, 135, 264, 521};
+
+unsigned GetExpectedInterval(long long summary) {
+  unsigned interval = 0;
+  while (interval + 1 < INTERVALS_BEGINS.size() && INTERVALS_BEGINS[interval + 1] <= summary)
+    ++interval;
+
+  return interval;
+}
+
+vector<long long> CreateSummaries() {
+  vector<long long> summaries;
+  for (long long s = -10; s < 5000; ++s)
+    summaries.push_back(s);
+
+  summaries.push_back(numeric_limits<long long>::min());
+  summaries.push_back(numeric_limits<long long>::max());
+  summaries.push_back(1ll << 32);
+  summaries.push_back((1ll << 32) + 5);
+  summaries.push_back(-(1ll << 32));
+
+  return summaries;
+}
+
+}
+
+TEST(CommandSummaryDividerTest, IntervalsBegins) {
+  ASSERT_EQ(CommandSummaryDivider::NUMBER_OF_INTERVALS, INTERVALS_BEGINS.size());
+
+  for (unsigned i = 0; i < INTERVALS_BEGINS.size(); ++i)
+    EXPECT_EQ(INTERVALS_BEGINS[i], CommandSummaryDivider::GetIntervalBegin(i));
+
+  // interval i > 0 holds 2 ^ (i - 1) + 1 summaries
+  for (unsigned i = 1; i + 1 < INTERVALS_BEGINS.size(); ++i)
+    EXPECT_EQ((1ll << (i - 1)) + 1, INTERVALS_BEGINS[i + 1] - INTERVALS_BEGINS[i]);
+}
+
+TEST(CommandSummaryDividerTest, EverySummary) {
+  CommandSummaryDivider divider;
+
+  for (long long summary : CreateSummaries()) {
+    const unsigned interval = GetExpectedInterval(summary);
+
+    ASSERT_EQ(interval, CommandSummaryDivider::GetInterval(summary)) << summary;
+    ASSERT_FLOAT_EQ(interval / 10.0f, divider(summary)) << summary;
+  }
+}
+
+TEST(CommandSummaryDividerTest, TableMatchesFormula) {
+  for (long long summary = 0; summary <= CommandSummaryDivider::MAX_SUMMARY; ++summary)
+    ASSERT_EQ(CommandSummaryDivider::GetValue(summary), CommandSummaryDivider::TABLE[summary]) << summary;
+}
+
+TEST(CommandSummaryDividerTest, Avx2EqualsScalar) {
+  const vector<long long> summaries = CreateSummaries();
+  vector<float> scalar(summaries.size()), avx2(summaries.size(), -1), selected(summaries.size(), -1);
+
+  DivideScalar(summaries.data(), summaries.size(), scalar.data());
+  DivideAvx2(summaries.data(), summaries.size(), avx2.data());
+  Divide(summaries.data(), summaries.size(), selected.data());
+
+  EXPECT_EQ(scalar, avx2);
+  EXPECT_EQ(scalar, selected);
+
+  // tail shorter than a vector
+  DivideAvx2(summaries.data() + 13, 5, avx2.data());
+  EXPECT_TRUE(equal(avx2.begin(), avx2.begin() + 5, scalar.begin() + 13));
+}
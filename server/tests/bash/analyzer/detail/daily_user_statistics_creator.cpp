@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+
+#include "src/bash/analyzer/detail/daily_user_statistics_creator.h"
+#include "src/bash/database/database_functions.h"
+#include "src/database/general_database_functions.h"
+#include "src/database/sqlite_wrapper.h"
+
+using namespace testing;
+using namespace std;
+using ::bash::analyzer::detail::DailyUserStatisticsCreator;
+
+class bash_analyzer_detail_DailyUserStatisticsCreatorTest : public ::testing::Test {
+ public:
+  ::database::SQLiteWrapperPtr sqlite_wrapper;
+  ::database::GeneralDatabaseFunctionsPtr general_database_functions;
+  ::bash::database::DatabaseFunctionsPtr database_functions;
+  ::bash::analyzer::detail::DailyUserStatisticsCreatorPtr creator;
+  const ::type::Date first_day;
+  const ::type::Date second_day;
+  const ::type::Date today;
+  const long long first_day_logs_count;
+
+  bash_analyzer_detail_DailyUserStatisticsCreatorTest() :
+  first_day(::type::Date::Create(1, 3, 2016)),
+  second_day(::type::Date::Create(2, 3, 2016)),
+  today(::type::Date::Create(3, 3, 2016)),
+  first_day_logs_count(DailyUserStatisticsCreator::CHUNK_LOGS * 2 + 500) {
+  }
+  virtual ~bash_analyzer_detail_DailyUserStatisticsCreatorTest() = default;
+
+  void SetUp() {
+    sqlite_wrapper = ::database::SQLiteWrapper::Create();
+    sqlite_wrapper->Open(":memory:");
+    general_database_functions = ::database::GeneralDatabaseFunctions::Create(nullptr, sqlite_wrapper);
+    general_database_functions->CreateTables();
+    database_functions = ::bash::database::DatabaseFunctions::Create(sqlite_wrapper, general_database_functions);
+    database_functions->CreateTables();
+    creator = DailyUserStatisticsCreator::Create(database_functions, general_database_functions);
+
+    general_database_functions->AddAgentName("agent");
+    const auto first_day_id = general_database_functions->AddAndGetDateId(first_day);
+    const auto second_day_id = general_database_functions->AddAndGetDateId(second_day);
+    const auto today_id = general_database_functions->AddAndGetDateId(today);
+
+    // the first day is longer than two chunks, commands of its logs are 1, 2, 3, 1, 2, ...
+    AddLogs(first_day_logs_count, first_day_id, "(ID - 1) % 3 + 1");
+    AddLogs(3, second_day_id, "1");
+    AddLogs(2, today_id, "1");
+  }
+
+  void TearDown() {
+    sqlite_wrapper->Close();
+  }
+
+  void AddLogs(long long count, ::database::type::RowId date_id, const string &command_id) {
+    sqlite_wrapper->Exec("with recursive N(X) as (select 1 union all select X + 1 from N where X<" + to_string(count) + ") "
+                         "insert into BASH_LOGS_TABLE (ID, AGENT_NAME_ID, TIME_ID, DATE_ID, USER_ID, COMMAND_ID) "
+                         " select ID, 1, 1, " + to_string(date_id) + ", 1, " + command_id +
+                         " from (select X + coalesce((select max(ID) from BASH_LOGS_TABLE), 0) as ID from N);");
+  }
+
+  long long GetSummary(const ::type::Date &date, ::database::type::RowId command_id) {
+    return sqlite_wrapper->GetFirstInt64Column("select C.SUMMARY from BASH_DAILY_USER_COMMAND_STATISTICS_TABLE as C "
+                                               " join BASH_DAILY_USER_STATISTICS_TABLE as S on S.ID=C.STATISTIC_ID "
+                                               " where S.USER_ID=1 and S.DATE_ID=" + to_string(general_database_functions->GetDateId(date)) +
+                                               " and C.COMMAND_ID=" + to_string(command_id) + ";", 0);
+  }
+
+  void ExpectFinalCounts() {
+    const long long per_command = first_day_logs_count / 3;
+
+    EXPECT_EQ(per_command + (first_day_logs_count % 3 >= 1 ? 1 : 0), GetSummary(first_day, 1));
+    EXPECT_EQ(per_command + (first_day_logs_count % 3 >= 2 ? 1 : 0), GetSummary(first_day, 2));
+    EXPECT_EQ(per_command, GetSummary(first_day, 3));
+    EXPECT_EQ(3, GetSummary(second_day, 1));
+    EXPECT_EQ(0, GetSummary(today, 1));
+    EXPECT_EQ(2, sqlite_wrapper->GetFirstInt64Column("select count(*) from BASH_DAILY_USER_STATISTICS_TABLE;"));
+    EXPECT_EQ(first_day_logs_count + 3, general_database_functions->GetWatermark(DailyUserStatisticsCreator::WATERMARK_STAGE, 1));
+  }
+};
+
+TEST_F(bash_analyzer_detail_DailyUserStatisticsCreatorTest, CreateStatistics) {
+  creator->CreateStatistics(today);
+
+  ExpectFinalCounts();
+}
+
+TEST_F(bash_analyzer_detail_DailyUserStatisticsCreatorTest, CreateStatistics_WhenRunAgain) {
+  creator->CreateStatistics(today);
+  creator->CreateStatistics(today);
+
+  ExpectFinalCounts();
+}
+
+TEST_F(bash_analyzer_detail_DailyUserStatisticsCreatorTest, CreateStatistics_ResumesAfterPartialRun) {
+  // the first chunk was saved before the previous run stopped
+  database_functions->CreateDailyUserStatistics(1, 0, DailyUserStatisticsCreator::CHUNK_LOGS, DailyUserStatisticsCreator::WATERMARK_STAGE);
+
+  creator->CreateStatistics(today);
+
+  ExpectFinalCounts();
+}
+
+TEST_F(bash_analyzer_detail_DailyUserStatisticsCreatorTest, CreateStatistics_DayByDay) {
+  creator->CreateStatistics(second_day);
+  EXPECT_EQ(first_day_logs_count, general_database_functions->GetWatermark(DailyUserStatisticsCreator::WATERMARK_STAGE, 1));
+  EXPECT_EQ(0, GetSummary(second_day, 1));
+
+  creator->CreateStatistics(today);
+
+  ExpectFinalCounts();
+}
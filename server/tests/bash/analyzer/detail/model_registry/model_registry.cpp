@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+
+#include "mock/library/fann/fann_wrapper.h"
+#include "src/bash/analyzer/detail/model_registry/model_registry.h"
+#include "src/bash/analyzer/detail/network_trainer/training_state.h"
+#include "src/bash/database/database_functions.h"
+#include "src/database/general_database_functions.h"
+#include "src/database/sqlite_wrapper.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::analyzer::detail::model_registry;
+using namespace bash::analyzer::detail::network_trainer;
+
+namespace
+{
+
+const string DIRECTORY = "/tmp";
+const ::database::type::RowId CONFIGURATION_ID = 987654;
+
+void SaveState(unsigned version) {
+  TrainingState s = TrainingState();
+  s.version = version;
+  s.users_ids = {1, 2};
+  s.commands_ids = {10, 11, 12};
+
+  ASSERT_TRUE(SaveTrainingState(DIRECTORY + "/network-" + to_string(CONFIGURATION_ID) + ".state", s));
+}
+
+void RemoveState() {
+  remove((DIRECTORY + "/network-" + to_string(CONFIGURATION_ID) + ".state").c_str());
+}
+
+::bash::database::DatabaseFunctionsPtr CreateDatabaseFunctions(::database::SQLiteWrapperPtr sqlite_wrapper) {
+  sqlite_wrapper->Open(":memory:");
+  auto general_database_functions = ::database::GeneralDatabaseFunctions::Create(nullptr, sqlite_wrapper);
+  general_database_functions->CreateTables();
+  auto database_functions = ::bash::database::DatabaseFunctions::Create(sqlite_wrapper, general_database_functions);
+  database_functions->CreateTables();
+
+  return database_functions;
+}
+
+}
+
+TEST(ModelRegistryTest, GetLoadsModelOnce) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto registry = ModelRegistry::Create(CreateDatabaseFunctions(::database::SQLiteWrapper::Create()), DIRECTORY, fann_wrapper);
+  SaveState(3);
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(registry->GetNetworkFilePath(CONFIGURATION_ID))).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, GetNumInput(ann)).WillRepeatedly(Return(100));
+  EXPECT_CALL(*fann_wrapper, GetNumOutput(ann)).WillRepeatedly(Return(2));
+  EXPECT_CALL(*fann_wrapper, Destroy(ann));
+
+  auto model = registry->Get(CONFIGURATION_ID);
+  RemoveState();
+
+  ASSERT_TRUE(model != nullptr);
+  EXPECT_EQ(3u, model->version);
+  EXPECT_EQ(ann, model->network.get());
+  EXPECT_EQ(::database::type::RowIds({1, 2}), model->users_ids);
+
+  // network trained with a fixed number of inputs, the rest stay 0
+  EXPECT_EQ(100u, model->number_of_inputs);
+  EXPECT_EQ(3u, model->features.GetNumberOfColumns());
+  unsigned column;
+  ASSERT_TRUE(model->features.GetColumn(12, column));
+  EXPECT_EQ(2u, column);
+
+  EXPECT_EQ(model, registry->Get(CONFIGURATION_ID));
+
+  model.reset();
+  registry->Prune({});
+}
+
+TEST(ModelRegistryTest, UpdateReplacesModel) {
+  char buffers[2];
+  struct fann *old_ann = reinterpret_cast<struct fann*> (&buffers[0]);
+  struct fann *new_ann = reinterpret_cast<struct fann*> (&buffers[1]);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto registry = ModelRegistry::Create(CreateDatabaseFunctions(::database::SQLiteWrapper::Create()), DIRECTORY, fann_wrapper);
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(_)).WillOnce(Return(old_ann)).WillOnce(Return(new_ann));
+  EXPECT_CALL(*fann_wrapper, GetNumInput(_)).WillRepeatedly(Return(3));
+  EXPECT_CALL(*fann_wrapper, GetNumOutput(_)).WillRepeatedly(Return(2));
+
+  SaveState(1);
+  auto old_model = registry->Get(CONFIGURATION_ID);
+  SaveState(2);
+  EXPECT_TRUE(registry->Update(CONFIGURATION_ID));
+  RemoveState();
+
+  // the old network is destroyed when its last user releases it
+  EXPECT_CALL(*fann_wrapper, Destroy(old_ann));
+  ASSERT_TRUE(old_model != nullptr);
+  EXPECT_EQ(1u, old_model->version);
+  EXPECT_EQ(2u, registry->Get(CONFIGURATION_ID)->version);
+  old_model.reset();
+
+  EXPECT_CALL(*fann_wrapper, Destroy(new_ann));
+  registry->Prune({});
+}
+
+TEST(ModelRegistryTest, InvalidNetworkIsNotUsed) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto registry = ModelRegistry::Create(CreateDatabaseFunctions(::database::SQLiteWrapper::Create()), DIRECTORY, fann_wrapper);
+
+  EXPECT_EQ(nullptr, registry->Get(CONFIGURATION_ID));
+
+  SaveState(1);
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(_)).Times(2).WillRepeatedly(Return(ann));
+  EXPECT_CALL(*fann_wrapper, GetNumOutput(ann)).WillOnce(Return(5)).WillOnce(Return(2));
+  EXPECT_CALL(*fann_wrapper, GetNumInput(ann)).WillOnce(Return(2));
+  EXPECT_CALL(*fann_wrapper, Destroy(ann)).Times(2);
+
+  EXPECT_EQ(nullptr, registry->Get(CONFIGURATION_ID));
+  // fewer inputs than selected commands
+  EXPECT_EQ(nullptr, registry->Get(CONFIGURATION_ID));
+  RemoveState();
+}
+
+TEST(ModelRegistryTest, GetLoadsNetworkWithoutState) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto sqlite_wrapper = ::database::SQLiteWrapper::Create();
+  auto registry = ModelRegistry::Create(CreateDatabaseFunctions(sqlite_wrapper), DIRECTORY, fann_wrapper);
+
+  // users 1 and 2 selected for the configuration, commands 10 and 11 marked
+  sqlite_wrapper->Exec("insert into BASH_DAILY_USER_STATISTICS_TABLE (ID, AGENT_NAME_ID, USER_ID, DATE_ID) values (1, 1, 1, 1), (2, 1, 2, 1);");
+  sqlite_wrapper->Exec("insert into BASH_ANOMALY_DETECTION_CONFIGURATION_SELECTED_STATISTICS_TABLE (CONFIGURATION_ID, STATISTIC_ID) "
+                       " values (" + to_string(CONFIGURATION_ID) + ", 1), (" + to_string(CONFIGURATION_ID) + ", 2);");
+  sqlite_wrapper->Exec("insert into BASH_SELECTED_COMMANDS_TABLE (CONFIGURATION_ID, COMMAND_ID) "
+                       " values (" + to_string(CONFIGURATION_ID) + ", 11), (" + to_string(CONFIGURATION_ID) + ", 10);");
+
+  // network trained before training states were saved
+  RemoveState();
+  const string network_file_path = registry->GetNetworkFilePath(CONFIGURATION_ID);
+  ofstream(network_file_path.c_str()) << "FANN_FLO_2.1\n";
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(network_file_path)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, GetNumInput(ann)).WillRepeatedly(Return(100));
+  EXPECT_CALL(*fann_wrapper, GetNumOutput(ann)).WillRepeatedly(Return(2));
+  EXPECT_CALL(*fann_wrapper, Destroy(ann));
+
+  auto model = registry->Get(CONFIGURATION_ID);
+  remove(network_file_path.c_str());
+
+  ASSERT_TRUE(model != nullptr);
+  EXPECT_EQ(0u, model->version);
+  EXPECT_EQ(::database::type::RowIds({1, 2}), model->users_ids);
+  EXPECT_EQ(100u, model->number_of_inputs);
+  EXPECT_EQ(2u, model->features.GetNumberOfColumns());
+  unsigned column;
+  ASSERT_TRUE(model->features.GetColumn(11, column));
+  EXPECT_EQ(1u, column);
+
+  model.reset();
+  registry->Prune({});
+}
@@ -0,0 +1,100 @@
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+
+#include "src/bash/analyzer/detail/network_trainer/training_state.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::analyzer::detail::network_trainer;
+using ::database::type::Classification;
+
+namespace
+{
+
+TrainingState CreateState() {
+  TrainingState s;
+  s.version = 3;
+  s.users_ids = {1, 2};
+  s.commands_ids = {10, 11, 12};
+  s.rows = {
+    {1, Classification::NORMAL},
+    {2, Classification::ANOMALY},
+    {5, Classification::NORMAL}
+  };
+  s.is_warm_start = false;
+  s.epochs = 42;
+  s.training_time = 1.5;
+  s.train_error = 0.01;
+  s.validation_error = 0.02;
+
+  return s;
+}
+
+}
+
+TEST(TrainingStateTest, GetTrainingMode) {
+  const auto previous = CreateState();
+  auto current = CreateState();
+
+  EXPECT_EQ(TrainingMode::NONE, GetTrainingMode(previous, current));
+
+  current.rows.push_back({7, Classification::ANOMALY});
+  EXPECT_EQ(TrainingMode::INCREMENTAL, GetTrainingMode(previous, current));
+
+  current.rows[1].second = Classification::NORMAL;
+  EXPECT_EQ(TrainingMode::FULL, GetTrainingMode(previous, current));
+
+  current = CreateState();
+  current.rows.erase(current.rows.begin());
+  EXPECT_EQ(TrainingMode::FULL, GetTrainingMode(previous, current));
+
+  current = CreateState();
+  current.commands_ids.push_back(13);
+  EXPECT_EQ(TrainingMode::FULL, GetTrainingMode(previous, current));
+
+  current = CreateState();
+  current.users_ids.push_back(3);
+  EXPECT_EQ(TrainingMode::FULL, GetTrainingMode(previous, current));
+}
+
+TEST(TrainingStateTest, SaveAndLoad) {
+  const string file_path = "/tmp/slas-training-state-test.state";
+  const auto state = CreateState();
+
+  ASSERT_TRUE(SaveTrainingState(file_path, state));
+
+  TrainingState loaded;
+  ASSERT_TRUE(LoadTrainingState(file_path, loaded));
+  remove(file_path.c_str());
+
+  EXPECT_EQ(state.users_ids, loaded.users_ids);
+  EXPECT_EQ(state.commands_ids, loaded.commands_ids);
+  EXPECT_EQ(state.rows, loaded.rows);
+  EXPECT_EQ(3u, loaded.version);
+  EXPECT_EQ(42u, loaded.epochs);
+  EXPECT_DOUBLE_EQ(1.5, loaded.training_time);
+  EXPECT_EQ(TrainingMode::NONE, GetTrainingMode(state, loaded));
+}
+
+TEST(TrainingStateTest, LoadMissingFile) {
+  TrainingState state;
+
+  EXPECT_FALSE(LoadTrainingState("/tmp/slas-training-state-test-missing.state", state));
+}
+
+TEST(TrainingStateTest, LoadWithSizesLargerThanFile) {
+  const string file_path = "/tmp/slas-training-state-test-damaged.state";
+  TrainingState state;
+
+  for (const string content : {"users 18446744073709551615 1 2\n",
+                               "users 2 1 2\ncommands 100000000 10\n",
+                               "users 2 1 2\ncommands 1 10\nrows 4611686018427387904\n1 0\n",
+                               "users 2 1 2\ncommands 1 10\nrows 3\n1 0\n"}) {
+    ofstream(file_path.c_str()) << content;
+
+    EXPECT_FALSE(LoadTrainingState(file_path, state)) << content;
+  }
+
+  remove(file_path.c_str());
+}
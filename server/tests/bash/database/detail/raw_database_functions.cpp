@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+
+#include "src/bash/database/detail/raw_database_functions.h"
+#include "src/database/general_database_functions.h"
+#include "src/database/sqlite_wrapper.h"
+
+using namespace testing;
+using namespace std;
+
+// statistics are counted in sql, so they are checked on a database in memory
+class bash_database_detail_RawDatabaseFunctionsTest : public ::testing::Test {
+ public:
+  ::database::SQLiteWrapperPtr sqlite_wrapper;
+  ::database::GeneralDatabaseFunctionsPtr general_database_functions;
+  ::bash::database::detail::RawDatabaseFunctionsPtr raw_database_functions;
+  const string stage;
+
+  bash_database_detail_RawDatabaseFunctionsTest() :
+  stage("example_stage") {
+  }
+  virtual ~bash_database_detail_RawDatabaseFunctionsTest() = default;
+
+  void SetUp() {
+    sqlite_wrapper = ::database::SQLiteWrapper::Create();
+    sqlite_wrapper->Open(":memory:");
+    general_database_functions = ::database::GeneralDatabaseFunctions::Create(nullptr, sqlite_wrapper);
+    general_database_functions->CreateTables();
+    raw_database_functions = ::bash::database::detail::RawDatabaseFunctions::Create(sqlite_wrapper);
+    raw_database_functions->CreateTables();
+  }
+
+  void TearDown() {
+    sqlite_wrapper->Close();
+  }
+
+  void AddLog(::database::type::RowId id, ::database::type::RowId user_id,
+              ::database::type::RowId date_id, ::database::type::RowId command_id) {
+    sqlite_wrapper->Exec("insert into BASH_LOGS_TABLE (ID, AGENT_NAME_ID, TIME_ID, DATE_ID, USER_ID, COMMAND_ID) values (" +
+                         to_string(id) + ", 1, 1, " + to_string(date_id) + ", " + to_string(user_id) + ", " + to_string(command_id) + ");");
+  }
+
+  long long GetSummary(::database::type::RowId user_id, ::database::type::RowId date_id, ::database::type::RowId command_id) {
+    return sqlite_wrapper->GetFirstInt64Column("select C.SUMMARY from BASH_DAILY_USER_COMMAND_STATISTICS_TABLE as C "
+                                               " join BASH_DAILY_USER_STATISTICS_TABLE as S on S.ID=C.STATISTIC_ID "
+                                               " where S.AGENT_NAME_ID=1 and S.USER_ID=" + to_string(user_id) +
+                                               " and S.DATE_ID=" + to_string(date_id) +
+                                               " and C.COMMAND_ID=" + to_string(command_id) + ";", 0);
+  }
+
+  long long GetRowsCount(const string &table) {
+    return sqlite_wrapper->GetFirstInt64Column("select count(*) from " + table + ";");
+  }
+};
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, GetLastLogIdBeforeDate) {
+  AddLog(1, 1, 1, 1);
+  AddLog(2, 1, 2, 1);
+  AddLog(3, 1, 3, 1);
+  AddLog(4, 1, 3, 1);
+
+  EXPECT_EQ(2, raw_database_functions->GetLastLogIdBeforeDate(1, 0, 3));
+  EXPECT_EQ(2, raw_database_functions->GetLastLogIdBeforeDate(1, 2, 3));
+}
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, GetLastLogIdBeforeDate_WhenNoLogsFromDate) {
+  AddLog(1, 1, 1, 1);
+  AddLog(2, 1, 2, 1);
+
+  EXPECT_EQ(2, raw_database_functions->GetLastLogIdBeforeDate(1, 0, 3));
+}
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, GetLastLogIdBeforeDate_WhenNoNewLogs) {
+  AddLog(1, 1, 1, 1);
+
+  EXPECT_EQ(1, raw_database_functions->GetLastLogIdBeforeDate(1, 1, 3));
+  EXPECT_EQ(0, raw_database_functions->GetLastLogIdBeforeDate(2, 0, 3));
+}
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, CreateDailyUserStatistics) {
+  AddLog(1, 1, 1, 1);
+  AddLog(2, 1, 1, 2);
+  AddLog(3, 1, 1, 1);
+  AddLog(4, 2, 1, 1);
+  AddLog(5, 1, 2, 1);
+
+  raw_database_functions->CreateDailyUserStatistics(1, 0, 5, stage);
+
+  EXPECT_EQ(3, GetRowsCount("BASH_DAILY_USER_STATISTICS_TABLE"));
+  EXPECT_EQ(2, GetSummary(1, 1, 1));
+  EXPECT_EQ(1, GetSummary(1, 1, 2));
+  EXPECT_EQ(1, GetSummary(2, 1, 1));
+  EXPECT_EQ(1, GetSummary(1, 2, 1));
+  EXPECT_EQ(5, general_database_functions->GetWatermark(stage, 1));
+}
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, CreateDailyUserStatistics_DaySplitBetweenChunks) {
+  AddLog(1, 1, 1, 1);
+  AddLog(2, 1, 1, 2);
+  AddLog(3, 1, 1, 1);
+  AddLog(4, 1, 1, 1);
+  AddLog(5, 1, 1, 3);
+
+  raw_database_functions->CreateDailyUserStatistics(1, 0, 2, stage);
+  raw_database_functions->CreateDailyUserStatistics(1, 2, 4, stage);
+  raw_database_functions->CreateDailyUserStatistics(1, 4, 5, stage);
+
+  EXPECT_EQ(1, GetRowsCount("BASH_DAILY_USER_STATISTICS_TABLE"));
+  EXPECT_EQ(3, GetRowsCount("BASH_DAILY_USER_COMMAND_STATISTICS_TABLE"));
+  EXPECT_EQ(3, GetSummary(1, 1, 1));
+  EXPECT_EQ(1, GetSummary(1, 1, 2));
+  EXPECT_EQ(1, GetSummary(1, 1, 3));
+  EXPECT_EQ(5, general_database_functions->GetWatermark(stage, 1));
+}
+
+TEST_F(bash_database_detail_RawDatabaseFunctionsTest, CreateDailyUserStatistics_FirstChunkReplacesOldCounts) {
+  AddLog(1, 1, 1, 1);
+  AddLog(2, 1, 1, 1);
+  sqlite_wrapper->Exec("insert into BASH_DAILY_USER_STATISTICS_TABLE (ID, AGENT_NAME_ID, USER_ID, DATE_ID, CLASSIFICATION) values (7, 1, 1, 1, 0);");
+  sqlite_wrapper->Exec("insert into BASH_DAILY_USER_COMMAND_STATISTICS_TABLE (STATISTIC_ID, COMMAND_ID, SUMMARY) values (7, 1, 2);");
+
+  raw_database_functions->CreateDailyUserStatistics(1, 0, 2, stage);
+
+  EXPECT_EQ(1, GetRowsCount("BASH_DAILY_USER_STATISTICS_TABLE"));
+  EXPECT_EQ(1, GetRowsCount("BASH_DAILY_USER_COMMAND_STATISTICS_TABLE"));
+  EXPECT_EQ(2, GetSummary(1, 1, 1));
+}
@@ -0,0 +1,86 @@
+#include <gmock/gmock.h>
+
+#include "src/bash/domain/detail/command_normalizer.h"
+#include "src/bash/domain/exception/detail/wrong_command_rule.h"
+
+using namespace testing;
+using namespace std;
+using namespace bash::domain::detail;
+
+namespace
+{
+
+const CommandRules RULES = {
+  {"/tmp/*", "<tmp>"},
+  {"tmp.??????", "<tmp>"},
+};
+
+}
+
+TEST(CommandNormalizerTest, Match) {
+  EXPECT_TRUE(CommandNormalizer::Match("/tmp/*", "/tmp/x.sh"));
+  EXPECT_TRUE(CommandNormalizer::Match("/tmp/*", "/tmp/"));
+  EXPECT_TRUE(CommandNormalizer::Match("*.sh", "deploy.sh"));
+  EXPECT_TRUE(CommandNormalizer::Match("a*b*c", "aXbYbZc"));
+  EXPECT_TRUE(CommandNormalizer::Match("l?", "ls"));
+  EXPECT_TRUE(CommandNormalizer::Match("*", ""));
+
+  EXPECT_FALSE(CommandNormalizer::Match("/tmp/*", "/var/tmp/x"));
+  EXPECT_FALSE(CommandNormalizer::Match("*.sh", "deploy.shx"));
+  EXPECT_FALSE(CommandNormalizer::Match("l?", "l"));
+  EXPECT_FALSE(CommandNormalizer::Match("ls", "lsof"));
+}
+
+TEST(CommandNormalizerTest, Normalize) {
+  auto normalizer = CommandNormalizer::Create(RULES, 100);
+
+  EXPECT_EQ("ls", normalizer->Normalize("ls"));
+  EXPECT_EQ("ls", normalizer->Normalize("/bin/ls"));
+  EXPECT_EQ("ls", normalizer->Normalize("./ls"));
+  EXPECT_EQ("deploy-#.sh", normalizer->Normalize("./deploy-1234.sh"));
+  EXPECT_EQ("deploy-#.sh", normalizer->Normalize("deploy-98765.sh"));
+  EXPECT_EQ("python3.10", normalizer->Normalize("/usr/bin/python3.10"));
+  EXPECT_EQ("<tmp>", normalizer->Normalize("/tmp/build/run.sh"));
+  EXPECT_EQ("<tmp>", normalizer->Normalize("/home/user/tmp.Ab3dEf"));
+  EXPECT_EQ("dir/", normalizer->Normalize("dir/"));
+
+  const string long_name(200, 'a');
+  EXPECT_EQ(string(CommandNormalizer::MAX_NAME_LENGTH, 'a'), normalizer->Normalize("/bin/" + long_name));
+}
+
+TEST(CommandNormalizerTest, NormalizedNamesDontChange) {
+  auto normalizer = CommandNormalizer::Create(RULES, 100);
+
+  for (const string command : {"/bin/ls", "./deploy-1234.sh", "/tmp/x", "tmp.abcdef", "x264"}) {
+    const auto name = normalizer->Normalize(command);
+    EXPECT_EQ(name, normalizer->Normalize(name)) << command;
+  }
+}
+
+TEST(CommandNormalizerTest, VocabularyIsBounded) {
+  auto normalizer = CommandNormalizer::Create({}, 3);
+
+  EXPECT_EQ("ls", normalizer->Normalize("ls"));
+  EXPECT_EQ("cat", normalizer->Normalize("/bin/cat"));
+  EXPECT_EQ(CommandNormalizer::OTHER_COMMAND, normalizer->Normalize("vim"));
+  EXPECT_EQ("ls", normalizer->Normalize("/usr/bin/ls"));
+  EXPECT_EQ(CommandNormalizer::OTHER_COMMAND, normalizer->Normalize(CommandNormalizer::OTHER_COMMAND));
+
+  EXPECT_EQ(3u, normalizer->GetVocabularySize());
+}
+
+TEST(CommandNormalizerTest, ParseRules) {
+  const auto rules = CommandNormalizer::ParseRules("/tmp/*=<tmp>,*.py=<python>");
+
+  ASSERT_EQ(2u, rules.size());
+  EXPECT_EQ("/tmp/*", rules[0].pattern);
+  EXPECT_EQ("<tmp>", rules[0].name);
+  EXPECT_EQ("*.py", rules[1].pattern);
+  EXPECT_EQ("<python>", rules[1].name);
+
+  EXPECT_TRUE(CommandNormalizer::ParseRules("").empty());
+
+  EXPECT_THROW(CommandNormalizer::ParseRules("/tmp/*"), ::bash::domain::exception::detail::WrongCommandRule);
+  EXPECT_THROW(CommandNormalizer::ParseRules("=x"), ::bash::domain::exception::detail::WrongCommandRule);
+  EXPECT_THROW(CommandNormalizer::ParseRules("x="), ::bash::domain::exception::detail::WrongCommandRule);
+}
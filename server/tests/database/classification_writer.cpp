@@ -0,0 +1,94 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#include <gmock/gmock.h>
+
+#include "src/database/classification_writer.h"
+#include "src/database/exception/detail/cant_execute_sql_statement_exception.h"
+
+#include "tests/mock/database/sqlite_wrapper.h"
+
+using namespace testing;
+using namespace database;
+using namespace std;
+
+#define DB_STATEMENT_EXAMPLE_PTR_VALUE (reinterpret_cast<sqlite3_stmt*>(0x000002))
+
+class ClassificationWriterTest : public ::testing::Test {
+ public:
+  ::mock::database::SQLiteWrapperPtr sqlite_wrapper;
+  ClassificationWriterPtr writer;
+
+  virtual ~ClassificationWriterTest() = default;
+
+  void SetUp() {
+    sqlite_wrapper = ::mock::database::SQLiteWrapper::Create();
+    writer = ClassificationWriter::Create(sqlite_wrapper, "EXAMPLE_TABLE");
+  }
+
+  void TearDown() {
+  }
+};
+
+TEST_F(ClassificationWriterTest, Write) {
+  const int anomaly = static_cast<int> (type::Classification::ANOMALY);
+
+  InSequence s;
+  EXPECT_CALL(*sqlite_wrapper, Prepare("update EXAMPLE_TABLE set CLASSIFICATION=? where ID=?;", NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BeginTransaction());
+  for (auto id : {4, 7}) {
+    EXPECT_CALL(*sqlite_wrapper, BindInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1, anomaly));
+    EXPECT_CALL(*sqlite_wrapper, BindInt64(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2, id));
+    EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Return(SQLITE_DONE));
+    EXPECT_CALL(*sqlite_wrapper, Reset(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  }
+  EXPECT_CALL(*sqlite_wrapper, CommitTransaction());
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  writer->Write({4, 7}, type::Classification::ANOMALY);
+
+  EXPECT_EQ(2, writer->GetUpdatedRowsCount());
+}
+
+TEST_F(ClassificationWriterTest, Write_TransactionPerPart) {
+  const type::RowIds ids(ClassificationWriter::MAX_ROWS_IN_TRANSACTION * 2 + 1, 1);
+
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).Times(1).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BeginTransaction()).Times(3);
+  EXPECT_CALL(*sqlite_wrapper, CommitTransaction()).Times(3);
+  EXPECT_CALL(*sqlite_wrapper, BindInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1, _)).Times(ids.size());
+  EXPECT_CALL(*sqlite_wrapper, BindInt64(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2, 1)).Times(ids.size());
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).Times(ids.size()).WillRepeatedly(Return(SQLITE_DONE));
+  EXPECT_CALL(*sqlite_wrapper, Reset(DB_STATEMENT_EXAMPLE_PTR_VALUE)).Times(ids.size());
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE)).Times(1);
+
+  writer->Write(ids, type::Classification::NORMAL);
+
+  EXPECT_EQ(static_cast<type::RowsCount> (ids.size()), writer->GetUpdatedRowsCount());
+}
+
+TEST_F(ClassificationWriterTest, Write_WhenEmpty) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, _)).Times(0);
+  EXPECT_CALL(*sqlite_wrapper, Exec(_, _, _)).Times(0);
+  EXPECT_CALL(*sqlite_wrapper, BeginTransaction()).Times(0);
+
+  writer->Write({}, type::Classification::NORMAL);
+
+  EXPECT_EQ(0, writer->GetUpdatedRowsCount());
+}
+
+TEST_F(ClassificationWriterTest, Write_WhenStepFails) {
+  EXPECT_CALL(*sqlite_wrapper, Prepare(_, NotNull())).WillOnce(SetArgPointee<1>(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+  EXPECT_CALL(*sqlite_wrapper, BeginTransaction());
+  EXPECT_CALL(*sqlite_wrapper, BindInt(DB_STATEMENT_EXAMPLE_PTR_VALUE, 1, _));
+  EXPECT_CALL(*sqlite_wrapper, BindInt64(DB_STATEMENT_EXAMPLE_PTR_VALUE, 2, 4));
+  EXPECT_CALL(*sqlite_wrapper, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE)).WillOnce(Throw(exception::detail::CantExecuteSqlStatementException()));
+  EXPECT_CALL(*sqlite_wrapper, RollbackTransaction());
+  EXPECT_CALL(*sqlite_wrapper, CommitTransaction()).Times(0);
+  EXPECT_CALL(*sqlite_wrapper, Finalize(DB_STATEMENT_EXAMPLE_PTR_VALUE));
+
+  EXPECT_THROW(writer->Write({4, 7}, type::Classification::NORMAL), exception::detail::CantExecuteSqlStatementException);
+  EXPECT_EQ(0, writer->GetUpdatedRowsCount());
+}
@@ -201,3 +201,15 @@ TEST_F(GeneralDatabaseFunctionsTest, GetAgentNameById_WhenStepThrowException) {
 
   EXPECT_THROW(general_database_functions->GetAgentNameById(0), ::database::exception::detail::CantExecuteSqlStatementException);
 }
+
+TEST_F(GeneralDatabaseFunctionsTest, GetWatermark) {
+  EXPECT_CALL(*sqlite_wrapper, GetFirstInt64Column(AllOf(HasSubstr("STAGE='stage'"), HasSubstr("AGENT_NAME_ID=3")), 0)).WillOnce(Return(120));
+
+  EXPECT_EQ(120, general_database_functions->GetWatermark("stage", 3));
+}
+
+TEST_F(GeneralDatabaseFunctionsTest, SetWatermark) {
+  EXPECT_CALL(*sqlite_wrapper, Exec(GeneralDatabaseFunctions::GetSetWatermarkSql("stage", 3, 120), nullptr, nullptr));
+
+  general_database_functions->SetWatermark("stage", 3, 120);
+}
@@ -1,6 +1,11 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include <gmock/gmock.h>
 
 #include "src/database/sqlite_wrapper.h"
+#include "src/database/statement_counters.h"
 #include "src/database/exception/detail/cant_open_database_exception.h"
 #include "src/database/exception/detail/cant_close_database_exception.h"
 #include "src/database/exception/detail/cant_execute_sql_statement_exception.h"
@@ -71,6 +76,16 @@ TEST_F(SQLiteWrapperTest, Open_WhenOpenFail) {
   EXPECT_FALSE(wrapper->IsOpen());
 }
 
+TEST_F(SQLiteWrapperTest, OpenReadOnly) {
+  EXPECT_CALL(*sqlite_mock, Open(NotNull(), NotNull(), SQLITE_OPEN_READONLY, IsNull()))
+      .WillOnce(DoAll(SetArgPointee<1>(DB_HANDLE_EXAMPLE_PTR_VALUE), Return(SQLITE_OK)));
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->OpenReadOnly("sqlite.db");
+
+  EXPECT_TRUE(wrapper->IsOpen());
+}
+
 TEST_F(SQLiteWrapperTest, Close_WhenDatabaseIsOpen) {
   MY_EXPECT_OPEN(sqlite_mock);
   MY_EXPECT_CLOSE(sqlite_mock);
@@ -498,6 +513,57 @@ TEST_F(SQLiteWrapperTest, Exec) {
   EXPECT_TRUE(wrapper->Close());
 }
 
+TEST_F(SQLiteWrapperTest, StatementsAreCountedInScope) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Prepare(DB_HANDLE_EXAMPLE_PTR_VALUE, NotNull(), -1, NotNull(), nullptr))
+      .WillRepeatedly(
+                      DoAll(SetArgPointee<3>(DB_STATEMENT_EXAMPLE_PTR_VALUE),
+                            Return(SQLITE_OK))
+                      );
+  EXPECT_CALL(*sqlite_mock, Step(DB_STATEMENT_EXAMPLE_PTR_VALUE))
+      .WillOnce(Return(SQLITE_ROW))
+      .WillOnce(Return(SQLITE_ROW))
+      .WillOnce(Return(SQLITE_DONE))
+      .WillOnce(Return(SQLITE_DONE));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq(example_text), nullptr, nullptr, nullptr)).WillOnce(Return(SQLITE_OK));
+  EXPECT_CALL(*sqlite_mock, TotalChanges(DB_HANDLE_EXAMPLE_PTR_VALUE))
+      .WillOnce(Return(0)).WillOnce(Return(0))
+      .WillOnce(Return(0)).WillOnce(Return(0))
+      .WillOnce(Return(0)).WillOnce(Return(0))
+      .WillOnce(Return(0)).WillOnce(Return(3))
+      .WillOnce(Return(3)).WillOnce(Return(5));
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  sqlite3_stmt *stmt;
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  // not counted outside of a scope
+  wrapper->Prepare("sql query", &stmt);
+
+  StatementCounters counters;
+  {
+    StatementCountersScope scope(&counters);
+    EXPECT_EQ(&counters, StatementCountersScope::GetCurrent());
+
+    wrapper->Prepare("select", &stmt);
+    wrapper->Step(stmt);
+    wrapper->Step(stmt);
+    wrapper->Step(stmt);
+
+    wrapper->Prepare("insert", &stmt);
+    wrapper->Step(stmt);
+
+    wrapper->Exec(example_text, nullptr, nullptr);
+  }
+  EXPECT_EQ(nullptr, StatementCountersScope::GetCurrent());
+
+  EXPECT_EQ(3, counters.statements);
+  EXPECT_EQ(2, counters.rows_read);
+  EXPECT_EQ(5, counters.rows_written);
+  EXPECT_TRUE(wrapper->Close());
+}
+
 TEST_F(SQLiteWrapperTest, Exec_WhenDatabaseIsClosed) {
   SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
 
@@ -508,6 +574,7 @@ TEST_F(SQLiteWrapperTest, Exec_WhenDatabaseIsClosed) {
 TEST_F(SQLiteWrapperTest, Exec_WhenFinalizeFail) {
   MY_EXPECT_OPEN(sqlite_mock);
   EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq(example_text), nullptr, nullptr, nullptr)).WillOnce(Return(SQLITE_NOMEM));
+  EXPECT_CALL(*sqlite_mock, GetAutocommit(DB_HANDLE_EXAMPLE_PTR_VALUE)).WillOnce(Return(1));
   MY_EXPECT_CLOSE(sqlite_mock);
 
   SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
@@ -707,3 +774,90 @@ TEST_F(SQLiteWrapperTest, GetFirstInt64Column_WithDefaultValue_WhenPrepareFail)
   EXPECT_THROW(wrapper->GetFirstInt64Column("sql", -1), database::exception::detail::CantExecuteSqlStatementException);
   EXPECT_TRUE(wrapper->Close());
 }
+
+TEST_F(SQLiteWrapperTest, CommitTransaction) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("begin transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("sql"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("commit transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  wrapper->BeginTransaction();
+  wrapper->Exec("sql");
+  wrapper->CommitTransaction();
+  EXPECT_TRUE(wrapper->Close());
+}
+
+TEST_F(SQLiteWrapperTest, RollbackTransaction) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("begin transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("sql"), _, _, _)).WillOnce(Return(SQLITE_ERROR));
+  EXPECT_CALL(*sqlite_mock, GetAutocommit(DB_HANDLE_EXAMPLE_PTR_VALUE)).WillOnce(Return(0));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("rollback transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  wrapper->BeginTransaction();
+  EXPECT_THROW(wrapper->Exec("sql"), database::exception::detail::CantExecuteSqlStatementException);
+  wrapper->RollbackTransaction();
+  EXPECT_TRUE(wrapper->Close());
+}
+
+TEST_F(SQLiteWrapperTest, RollbackTransaction_WhenRolledBackBySQLite) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("begin transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("commit transaction;"), _, _, _)).WillOnce(Return(SQLITE_FULL));
+  EXPECT_CALL(*sqlite_mock, GetAutocommit(DB_HANDLE_EXAMPLE_PTR_VALUE)).WillOnce(Return(1));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("rollback transaction;"), _, _, _)).Times(0);
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  wrapper->BeginTransaction();
+  EXPECT_THROW(wrapper->CommitTransaction(), database::exception::detail::CantExecuteSqlStatementException);
+  EXPECT_TRUE(wrapper->Close());
+}
+
+TEST_F(SQLiteWrapperTest, Exec_RollbackUnfinishedTransaction) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("begin; sql; end;"), _, _, _)).WillOnce(Return(SQLITE_ERROR));
+  EXPECT_CALL(*sqlite_mock, GetAutocommit(DB_HANDLE_EXAMPLE_PTR_VALUE)).WillOnce(Return(0));
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, StrEq("rollback transaction;"), _, _, _)).WillOnce(Return(SQLITE_OK));
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  EXPECT_THROW(wrapper->Exec("begin; sql; end;"), database::exception::detail::CantExecuteSqlStatementException);
+  EXPECT_TRUE(wrapper->Close());
+}
+
+TEST_F(SQLiteWrapperTest, Exec_WaitsForTransactionOfOtherThread) {
+  MY_EXPECT_OPEN(sqlite_mock);
+  EXPECT_CALL(*sqlite_mock, Exec(DB_HANDLE_EXAMPLE_PTR_VALUE, _, _, _, _)).WillRepeatedly(Return(SQLITE_OK));
+  MY_EXPECT_CLOSE(sqlite_mock);
+
+  SQLiteWrapperPtr wrapper = SQLiteWrapper::Create(move(sqlite_mock));
+  wrapper->Open("sqlite.db");
+
+  atomic<bool> is_executed(false);
+  wrapper->BeginTransaction();
+  thread other([&wrapper, &is_executed]() {
+    wrapper->Exec("sql");
+    is_executed = true;
+  });
+
+  this_thread::sleep_for(chrono::milliseconds(50));
+  EXPECT_FALSE(is_executed);
+  wrapper->CommitTransaction();
+  other.join();
+
+  EXPECT_TRUE(is_executed);
+  EXPECT_TRUE(wrapper->Close());
+}
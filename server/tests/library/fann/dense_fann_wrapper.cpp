@@ -0,0 +1,151 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+
+#include "src/library/fann/dense_fann_wrapper.h"
+#include "tests/mock/library/fann/fann_wrapper.h"
+
+using namespace testing;
+using namespace std;
+using namespace library::fann;
+
+namespace
+{
+
+const string NETWORK_FILE_PATH = "/tmp/slas-dense-fann-wrapper-test.net";
+
+// one input, one linear output: 2 * input + 1
+void SaveNetwork() {
+  ofstream file(NETWORK_FILE_PATH.c_str());
+  file << "FANN_FLO_2.1\n"
+       << "network_type=0\n"
+       << "layer_sizes=2 2 \n"
+       << "neurons (num_inputs, activation_function, activation_steepness)=(0, 0, 0.0) (0, 0, 0.0) (2, 0, 1.0) (0, 0, 1.0) \n"
+       << "connections (connected_to_neuron, weight)=(0, 2.0) (1, 1.0) \n";
+}
+
+// the same network after training: 3 * input + 2
+void ExpectTrainedNetwork(mock::library::fann::FannWrapper &fann_wrapper, struct fann *ann) {
+  struct fann_connection weight = {0, 2, 3};
+  struct fann_connection bias = {1, 2, 2};
+
+  EXPECT_CALL(fann_wrapper, GetLayerArray(ann)).WillRepeatedly(Return(vector<unsigned>({1, 1})));
+  EXPECT_CALL(fann_wrapper, GetBiasArray(ann)).WillRepeatedly(Return(vector<unsigned>({1, 0})));
+  EXPECT_CALL(fann_wrapper, GetActivationFunction(ann, _, _)).WillRepeatedly(Return(FANN_LINEAR));
+  EXPECT_CALL(fann_wrapper, GetActivationSteepness(ann, _, _)).WillRepeatedly(Return(1));
+  EXPECT_CALL(fann_wrapper, GetConnectionArray(ann)).WillRepeatedly(Return(vector<struct fann_connection>({weight, bias})));
+}
+
+}
+
+TEST(DenseFannWrapperTest, RunWithDenseNetwork) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto dense_fann_wrapper = DenseFannWrapper::Create(fann_wrapper, DenseNetwork::Precision::FLOAT32);
+  SaveNetwork();
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(NETWORK_FILE_PATH)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, Run(_, _)).Times(0);
+
+  ASSERT_EQ(ann, dense_fann_wrapper->CreateFromFile(NETWORK_FILE_PATH));
+  remove(NETWORK_FILE_PATH.c_str());
+
+  auto network = dense_fann_wrapper->GetDenseNetwork(ann);
+  ASSERT_TRUE(network != nullptr);
+  EXPECT_EQ(1u, network->GetNumInput());
+
+  fann_type input = 3;
+  EXPECT_FLOAT_EQ(7, *dense_fann_wrapper->Run(ann, &input));
+
+  EXPECT_CALL(*fann_wrapper, Destroy(ann));
+  dense_fann_wrapper->Destroy(ann);
+  EXPECT_EQ(nullptr, dense_fann_wrapper->GetDenseNetwork(ann));
+}
+
+TEST(DenseFannWrapperTest, RunWithLibfannWhenFileIsNotSupported) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  fann_type output = 5;
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto dense_fann_wrapper = DenseFannWrapper::Create(fann_wrapper, DenseNetwork::Precision::INT8);
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(NETWORK_FILE_PATH)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, Run(ann, _)).WillOnce(Return(&output));
+
+  ASSERT_EQ(ann, dense_fann_wrapper->CreateFromFile(NETWORK_FILE_PATH));
+  EXPECT_EQ(nullptr, dense_fann_wrapper->GetDenseNetwork(ann));
+
+  fann_type input = 3;
+  EXPECT_EQ(&output, dense_fann_wrapper->Run(ann, &input));
+}
+
+TEST(DenseFannWrapperTest, RunAfterTraining) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto dense_fann_wrapper = DenseFannWrapper::Create(fann_wrapper, DenseNetwork::Precision::FLOAT32);
+  SaveNetwork();
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(NETWORK_FILE_PATH)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, TrainEpoch(ann, nullptr)).WillOnce(Return(0.1));
+  EXPECT_CALL(*fann_wrapper, Run(_, _)).Times(0);
+  ExpectTrainedNetwork(*fann_wrapper, ann);
+
+  ASSERT_EQ(ann, dense_fann_wrapper->CreateFromFile(NETWORK_FILE_PATH));
+  remove(NETWORK_FILE_PATH.c_str());
+
+  fann_type input = 3;
+  EXPECT_FLOAT_EQ(7, *dense_fann_wrapper->Run(ann, &input));
+
+  dense_fann_wrapper->TrainEpoch(ann, nullptr);
+  EXPECT_FLOAT_EQ(11, *dense_fann_wrapper->Run(ann, &input));
+}
+
+TEST(DenseFannWrapperTest, RunWithLibfannAfterChangeToUnsupportedNetwork) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  fann_type output = 5;
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto dense_fann_wrapper = DenseFannWrapper::Create(fann_wrapper, DenseNetwork::Precision::FLOAT32);
+  SaveNetwork();
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(NETWORK_FILE_PATH)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, SetActivationFunctionOutput(ann, FANN_THRESHOLD));
+  ExpectTrainedNetwork(*fann_wrapper, ann);
+  EXPECT_CALL(*fann_wrapper, GetActivationFunction(ann, _, _)).WillRepeatedly(Return(FANN_THRESHOLD));
+  EXPECT_CALL(*fann_wrapper, Run(ann, _)).WillOnce(Return(&output));
+
+  ASSERT_EQ(ann, dense_fann_wrapper->CreateFromFile(NETWORK_FILE_PATH));
+  remove(NETWORK_FILE_PATH.c_str());
+
+  dense_fann_wrapper->SetActivationFunctionOutput(ann, FANN_THRESHOLD);
+
+  fann_type input = 3;
+  EXPECT_EQ(&output, dense_fann_wrapper->Run(ann, &input));
+}
+
+TEST(DenseFannWrapperTest, CopyAfterTraining) {
+  char buffer[2];
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer[0]);
+  struct fann *copy = reinterpret_cast<struct fann*> (&buffer[1]);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+  auto dense_fann_wrapper = DenseFannWrapper::Create(fann_wrapper, DenseNetwork::Precision::FLOAT32);
+  SaveNetwork();
+
+  EXPECT_CALL(*fann_wrapper, CreateFromFile(NETWORK_FILE_PATH)).WillOnce(Return(ann));
+  EXPECT_CALL(*fann_wrapper, TrainOnData(ann, nullptr, 10, 0, 0.01f));
+  EXPECT_CALL(*fann_wrapper, Copy(ann)).WillOnce(Return(copy));
+  EXPECT_CALL(*fann_wrapper, Run(_, _)).Times(0);
+  ExpectTrainedNetwork(*fann_wrapper, copy);
+
+  ASSERT_EQ(ann, dense_fann_wrapper->CreateFromFile(NETWORK_FILE_PATH));
+  remove(NETWORK_FILE_PATH.c_str());
+
+  dense_fann_wrapper->TrainOnData(ann, nullptr, 10, 0, 0.01f);
+  ASSERT_EQ(copy, dense_fann_wrapper->Copy(ann));
+
+  fann_type input = 3;
+  EXPECT_FLOAT_EQ(11, *dense_fann_wrapper->Run(copy, &input));
+}
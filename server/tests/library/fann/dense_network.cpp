@@ -0,0 +1,270 @@
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <gmock/gmock.h>
+
+#include "src/library/fann/dense_network.h"
+#include "src/library/fann/fann_wrapper.h"
+#include "src/library/fann/matrix_kernel.h"
+#include "tests/mock/library/fann/fann_wrapper.h"
+
+using namespace testing;
+using namespace std;
+using namespace library::fann;
+
+namespace
+{
+
+// fann_run for one row, neuron by neuron: inputs and the bias neuron
+// multiplied with weights, then steepness, limit and activation function
+vector<float> ReferenceRun(const DenseNetwork::Layers &layers, vector<float> values) {
+  for (const auto &layer : layers) {
+    vector<float> next(layer.num_output);
+
+    for (unsigned j = 0; j < layer.num_output; ++j) {
+      float sum = 0;
+      for (unsigned i = 0; i < layer.num_input; ++i)
+        sum += values[i] * layer.weights[i * layer.num_output + j];
+      sum += layer.bias[j];
+
+      sum *= layer.steepness;
+      const float max_sum = 150 / layer.steepness;
+      sum = max(-max_sum, min(max_sum, sum));
+
+      if (layer.activation_function == FANN_SIGMOID)
+        next[j] = 1.0f / (1.0f + exp(-2.0f * sum));
+      else if (layer.activation_function == FANN_SIGMOID_SYMMETRIC)
+        next[j] = 2.0f / (1.0f + exp(-2.0f * sum)) - 1.0f;
+      else
+        next[j] = sum;
+    }
+
+    values = next;
+  }
+
+  return values;
+}
+
+DenseNetwork::Layer RandomLayer(mt19937 &generator, unsigned num_input, unsigned num_output,
+                                enum fann_activationfunc_enum activation_function) {
+  uniform_real_distribution<float> distribution(-0.5, 0.5);
+
+  DenseNetwork::Layer layer;
+  layer.num_input = num_input;
+  layer.num_output = num_output;
+  layer.activation_function = activation_function;
+  layer.steepness = 0.5;
+  for (unsigned i = 0; i < num_input * num_output; ++i)
+    layer.weights.push_back(distribution(generator));
+  for (unsigned i = 0; i < num_output; ++i)
+    layer.bias.push_back(distribution(generator));
+
+  return layer;
+}
+
+// most commands aren't used by a user, so most inputs are 0
+vector<float> RandomInputs(mt19937 &generator, size_t rows, unsigned num_input) {
+  uniform_real_distribution<float> distribution(0, 1);
+
+  vector<float> inputs(rows * num_input);
+  for (auto &i : inputs)
+    i = (distribution(generator) < 0.2) ? distribution(generator) : 0;
+
+  return inputs;
+}
+
+struct fann_connection Connection(unsigned from, unsigned to, float weight) {
+  struct fann_connection c;
+  c.from_neuron = from;
+  c.to_neuron = to;
+  c.weight = weight;
+
+  return c;
+}
+
+}
+
+TEST(DenseNetworkTest, RunEqualsReference) {
+  mt19937 generator(1);
+  const DenseNetwork::Layers layers = {
+    RandomLayer(generator, 300, 30, FANN_SIGMOID),
+    RandomLayer(generator, 30, 7, FANN_SIGMOID_SYMMETRIC),
+    RandomLayer(generator, 7, 3, FANN_LINEAR)
+  };
+  auto network = DenseNetwork::Create(layers);
+
+  // rows and inputs aren't multiples of the blocks
+  const size_t rows = 2 * DenseNetwork::ROWS_BLOCK + 5;
+  const auto inputs = RandomInputs(generator, rows, 300);
+  vector<float> outputs(rows * 3);
+
+  network->Run(inputs.data(), rows, outputs.data());
+
+  for (size_t r = 0; r < rows; ++r) {
+    const auto expected = ReferenceRun(layers, vector<float>(inputs.begin() + r * 300, inputs.begin() + (r + 1) * 300));
+
+    for (unsigned o = 0; o < 3; ++o)
+      EXPECT_NEAR(expected[o], outputs[r * 3 + o], 1e-4) << "row " << r << ", output " << o;
+  }
+}
+
+TEST(DenseNetworkTest, RunEqualsFannRun) {
+  mt19937 generator(1);
+  auto fann_wrapper = FannWrapper::Create();
+
+  struct fann *ann = fann_wrapper->CreateStandard(3, 300, 30, 3);
+  ASSERT_TRUE(ann != nullptr);
+  fann_wrapper->SetActivationFunctionHidden(ann, FANN_SIGMOID_SYMMETRIC);
+  fann_wrapper->SetActivationFunctionOutput(ann, FANN_SIGMOID);
+
+  // a few epochs, so the weights aren't only the initial random ones
+  const size_t train_rows = 100;
+  const auto train_inputs = RandomInputs(generator, train_rows, 300);
+  const auto train_outputs = RandomInputs(generator, train_rows, 3);
+  auto train_data = fann_wrapper->CreateTrainData(300, 3, train_inputs, train_outputs);
+  for (int i = 0; i < 5; ++i)
+    fann_wrapper->TrainEpoch(ann, train_data);
+  fann_wrapper->DestroyTrainData(train_data);
+
+  auto network = DenseNetwork::Create(ann, fann_wrapper);
+  ASSERT_TRUE(network != nullptr);
+
+  const size_t rows = 2 * DenseNetwork::ROWS_BLOCK + 5;
+  auto inputs = RandomInputs(generator, rows, 300);
+  vector<float> outputs(rows * 3);
+
+  network->Run(inputs.data(), rows, outputs.data());
+
+  for (size_t r = 0; r < rows; ++r) {
+    const fann_type *expected = fann_wrapper->Run(ann, inputs.data() + r * 300);
+
+    for (unsigned o = 0; o < 3; ++o)
+      EXPECT_NEAR(expected[o], outputs[r * 3 + o], 1e-5) << "row " << r << ", output " << o;
+  }
+
+  fann_wrapper->Destroy(ann);
+}
+
+TEST(DenseNetworkTest, CreateFromFann) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+
+  // neurons: inputs 0-1, bias 2, hidden 3-4, bias 5, output 6
+  EXPECT_CALL(*fann_wrapper, GetLayerArray(ann)).WillOnce(Return(vector<unsigned>({2, 2, 1})));
+  EXPECT_CALL(*fann_wrapper, GetBiasArray(ann)).WillOnce(Return(vector<unsigned>({1, 1, 0})));
+  EXPECT_CALL(*fann_wrapper, GetActivationFunction(ann, _, _)).WillRepeatedly(Return(FANN_SIGMOID));
+  EXPECT_CALL(*fann_wrapper, GetActivationSteepness(ann, _, _)).WillRepeatedly(Return(0.5));
+  EXPECT_CALL(*fann_wrapper, GetConnectionArray(ann)).WillOnce(Return(vector<struct fann_connection>({
+    Connection(0, 3, 0.1), Connection(1, 3, 0.2), Connection(2, 3, 0.3),
+    Connection(0, 4, -0.4), Connection(1, 4, 0.5), Connection(2, 4, -0.6),
+    Connection(3, 6, 0.7), Connection(4, 6, -0.8), Connection(5, 6, 0.9)
+  })));
+
+  auto network = DenseNetwork::Create(ann, fann_wrapper);
+  ASSERT_TRUE(network != nullptr);
+  EXPECT_EQ(2u, network->GetNumInput());
+  EXPECT_EQ(1u, network->GetNumOutput());
+
+  const float input[] = {1, 2};
+  float output;
+  network->Run(input, 1, &output);
+
+  auto sigmoid = [](float sum) { return 1.0f / (1.0f + exp(-2.0f * 0.5f * sum)); };
+  const float h0 = sigmoid(1 * 0.1 + 2 * 0.2 + 0.3);
+  const float h1 = sigmoid(1 * -0.4 + 2 * 0.5 - 0.6);
+  EXPECT_NEAR(sigmoid(h0 * 0.7 + h1 * -0.8 + 0.9), output, 1e-6);
+}
+
+TEST(DenseNetworkTest, CreateFromFannWithShortcutConnection) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+
+  EXPECT_CALL(*fann_wrapper, GetLayerArray(ann)).WillOnce(Return(vector<unsigned>({1, 1, 1})));
+  EXPECT_CALL(*fann_wrapper, GetBiasArray(ann)).WillOnce(Return(vector<unsigned>({1, 1, 0})));
+  EXPECT_CALL(*fann_wrapper, GetActivationFunction(ann, _, _)).WillRepeatedly(Return(FANN_SIGMOID));
+  EXPECT_CALL(*fann_wrapper, GetActivationSteepness(ann, _, _)).WillRepeatedly(Return(0.5));
+  EXPECT_CALL(*fann_wrapper, GetConnectionArray(ann)).WillOnce(Return(vector<struct fann_connection>({
+    Connection(0, 2, 0.1), Connection(2, 4, 0.2), Connection(0, 4, 0.3)
+  })));
+
+  EXPECT_EQ(nullptr, DenseNetwork::Create(ann, fann_wrapper));
+}
+
+TEST(DenseNetworkTest, CreateFromFannWithUnsupportedActivationFunction) {
+  char buffer;
+  struct fann *ann = reinterpret_cast<struct fann*> (&buffer);
+  auto fann_wrapper = mock::library::fann::FannWrapper::Create();
+
+  EXPECT_CALL(*fann_wrapper, GetLayerArray(ann)).WillOnce(Return(vector<unsigned>({1, 1})));
+  EXPECT_CALL(*fann_wrapper, GetBiasArray(ann)).WillOnce(Return(vector<unsigned>({1, 0})));
+  EXPECT_CALL(*fann_wrapper, GetActivationFunction(ann, 1, 0)).WillOnce(Return(FANN_THRESHOLD));
+  EXPECT_CALL(*fann_wrapper, GetActivationSteepness(ann, 1, 0)).WillOnce(Return(0.5));
+
+  EXPECT_EQ(nullptr, DenseNetwork::Create(ann, fann_wrapper));
+}
+
+TEST(DenseNetworkTest, Int8RunIsCloseToFloat) {
+  mt19937 generator(3);
+  const DenseNetwork::Layers layers = {
+    RandomLayer(generator, 300, 30, FANN_SIGMOID),
+    RandomLayer(generator, 30, 3, FANN_SIGMOID)
+  };
+  auto network = DenseNetwork::Create(layers);
+  auto quantized_network = DenseNetwork::Create(layers, DenseNetwork::Precision::INT8);
+  EXPECT_EQ(DenseNetwork::Precision::INT8, quantized_network->GetPrecision());
+
+  const size_t rows = DenseNetwork::ROWS_BLOCK + 9;
+  const auto inputs = RandomInputs(generator, rows, 300);
+  vector<float> outputs(rows * 3), quantized_outputs(rows * 3);
+
+  network->Run(inputs.data(), rows, outputs.data());
+  quantized_network->Run(inputs.data(), rows, quantized_outputs.data());
+
+  for (size_t i = 0; i < outputs.size(); ++i)
+    EXPECT_NEAR(outputs[i], quantized_outputs[i], 1e-2);
+}
+
+TEST(DenseNetworkTest, CreateWithWrongLayerSizes) {
+  mt19937 generator(1);
+  const DenseNetwork::Layers layers = {
+    RandomLayer(generator, 10, 5, FANN_SIGMOID),
+    RandomLayer(generator, 4, 2, FANN_SIGMOID)
+  };
+
+  EXPECT_THROW(DenseNetwork::Create(layers), invalid_argument);
+}
+
+TEST(MatrixKernelTest, Avx2EqualsScalar) {
+  mt19937 generator(2);
+  const size_t rows = 13;
+  const unsigned k = 45, n = 37;
+  const auto a = RandomInputs(generator, rows, k + 3);
+  const auto b = RandomInputs(generator, k, n);
+  vector<float> scalar(rows * n, 1), avx2(rows * n, 1);
+
+  MultiplyAddScalar(a.data(), k + 3, b.data(), scalar.data(), rows, k, n);
+  MultiplyAddAvx2(a.data(), k + 3, b.data(), avx2.data(), rows, k, n);
+
+  for (size_t i = 0; i < scalar.size(); ++i)
+    EXPECT_NEAR(scalar[i], avx2[i], 1e-5);
+}
+
+TEST(MatrixKernelTest, Int8Avx2EqualsScalar) {
+  mt19937 generator(4);
+  uniform_int_distribution<int> distribution(-127, 127);
+  const size_t rows = 13;
+  const unsigned k = 45, n = 37;
+  const auto a = RandomInputs(generator, rows, k + 3);
+  vector<int8_t> b(k * n);
+  for (auto &w : b)
+    w = distribution(generator);
+  vector<float> scalar(rows * n, 1), avx2(rows * n, 1);
+
+  MultiplyAddInt8Scalar(a.data(), k + 3, b.data(), scalar.data(), rows, k, n);
+  MultiplyAddInt8Avx2(a.data(), k + 3, b.data(), avx2.data(), rows, k, n);
+
+  for (size_t i = 0; i < scalar.size(); ++i)
+    EXPECT_NEAR(scalar[i], avx2[i], 1e-5 * max(1.0f, fabs(scalar[i])));
+}
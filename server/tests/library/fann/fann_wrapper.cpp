@@ -0,0 +1,203 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <gmock/gmock.h>
+
+#include "src/library/fann/fann_wrapper.h"
+#include "tests/mock/library/fann/fann.h"
+
+using namespace testing;
+using namespace std;
+using namespace library::fann;
+
+namespace
+{
+
+const string SNAPSHOT_FILE_PATH = "/tmp/slas-fann-wrapper-test.snapshot";
+
+// allocated the same way as by fann_create_train
+struct fann_train_data* CreateTrain(unsigned num_data, unsigned num_input, unsigned num_output) {
+  auto data = static_cast<struct fann_train_data*> (calloc(1, sizeof (struct fann_train_data)));
+  data->num_data = num_data;
+  data->num_input = num_input;
+  data->num_output = num_output;
+  data->input = static_cast<fann_type**> (calloc(num_data, sizeof (fann_type*)));
+  data->output = static_cast<fann_type**> (calloc(num_data, sizeof (fann_type*)));
+
+  for (unsigned row = 0; row < num_data; ++row) {
+    data->input[row] = static_cast<fann_type*> (calloc(num_input, sizeof (fann_type)));
+    data->output[row] = static_cast<fann_type*> (calloc(num_output, sizeof (fann_type)));
+  }
+
+  return data;
+}
+
+void DestroyTrain(struct fann_train_data *data) {
+  for (unsigned row = 0; row < data->num_data; ++row) {
+    free(data->input[row]);
+    free(data->output[row]);
+  }
+
+  free(data->input);
+  free(data->output);
+  free(data);
+}
+
+long GetFileSize(const string &file_path) {
+  ifstream file(file_path.c_str(), ios::binary | ios::ate);
+  return file.tellg();
+}
+
+void TruncateFile(const string &file_path, long size) {
+  vector<char> content(size);
+  ifstream(file_path.c_str(), ios::binary).read(content.data(), size);
+  ofstream(file_path.c_str(), ios::binary | ios::trunc).write(content.data(), size);
+}
+
+// num_data is the first field after the 8 bytes of the magic
+void WriteNumData(const string &file_path, std::uint32_t num_data) {
+  fstream file(file_path.c_str(), ios::in | ios::out | ios::binary);
+  file.seekp(8);
+  file.write(reinterpret_cast<const char*> (&num_data), sizeof (num_data));
+}
+
+}
+
+class FannWrapperTest : public ::testing::Test {
+ public:
+  ::mock::library::fann::FannPtr fann;
+  FannWrapperPtr fann_wrapper;
+
+  virtual ~FannWrapperTest() = default;
+
+  void SetUp() {
+    fann = ::mock::library::fann::Fann::Create();
+    fann_wrapper = FannWrapper::Create(fann);
+
+    EXPECT_CALL(*fann, CreateTrain(_, _, _)).WillRepeatedly(Invoke(CreateTrain));
+    EXPECT_CALL(*fann, DestroyTrain(_)).WillRepeatedly(Invoke(DestroyTrain));
+  }
+
+  void TearDown() {
+    remove(SNAPSHOT_FILE_PATH.c_str());
+  }
+
+  struct fann_train_data* CreateExampleData() {
+    return fann_wrapper->CreateTrainData(2, 1, {1, 2, 3, 4, 5, 6}, {0.5, 1, 1.5});
+  }
+};
+
+TEST_F(FannWrapperTest, CreateTrainData) {
+  auto data = CreateExampleData();
+
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(3u, data->num_data);
+  EXPECT_EQ(2u, data->num_input);
+  EXPECT_EQ(1u, data->num_output);
+  EXPECT_FLOAT_EQ(3, data->input[1][0]);
+  EXPECT_FLOAT_EQ(4, data->input[1][1]);
+  EXPECT_FLOAT_EQ(6, data->input[2][1]);
+  EXPECT_FLOAT_EQ(1.5, data->output[2][0]);
+
+  fann_wrapper->DestroyTrainData(data);
+}
+
+TEST_F(FannWrapperTest, CreateTrainData_WhenSizesDontMatch) {
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_THROW(fann_wrapper->CreateTrainData(2, 1, {1, 2, 3}, {1, 2}), invalid_argument);
+  EXPECT_THROW(fann_wrapper->CreateTrainData(2, 1, {1, 2, 3, 4}, {1}), invalid_argument);
+  EXPECT_THROW(fann_wrapper->CreateTrainData(0, 1, vector<fann_type>(), vector<fann_type>()), invalid_argument);
+}
+
+TEST_F(FannWrapperTest, CreateTrainData_RowsStartWithZeros) {
+  auto data = fann_wrapper->CreateTrainData(2, 3, 1, [](unsigned row, fann_type *input, fann_type *) {
+    input[0] = row + 1;
+  });
+
+  ASSERT_NE(nullptr, data);
+  EXPECT_FLOAT_EQ(2, data->input[1][0]);
+  EXPECT_FLOAT_EQ(0, data->input[1][2]);
+  EXPECT_FLOAT_EQ(0, data->output[1][0]);
+
+  fann_wrapper->DestroyTrainData(data);
+}
+
+TEST_F(FannWrapperTest, CreateTrainData_WhenCallbackThrows) {
+  EXPECT_CALL(*fann, DestroyTrain(NotNull())).WillOnce(Invoke(DestroyTrain));
+
+  EXPECT_THROW(fann_wrapper->CreateTrainData(2, 1, 1, [](unsigned row, fann_type *, fann_type *) {
+    if (row == 1)
+      throw runtime_error("error");
+  }), runtime_error);
+}
+
+TEST_F(FannWrapperTest, TrainDataSnapshot) {
+  auto data = CreateExampleData();
+  ASSERT_TRUE(fann_wrapper->SaveTrainDataSnapshot(data, SNAPSHOT_FILE_PATH));
+  fann_wrapper->DestroyTrainData(data);
+
+  auto loaded = fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH);
+
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(3u, loaded->num_data);
+  EXPECT_EQ(2u, loaded->num_input);
+  EXPECT_EQ(1u, loaded->num_output);
+  EXPECT_FLOAT_EQ(1, loaded->input[0][0]);
+  EXPECT_FLOAT_EQ(4, loaded->input[1][1]);
+  EXPECT_FLOAT_EQ(5, loaded->input[2][0]);
+  EXPECT_FLOAT_EQ(0.5, loaded->output[0][0]);
+  EXPECT_FLOAT_EQ(1.5, loaded->output[2][0]);
+
+  fann_wrapper->DestroyTrainData(loaded);
+}
+
+TEST_F(FannWrapperTest, LoadTrainDataSnapshot_WhenFileDoesntExist) {
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_EQ(nullptr, fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH));
+}
+
+TEST_F(FannWrapperTest, LoadTrainDataSnapshot_WhenTruncated) {
+  auto data = CreateExampleData();
+  ASSERT_TRUE(fann_wrapper->SaveTrainDataSnapshot(data, SNAPSHOT_FILE_PATH));
+  fann_wrapper->DestroyTrainData(data);
+  TruncateFile(SNAPSHOT_FILE_PATH, GetFileSize(SNAPSHOT_FILE_PATH) - sizeof (fann_type));
+
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_EQ(nullptr, fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH));
+}
+
+TEST_F(FannWrapperTest, LoadTrainDataSnapshot_WhenHeaderIsTruncated) {
+  auto data = CreateExampleData();
+  ASSERT_TRUE(fann_wrapper->SaveTrainDataSnapshot(data, SNAPSHOT_FILE_PATH));
+  fann_wrapper->DestroyTrainData(data);
+  TruncateFile(SNAPSHOT_FILE_PATH, 10);
+
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_EQ(nullptr, fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH));
+}
+
+TEST_F(FannWrapperTest, LoadTrainDataSnapshot_WhenRowsCountIsCorrupted) {
+  auto data = CreateExampleData();
+  ASSERT_TRUE(fann_wrapper->SaveTrainDataSnapshot(data, SNAPSHOT_FILE_PATH));
+  fann_wrapper->DestroyTrainData(data);
+  WriteNumData(SNAPSHOT_FILE_PATH, 0xFFFFFFFF);
+
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_EQ(nullptr, fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH));
+}
+
+TEST_F(FannWrapperTest, LoadTrainDataSnapshot_WhenMagicIsWrong) {
+  ofstream(SNAPSHOT_FILE_PATH.c_str(), ios::binary) << "not a snapshot file, only text";
+
+  EXPECT_CALL(*fann, CreateTrain(_, _, _)).Times(0);
+
+  EXPECT_EQ(nullptr, fann_wrapper->LoadTrainDataSnapshot(SNAPSHOT_FILE_PATH));
+}
@@ -0,0 +1,93 @@
+#include <sstream>
+#include <gmock/gmock.h>
+
+#include "src/library/fann/network_file.h"
+
+using namespace testing;
+using namespace std;
+using namespace library::fann;
+
+namespace
+{
+
+// 2 inputs, 2 hidden neurons, 1 output, saved by fann_save; neurons:
+// inputs 0-1, bias 2, hidden 3-4, bias 5, output 6, bias 7
+const string NETWORK =
+    "FANN_FLO_2.1\n"
+    "num_layers=3\n"
+    "learning_rate=0.700000\n"
+    "connection_rate=1.000000\n"
+    "network_type=0\n"
+    "learning_momentum=0.000000\n"
+    "training_algorithm=2\n"
+    "bit_fail_limit=3.49999994039535522461e-01\n"
+    "cascade_activation_steepnesses=2.50000000000000000000e-01 5.00000000000000000000e-01 \n"
+    "layer_sizes=3 3 2 \n"
+    "scale_included=0\n"
+    "neurons (num_inputs, activation_function, activation_steepness)=(0, 0, 0.00000000000000000000e+00) "
+    "(0, 0, 0.00000000000000000000e+00) (0, 0, 0.00000000000000000000e+00) "
+    "(3, 3, 5.00000000000000000000e-01) (3, 3, 5.00000000000000000000e-01) (0, 3, 5.00000000000000000000e-01) "
+    "(3, 5, 1.00000000000000000000e+00) (0, 5, 1.00000000000000000000e+00) \n"
+    "connections (connected_to_neuron, weight)=(0, 1.00000001490116119385e-01) (1, 2.00000002980232238770e-01) "
+    "(2, 3.00000011920928955078e-01) (0, -4.00000005960464477539e-01) (1, 5.00000000000000000000e-01) "
+    "(2, -6.00000023841857910156e-01) (3, 6.99999988079071044922e-01) (4, -8.00000011920928955078e-01) "
+    "(5, 8.99999976158142089844e-01) \n";
+
+string Replace(string text, const string &from, const string &to) {
+  return text.replace(text.find(from), from.size(), to);
+}
+
+bool Read(const string &text, DenseNetwork::Layers &layers) {
+  istringstream stream(text);
+  return ReadNetworkFile(stream, layers);
+}
+
+}
+
+TEST(NetworkFileTest, ReadLayers) {
+  DenseNetwork::Layers layers;
+  ASSERT_TRUE(Read(NETWORK, layers));
+  ASSERT_EQ(2u, layers.size());
+
+  EXPECT_EQ(2u, layers[0].num_input);
+  EXPECT_EQ(2u, layers[0].num_output);
+  EXPECT_EQ(FANN_SIGMOID, layers[0].activation_function);
+  EXPECT_FLOAT_EQ(0.5, layers[0].steepness);
+  EXPECT_THAT(layers[0].weights, ElementsAre(FloatEq(0.1), FloatEq(-0.4), FloatEq(0.2), FloatEq(0.5)));
+  EXPECT_THAT(layers[0].bias, ElementsAre(FloatEq(0.3), FloatEq(-0.6)));
+
+  EXPECT_EQ(2u, layers[1].num_input);
+  EXPECT_EQ(1u, layers[1].num_output);
+  EXPECT_EQ(FANN_SIGMOID_SYMMETRIC, layers[1].activation_function);
+  EXPECT_FLOAT_EQ(1, layers[1].steepness);
+  EXPECT_THAT(layers[1].weights, ElementsAre(FloatEq(0.7), FloatEq(-0.8)));
+  EXPECT_THAT(layers[1].bias, ElementsAre(FloatEq(0.9)));
+}
+
+TEST(NetworkFileTest, FixedPointNetwork) {
+  DenseNetwork::Layers layers;
+
+  EXPECT_FALSE(Read(Replace(NETWORK, "FANN_FLO_2.1", "FANN_FIX_2.0"), layers));
+  EXPECT_TRUE(layers.empty());
+}
+
+TEST(NetworkFileTest, ShortcutNetwork) {
+  DenseNetwork::Layers layers;
+
+  EXPECT_FALSE(Read(Replace(NETWORK, "network_type=0", "network_type=1"), layers));
+  // output connected with an input
+  EXPECT_FALSE(Read(Replace(NETWORK, "(3, 6.99999988079071044922e-01)", "(0, 6.99999988079071044922e-01)"), layers));
+}
+
+TEST(NetworkFileTest, DifferentActivationFunctionsInLayer) {
+  DenseNetwork::Layers layers;
+
+  EXPECT_FALSE(Read(Replace(NETWORK, "(3, 3, 5.00000000000000000000e-01) (0, 3,", "(3, 5, 5.00000000000000000000e-01) (0, 3,"), layers));
+}
+
+TEST(NetworkFileTest, MissingConnections) {
+  DenseNetwork::Layers layers;
+
+  EXPECT_FALSE(Read(Replace(NETWORK, "(5, 8.99999976158142089844e-01) ", ""), layers));
+  EXPECT_FALSE(Read(Replace(NETWORK, "(0, 1.00000001490116119385e-01)", "(0, 1.0"), layers));
+}
@@ -23,6 +23,7 @@ class AnalyzerObject : public ::analyzer::AnalyzerObjectInterface {
   }
 
   MOCK_METHOD0(Analyze, void());
+  MOCK_CONST_METHOD0(GetSchedule, ::analyzer::type::Schedule());
 };
 
 }
@@ -30,31 +30,77 @@ class DatabaseFunctions : public ::apache::database::detail::DatabaseFunctionsIn
     return std::make_shared<DatabaseFunctions>();
   }
 
-  MOCK_METHOD4(GetLogsCount, ::database::type::RowsCount(std::string agent_name, std::string virtualhost_name,
-                                                         ::type::Date from, ::type::Date to));
+  MOCK_METHOD0(CreateTables, void());
 
-  MOCK_METHOD6(GetLogs, ::type::ApacheLogs(std::string agent_name, std::string virtualhost_name,
-                                           ::type::Date from, ::type::Date to,
-                                           unsigned limit, ::database::type::RowsCount offset));
+  MOCK_METHOD1(RemoveAnomalyDetectionConfiguration, void(const ::database::type::RowId &id));
+  MOCK_METHOD0(GetAnomalyDetectionConfigurations, const ::apache::type::AnomalyDetectionConfiguration());
+
+  MOCK_METHOD1(AddLogs, void(const ::type::ApacheLogs &log_entries));
+  MOCK_METHOD0(GetLastLogId, ::database::type::RowId());
+  MOCK_METHOD2(GetLogsAfter, ::type::ApacheLogs(const ::database::type::RowId &id, unsigned limit));
+
+  MOCK_METHOD0(GetSessionizerCheckpoint, ::apache::type::SessionizerCheckpoint());
+  MOCK_METHOD2(SaveSessionizerCheckpoint, void(const ::apache::type::ApacheSessions &closed_sessions,
+                                               const ::apache::type::SessionizerCheckpoint &checkpoint));
+
+  MOCK_METHOD4(GetTrafficSketches, ::apache::type::TrafficSketchesList(const std::string &agent_name,
+                                                                       const std::string &virtualhost_name,
+                                                                       const ::type::Timestamp &from,
+                                                                       const ::type::Timestamp &to));
+  MOCK_METHOD1(SaveTrafficSketches, void(const ::apache::type::TrafficSketchesList &sketches));
 
   MOCK_METHOD1(AddSessionStatistics, bool(const ::apache::type::ApacheSessions &sessions));
+  MOCK_METHOD4(GetSessionStatisticsCount, ::database::type::RowsCount(const std::string &agent_name, const std::string &virtualhost_name,
+                                                                      const ::type::Timestamp &from, const ::type::Timestamp &to));
+  MOCK_METHOD6(GetSessionStatistics, ::apache::type::ApacheSessions(const std::string &agent_name, const std::string &virtualhost_name,
+                                                                    const ::type::Timestamp &from, const ::type::Timestamp &to,
+                                                                    unsigned limit, ::database::type::RowsCount offset));
+  MOCK_METHOD2(GetNotClassifiedSessionsStatisticsCount, ::database::type::RowsCount(const ::database::type::RowId &agent_name_id,
+                                                                                    const ::database::type::RowId &virtualhost_name_id));
+  MOCK_METHOD4(GetNotClassifiedSessionStatistics, ::apache::type::ApacheSessions(const ::database::type::RowId &agent_name_id,
+                                                                                 const ::database::type::RowId &virtualhost_name_id,
+                                                                                 unsigned limit, ::database::type::RowsCount offset));
+  MOCK_METHOD4(GetSessionStatisticsWithoutLearningSetCount, ::database::type::RowsCount(const std::string &agent_name, const std::string &virtualhost_name,
+                                                                                        const ::type::Timestamp &from, const ::type::Timestamp &to));
+  MOCK_METHOD2(IsSessionStatisticsWithoutLearningSetExists, bool(const std::string &agent_name, const std::string &virtualhost_name));
+  MOCK_METHOD6(GetSessionStatisticsWithoutLearningSet, ::apache::type::ApacheSessions(const std::string &agent_name, const std::string &virtualhost_name,
+                                                                                      const ::type::Timestamp &from, const ::type::Timestamp &to,
+                                                                                      unsigned limit, long long offset));
+  MOCK_METHOD1(GetOneSessionStatistic, ::apache::type::ApacheSessionEntry(::database::type::RowId id));
+  MOCK_METHOD2(UpdateSessionStatisticClassification, void(const ::database::type::RowId &id, const ::database::type::Classification &classification));
+  MOCK_METHOD2(UpdateSessionStatisticsClassification, void(const ::database::type::RowIds &ids, const ::database::type::Classification &classification));
+  MOCK_METHOD2(ClearAnomalyMarksInLearningSet, void(const ::database::type::RowId &agent_name_id,
+                                                    const ::database::type::RowId &virtualhost_name_id));
+  MOCK_METHOD2(MarkLearningSetWithIqrMethod, void(const ::database::type::RowId &agent_name_id,
+                                                  const ::database::type::RowId &virtualhost_name_id));
+
+  MOCK_METHOD2(GetKnnConfiguration, ::apache::type::KnnConfiguration(const std::string &agent_name,
+                                                                     const std::string &virtualhost_name));
+  MOCK_METHOD3(SetKnnConfiguration, void(const std::string &agent_name,
+                                         const std::string &virtualhost_name,
+                                         const ::apache::type::KnnConfiguration &configuration));
+  MOCK_METHOD2(GetRealtimeScoringConfiguration, ::apache::type::RealtimeScoringConfiguration(const std::string &agent_name,
+                                                                                             const std::string &virtualhost_name));
+  MOCK_METHOD3(SetRealtimeScoringConfiguration, void(const std::string &agent_name,
+                                                     const std::string &virtualhost_name,
+                                                     const ::apache::type::RealtimeScoringConfiguration &configuration));
 
   MOCK_METHOD0(GetAgentNames, ::database::type::AgentNames());
 
   MOCK_METHOD1(GetVirtualhostNames, ::database::type::VirtualhostNames(::database::type::AgentName agent_name));
 
-  MOCK_METHOD1(IsLastRunSet, bool());
-
-  MOCK_METHOD2(SetLastRun, void(const ::type::Date &date));
-
-  MOCK_METHOD1(GetLastRun, ::type::Date());
+  MOCK_METHOD0(IsLastRunSet, bool());
+  MOCK_METHOD1(SetLastRun, void(const ::type::Timestamp &date));
+  MOCK_METHOD0(GetLastRun, ::type::Timestamp());
 
   MOCK_METHOD1(AddVirtualhostName, void (const std::string &name));
   MOCK_METHOD1(AddAndGetVirtualhostNameId, ::database::type::RowId(const std::string &name));
   MOCK_METHOD1(GetVirtualhostNameId, ::database::type::RowId(const std::string &name));
   MOCK_METHOD1(GetVirtualhostNameById, std::string(const ::database::type::RowId &id));
 
-  MOCK_METHOD3(GetLearningSessionsIds, ::database::type::RowIds(const ::database::type::RowId &agent_id,
+  MOCK_METHOD4(GetLearningSessions, ::apache::type::ApacheSessions(const ::database::type::RowId &agent, const ::database::type::RowId &virtualhost,
+                                                                   unsigned limit, ::database::type::RowsCount offset));
+  MOCK_METHOD4(GetLearningSessionsIds, ::database::type::RowIds(const ::database::type::RowId &agent_id,
                                                                 const ::database::type::RowId &virtualhost_id,
                                                                 unsigned limit, ::database::type::RowId offset));
   MOCK_METHOD2(GetLearningSessionsCount, ::database::type::RowsCount(const ::database::type::RowId &agent_id,
@@ -64,6 +110,14 @@ class DatabaseFunctions : public ::apache::database::detail::DatabaseFunctionsIn
                                          const ::database::type::RowIds &sessions_ids));
   MOCK_METHOD2(RemoveAllLearningSessions, void(const ::database::type::RowId &agent_id,
                                                const ::database::type::RowId &virtualhost_id));
+  MOCK_METHOD2(GetLearningSetVersion, ::database::type::RowId(const ::database::type::RowId &agent_id,
+                                                              const ::database::type::RowId &virtualhost_id));
+
+  MOCK_METHOD2(GetFeatureNormalization, ::apache::type::FeatureNormalization(const ::database::type::RowId &agent_id,
+                                                                             const ::database::type::RowId &virtualhost_id));
+  MOCK_METHOD3(SetFeatureNormalization, void(const ::database::type::RowId &agent_id,
+                                             const ::database::type::RowId &virtualhost_id,
+                                             const ::apache::type::FeatureNormalization &normalization));
 };
 
 }
@@ -46,6 +46,9 @@ class GeneralDatabaseFunctions : public ::database::detail::GeneralDatabaseFunct
   MOCK_METHOD1(AddAndGetAgentNameId, ::database::type::RowId(const std::string &name));
   MOCK_METHOD1(GetAgentNameId, ::database::type::RowId(const std::string &name));
   MOCK_METHOD1(GetAgentNameById, std::string(const ::database::type::RowId &id));
+
+  MOCK_METHOD2(GetWatermark, ::database::type::RowId(const std::string &stage, ::database::type::RowId agent_name_id));
+  MOCK_METHOD3(SetWatermark, void(const std::string &stage, ::database::type::RowId agent_name_id, ::database::type::RowId watermark));
 };
 
 }
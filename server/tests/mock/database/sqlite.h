@@ -25,8 +25,10 @@ class SQLite : public ::database::detail::SQLiteInterface {
   MOCK_METHOD3(BindInt64, int (sqlite3_stmt *pStmt, int pos, sqlite3_int64 value));
 
   MOCK_METHOD5(BindText, int (sqlite3_stmt *pStmt, int pos, const char *value, int num, void (*destructor) (void*)));
+  MOCK_METHOD5(BindBlob, int (sqlite3_stmt *pStmt, int pos, const void *value, int num, void (*destructor) (void*)));
 
   MOCK_METHOD1(Step, int (sqlite3_stmt *pStmt));
+  MOCK_METHOD1(Reset, int (sqlite3_stmt *pStmt));
 
   MOCK_METHOD2(ColumnDouble, double (sqlite3_stmt *pStmt, int iCol));
 
@@ -35,12 +37,18 @@ class SQLite : public ::database::detail::SQLiteInterface {
   MOCK_METHOD2(ColumnInt64, sqlite3_int64(sqlite3_stmt *pStmt, int iCol));
 
   MOCK_METHOD2(ColumnText, const unsigned char* (sqlite3_stmt *pStmt, int iCol));
+  MOCK_METHOD2(ColumnBlob, const void* (sqlite3_stmt *pStmt, int iCol));
+  MOCK_METHOD2(ColumnBytes, int (sqlite3_stmt *pStmt, int iCol));
 
   MOCK_METHOD1(Finalize, int (sqlite3_stmt *pStmt));
 
   MOCK_METHOD1(Close, int (sqlite3 *pDb));
 
   MOCK_METHOD5(Exec, int (sqlite3 *pDb, const char *sql, int (*callback) (void *, int, char **, char **), void *arg, char **errmsg));
+
+  MOCK_METHOD1(TotalChanges, int (sqlite3 *pDb));
+
+  MOCK_METHOD1(GetAutocommit, int (sqlite3 *pDb));
 };
 
 typedef std::unique_ptr<SQLite> SQLitePtr;
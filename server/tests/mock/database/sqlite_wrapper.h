@@ -37,16 +37,23 @@ class SQLiteWrapper : public ::database::detail::SQLiteWrapperInterface {
   MOCK_METHOD3(BindInt, void(sqlite3_stmt *pStmt, int pos, int value));
   MOCK_METHOD3(BindInt64, void(sqlite3_stmt *pStmt, int pos, sqlite3_int64 value));
   MOCK_METHOD3(BindText, void(sqlite3_stmt *pStmt, int pos, const std::string &value));
+  MOCK_METHOD3(BindBlob, void(sqlite3_stmt *pStmt, int pos, const std::string &value));
 
   MOCK_METHOD2(ColumnDouble, double(sqlite3_stmt *pStmt, int iCol));
   MOCK_METHOD2(ColumnInt, int(sqlite3_stmt *pStmt, int iCol));
   MOCK_METHOD2(ColumnInt64, sqlite3_int64(sqlite3_stmt *pStmt, int iCol));
   MOCK_METHOD2(ColumnText, const std::string(sqlite3_stmt *pStmt, int iCol));
+  MOCK_METHOD2(ColumnBlob, const std::string(sqlite3_stmt *pStmt, int iCol));
 
   MOCK_METHOD1(Step, int(sqlite3_stmt *pStmt));
+  MOCK_METHOD1(Reset, void(sqlite3_stmt *pStmt));
   MOCK_METHOD1(Finalize, void(sqlite3_stmt *pStmt));
 
   MOCK_METHOD3(Exec, void(const std::string &sql, int (*callback) (void *, int, char **, char **), void *arg));
+
+  MOCK_METHOD0(BeginTransaction, void());
+  MOCK_METHOD0(CommitTransaction, void());
+  MOCK_METHOD0(RollbackTransaction, void());
   MOCK_METHOD1(GetFirstInt64Column, long long(const std::string &sql));
   MOCK_METHOD2(GetFirstInt64Column, long long(const std::string &sql, long long default_return_value));
 
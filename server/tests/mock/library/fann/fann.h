@@ -0,0 +1,89 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/library/fann/detail/fann_interface.h"
+
+#include <gmock/gmock.h>
+#include <memory>
+
+namespace mock
+{
+
+namespace library
+{
+
+namespace fann
+{
+
+class Fann;
+typedef std::shared_ptr<Fann> FannPtr;
+
+class Fann : public ::library::fann::detail::FannInterface {
+ public:
+  virtual ~Fann() = default;
+
+  static FannPtr Create() {
+    return std::make_shared<Fann>();
+  }
+
+  MOCK_METHOD4(CreateStandard, struct fann*(unsigned num_layers, unsigned num_input,
+                                            unsigned num_neurons_hidden, unsigned num_output));
+
+  MOCK_METHOD2(SetActivationFunctionHidden, void(struct fann *ann,
+                                                 enum fann_activationfunc_enum activation_function));
+
+  MOCK_METHOD2(SetActivationFunctionOutput, void(struct fann *ann,
+                                                 enum fann_activationfunc_enum activation_function));
+
+  MOCK_METHOD5(TrainOnFile, void(struct fann *ann, const char *filename, unsigned int max_epochs,
+                                 unsigned int epochs_between_reports, float desired_error));
+
+  MOCK_METHOD3(CreateTrain, struct fann_train_data*(unsigned num_data, unsigned num_input, unsigned num_output));
+
+  MOCK_METHOD5(TrainOnData, void(struct fann *ann, struct fann_train_data *data, unsigned int max_epochs,
+                                 unsigned int epochs_between_reports, float desired_error));
+
+  MOCK_METHOD1(DestroyTrain, void(struct fann_train_data *data));
+
+  MOCK_METHOD2(TrainEpoch, float(struct fann *ann, struct fann_train_data *data));
+
+  MOCK_METHOD2(TestData, float(struct fann *ann, struct fann_train_data *data));
+
+  MOCK_METHOD1(Copy, struct fann*(struct fann *ann));
+
+  MOCK_METHOD1(GetNumInput, unsigned(struct fann *ann));
+
+  MOCK_METHOD1(GetNumOutput, unsigned(struct fann *ann));
+
+  MOCK_METHOD1(GetNumLayers, unsigned(struct fann *ann));
+
+  MOCK_METHOD2(GetLayerArray, void(struct fann *ann, unsigned *layers));
+
+  MOCK_METHOD2(GetBiasArray, void(struct fann *ann, unsigned *bias));
+
+  MOCK_METHOD1(GetTotalConnections, unsigned(struct fann *ann));
+
+  MOCK_METHOD2(GetConnectionArray, void(struct fann *ann, struct fann_connection *connections));
+
+  MOCK_METHOD3(GetActivationFunction, enum fann_activationfunc_enum(struct fann *ann, int layer, int neuron));
+
+  MOCK_METHOD3(GetActivationSteepness, fann_type(struct fann *ann, int layer, int neuron));
+
+  MOCK_METHOD1(CreateFromFile, struct fann*(const char *configuration_file));
+
+  MOCK_METHOD2(Save, int(struct fann *ann, const char *configuration_file));
+
+  MOCK_METHOD2(Run, fann_type*(struct fann *ann, fann_type *input));
+
+  MOCK_METHOD1(Destroy, void(struct fann *ann));
+};
+
+}
+
+}
+
+}
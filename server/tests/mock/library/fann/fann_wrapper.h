@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016 Adam Chyła, adam@chyla.org
+ * All rights reserved. Distributed under the terms of the MIT License.
+ */
+
+#pragma once
+
+#include "src/library/fann/detail/fann_wrapper_interface.h"
+
+#include <gmock/gmock.h>
+#include <memory>
+
+namespace mock
+{
+
+namespace library
+{
+
+namespace fann
+{
+
+class FannWrapper;
+typedef std::shared_ptr<FannWrapper> FannWrapperPtr;
+
+class FannWrapper : public ::library::fann::detail::FannWrapperInterface {
+ public:
+  virtual ~FannWrapper() = default;
+
+  static FannWrapperPtr Create() {
+    return std::make_shared<FannWrapper>();
+  }
+
+  MOCK_METHOD4(CreateStandard, struct fann*(unsigned num_layers, unsigned num_input,
+                                            unsigned num_neurons_hidden, unsigned num_output));
+
+  MOCK_METHOD2(SetActivationFunctionHidden, void(struct fann *ann,
+                                                 enum fann_activationfunc_enum activation_function));
+
+  MOCK_METHOD2(SetActivationFunctionOutput, void(struct fann *ann,
+                                                 enum fann_activationfunc_enum activation_function));
+
+  MOCK_METHOD5(TrainOnFile, void(struct fann *ann, const std::string &filename, unsigned int max_epochs,
+                                 unsigned int epochs_between_reports, float desired_error));
+
+  MOCK_METHOD4(CreateTrainData, struct fann_train_data*(unsigned num_data, unsigned num_input, unsigned num_output,
+                                                        const TrainDataCallback &callback));
+
+  MOCK_METHOD4(CreateTrainData, struct fann_train_data*(unsigned num_input, unsigned num_output,
+                                                        const std::vector<fann_type> &inputs,
+                                                        const std::vector<fann_type> &outputs));
+
+  MOCK_METHOD5(TrainOnData, void(struct fann *ann, struct fann_train_data *data, unsigned int max_epochs,
+                                 unsigned int epochs_between_reports, float desired_error));
+
+  MOCK_METHOD2(TrainEpoch, float(struct fann *ann, struct fann_train_data *data));
+
+  MOCK_METHOD2(TestData, float(struct fann *ann, struct fann_train_data *data));
+
+  MOCK_METHOD2(SaveTrainDataSnapshot, bool(struct fann_train_data *data, const std::string &file_path));
+
+  MOCK_METHOD1(LoadTrainDataSnapshot, struct fann_train_data*(const std::string &file_path));
+
+  MOCK_METHOD1(DestroyTrainData, void(struct fann_train_data *data));
+
+  MOCK_METHOD1(CreateFromFile, struct fann*(const std::string &configuration_file));
+
+  MOCK_METHOD1(Copy, struct fann*(struct fann *ann));
+
+  MOCK_METHOD1(GetNumInput, unsigned(struct fann *ann));
+
+  MOCK_METHOD1(GetNumOutput, unsigned(struct fann *ann));
+
+  MOCK_METHOD1(GetLayerArray, std::vector<unsigned>(struct fann *ann));
+
+  MOCK_METHOD1(GetBiasArray, std::vector<unsigned>(struct fann *ann));
+
+  MOCK_METHOD1(GetConnectionArray, std::vector<struct fann_connection>(struct fann *ann));
+
+  MOCK_METHOD3(GetActivationFunction, enum fann_activationfunc_enum(struct fann *ann, int layer, int neuron));
+
+  MOCK_METHOD3(GetActivationSteepness, fann_type(struct fann *ann, int layer, int neuron));
+
+  MOCK_METHOD2(Save, int(struct fann *ann, const std::string &configuration_file));
+
+  MOCK_METHOD2(Run, fann_type*(struct fann *ann, fann_type *input));
+
+  MOCK_METHOD1(GetDenseNetwork, std::shared_ptr< ::library::fann::DenseNetwork>(struct fann *ann));
+
+  MOCK_METHOD1(Destroy, void(struct fann *ann));
+};
+
+}
+
+}
+
+}
@@ -25,8 +25,15 @@ class ProgramOptionsCommandExecutorObjectTest : public ::testing::Test {
                             false,
                             "/var/lib/database_file",
                             "/var/lib/",
+                            InferenceEngine::DENSE,
+                            "/tmp/*=<tmp>",
+                            4096,
                             "127.0.0.1",
                             8124,
+                            20,
+                            4,
+                            50,
+                            "",
                             SecurityOption::NONE,
                             "address",
                             9955,
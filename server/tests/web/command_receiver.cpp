@@ -1,7 +1,11 @@
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <gmock/gmock.h>
 #include <memory>
 #include <thread>
 #include <unistd.h>
+#include <slas/network/network.h>
 
 #include "tests/mock/libpatlms/network/network.h"
 #include "tests/mock/web/command_executor.h"
@@ -9,6 +13,7 @@
 #include "src/web/command_receiver.h"
 #include "src/web/exception/detail/connection_is_already_open_exception.h"
 #include "src/web/exception/detail/port_is_closed_exception.h"
+#include "src/web/exception/detail/wrong_command_timeout_exception.h"
 
 using namespace testing;
 using namespace std;
@@ -84,37 +89,153 @@ TEST_F(CommandReceiverTest, IsListen_WhenConstructed) {
   EXPECT_FALSE(command_receiver->IsListen());
 }
 
-TEST_F(CommandReceiverTest, StartListen) {
-  network::ConnectionData new_client;
-  new_client.socket = CLIENT_SOCKET;
-  string example_command_text = "example command";
-  string example_command_result = "example command result";
+TEST_F(CommandReceiverTest, StartListen_WhenPortIsClosed) {
+  EXPECT_FALSE(command_receiver->IsPortOpen());
 
-  EXPECT_CALL(*network_mock, OpenIpv4Socket(StrEq(ADDRESS), PORT)).WillOnce(Return(SOCKET));
-  EXPECT_CALL(*network_mock, Accept(SOCKET)).Times(AtLeast(1)).WillRepeatedly(Return(new_client));
-  EXPECT_CALL(*network_mock, WaitForData(SOCKET, TIMEOUT)).Times(AtLeast(1)).WillRepeatedly(Return(network::WaitStatus::NEW_DATA));
-  EXPECT_CALL(*network_mock, WaitForData(CLIENT_SOCKET, TIMEOUT)).Times(AtLeast(1)).WillRepeatedly(Return(network::WaitStatus::NEW_DATA));
-  EXPECT_CALL(*network_mock, ReceiveText(CLIENT_SOCKET)).Times(AtLeast(1)).WillRepeatedly(Return(example_command_text));
-  EXPECT_CALL(*network_mock, SendText(CLIENT_SOCKET, example_command_result)).Times(AtLeast(1)).WillRepeatedly(Return());
-  EXPECT_CALL(*network_mock, Close(CLIENT_SOCKET)).Times(AtLeast(1)).WillRepeatedly(Return());
+  EXPECT_THROW(command_receiver->StartListen(), exception::detail::PortIsClosedException);
+}
 
-  EXPECT_CALL(*command_executor_mock, Execute(example_command_text)).Times(AtLeast(1)).WillRepeatedly(Return(example_command_result));
+TEST_F(CommandReceiverTest, ParseCommandTimeouts) {
+  auto timeouts = CommandReceiver::ParseCommandTimeouts("get_commands_statistics=120,start_analyzing=5");
 
-  command_receiver->OpenPort(ADDRESS, PORT);
+  ASSERT_EQ(2u, timeouts.size());
+  EXPECT_EQ(chrono::seconds(120), timeouts["get_commands_statistics"]);
+  EXPECT_EQ(chrono::seconds(5), timeouts["start_analyzing"]);
+
+  EXPECT_TRUE(CommandReceiver::ParseCommandTimeouts("").empty());
 
-  thread listen_thread([this]() {
-    command_receiver->StartListen();
-  });
+  EXPECT_THROW(CommandReceiver::ParseCommandTimeouts("command"), exception::detail::WrongCommandTimeoutException);
+  EXPECT_THROW(CommandReceiver::ParseCommandTimeouts("=5"), exception::detail::WrongCommandTimeoutException);
+  EXPECT_THROW(CommandReceiver::ParseCommandTimeouts("command="), exception::detail::WrongCommandTimeoutException);
+  EXPECT_THROW(CommandReceiver::ParseCommandTimeouts("command=5s"), exception::detail::WrongCommandTimeoutException);
+}
 
-  usleep(300);
+// the receiver listens on a real unix socket, network calls are passed
+// to a real Network object
+class CommandReceiverListenTest : public ::testing::Test {
+ public:
+  void SetUp() {
+    socket_path = "/tmp/slas_command_receiver_test_" + to_string(getpid()) + ".socket";
+    unlink(socket_path.c_str());
 
-  command_receiver->StopListen();
+    network = Network::Create();
+    listen_socket = network->OpenUnixSocket(socket_path);
+
+    network_mock = make_shared<mock::libpatlms::network::Network>();
+    EXPECT_CALL(*network_mock, OpenIpv4Socket(_, _)).WillRepeatedly(Return(listen_socket));
+    EXPECT_CALL(*network_mock, Accept(_)).WillRepeatedly(Invoke(network.get(), &Network::Accept));
+    EXPECT_CALL(*network_mock, ReceiveText(_)).WillRepeatedly(Invoke(network.get(), &Network::ReceiveText));
+    EXPECT_CALL(*network_mock, SendText(_, _)).WillRepeatedly(Invoke(network.get(), &Network::SendText));
+    EXPECT_CALL(*network_mock, Close(_)).WillRepeatedly(Invoke(network.get(), &Network::Close));
+
+    command_executor_mock = make_shared<mock::web::CommandExecutor>();
+  }
+
+  void TearDown() {
+    command_receiver->StopListen();
+    listen_thread.join();
+    command_receiver->ClosePort();
+
+    unlink(socket_path.c_str());
+  }
 
-  listen_thread.join();
+  void StartListen(const CommandReceiverPtr &receiver) {
+    command_receiver = receiver;
+    command_receiver->OpenPort("127.0.0.1", 8088);
+
+    listen_thread = thread([this]() {
+      command_receiver->StartListen();
+    });
+  }
+
+  int Connect() {
+    int client_socket = network->Socket(PF_UNIX);
+    network->ConnectUnix(client_socket, socket_path);
+    return client_socket;
+  }
+
+  string socket_path;
+  NetworkPtr network;
+  int listen_socket;
+  shared_ptr<mock::libpatlms::network::Network> network_mock;
+  shared_ptr<mock::web::CommandExecutor> command_executor_mock;
+  CommandReceiverPtr command_receiver;
+  thread listen_thread;
+};
+
+TEST_F(CommandReceiverListenTest, ManyCommandsOnOneConnection) {
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"first\" }")).WillOnce(Return("first result"));
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"second\" }")).WillOnce(Return("second result"));
+  StartListen(CommandReceiver::Create(command_executor_mock, network_mock));
+
+  int client_socket = Connect();
+
+  network->SendText(client_socket, "{ \"command\" : \"first\" }");
+  EXPECT_EQ("first result", network->ReceiveText(client_socket));
+
+  network->SendText(client_socket, "{ \"command\" : \"second\" }");
+  EXPECT_EQ("second result", network->ReceiveText(client_socket));
+
+  network->Close(client_socket);
 }
 
-TEST_F(CommandReceiverTest, StartListen_WhenPortIsClosed) {
-  EXPECT_FALSE(command_receiver->IsPortOpen());
+TEST_F(CommandReceiverListenTest, SlowCommandDoesntBlockOtherClients) {
+  promise<void> slow_started, slow_release;
+  auto release = slow_release.get_future();
+  atomic<bool> released(false);
+
+  // the slow command ends only after the fast one gets its result
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"slow\" }")).WillOnce(InvokeWithoutArgs([&]() {
+    slow_started.set_value();
+    released = (release.wait_for(chrono::seconds(30)) == future_status::ready);
+    return string("slow result");
+  }));
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"fast\" }")).WillOnce(Return("fast result"));
+  StartListen(CommandReceiver::Create(command_executor_mock, network_mock));
+
+  int slow_socket = Connect();
+  network->SendText(slow_socket, "{ \"command\" : \"slow\" }");
+  slow_started.get_future().wait();
+
+  int fast_socket = Connect();
+  network->SendText(fast_socket, "{ \"command\" : \"fast\" }");
+  EXPECT_EQ("fast result", network->ReceiveText(fast_socket));
+  slow_release.set_value();
+
+  EXPECT_EQ("slow result", network->ReceiveText(slow_socket));
+  EXPECT_TRUE(released);
+
+  network->Close(fast_socket);
+  network->Close(slow_socket);
+}
 
-  EXPECT_THROW(command_receiver->StartListen(), exception::detail::PortIsClosedException);
+TEST_F(CommandReceiverListenTest, CommandTimeout) {
+  promise<void> slow_release;
+  auto release = slow_release.get_future();
+  atomic<bool> released(false);
+
+  // the slow command ends only after the client gets the timeout error
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"slow\" }")).WillOnce(InvokeWithoutArgs([&]() {
+    released = (release.wait_for(chrono::seconds(30)) == future_status::ready);
+    return string("slow result");
+  }));
+  EXPECT_CALL(*command_executor_mock, Execute("{ \"command\" : \"fast\" }")).WillOnce(Return("fast result"));
+  StartListen(CommandReceiver::Create(command_executor_mock, network_mock, 1, chrono::seconds(60), {{"slow", chrono::seconds(1)}}));
+
+  int client_socket = Connect();
+  network->SendText(client_socket, "{ \"command\" : \"slow\" }");
+
+  auto result = network->ReceiveText(client_socket);
+  EXPECT_THAT(result, HasSubstr("\"error\""));
+  EXPECT_THAT(result, HasSubstr("Timeout"));
+  slow_release.set_value();
+
+  // the only worker is free again when the timed out command ends
+  int next_socket = Connect();
+  network->SendText(next_socket, "{ \"command\" : \"fast\" }");
+  EXPECT_EQ("fast result", network->ReceiveText(next_socket));
+  EXPECT_TRUE(released);
+
+  network->Close(next_socket);
+  network->Close(client_socket);
 }